@@ -0,0 +1,168 @@
+#ifndef _GP_GUI_DIRTY_RANGES_H_
+#define _GP_GUI_DIRTY_RANGES_H_
+
+/// @file    gp_gui_dirty_ranges.h
+/// @brief   Interval set used to track which bytes of a vertex attribute changed since the last upload
+/// @note    Intervals are half open [begin, end), kept sorted and disjoint. Overlapping or touching
+/// intervals are merged on insertion so every range maps to exactly one glBufferSubData call.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace GridPro_GFX {
+
+    class DirtyRangeSet
+    {
+        public :
+        struct Range
+        {
+            size_t begin, end;
+            size_t size() const { return end - begin; }
+        };
+
+        /// @brief Mark [begin, end) as dirty, merging with the neighbouring intervals
+        void add(size_t begin, size_t end)
+        {
+            if(end <= begin) return;
+
+            /// First interval that could touch the new one (its end is not before begin)
+            auto first = std::lower_bound(m_ranges.begin(), m_ranges.end(), begin,
+                                          [](const Range& range, size_t value) { return range.end < value; });
+            auto last = first;
+            while(last != m_ranges.end() && last->begin <= end)
+            {
+                begin = std::min(begin, last->begin);
+                end   = std::max(end,   last->end);
+                ++last;
+            }
+
+            if(first == last)
+            {
+                m_ranges.insert(first, Range{begin, end});
+                return;
+            }
+
+            *first = Range{begin, end};
+            m_ranges.erase(first + 1, last);
+        }
+
+        /// @brief Merge every range of another set into this one
+        void add(const DirtyRangeSet& other)
+        {
+            for(const Range& range : other.m_ranges)
+                add(range.begin, range.end);
+        }
+
+        /// @brief Merge ranges separated by less than max_gap bytes
+        /// @note  Re-uploading a few clean bytes is cheaper than issuing another buffer update
+        void coalesce(size_t max_gap)
+        {
+            if(m_ranges.size() < 2) return;
+
+            size_t out = 0;
+            for(size_t i = 1; i < m_ranges.size(); ++i)
+            {
+                if(m_ranges[i].begin - m_ranges[out].end <= max_gap)
+                    m_ranges[out].end = m_ranges[i].end;
+                else
+                    m_ranges[++out] = m_ranges[i];
+            }
+            m_ranges.resize(out + 1);
+        }
+
+        /// @brief Drop everything past limit (the attribute was shrunk after the ranges were recorded)
+        void clamp(size_t limit)
+        {
+            while(!m_ranges.empty() && m_ranges.back().begin >= limit)
+                m_ranges.pop_back();
+
+            if(!m_ranges.empty())
+                m_ranges.back().end = std::min(m_ranges.back().end, limit);
+        }
+
+        void clear()                              { m_ranges.clear(); }
+        bool empty() const                        { return m_ranges.empty(); }
+        size_t num_ranges() const                 { return m_ranges.size(); }
+        const std::vector<Range>& ranges() const  { return m_ranges; }
+
+        /// @brief Total number of dirty bytes
+        size_t num_bytes() const
+        {
+            size_t total = 0;
+            for(const Range& range : m_ranges)
+                total += range.size();
+            return total;
+        }
+
+        private :
+        std::vector<Range> m_ranges;
+    };
+
+    /// @brief Log of single vertex writes (node dragging), folded into ranges of vertex indices before upload
+    /// @note  Recording is an append. Folding sorts the log, drops repeated writes to the same vertex and merges
+    /// consecutive indices, so a frame uploads one range per run of touched vertices instead of one per write
+    class VertexUpdateJournal
+    {
+        public :
+        /// @brief Pending writes kept before they are folded in place (bounds the memory of long drags between frames)
+        static constexpr size_t MAX_PENDING_WRITES = 1 << 16;
+
+        void record(uint32_t vertex_index)
+        {
+            m_pending.push_back(vertex_index);
+            if(m_pending.size() >= MAX_PENDING_WRITES)
+                fold();
+        }
+
+        /// @brief Record the vertices [begin, end) in one go
+        void record_range(size_t begin, size_t end)     { m_ranges.add(begin, end); }
+
+        bool empty() const                              { return m_pending.empty() && m_ranges.empty(); }
+
+        /// @brief Ranges of vertex indices written since the last clear
+        const DirtyRangeSet& ranges()
+        {
+            fold();
+            return m_ranges;
+        }
+
+        void clear()
+        {
+            m_pending.clear();
+            m_ranges.clear();
+        }
+
+        private :
+        void fold()
+        {
+            if(m_pending.empty()) return;
+
+            std::sort(m_pending.begin(), m_pending.end());
+            m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+
+            size_t run_begin = m_pending.front();
+            size_t run_end   = run_begin + 1;
+            for(size_t i = 1; i < m_pending.size(); ++i)
+            {
+                if(m_pending[i] == run_end)
+                {
+                    ++run_end;
+                    continue;
+                }
+                m_ranges.add(run_begin, run_end);
+                run_begin = m_pending[i];
+                run_end   = run_begin + 1;
+            }
+            m_ranges.add(run_begin, run_end);
+            m_pending.clear();
+        }
+
+        std::vector<uint32_t> m_pending;
+        DirtyRangeSet m_ranges;
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_DIRTY_RANGES_H_
@@ -0,0 +1,174 @@
+#ifndef _GP_GUI_DRAW_BUCKETS_H_
+#define _GP_GUI_DRAW_BUCKETS_H_
+
+/// @file    gp_gui_draw_buckets.h
+/// @brief   Entity slots grouped by layer, with one visibility bit per slot
+/// @note    A layer pass walks its own bucket and tests one bit per entity instead of visiting every entity of the scene
+/// and comparing layer IDs. The buckets change only when an entity is committed to a layer or destroyed, the bits only
+/// when it is shown or hidden. Removing a slot moves the last slot of its bucket into its place, so the order inside a
+/// bucket is the commit order only until the first removal.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace GridPro_GFX {
+
+    class DrawBuckets
+    {
+        public :
+        static constexpr uint32_t NO_BUCKET = 0xFFFFFFFF;
+
+        /// @brief Put a slot in the bucket of a layer, moving it out of its previous one. A new slot starts hidden
+        void insert(const uint32_t& slot, const float& layer)
+        {
+            if(slot >= m_entries.size())
+            {
+                m_entries.resize(slot + 1);
+                m_visible.resize(m_entries.size() / 64 + 1, 0);
+            }
+
+            const uint32_t bucket = find_or_add_bucket(layer);
+            if(m_entries[slot].bucket == bucket) return;
+
+            erase_from_bucket(slot);
+            m_entries[slot].bucket   = bucket;
+            m_entries[slot].position = static_cast<uint32_t>(m_buckets[bucket].slots.size());
+            m_buckets[bucket].slots.push_back(slot);
+        }
+
+        /// @brief Drop a slot from its bucket and clear its visibility bit
+        void remove(const uint32_t& slot)
+        {
+            if(!contains(slot)) return;
+            set_visible(slot, false);
+            erase_from_bucket(slot);
+            m_entries[slot].bucket = NO_BUCKET;
+        }
+
+        bool contains(const uint32_t& slot) const
+        {
+            return slot < m_entries.size() && m_entries[slot].bucket != NO_BUCKET;
+        }
+
+        /// @brief Layer of a slot, check contains() first
+        float layer_of(const uint32_t& slot) const { return m_buckets[m_entries[slot].bucket].layer; }
+
+        /// @note Only slots in a bucket can be made visible
+        void set_visible(const uint32_t& slot, const bool& visible)
+        {
+            if(!contains(slot)) return;
+            const uint64_t bit = uint64_t(1) << (slot % 64);
+            if(visible) m_visible[slot / 64] |= bit;
+            else        m_visible[slot / 64] &= ~bit;
+        }
+
+        bool is_visible(const uint32_t& slot) const
+        {
+            return slot < m_entries.size() && (m_visible[slot / 64] >> (slot % 64)) & 1;
+        }
+
+        /// @brief Slots of a layer, visible or not
+        const std::vector<uint32_t>& slots(const float& layer) const
+        {
+            static const std::vector<uint32_t> no_slots;
+            const uint32_t bucket = find_bucket(layer);
+            return bucket != NO_BUCKET ? m_buckets[bucket].slots : no_slots;
+        }
+
+        /// @brief Call fn(slot) for the visible slots of a layer, in bucket order
+        template<typename Fn>
+        void for_each_visible(const float& layer, Fn&& fn) const
+        {
+            for(const uint32_t& slot : slots(layer))
+            {
+                if(is_visible(slot))
+                    fn(slot);
+            }
+        }
+
+        /// @brief Call fn(slot) for the visible slots of every layer, in slot order
+        template<typename Fn>
+        void for_each_visible(Fn&& fn) const
+        {
+            for(size_t word = 0; word < m_visible.size(); ++word)
+            {
+                uint64_t bits = m_visible[word];
+                for(uint32_t slot = static_cast<uint32_t>(word * 64); bits != 0; ++slot, bits >>= 1)
+                {
+                    if(bits & 1)
+                        fn(slot);
+                }
+            }
+        }
+
+        /// @brief Call fn(slot) for every slot in a bucket, visible or not
+        template<typename Fn>
+        void for_each(Fn&& fn) const
+        {
+            for(const Bucket& bucket : m_buckets)
+            {
+                for(const uint32_t& slot : bucket.slots)
+                    fn(slot);
+            }
+        }
+
+        void clear()
+        {
+            m_buckets.clear();
+            m_entries.clear();
+            m_visible.clear();
+        }
+
+        private :
+        /// Scenes use a handful of layers, a linear search beats hashing floats
+        uint32_t find_bucket(const float& layer) const
+        {
+            for(size_t i = 0; i < m_buckets.size(); ++i)
+            {
+                if(m_buckets[i].layer == layer)
+                    return static_cast<uint32_t>(i);
+            }
+            return NO_BUCKET;
+        }
+
+        uint32_t find_or_add_bucket(const float& layer)
+        {
+            const uint32_t bucket = find_bucket(layer);
+            if(bucket != NO_BUCKET) return bucket;
+            m_buckets.push_back(Bucket{layer, {}});
+            return static_cast<uint32_t>(m_buckets.size() - 1);
+        }
+
+        void erase_from_bucket(const uint32_t& slot)
+        {
+            const Entry entry = m_entries[slot];
+            if(entry.bucket == NO_BUCKET) return;
+
+            std::vector<uint32_t>& bucket_slots = m_buckets[entry.bucket].slots;
+            const uint32_t last = bucket_slots.back();
+            bucket_slots[entry.position] = last;
+            m_entries[last].position = entry.position;
+            bucket_slots.pop_back();
+        }
+
+        struct Bucket
+        {
+            float                 layer;
+            std::vector<uint32_t> slots;
+        };
+
+        struct Entry
+        {
+            uint32_t bucket   = NO_BUCKET;
+            uint32_t position = 0;
+        };
+
+        std::vector<Bucket>   m_buckets;
+        std::vector<Entry>    m_entries;   ///< by slot
+        std::vector<uint64_t> m_visible;   ///< one bit per slot
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_DRAW_BUCKETS_H_
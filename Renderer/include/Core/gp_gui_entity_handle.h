@@ -4,6 +4,7 @@
 #include <string>
 
 #include "ecs.h"
+#include "gp_gui_slot_map.h"
 
 
 namespace GridPro_GFX
@@ -80,9 +81,13 @@ namespace GridPro_GFX
          
     private:
         friend class  Scene_Manager;
-        std::string   entity_key;
+        /// @brief Key stored with the entity in the scene, not a copy
+        const std::string* entity_key;
         ecs::Entity*  entity_ptr;
         Scene_Manager* scene_ptr;
+
+        /// @brief Slot of the entity in the scene, outlives it : is_valid() turns false once the slot is freed or reused
+        SlotHandle    slot_handle;
     };
 
 } // namespace GridPro_GFX
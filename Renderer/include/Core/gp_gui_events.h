@@ -4,6 +4,8 @@
 #include <glm/glm.hpp>
 #include <string>
 
+#include "gp_gui_slot_map.h"
+
 
 namespace GridPro_GFX
 {
@@ -253,11 +255,23 @@ uint32_t getSubEntityID()
    return this->sub_entity_id; 
 }
 
-std::string getEntityKey() const 
+const std::string& getEntityKey() const 
 {
    return entity_name;
 }
 
+/// @brief Handle of the picked entity, null when nothing is picked
+/// @note  Compare and look geometries up with it instead of the entity key on paths run at every mouse move
+const EntityId& getEntityHandle() const 
+{
+   return entity_handle;
+}
+
+void setEntityHandle(const EntityId& input_handle)  
+{
+   entity_handle = input_handle;
+}
+
 void setEntityKey(const std::string& inputname)  
 {
    entity_name = inputname;
@@ -283,6 +297,7 @@ private:
     uint32_t picked_color_id;
     float depth;
     std::string entity_name;
+    EntityId entity_handle;
 };
 
 } // namespace GridPro_GFX
@@ -8,6 +8,8 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/matrix_access.hpp>
 #include <cmath>
+#include <limits>
+#include <algorithm>
 
 #include <cstdint>
 
@@ -41,6 +43,8 @@ namespace GridPro_GFX
         cached_is_depth_test_enabled = false;
         cached_depth_test_enabled = false;
         is_2d = false;
+        enable_lod = true;
+        lod_pixel_error = 1.0f;
       }
 
       void set_screen_dims(double x , double y)
@@ -96,6 +100,29 @@ namespace GridPro_GFX
         return false;
       }
 
+      /// @brief Size in pixels of the screen space extent of a bounding box under the current MVP
+      /// @note  Returns the largest float when part of the box is behind the camera (draw at full detail)
+      float get_projected_screen_size(const std::array<float, 6> &bb) const
+      {
+        float min_x =  std::numeric_limits<float>::max(), min_y =  std::numeric_limits<float>::max();
+        float max_x = -std::numeric_limits<float>::max(), max_y = -std::numeric_limits<float>::max();
+        const glm::mat4 mvp = m_projection * m_view * m_model;
+
+        for (int i = 0; i < 8; ++i)
+        {
+          const glm::vec4 corner((i & 1) ? bb[3] : bb[0], (i & 2) ? bb[4] : bb[1], (i & 4) ? bb[5] : bb[2], 1.0f);
+          const glm::vec4 clip = mvp * corner;
+          if (clip.w <= 0.0f) return std::numeric_limits<float>::max();
+
+          const float x = (clip.x / clip.w + 1.0f) * 0.5f * m_screen_dims.x;
+          const float y = (clip.y / clip.w + 1.0f) * 0.5f * m_screen_dims.y;
+          min_x = std::min(min_x, x); max_x = std::max(max_x, x);
+          min_y = std::min(min_y, y); max_y = std::max(max_y, y);
+        }
+
+        return std::sqrt((max_x - min_x) * (max_x - min_x) + (max_y - min_y) * (max_y - min_y));
+      }
+
      ~SceneState() {}
       enum RenderMode { NONE = 0 , RENDER = 1, SELECT = 2, RENDER_AND_SELECT = 3 }; 
       enum DriverEnum { OpenGL_2_1 = 0, OpenGL_3_3 = 1 };
@@ -138,6 +165,10 @@ namespace GridPro_GFX
 
       bool  render_systems_enabled;
       uint32_t m_render_context_id;
+
+      /// Level of detail selection : switch to a coarser level while its error stays below lod_pixel_error pixels
+      bool  enable_lod;
+      float lod_pixel_error;
       
       bool  is_render_systems_enabled()   { return render_systems_enabled; }
       bool  flip_render_systems_switch()  { render_systems_enabled = !render_systems_enabled; return render_systems_enabled; }
@@ -26,6 +26,19 @@
 #include <memory>
 
 #include "gp_gui_typedefs.h"
+#include "gp_gui_vertex_layout.h"
+#include "gp_gui_dirty_ranges.h"
+#include "gp_gui_index_buffer.h"
+#include "gp_gui_primitive_traits.h"
+#include "gp_gui_mesh_simplifier.h"
+#include "gp_gui_mesh_optimizer.h"
+#include "gp_gui_triangulator.h"
+#include "gp_gui_tessellator.h"
+#include "gp_gui_interned_table.h"
+#include "gp_gui_vertex_transform.h"
+#include "gp_gui_instance_array.h"
+#include "gp_gui_primitive_color_array.h"
+#include "gp_gui_strip_array.h"
 
 #include "../Viewers/export.h"
 
@@ -205,8 +218,8 @@ public:
             switch(pickScheme)
             {
                 case PICK_NONE: count = 0; break;
-                case PICK_BY_VERTEX: count = get_num_unique_positions(); break;
-                case PICK_BY_PRIMITIVE: count = get_num_primitives(); break;
+                case PICK_BY_VERTEX: count = isInstanced() ? get_num_instances() : get_num_unique_positions(); break;
+                case PICK_BY_PRIMITIVE: count = isInstanced() ? get_num_instances() : isMultiStrip() ? get_num_strips() : get_num_primitives(); break;
                 case PICK_GEOMETRY: count = 1; break;
                 default: count = 0; break;
             }
@@ -239,8 +252,12 @@ public:
 
         std::array<float, 3> get_primitive_vertex(const uint32_t& index);
 
-        float* get_vertex_ref(const uint32_t& index);
+        /// @brief Position of a vertex, nullptr if out of range
+        /// @note  Read only : the buffer may be shared copy-on-write, writes go through GeometryDescriptor::update_vertex
+        const float* get_vertex_ref(const uint32_t& index) const;
 
+        /// @brief Refine one triangle into an indexed GL_TRIANGLES descriptor (4^tessellation_level triangles)
+        /// @note  Midpoints are shared between the sub triangles, see GeometryDescriptor::tessellate_primitive_set
         std::shared_ptr<GeometryDescriptor> tesselate_primitve(const uint32_t& index, const uint32_t& tessellation_level);
         
         /// @brief Set shader model
@@ -327,60 +344,103 @@ public:
         { return indices;  }
 
         /// @brief Share Pointer to the Positions
+        /// @note  Shared buffers are copy-on-write, the first write through this set detaches it from the owner
         void share_position_shared_ptr(std::shared_ptr<std::vector<float>>& in_position) 
-        { positions = in_position; }
+        { positions = in_position; set_copy_on_write(POSITION_ARRAY); invalidate_bounding_box(); }
 
         /// @brief Share Pointer to the Normals
         void share_normals_shared_ptr(std::shared_ptr<std::vector<float>>& in_normal) 
-        { normals = in_normal; }
+        { normals = in_normal; set_copy_on_write(NORMAL_ARRAY); }
 
         /// @brief Share Pointer to the Colors
         void share_colors_shared_ptr(std::shared_ptr<std::vector<uint8_t>>& in_color) 
-        { colors = in_color; }
+        { colors = in_color; set_copy_on_write(COLOR_ARRAY); }
 
         /// @brief SharePointer to the Indices
         void share_indices_shared_ptr(std::shared_ptr<std::vector<uint32_t>>& in_indices) 
-        { indices = in_indices; }
+        { indices = in_indices; set_copy_on_write(INDEX_ARRAY); }
 
+        /// @brief Get Weak Pointer to the Interleaved Vertices (expired if the set is not interleaved)
+        std::weak_ptr<InterleavedVertexArray> get_interleaved_weak_ptr() const
+        { return interleaved_vertices; }
+
+        /// @brief Check if the primitive set stores its vertices interleaved
+        bool isInterleaved() const              { return interleaved_vertices != nullptr; }
+
+        /// @brief Get the runtime vertex layout of an interleaved primitive set
+        /// @return nullptr if the primitive set is not interleaved
+        const VertexLayoutInfo* get_vertex_layout() const 
+        { return interleaved_vertices ? &interleaved_vertices->layout() : nullptr; }
+
+        /// @brief Pack the separate position, normal and color arrays into one interleaved array
+        /// @note  Positions are detached from the shared GeometryDescriptor positions and the separate arrays are released
+        /// @throws std::runtime_error if the attribute counts do not match
+        void interleave_vertex_attributes(const VertexLayoutInfo& layout);
+
+        /// @brief Enable / Disable the compressed GPU vertex format (16 bit positions, packed normals, normalized colors)
+        /// @note  Only the uploaded VBO is compressed. The CPU side arrays keep full precision for picking and editing
+        void set_vertex_compression(const bool& flag)
+        { use_vertex_compression = flag; dirtyFlags |= (DIRTY_POSITIONS | DIRTY_NORMALS | DIRTY_COLORS); }
+
+        /// @brief Check if the primitive set is uploaded in the compressed vertex format
+        bool isVertexCompressionEnabled() const { return use_vertex_compression; }
+
+        /// @brief Encode the vertex attributes into the compressed GPU vertex format
+        /// @param quantization is filled with the quantization box (bounding box) of the positions
+        /// @return Interleaved array in one of the QuantizedLayout_* layouts
+        InterleavedVertexArray build_quantized_vertex_array(VertexQuantization& quantization) const;
+
+        /// @brief Re-encode the vertices [first, last) of an array built by build_quantized_vertex_array
+        void encode_quantized_vertices(const VertexQuantization& quantization, InterleavedVertexArray& quantized, const size_t& first, const size_t& last) const;
+
+        /// @brief Check which vertex attributes are present (works for both separate and interleaved storage)
+        bool has_normal_attrib() const          { return isInterleaved() ? interleaved_vertices->layout().has(ATTRIB_NORMAL) : normals->size() > 0; }
+        bool has_color_attrib()  const          { return isInterleaved() ? interleaved_vertices->layout().has(ATTRIB_COLOR)  : colors->size()  > 0; }
+
+
+        /// @brief Get the number of stored positions
+        size_t get_num_positions() const        { return isInterleaved() ? interleaved_vertices->size() : positions->size() / 3; }
 
         /// @brief Get the number of vertices
-        size_t get_num_unique_positions() const { if(primitiveType != POINTS) { return positions->size() / 3; } else { if(indices->size()) return indices->size(); } return positions->size() / 3; }
-        size_t get_num_vertices() const         { return indices->size() ? indices->size() : positions->size() / 3; }
+        size_t get_num_unique_positions() const { if(primitiveType != POINTS) { return get_num_positions(); } else { if(indices->size()) return indices->size(); } return get_num_positions(); }
+        size_t get_num_vertices() const         { return indices->size() ? indices->size() : get_num_positions(); }
+
+        /// @brief Index type the drivers draw this set with (GL_UNSIGNED_SHORT below 65536 positions, see gp_gui_index_buffer.h)
+        GLenum get_index_type() const           { return select_index_type(get_num_positions()); }
+
         size_t get_num_indices()  const         { return indices->size(); }
         size_t get_num_normals()  const         { return normals->size() / 3; }
         size_t get_num_colors()   const         { return colors->size() / (colorFormat == RGB ? 3 : 4); }
-        size_t get_num_vertices_per_primitive() const 
+        /// @brief Get the traits of the primitive type (see gp_gui_primitive_traits.h)
+        /// @throws std::runtime_error if the primitive type is NONE
+        const PrimitiveTraits& get_primitive_traits() const
         {
-            GLuint vertices_per_primitive = 1 ;
-            switch(primitiveType) {
-                case POINTS:         vertices_per_primitive = 1; break;
-                case LINES:          vertices_per_primitive = 2; break;
-                case LINE_STRIP:     vertices_per_primitive = 2; break;
-                case LINE_LOOP:      vertices_per_primitive = 2; break;
-                case TRIANGLES:      vertices_per_primitive = 3; break;
-                case TRIANGLE_STRIP: vertices_per_primitive = 3; break;
-                case TRIANGLE_FAN:   vertices_per_primitive = 3; break;
-                case QUADS:          vertices_per_primitive = 4; break;
-                case QUAD_STRIP:     vertices_per_primitive = 4; break;
-                case POLYGON:        vertices_per_primitive = 3; break;
-                case NONE:           throw std::runtime_error("PrimitiveType is set to None\n"); break;  
-                default:             vertices_per_primitive = 1; break;
-            }
-            return vertices_per_primitive;
+            if(primitiveType == NONE)
+                throw std::runtime_error("PrimitiveType is set to None\n");
+            return GridPro_GFX::get_primitive_traits(static_cast<GLenum>(primitiveType));
         }
 
-        size_t get_num_primitives() const       { return get_num_vertices() / get_num_vertices_per_primitive(); }
+        size_t get_num_vertices_per_primitive() const { return get_primitive_traits().vertices_per_primitive; }
+
+        /// @brief Get the number of primitives GL assembles from the vertices (segments of a strip, quads of a quad strip)
+        size_t get_num_primitives() const
+        {
+            const size_t num_vertices = get_num_vertices();
+            return dispatch_primitive_type(static_cast<GLenum>(primitiveType), [&](auto traits) { return decltype(traits)::num_primitives(num_vertices); });
+        }
 
         /// @brief Reset the primitive set
         void release_ref_all() 
         {
-            normals.reset(); colors.reset(); indices.reset();
+            normals.reset(); colors.reset(); indices.reset(); interleaved_vertices.reset();
             
+            detach_attrib_array(POSITION_ARRAY);
            *positions = std::vector<float>(0);
             normals   = std::make_shared<std::vector<float>>(0);
             colors    = std::make_shared<std::vector<uint8_t>>(0);
             indices   = std::make_shared<std::vector<uint32_t>>(0);
 
+            invalidate_bounding_box();
             dirtyFlags = DIRTY_ALL;
         }
 
@@ -388,22 +448,23 @@ public:
         void clear_all() {
             clear_positions(); clear_normals(); 
             clear_colors();    clear_indices();
+            interleaved_vertices.reset();
         }        
         
         void clear_positions() 
-        { positions->resize(0); dirtyFlags |= DIRTY_POSITIONS; }
+        { detach_attrib_array(POSITION_ARRAY); positions->resize(0); if(interleaved_vertices) interleaved_vertices->clear(); invalidate_bounding_box(); dirtyFlags |= DIRTY_POSITIONS; }
 
         void clear_normals() 
-        { normals->resize(0);   dirtyFlags |= DIRTY_NORMALS;   }
+        { detach_attrib_array(NORMAL_ARRAY);   normals->resize(0);   dirtyFlags |= DIRTY_NORMALS;   }
 
         void clear_colors() 
-        { colors->resize(0);    dirtyFlags |= DIRTY_COLORS;    }
+        { detach_attrib_array(COLOR_ARRAY);    colors->resize(0);    dirtyFlags |= DIRTY_COLORS;    }
 
         void clear_indices() 
-        { indices->resize(0);   dirtyFlags |= DIRTY_INDICES;   }
+        { detach_attrib_array(INDEX_ARRAY);    indices->resize(0);   dirtyFlags |= DIRTY_INDICES;   }
 
         void release_positions_ref() 
-        { *positions = std::vector<float>(0);     dirtyFlags |= DIRTY_POSITIONS; }
+        { detach_attrib_array(POSITION_ARRAY); *positions = std::vector<float>(0); invalidate_bounding_box(); dirtyFlags |= DIRTY_POSITIONS; }
 
         void release_normals_ref() 
         { normals.reset();   normals   = std::make_shared<std::vector<float>>(0);     dirtyFlags |= DIRTY_NORMALS;   }
@@ -422,7 +483,49 @@ public:
         bool isDirty(const uint32_t& flag) const { return (dirtyFlags & flag) != 0; }
         bool isDirty() const                     { return  dirtyFlags != 0; }
 
-        bool isHavingPositonUpdates() const     { return batch_vertex_updates.empty() == false; }
+        bool isHavingPositonUpdates() const     { return vertex_update_journal.empty() == false; }
+
+        /// @brief Record a position written in place (the CPU copy already holds the new value)
+        void record_vertex_update(const uint32_t& index) { vertex_update_journal.record(index); }
+
+        /// @brief Record positions [first_vertex, end_vertex) written in place
+        void record_vertex_update_range(const size_t& first_vertex, const size_t& end_vertex) { vertex_update_journal.record_range(first_vertex, end_vertex); }
+
+        /// @brief Turn the recorded vertex writes into dirty byte ranges of the positions (merged runs of vertices)
+        /// @note  Called by the VAOs before uploading the dirty ranges
+        void flush_vertex_updates();
+
+        /// @brief Mark a byte range of a vertex attribute as changed. The VAO uploads only these ranges on its next bind
+        /// @note  Interleaved primitive sets record every vertex attribute in the POSITION_ARRAY ranges (bytes of the interleaved block)
+        void mark_dirty_range(VertexAttribArrayType type, const size_t& byte_begin, const size_t& byte_end)
+        { dirty_ranges[attrib_slot(type)].add(byte_begin, byte_end); }
+
+        /// @brief Get the changed byte ranges of a vertex attribute
+        const DirtyRangeSet& get_dirty_ranges(VertexAttribArrayType type) const
+        { return dirty_ranges[attrib_slot(type)]; }
+
+        /// @brief Check if any attribute has changed ranges waiting for upload
+        bool hasDirtyRanges() const
+        { for(const auto& ranges : dirty_ranges) if(!ranges.empty()) return true; return false; }
+
+        /// @brief Drop the changed ranges (called by the VAO once they are uploaded)
+        void clear_dirty_ranges()
+        { for(auto& ranges : dirty_ranges) ranges.clear(); }
+
+        /// @brief Changed ranges of the position, normal and color attributes converted to vertex index ranges
+        DirtyRangeSet get_dirty_vertex_ranges() const;
+
+        /// @brief Keep an attribute buffer shared until the first write, which then gives this set a private copy
+        /// @note  POSITION_ARRAY also covers the interleaved vertices
+        void set_copy_on_write(VertexAttribArrayType type)    { copy_on_write_flags |= (1u << attrib_slot(type)); }
+        void set_copy_on_write_all()                          { copy_on_write_flags = (1u << 4) - 1; }
+
+        /// @brief Check if an attribute buffer is still shared copy-on-write
+        bool isCopyOnWrite(VertexAttribArrayType type) const  { return (copy_on_write_flags & (1u << attrib_slot(type))) != 0; }
+
+        /// @brief Make a copy-on-write attribute buffer private to this set before writing to it
+        /// @note  Only this set is detached. GeometryDescriptor::detach_attrib_array keeps sets of one descriptor sharing
+        void detach_attrib_array(VertexAttribArrayType type);
 
         void set_node_manipulator(const bool& flag)   { is_node_manipulation_enabled = flag; pickScheme = PICK_BY_VERTEX; }
         bool isNodeManipulationEnabled() const        { return is_node_manipulation_enabled; }
@@ -442,7 +545,7 @@ public:
         void clearDirty()                             { dirtyFlags = 0; }
 
         /// @brief Validate the primitive set
-        bool isDrawable() const                 { return positions->size() > 0 && primitiveType != PrimitiveType::NONE; }
+        bool isDrawable() const                 { return get_num_positions() > 0 && primitiveType != PrimitiveType::NONE; }
         bool isHighlightable() const            { return is_hover_highlightable; }
         bool isHighlighted() const              { return is_already_hover_highlighted; }
         bool isSelectionHighlightable() const   { return is_select_highlightable; }
@@ -493,13 +596,109 @@ public:
            custom_highlight_color = {r, g, b, a}; 
         }
         
+        /// @brief Get the axis aligned bounding box {min_x, min_y, min_z, max_x, max_y, max_z} of the positions
+        /// @note  Cached. Computed by a parallel reduction on first use and kept up to date incrementally
         std::array<float, 6> get_bounding_box() const ;
 
+        /// @brief Override the cached bounding box (it is still grown by later vertex edits)
         void set_bounding_box(std::array<float, 6> in_bounding_box) 
         {
-            m_bounding_box = std::make_shared<std::array<float, 6>>(in_bounding_box);
+            m_bounding_box = in_bounding_box;
+            m_bounding_box_num_positions = get_num_positions();
+            is_bounding_box_valid = true;
+        }
+
+        /// @brief Drop the cached bounding box. It is recomputed on the next get_bounding_box()
+        void invalidate_bounding_box()          { is_bounding_box_valid = false; }
+
+        /// @brief Check if the cached bounding box matches the current positions
+        bool isBoundingBoxValid() const         { return is_bounding_box_valid && m_bounding_box_num_positions == get_num_positions(); }
+
+        /// @brief Grow the cached bounding box by a newly appended position
+        void expand_bounding_box(const float& x, const float& y, const float& z);
+
+        /// @brief Update the cached bounding box for a vertex moved from old_position to new_position
+        /// @note  Moving a vertex away from a face of the box can shrink it, so the cache is dropped in that case
+        void update_bounding_box(const std::array<float, 3>& old_position, const std::array<float, 3>& new_position);
+
+        /// @brief Attach simplified levels of detail (level 0 is the primitive set itself, levels index its vertex array)
+        /// @note  The chain is dropped as soon as the number of positions or indices changes
+        void set_lod_chain(std::vector<LodLevel>&& levels)
+        {
+            lod_chain = levels.empty() ? nullptr : std::make_shared<const std::vector<LodLevel>>(std::move(levels));
+            lod_base_num_positions = get_num_positions();
+            lod_base_num_indices = get_num_indices();
         }
 
+        void clear_lod_chain()                  { lod_chain.reset(); }
+
+        /// @brief Check if simplified levels exist and still match the vertex and index arrays
+        bool hasLodChain() const                { return lod_chain && lod_base_num_positions == get_num_positions() && lod_base_num_indices == get_num_indices(); }
+
+        /// @brief Number of levels including the full resolution level 0
+        size_t get_num_lod_levels() const       { return hasLodChain() ? lod_chain->size() + 1 : 1; }
+
+        /// @brief Get a simplified level (1 <= level < get_num_lod_levels())
+        const LodLevel& get_lod_level(const size_t& level) const { return (*lod_chain)[level - 1]; }
+
+        /// @brief Get the simplified levels (nullptr if there are none or they are out of date)
+        std::shared_ptr<const std::vector<LodLevel>> get_lod_chain() const { return hasLodChain() ? lod_chain : nullptr; }
+
+        /// @brief Pick the coarsest level whose geometric error stays below max_pixel_error on screen
+        /// @param screen_size_pixels  projected size of the bounding box diagonal in pixels
+        size_t select_lod_level(const float& screen_size_pixels, const float& max_pixel_error) const;
+
+        /// @brief Check if the primitive type has no core profile equivalent (quads, quad strips and polygons)
+        /// @note  The OpenGL 3.3 driver draws these sets from their triangulation
+        bool requiresTriangulation() const      { return primitiveType == QUADS || primitiveType == QUAD_STRIP || primitiveType == POLYGON; }
+
+        /// @brief Attach the indexed triangle form of the primitive set
+        /// @note  Dropped as soon as the number of positions or indices changes
+        void set_triangulation(Triangulation&& in_triangulation)
+        {
+            triangulation = std::make_shared<const Triangulation>(std::move(in_triangulation));
+            triangulation_base_num_positions = get_num_positions();
+            triangulation_base_num_indices = get_num_indices();
+        }
+
+        void clear_triangulation()              { triangulation.reset(); }
+
+        /// @brief Check if a triangulation exists and still matches the vertex and index arrays
+        bool hasTriangulation() const           { return triangulation && triangulation_base_num_positions == get_num_positions() && triangulation_base_num_indices == get_num_indices(); }
+
+        /// @brief Get the triangulation (nullptr if there is none or it is out of date)
+        std::shared_ptr<const Triangulation> get_triangulation() const { return hasTriangulation() ? triangulation : nullptr; }
+
+        /// @brief Check if the set is a prototype instancing set (its vertices are drawn once per instance)
+        /// @note  Instances are the pickable entities of an instanced set picked by primitive or by vertex
+        bool isInstanced() const                { return instances != nullptr; }
+
+        size_t get_num_instances() const        { return instances ? instances->size() : 0; }
+
+        /// @brief Get the per instance transforms and colors (nullptr if the set is not instanced)
+        std::shared_ptr<const InstanceArray> get_instances() const { return instances; }
+
+        /// @brief Bounding box of the prototype placed at every instance (the box of the positions if the set is not instanced)
+        std::array<float, 6> get_instanced_bounding_box() const { return instances ? instances->get_bounding_box(get_bounding_box()) : get_bounding_box(); }
+
+        /// @brief Check if the set is drawn with its per primitive colors (ColorScheme::PER_PRIMITIVE and a color array)
+        bool hasPrimitiveColors() const         { return colorScheme == PER_PRIMITIVE && primitive_colors && !primitive_colors->empty(); }
+
+        /// @brief Get the per primitive colors (nullptr if the set has none)
+        std::shared_ptr<const PrimitiveColorArray> get_primitive_colors() const { return primitive_colors; }
+
+        /// @brief Check if the primitive type can hold several strips (line strips, line loops, triangle strips and fans)
+        bool supportsStrips() const             { return primitiveType == LINE_STRIP || primitiveType == LINE_LOOP || primitiveType == TRIANGLE_STRIP || primitiveType == TRIANGLE_FAN; }
+
+        /// @brief Check if the set packs several strips (see gp_gui_strip_array.h), they are its pickable primitives
+        /// @note  Strips no longer covering every vertex of the set (vertices added without a strip) are ignored
+        bool isMultiStrip() const               { return supportsStrips() && strips && !strips->empty() && strips->get_num_vertices() == get_num_vertices(); }
+
+        size_t get_num_strips() const           { return isMultiStrip() ? strips->size() : 0; }
+
+        /// @brief Get the strip boundaries (nullptr if the set is not a multi strip set)
+        std::shared_ptr<const StripArray> get_strips() const { return isMultiStrip() ? strips : nullptr; }
+
         /// @brief Validate the primitive set (will throw an exception if the primitive set is not valid)
         /// @note This function is used to validate the primitive set
         /// @note It will throw an exception if the primitive set is not valid
@@ -542,10 +741,15 @@ public:
 
         std::vector<float> get_flattened_position_array();
 
-        void update_vertex(const std::array<float, 3> &position, const uint32_t &index);
-
       private:
         friend class GeometryDescriptor;
+
+        /// @brief Writable position of a vertex, nullptr if out of range
+        /// @note  Does not detach : the descriptor detaches every set sharing the positions first
+        float* vertex_data(const uint32_t& index);
+
+        /// @brief Move a vertex in place, see GeometryDescriptor::update_vertex
+        void update_vertex(const std::array<float, 3> &position, const uint32_t &index);
         /// @brief Name of the primitive set instance
         const std::string InstanceName;
 
@@ -591,12 +795,75 @@ public:
         /// @brief Indices for this primitive set
         std::shared_ptr<std::vector<uint32_t>> indices;
 
-        /// @brief Bounding Box
-        std::shared_ptr<std::array<float, 6>> m_bounding_box;
+        /// @brief Interleaved vertices (optional). When set it replaces positions, normals and colors
+        std::shared_ptr<InterleavedVertexArray> interleaved_vertices;
+
+        /// @brief Cached Bounding Box
+        mutable std::array<float, 6> m_bounding_box;
+
+        /// @brief Number of positions the cached bounding box was built for
+        mutable size_t m_bounding_box_num_positions;
+
+        mutable bool is_bounding_box_valid;
 
         /// @brief Flags to indicate which data has changed
         uint32_t dirtyFlags;
 
+        /// @brief Upload the vertices in the compressed vertex format
+        bool use_vertex_compression;
+
+        /// @brief Changed byte ranges per vertex attribute (positions, normals, colors, indices)
+        std::array<DirtyRangeSet, 4> dirty_ranges;
+
+        /// @brief Attribute buffers that are still shared copy-on-write (bit per attrib_slot)
+        uint32_t copy_on_write_flags;
+
+        /// @brief Simplified levels of detail, shared between clones
+        std::shared_ptr<const std::vector<LodLevel>> lod_chain;
+
+        /// @brief Number of positions and indices the levels of detail were built for
+        size_t lod_base_num_positions;
+        size_t lod_base_num_indices;
+
+        /// @brief Indexed triangle form of quads, quad strips and polygons, shared between clones
+        std::shared_ptr<const Triangulation> triangulation;
+
+        /// @brief Number of positions and indices the triangulation was built for
+        size_t triangulation_base_num_positions;
+        size_t triangulation_base_num_indices;
+
+        /// @brief Per instance transforms and colors of a prototype instancing set, shared copy-on-write between clones
+        std::shared_ptr<InstanceArray> instances;
+
+        /// @brief One RGBA color per primitive, shared copy-on-write between clones
+        std::shared_ptr<PrimitiveColorArray> primitive_colors;
+
+        /// @brief Boundaries of the strips of a multi strip set, shared copy-on-write between clones
+        std::shared_ptr<StripArray> strips;
+
+        /// @brief Identity of the buffer behind an attribute (the interleaved array holds the positions of interleaved sets)
+        const void* attrib_storage(VertexAttribArrayType type) const
+        {
+            switch(type) {
+                case POSITION_ARRAY: return isInterleaved() ? static_cast<const void*>(interleaved_vertices.get()) : positions.get();
+                case NORMAL_ARRAY:   return normals.get();
+                case COLOR_ARRAY:    return colors.get();
+                case INDEX_ARRAY:    return indices.get();
+            }
+            return nullptr;
+        }
+
+        static size_t attrib_slot(VertexAttribArrayType type)
+        {
+            switch(type) {
+                case POSITION_ARRAY: return 0;
+                case NORMAL_ARRAY:   return 1;
+                case COLOR_ARRAY:    return 2;
+                case INDEX_ARRAY:    return 3;
+            }
+            throw std::runtime_error("Invalid vertex attrib array type\n");
+        }
+
       public:
         /// @brief Color if(if Mono Color Scheme)
         struct Color
@@ -649,14 +916,8 @@ public:
         std::array<float, 4> material_emission;
         float material_shininess;
 
-        /// @brief Batch Vertex Update
-        struct batch_vertex_update
-        {
-            std::array<float, 3> m_position;
-            uint32_t index;
-        };
-
-        std::deque<batch_vertex_update> batch_vertex_updates;
+        /// @brief Vertices moved through update_vertex since the last upload
+        VertexUpdateJournal vertex_update_journal;
 
         bool is_hover_highlightable;
         bool is_already_hover_highlighted;
@@ -679,13 +940,23 @@ public:
     }; // Struct PrimitiveSetInstance
 
     //+---------------------------------------------------------------------------------------------------------+
-    #define primitive_set_iterator std::unordered_map<std::string, std::shared_ptr<PrimitiveSetInstance>>::iterator
+    #define primitive_set_iterator InternedTable<GeometryDescriptor::PrimitiveSetInstance>::iterator
+    //+---------------------------------------------------------------------------------------------------------+
+    /// @brief Interned ID of a primitive set, resolves without hashing the name
+    /// @note  Stays valid until a primitive set of the descriptor is removed (IDs of later sets shift then)
+    struct PrimitiveSetHandle
+    {
+        uint32_t id         = InternedTable<PrimitiveSetInstance>::INVALID_ID;
+        uint32_t generation = 0;
+    };
     //+---------------------------------------------------------------------------------------------------------+
     /// @brief Member Variables of Geometry Descriptor
     std::shared_ptr<std::vector<float>> positions; /* Common Across all primitives */
-    std::unordered_map<std::string, std::shared_ptr<PrimitiveSetInstance>> primitives;
+    /// @brief Primitive sets in insertion order, the name lookup is a secondary index
+    InternedTable<PrimitiveSetInstance> primitives;
     std::string currentPrimitiveSetInstanceName;
     std::shared_ptr<PrimitiveSetInstance> currentPrimitiveSet;
+    PrimitiveSetHandle currentPrimitiveSetHandle;
     uint32_t id;
     //+---------------------------------------------------------------------------------------------------------+
     uint32_t get_id() const { return id; }
@@ -709,12 +980,15 @@ public:
     virtual ~GeometryDescriptor();
     
     /// @brief Assignment operator
+    /// @note  The copied primitive table has a new generation, handles of src do not validate against this descriptor
     GeometryDescriptor& operator=(const GeometryDescriptor& src) 
     {   
+        if (this == &src) return *this;
         positions = src.positions;    
         primitives = src.primitives;
         currentPrimitiveSetInstanceName = src.currentPrimitiveSetInstanceName;
         currentPrimitiveSet = src.currentPrimitiveSet;
+        currentPrimitiveSetHandle = { primitives.find_id(currentPrimitiveSetInstanceName), primitives.generation() };
         id = src.id;
         
         return *this;
@@ -723,13 +997,11 @@ public:
     /// @brief Copy Constructor
     GeometryDescriptor(const GeometryDescriptor& src) 
     {
-        positions = src.positions;
-        primitives = src.primitives;
-        currentPrimitiveSetInstanceName = src.currentPrimitiveSetInstanceName;
-        currentPrimitiveSet = src.currentPrimitiveSet;
-        id = src.id;
+        *this = src;
     }
 
+    /// @brief Clone the descriptor and all its primitive sets
+    /// @note  Attribute buffers are shared copy-on-write, a clone costs no vertex memory until one side edits it
     __INLINE__ std::shared_ptr<GeometryDescriptor> clone() 
     {
         std::shared_ptr<GeometryDescriptor> clone_instance = std::make_shared<GeometryDescriptor>();
@@ -740,6 +1012,7 @@ public:
         }
         clone.currentPrimitiveSetInstanceName = currentPrimitiveSetInstanceName;
         clone.currentPrimitiveSet = clone.primitives[clone.currentPrimitiveSetInstanceName];
+        clone.currentPrimitiveSetHandle = { clone.primitives.find_id(currentPrimitiveSetInstanceName), clone.primitives.generation() };
         clone.id = id;
 
         return clone_instance;
@@ -774,10 +1047,35 @@ public:
     /// @brief Set the current primitive set
     __INLINE__ void set_current_primitive_set(const std::string& name, GLenum Primitivetype);
 
+    /// @brief Set the current primitive set by handle (no name lookup)
+    /// @throws std::runtime_error if the handle is out of date
+    __INLINE__ void set_current_primitive_set(const PrimitiveSetHandle& handle);
+
     /// @brief get current primitive set name
     /// @return std::string
     __INLINE__ const std::string get_current_primitive_set_name() const { return currentPrimitiveSetInstanceName; }
 
+    /// @brief Get the handle of a primitive set (id is INVALID_ID if there is no set with that name)
+    __INLINE__ PrimitiveSetHandle get_primitive_set_handle(const std::string& name) const
+    {
+        return { primitives.find_id(name), primitives.generation() };
+    }
+
+    /// @brief Get the handle of the current primitive set
+    __INLINE__ PrimitiveSetHandle get_current_primitive_set_handle() const { return currentPrimitiveSetHandle; }
+
+    /// @brief Check if a handle still refers to a primitive set of this descriptor
+    __INLINE__ bool isValidHandle(const PrimitiveSetHandle& handle) const
+    {
+        return handle.generation == primitives.generation() && primitives.contains_id(handle.id);
+    }
+
+    /// @brief Get the name of the primitive set behind a valid handle
+    __INLINE__ const std::string& get_primitive_set_name(const PrimitiveSetHandle& handle) const { return primitives.at_id(handle.id).first; }
+
+    /// @brief get a primitive set by handle (expired weak_ptr if the handle is out of date)
+    __INLINE__ std::weak_ptr<PrimitiveSetInstance> get_primitive_set(const PrimitiveSetHandle& handle);
+
     /// @brief get a primitive set by name
     /// @param name 
     /// @return std::weak_ptr<PrimitiveSetInstance>. call lock() to get a shared_ptr
@@ -835,6 +1133,10 @@ public:
   Functions for adding vertex attributes data
   @note
   These functions are used to add vertex attributes data to the current primitive set
+  @note
+  The position, normal and color functions write the separate arrays and throw std::runtime_error on an interleaved (or
+  adopted) primitive set : its vertices live in the vertex layout, append them with push_interleaved_vertices and write
+  them with update_pos_array / update_normal_array / update_color_array
 */
 
     /// @brief Push a position vector (x, y, z) to the current primitive set
@@ -876,6 +1178,55 @@ public:
     /// @brief Copy a Index array to the current primitive set (replaces the current array)
     __INLINE__ void copy_index_array(const std::vector<uint32_t>& index_array);
 
+    /// @brief Overwrite positions in place starting at first_vertex (only the changed bytes are re-uploaded)
+    /// @throws std::runtime_error if the array runs past the stored positions
+    __INLINE__ void update_pos_array(const uint32_t& first_vertex, const std::vector<float>& position_array);
+
+    /// @brief Overwrite normals in place starting at first_vertex (only the changed bytes are re-uploaded)
+    __INLINE__ void update_normal_array(const uint32_t& first_vertex, const std::vector<float>& normal_array);
+
+    /// @brief Overwrite colors in place starting at first_vertex (only the changed bytes are re-uploaded)
+    /// @note  color_array uses the color format of the primitive set (3 or 4 components per vertex)
+    __INLINE__ void update_color_array(const uint32_t& first_vertex, const std::vector<uint8_t>& color_array);
+
+    /// @brief Overwrite indices in place starting at first_index (only the changed bytes are re-uploaded)
+    __INLINE__ void update_index_array(const uint32_t& first_index, const std::vector<uint32_t>& index_array);
+
+    /// @brief Give the current primitive set a private copy of a copy-on-write attribute buffer
+    /// @note  Primitive sets of this descriptor sharing the buffer move to the copy together, so only clones and
+    /// other descriptors are cut off. Called by every mutator of this class before it writes
+    __INLINE__ void detach_attrib_array(PrimitiveSetInstance::VertexAttribArrayType type);
+
+    /// @brief Same as detach_attrib_array(type) for any primitive set of this descriptor
+    __INLINE__ void detach_attrib_array(const std::shared_ptr<PrimitiveSetInstance>& primitiveSet, PrimitiveSetInstance::VertexAttribArrayType type);
+
+    /// @brief Throw if the current primitive set is interleaved, the drivers would never read a separate position, normal or color array of it
+    /// @param caller  name of the writing function, for the message
+    __INLINE__ void require_separate_attrib_storage(const char* caller) const;
+
+    /// @brief Writable position of a vertex of the current primitive set, nullptr if out of range
+    /// @note  Detaches the positions once for every primitive set sharing them, so they all keep seeing the same vertices
+    __INLINE__ float* get_vertex_write_ref(const uint32_t& index);
+
+    /// @brief Get the positions of the current primitive set ready for an in place bulk write (detached, with stride)
+    __INLINE__ float* begin_position_write(size_t& stride_bytes);
+
+    /// @brief Record vertices [first_vertex, end_vertex) as moved on every primitive set sharing the current positions
+    __INLINE__ void end_position_write(const size_t& first_vertex, const size_t& end_vertex);
+
+    /// @brief Get the instances of the current primitive set for writing (created if absent, detached if shared)
+    __INLINE__ InstanceArray& instances_for_write();
+
+    /// @brief Get the per primitive colors of the current primitive set for writing (created if absent, detached if shared)
+    __INLINE__ PrimitiveColorArray& primitive_colors_for_write();
+
+    /// @brief Get the strips of the current primitive set for writing (created if absent, detached if shared)
+    __INLINE__ StripArray& strips_for_write();
+
+    /// @brief Collect the primitive sets drawing from the vertices of the current primitive set (itself included)
+    /// @return false if one of them is neither indexed nor a point set, its draw order then depends on the vertex order
+    __INLINE__ bool collect_vertex_sharing_sets(std::vector<std::shared_ptr<PrimitiveSetInstance>>& group) const;
+
     /// @brief Move a position array to the current primitive set (replaces the current array)
     __INLINE__ void move_pos_array(std::vector<float>&& position_array);
 
@@ -919,6 +1270,7 @@ public:
     /// @brief Share Positions Array by accepting a shared pointer to the positions array
     /// @param std::shared_ptr<std::vector<float>> in_position
     /// @note  This is useful when you want to share the same positions array between multiple descriptors
+    /// @throws std::runtime_error if the current primitive set is interleaved or adopted
     __INLINE__ void share_positions_shared_ptr(std::shared_ptr<std::vector<float>> &in_position);
 
     /// @brief Share Normals Array by accepting a shared pointer to the normals array
@@ -936,6 +1288,172 @@ public:
     /// @note  This is useful when you want to share the same indices array between multiple descriptors
     __INLINE__ void share_indices_shared_ptr(std::shared_ptr<std::vector<uint32_t>> &in_indices);
 
+    /// @brief    Switch the current primitive set to interleaved storage with a compile time layout
+    /// @note  Existing separate arrays are packed once here, so the render kernels never repack at upload time
+    /// @note  Usage : descriptor->set_interleaved_layout<VertexLayout<Pos3f, Normal3f, Color4ub>>();
+    template<typename Layout>
+    void set_interleaved_layout()
+    {
+        currentPrimitiveSet->interleave_vertex_attributes(Layout::info());
+    }
+
+    /// @brief    Push one interleaved vertex to the current primitive set
+    /// @note  The first push on an empty primitive set enables interleaved storage with the given layout
+    /// @throws std::runtime_error if the primitive set already uses a different layout
+    template<typename Layout>
+    void push_vertex(const typename Layout::Vertex& vertex)
+    {
+        push_interleaved_vertices(Layout::info(), &vertex, 1);
+    }
+
+    /// @brief    Copy an interleaved vertex array to the current primitive set (replaces the current vertices)
+    template<typename Layout>
+    void copy_interleaved_array(const std::vector<typename Layout::Vertex>& vertices)
+    {
+        auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::POSITION_ARRAY));
+        primitiveSet->interleaved_vertices = std::make_shared<InterleavedVertexArray>(Layout::info());
+        primitiveSet->interleaved_vertices->append(vertices.data(), vertices.size());
+        primitiveSet->positions = std::make_shared<std::vector<float>>(0);
+        primitiveSet->invalidate_bounding_box();
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS | PrimitiveSetInstance::DIRTY_NORMALS | PrimitiveSetInstance::DIRTY_COLORS);
+    }
+
+    /// @brief    Append raw interleaved vertices matching a layout to the current primitive set
+    __INLINE__ void push_interleaved_vertices(const VertexLayoutInfo& layout, const void* vertices, const size_t& num_vertices);
+
+    /// @brief    Let the current primitive set use externally owned interleaved vertices in place (no copy)
+    /// @param layout   layout of the external vertices (positions must be Pos3f)
+    /// @param release  called with the pointer once neither the primitive set nor a clone references the memory
+    /// @note  The set becomes interleaved. Render kernels, picking and get_vertex_ref work on the external memory directly.
+    /// Writes go to the external memory, pushing more vertices copies them into owned storage first
+    /// @note  All attributes then come from the adopted block : the separate position / normal / color functions refuse the set,
+    /// append with push_interleaved_vertices and write in place with update_pos_array / update_normal_array / update_color_array
+    /// @throws std::runtime_error if the set holds separate normals or colors the layout does not carry (clear them first)
+    __INLINE__ void adopt_interleaved_vertices(const VertexLayoutInfo& layout, void* vertices, const size_t& num_vertices, InterleavedVertexArray::ReleaseCallback release);
+
+    /// @brief    Same as above, the memory is kept alive by an owner handle instead of a release callback
+    __INLINE__ void adopt_interleaved_vertices(const VertexLayoutInfo& layout, void* vertices, const size_t& num_vertices, std::shared_ptr<const void> owner);
+
+    /// @brief    Let the current primitive set use an external xyz float array as its positions (no copy)
+    /// @param num_floats  number of floats in the array (3 per position)
+    /// @note  The layout is positions only : the set can have no normals or colors, and push_pos3f / move_pos_array refuse it
+    __INLINE__ void adopt_pos_array(float* position_array, const size_t& num_floats, InterleavedVertexArray::ReleaseCallback release);
+
+    /// @brief    Same as above, the memory is kept alive by an owner handle instead of a release callback
+    __INLINE__ void adopt_pos_array(float* position_array, const size_t& num_floats, std::shared_ptr<const void> owner);
+
+    /// @brief    Drop the cached bounding box of every primitive set sharing the current position array
+    __INLINE__ void invalidate_bounding_box();
+
+    /// @brief    Build a chain of simplified levels of detail for the current GL_TRIANGLES primitive set
+    /// @note  Quadric error simplification. Levels only hold indices into the existing vertex array, so they cost
+    /// no extra vertex memory. Call before commit_geometry, the render kernels switch levels by projected screen size
+    /// @throws std::runtime_error if the current primitive set is not GL_TRIANGLES
+    __INLINE__ void build_lod_chain(const SimplificationOptions& options = SimplificationOptions());
+
+    /// @brief    Drop the levels of detail of the current primitive set
+    __INLINE__ void clear_lod_chain();
+
+    /// @brief    Triangulate the current GL_QUADS, GL_QUAD_STRIP or GL_POLYGON primitive set
+    /// @note  Keeps the primitive type and primitive IDs : the triangles carry the ID of the primitive they were cut
+    /// from, so picking by primitive still reports quad IDs. The OpenGL 3.3 driver triangulates on demand, calling
+    /// this ahead of commit_geometry keeps the work off the render thread
+    /// @throws std::runtime_error if the current primitive set is not a quad, quad strip or polygon set
+    __INLINE__ void triangulate_primitive_set();
+
+    /// @brief    Reorder the current indexed GL_TRIANGLES primitive set for the GPU vertex cache and less overdraw
+    /// @param reorder_vertices  also sort the vertices by first use (positions, normals and colors move together)
+    /// @note  Triangles are reordered with Tipsify, then clusters are sorted so outward facing ones draw first.
+    /// Vertices are only moved if every primitive set sharing them is indexed (their indices are remapped too) or
+    /// is a non indexed point set. Vertex IDs change, so run it before handing out vertex picks or vertex refs
+    /// @return old vertex index -> new vertex index, empty if the vertices kept their order
+    /// @throws std::runtime_error if the current primitive set is not an indexed GL_TRIANGLES set
+    __INLINE__ std::vector<uint32_t> optimize_vertex_order(const bool& reorder_vertices = true);
+
+    /// @brief    Weld coincident vertices of the current primitive set and drop degenerate and repeated primitives
+    /// @param tolerance           vertices closer than this merge (0 merges identical positions only)
+    /// @param compare_attributes  only merge vertices with identical normals and colors (keeps shading seams)
+    /// @note  Parallel spatial hash. A non indexed set becomes indexed, unreferenced vertices are compacted away.
+    /// Primitive sets sharing the vertices follow (see optimize_vertex_order), otherwise the current set gets
+    /// private arrays. Vertex counts change, so call it before commit_geometry
+    __INLINE__ MeshOptimizer::CleanupStatistics weld_vertices(const float& tolerance = 0.0f, const bool& compare_attributes = true);
+
+    /// @brief    Refine the current GL_TRIANGLES primitive set by edge midpoint subdivision, in parallel
+    /// @param options    uniform levels, or adaptive by edge length and normal angle (see TessellationOptions)
+    /// @param triangles  triangles to refine, empty for all. Neighbours are split as needed to stay crack free
+    /// @note  The output is indexed and watertight : midpoints are shared between the triangles of an edge. They are
+    /// appended after the existing vertices (normals renormalized, colors averaged), so vertex IDs and the indices of
+    /// other sets sharing the vertices stay valid. A non indexed set becomes indexed. Call it before commit_geometry
+    /// @return output triangle -> triangle it was cut from, empty if the set has no triangles
+    /// @throws std::runtime_error if the current primitive set is not GL_TRIANGLES, is interleaved, or a triangle is out of range
+    __INLINE__ std::vector<uint32_t> tessellate_primitive_set(const TessellationOptions& options = TessellationOptions(),
+                                                              const std::vector<uint32_t>& triangles = std::vector<uint32_t>());
+
+    /// @brief    Make the current primitive set draw the current primitive set of another descriptor once per instance
+    /// @note  Meant for the output of gp_primitives (sphere, cone, cuboid ...). The vertex and index arrays are shared
+    /// copy-on-write, so a thousand markers cost one prototype and a thousand transforms, in one draw call on 3.3
+    /// @throws std::runtime_error if the prototype has no vertices or another primitive type
+    __INLINE__ void set_instance_prototype(const GeometryDescriptor& prototype);
+
+    /// @brief    Append an instance of the current primitive set, drawn with the set color
+    /// @param matrix  column major 4x4 (glm::mat4 memory layout), the last row is ignored
+    /// @note  The first instance turns the set into a prototype instancing set
+    __INLINE__ void push_instance(const std::array<float, 16>& matrix);
+
+    /// @brief    Append an instance of the current primitive set with its own RGBA color
+    /// @note  Either every instance of a set has a color or none has
+    __INLINE__ void push_instance(const std::array<float, 16>& matrix, const std::array<uint8_t, 4>& color);
+
+    /// @brief    Replace the instances of the current primitive set
+    /// @param transforms  12 floats per instance : xyz of the 4 columns of an affine matrix
+    /// @param colors      4 bytes RGBA per instance, or empty to use the set color
+    __INLINE__ void move_instance_arrays(std::vector<float>&& transforms, std::vector<uint8_t>&& colors = std::vector<uint8_t>());
+
+    __INLINE__ void update_instance_transform(const size_t& instance, const std::array<float, 16>& matrix);
+    __INLINE__ void update_instance_color(const size_t& instance, const std::array<uint8_t, 4>& color);
+    __INLINE__ void reserve_instances(const size_t& num_instances);
+
+    /// @brief    Remove every instance (the set stays instanced and draws nothing)
+    __INLINE__ void clear_instances();
+
+    /// @brief    Give every primitive of the current primitive set its own color and switch it to ColorScheme::PER_PRIMITIVE
+    /// @param colors  4 bytes RGBA per primitive, in pick ID order (see gp_gui_primitive_color_array.h)
+    /// @note  One color per cell instead of one per vertex, and indexed sets stay indexed. Vertex colors are kept but
+    /// not drawn while the set is PER_PRIMITIVE
+    __INLINE__ void move_primitive_color_array(std::vector<uint8_t>&& colors);
+
+    __INLINE__ void update_primitive_color(const size_t& primitive, const std::array<uint8_t, 4>& color);
+
+    /// @brief    Remove the per primitive colors, a PER_PRIMITIVE set goes back to the set color
+    __INLINE__ void clear_primitive_colors();
+
+    /// @brief    Append a strip to the current non indexed line strip, line loop, triangle strip or fan set
+    /// @param positions  xyz per vertex of the strip, appended to the positions of the set
+    /// @note  Thousands of strips in one set draw with a single call and are still picked one by one : strip i is
+    /// primitive i of PICK_BY_PRIMITIVE. Normals and colors, if any, are pushed alongside as usual
+    /// @throws std::runtime_error if the set is indexed, interleaved or not a strip type
+    __INLINE__ void push_strip(const std::vector<float>& positions);
+
+    /// @brief    Append a strip to the current indexed line strip, line loop, triangle strip or fan set
+    /// @param strip_indices  vertex IDs of the strip, appended to the indices of the set
+    /// @throws std::runtime_error if the set already has vertices outside its strips or is not a strip type
+    __INLINE__ void push_strip_indices(const std::vector<uint32_t>& strip_indices);
+
+    /// @brief    Split the vertices of the current strip set into strips
+    /// @param strip_offsets  number of strips + 1 entries : strip i is the vertices [strip_offsets[i], strip_offsets[i + 1])
+    /// (indices of an indexed set, positions otherwise), starting with 0 and ending with the vertex count
+    /// @throws std::runtime_error if the offsets do not cover the vertices of the set or it is not a strip type
+    __INLINE__ void move_strip_offsets(std::vector<uint32_t>&& strip_offsets);
+
+    /// @brief    Remove the strip boundaries, the set draws as one strip again
+    __INLINE__ void clear_strips();
+
+    /// @brief    Enable the compressed GPU vertex format for the current primitive set
+    /// @note  Cuts the VBO size by 2-3x. Positions are quantized to 16 bits inside the primitive set's bounding box
+    /// @param bool flag
+    __INLINE__ void set_vertex_compression(const bool& flag);
+
     /// @brief    Set the Bounding Box of the current primitive set
     /// @param std::array<float, 6> bounding_box
     __INLINE__ void set_bounding_box(const std::array<float, 6>& bounding_box);
@@ -1030,6 +1548,29 @@ public:
     /// @param uint32_t index
     __INLINE__ void translate_vertex(const std::array<float, 3>& translation_vector, const uint32_t& index);
 
+    /// @brief Translate a selection of vertices of the current primitive set
+    /// @note  Repeated indices move once. SIMD and multithreaded, the move is recorded as one dirty range
+    /// (lowest to highest selected vertex) on every primitive set sharing the positions
+    /// @throws std::runtime_error if an index is out of range
+    __INLINE__ void translate_vertices(const std::array<float, 3>& translation_vector, const std::vector<uint32_t>& vertex_indices);
+
+    /// @brief Translate the vertices [first_vertex, first_vertex + num_vertices) of the current primitive set
+    __INLINE__ void translate_vertices(const std::array<float, 3>& translation_vector, const size_t& first_vertex, const size_t& num_vertices);
+
+    /// @brief Apply an affine matrix to a selection of vertices of the current primitive set
+    /// @param matrix  column major 4x4 (glm::mat4 memory layout, e.g. copied from glm::value_ptr), the last row is ignored
+    __INLINE__ void transform_vertices(const std::array<float, 16>& matrix, const std::vector<uint32_t>& vertex_indices);
+
+    /// @brief Apply an affine matrix to the vertices [first_vertex, first_vertex + num_vertices) of the current primitive set
+    __INLINE__ void transform_vertices(const std::array<float, 16>& matrix, const size_t& first_vertex, const size_t& num_vertices);
+
+    /// @brief Add a displacement (3 floats per vertex, in the order of vertex_indices) to a selection of vertices
+    /// @note  A repeated index gets the sum of its displacements
+    __INLINE__ void displace_vertices(const std::vector<float>& displacements, const std::vector<uint32_t>& vertex_indices);
+
+    /// @brief Add a displacement field to the vertices [first_vertex, first_vertex + displacements.size() / 3)
+    __INLINE__ void displace_vertices(const std::vector<float>& displacements, const size_t& first_vertex);
+
     /// @brief check if the Node Manipulation is enabled
     /// @return bool
     __INLINE__ bool isNodeManipulationEnabled() const;
@@ -1052,6 +1593,9 @@ public:
     /// @param flag 
     __INLINE__ void clearDirtyFlags(const std::string& name, PrimitiveSetInstance::DirtyFlags flag);
 
+    /// @brief  Clear dirty flags for the primitive set behind a handle
+    __INLINE__ void clearDirtyFlags(const PrimitiveSetHandle& handle);
+
     /// @brief  check if the current PrimitiveSet is drawable.
     /// @return bool
     __INLINE__ bool isDrawable() const;
@@ -1072,6 +1616,10 @@ public:
     /// @return std::array<float, 6>
     __INLINE__ std::array<float, 6> get_bounding_box() const;
 
+    /// @brief Get the union of the Bounding Boxes of all drawable primitive sets
+    /// @return std::array<float, 6>
+    __INLINE__ std::array<float, 6> get_total_bounding_box() const;
+
 };
 }
 
@@ -0,0 +1,156 @@
+#ifndef _GP_GUI_GEOMETRY_FILE_H_
+#define _GP_GUI_GEOMETRY_FILE_H_
+
+/// @file    gp_gui_geometry_file.h
+/// @brief   Versioned binary container of a GeometryDescriptor, laid out to be memory mapped
+/// @note    Layout : FileHeader, the table of SetRecords, then the array blocks. Every block starts on BLOCK_ALIGNMENT
+/// and holds the arrays exactly as the descriptor stores them (xyz floats, interleaved vertices, uint32 indices), so
+/// a mapped file is used as the vertex arrays in place. Arrays shared between primitive sets are written once.
+/// Files are native endian, readers reject a file written with the other byte order.
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <memory>
+
+#include "gp_gui_vertex_layout.h"
+#include "../Viewers/export.h"
+
+namespace GridPro_GFX {
+
+    class GeometryDescriptor;
+
+namespace GeometryFile {
+
+    /// @brief First 8 bytes of every file
+    constexpr char     MAGIC[8]        = {'G', 'P', 'G', 'E', 'O', 'M', '\0', '\0'};
+
+    /// @brief Incremented on every layout change, readers reject other versions (the source file is parsed again)
+    constexpr uint32_t FORMAT_VERSION  = 2;
+
+    /// @brief Written as is, reads back byte swapped on a machine of the other endianness
+    constexpr uint32_t ENDIAN_TAG      = 0x01020304;
+
+    /// @brief Alignment of every array block (cache line, enough for SSE loads and GL client arrays)
+    constexpr size_t   BLOCK_ALIGNMENT = 64;
+
+    /// @brief shared_from value of an array block owned by its primitive set
+    constexpr uint32_t NOT_SHARED      = 0xFFFFFFFF;
+
+    /// @brief Extension of the files written by the TestApp cache
+    constexpr const char* FILE_EXTENSION = ".gpgeom";
+
+    struct FileHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t endian_tag;
+        uint32_t header_size;           ///< sizeof(FileHeader) of the writer
+        uint32_t set_record_size;       ///< sizeof(SetRecord) of the writer
+        uint32_t num_sets;
+        uint32_t reserved;
+        uint64_t set_table_offset;
+        uint64_t file_size;
+        float    bounding_box[6];       ///< of the whole descriptor
+    };
+
+    /// @brief One array of a primitive set
+    struct ArrayBlock
+    {
+        uint64_t offset;                ///< from the start of the file, 0 if the array is empty
+        uint64_t size_bytes;
+        uint32_t shared_from;           ///< earlier primitive set this array is shared with, or NOT_SHARED
+        uint32_t reserved;
+    };
+
+    struct AttribRecord
+    {
+        uint32_t semantic;
+        uint32_t components;
+        uint32_t gl_type;
+        uint32_t normalized;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /// @brief Flags of SetRecord::flags
+    enum SetFlags : uint32_t
+    {
+        SET_HOVER_HIGHLIGHTABLE     = 1u << 0,
+        SET_SELECTION_HIGHLIGHTABLE = 1u << 1,
+        SET_CUSTOM_HIGHLIGHT_COLOR  = 1u << 2,
+        SET_VERTEX_COMPRESSION      = 1u << 3
+    };
+
+    struct SetRecord
+    {
+        uint64_t name_offset;
+        uint32_t name_size;
+        uint32_t primitive_type;
+
+        uint32_t color_format;
+        uint32_t color_scheme;
+        uint32_t shading_model;
+        uint32_t wireframe_mode;
+        uint32_t blend_func;
+        uint32_t pick_scheme;
+        uint32_t flags;
+        float    line_width;
+        float    point_size;
+
+        uint8_t  fill_color[4];
+        uint8_t  wireframe_color[4];
+        uint8_t  highlight_color[4];
+        uint8_t  selection_color[4];
+        uint8_t  custom_highlight_color[4];
+
+        float    material_ambient[4];
+        float    material_diffuse[4];
+        float    material_specular[4];
+        float    material_emission[4];
+        float    material_shininess;
+
+        float    bounding_box[6];
+
+        /// @brief Interleaved vertex layout, vertex_stride is 0 when vertices holds plain xyz positions
+        uint32_t     vertex_stride;
+        uint32_t     num_attribs;
+        AttribRecord attribs[ATTRIB_MAX];
+
+        ArrayBlock   vertices;
+        ArrayBlock   normals;
+        ArrayBlock   colors;
+        ArrayBlock   indices;
+        ArrayBlock   instance_transforms;
+        ArrayBlock   instance_colors;
+        ArrayBlock   strip_offsets;
+    };
+
+    /// @brief How read() gets the arrays into memory
+    enum class ReadMode
+    {
+        MAP,    ///< vertices stay in the mapping, private copy-on-write pages (edits never reach the file)
+        COPY    ///< every array is copied, the file is closed when read() returns
+    };
+
+    /// @brief Write every primitive set of a descriptor : arrays, render and pick state, materials, bounding boxes
+    /// @note  Levels of detail and triangulations are not stored, they are rebuilt from the arrays
+    /// @throws std::runtime_error if the file cannot be written
+    LIB_API void write(const GeometryDescriptor& descriptor, const std::string& path);
+
+    /// @brief Build a descriptor from a file written by write()
+    /// @note  MAP adopts the vertices (positions or interleaved vertices) of every set in place, the mapping lives
+    /// until the last primitive set using it is gone. Normals, colors and indices are copied into the descriptor.
+    /// Adopted vertices make a set interleaved, which takes no separate normals or colors : sets having some (and the
+    /// sets they share their vertices with) get copied vertices instead
+    /// @throws std::runtime_error if the file is missing, truncated, of another version or another byte order
+    LIB_API std::shared_ptr<GeometryDescriptor> read(const std::string& path, const ReadMode& mode = ReadMode::MAP);
+
+    /// @brief Check the header of a file without reading it (false for missing files, other versions, other byte orders)
+    LIB_API bool is_readable(const std::string& path);
+
+} // namespace GeometryFile
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_GEOMETRY_FILE_H_
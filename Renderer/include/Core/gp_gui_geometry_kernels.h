@@ -0,0 +1,100 @@
+#ifndef _GP_GUI_GEOMETRY_KERNELS_H_
+#define _GP_GUI_GEOMETRY_KERNELS_H_
+
+/// @file    gp_gui_geometry_kernels.h
+/// @brief   Per vertex loops of the descriptor and the drivers, specialized on the primitive type and index width
+/// @note    Pick the specialization once with dispatch_primitive_type() / dispatch_index_type() (see
+/// gp_gui_primitive_traits.h), the loops themselves carry no switch and split over the workers of gp_gui_parallel.h.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "gp_gui_primitive_traits.h"
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+namespace GeometryKernels {
+
+    /// @brief Copy the xyz floats of the indexed vertices back to back (de-indexing)
+    /// @param base          first vertex, each vertex starts with 3 floats
+    /// @param stride_bytes  distance between vertices (12 for plain xyz arrays, the layout stride of interleaved ones)
+    template<typename IndexT>
+    void gather_vec3(const uint8_t* base, const size_t& stride_bytes, const IndexT* indices, const size_t& count, float* out)
+    {
+        Parallel::parallel_for(0, count, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t i = begin; i < end; ++i)
+                std::memcpy(out + i * 3, base + size_t(indices[i]) * stride_bytes, 3 * sizeof(float));
+        });
+    }
+
+    /// @brief Copy the xyz floats of count consecutive vertices back to back (strided to packed)
+    inline void copy_vec3(const uint8_t* base, const size_t& stride_bytes, const size_t& count, float* out)
+    {
+        if(stride_bytes == 3 * sizeof(float))
+        {
+            std::memcpy(out, base, count * 3 * sizeof(float));
+            return;
+        }
+
+        Parallel::parallel_for(0, count, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t i = begin; i < end; ++i)
+                std::memcpy(out + i * 3, base + i * stride_bytes, 3 * sizeof(float));
+        });
+    }
+
+    /// @brief Pick color (RGB bytes of the pick ID, as PixelData lays them out) of one pick entity
+    inline void write_pick_color(const uint32_t& pick_id, uint8_t* rgb)
+    {
+        uint8_t rgba[4];
+        std::memcpy(rgba, &pick_id, sizeof(rgba));
+        rgb[0] = rgba[0];
+        rgb[1] = rgba[1];
+        rgb[2] = rgba[2];
+    }
+
+    /// @brief Give every vertex the pick color of the primitive it provokes, for a flat shaded pick pass
+    /// @param first_id      pick ID of primitive 0
+    /// @param num_vertices  vertices of the unshared (de-indexed) vertex sequence
+    /// @param rgb           3 bytes per vertex
+    /// @note  Vertices provoking no primitive (the first vertices of a strip) take the color of the first one, the
+    /// primitive IDs are clamped to the last primitive so a trailing partial primitive stays in the reservation
+    template<typename Traits>
+    void fill_pick_colors(const uint32_t& first_id, const size_t& num_vertices, uint8_t* rgb)
+    {
+        const size_t num_primitives = Traits::num_primitives(num_vertices);
+        if(num_primitives == 0) return;
+        const size_t last_primitive = num_primitives - 1;
+
+        Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; ++v)
+                write_pick_color(first_id + static_cast<uint32_t>(std::min(Traits::provoked_primitive(v, num_vertices), last_primitive)), rgb + v * 3);
+        });
+    }
+
+    /// @brief Give every vertex the RGBA color of the primitive it provokes
+    /// @param colors      4 bytes per primitive, num_colors of them
+    /// @param rgba        4 bytes per vertex
+    template<typename Traits>
+    void expand_primitive_colors(const uint8_t* colors, const size_t& num_colors, const size_t& num_vertices, uint8_t* rgba)
+    {
+        if(num_colors == 0) return;
+        const size_t last_color = num_colors - 1;
+
+        Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; ++v)
+                std::memcpy(rgba + v * 4, colors + std::min(Traits::provoked_primitive(v, num_vertices), last_color) * 4, 4);
+        });
+    }
+
+} // namespace GeometryKernels
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_GEOMETRY_KERNELS_H_
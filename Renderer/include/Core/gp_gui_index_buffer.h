@@ -0,0 +1,117 @@
+#ifndef _GP_GUI_INDEX_BUFFER_H_
+#define _GP_GUI_INDEX_BUFFER_H_
+
+/// @file    gp_gui_index_buffer.h
+/// @brief   Index width selection : sets addressing fewer than 65536 vertices are drawn with 16 bit indices
+/// @note    Primitive sets keep their indices as uint32_t (the editing format of the whole API). The narrowed copy is
+/// what goes to the index buffers and the client side draw calls, together with the GL type to draw it with.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "gp_gui_typedefs.h"
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+    /// @brief Vertex arrays smaller than this are addressed with GL_UNSIGNED_SHORT indices
+    constexpr size_t COMPACT_INDEX_VERTEX_LIMIT = 65536;
+
+    /// @brief Narrowest index type able to address num_vertices vertices
+    inline GLenum select_index_type(const size_t& num_vertices)
+    {
+        return num_vertices < COMPACT_INDEX_VERTEX_LIMIT ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    /// @brief Size in bytes of one index of a GL index type
+    inline size_t index_type_size(const GLenum& index_type)
+    {
+        return index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    /// @brief Strip separator of restart index lists, kept as uint32_t like every other index
+    /// @note  Narrowing it to 16 bits gives 0xFFFF, the restart index of GL_UNSIGNED_SHORT lists
+    constexpr uint32_t PRIMITIVE_RESTART_INDEX = 0xFFFFFFFF;
+
+    /// @brief Restart index to pass to glPrimitiveRestartIndex for lists of index_type
+    /// @note  It is the largest value of the type, never a vertex : 16 bit lists address fewer than 65536 vertices
+    /// (IDs up to 0xFFFE, see COMPACT_INDEX_VERTEX_LIMIT), so 0xFFFF is free
+    inline uint32_t primitive_restart_index(const GLenum& index_type)
+    {
+        return index_type == GL_UNSIGNED_SHORT ? 0xFFFFu : PRIMITIVE_RESTART_INDEX;
+    }
+
+    /// @brief Indices in the narrowest type the vertex count allows
+    /// @note  32 bit indices are not copied : data() points back to the source, which must outlive the use of data()
+    class CompactIndexArray
+    {
+        public :
+        /// @brief Encode count indices addressing a vertex array of num_vertices vertices
+        void assign(const uint32_t* indices, const size_t& count, const size_t& num_vertices)
+        {
+            m_type  = select_index_type(num_vertices);
+            m_count = count;
+            m_wide  = indices;
+
+            if(m_type == GL_UNSIGNED_INT)
+            {
+                m_narrow.clear();
+                m_narrow.shrink_to_fit();
+                return;
+            }
+
+            m_narrow.resize(count);
+            update(indices, 0, count);
+        }
+
+        void assign(const std::vector<uint32_t>& indices, const size_t& num_vertices)
+        {
+            assign(indices.data(), indices.size(), num_vertices);
+        }
+
+        /// @brief Re-encode the indices [first, end) after an in place edit of the source (same count and vertex range)
+        void update(const uint32_t* indices, const size_t& first, const size_t& end)
+        {
+            m_wide = indices;
+            if(m_type == GL_UNSIGNED_INT) return;
+
+            uint16_t* narrow = m_narrow.data();
+            Parallel::parallel_for(first, end < m_count ? end : m_count, [&](size_t begin, size_t chunk_end, uint32_t)
+            {
+                for(size_t i = begin; i < chunk_end; ++i)
+                    narrow[i] = static_cast<uint16_t>(indices[i]);
+            });
+        }
+
+        void clear()
+        {
+            m_type  = GL_UNSIGNED_INT;
+            m_count = 0;
+            m_wide  = nullptr;
+            m_narrow.clear();
+        }
+
+        bool isCompact() const                  { return m_type == GL_UNSIGNED_SHORT; }
+        bool empty() const                      { return m_count == 0; }
+
+        /// @brief GL type to pass to glDrawElements
+        GLenum type() const                     { return m_type; }
+        size_t size() const                     { return m_count; }
+        size_t index_size() const               { return index_type_size(m_type); }
+        size_t size_bytes() const               { return m_count * index_size(); }
+
+        const void* data() const
+        {
+            return isCompact() ? static_cast<const void*>(m_narrow.data()) : static_cast<const void*>(m_wide);
+        }
+
+        private :
+        GLenum                m_type  = GL_UNSIGNED_INT;
+        size_t                m_count = 0;
+        const uint32_t*       m_wide  = nullptr;
+        std::vector<uint16_t> m_narrow;
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_INDEX_BUFFER_H_
@@ -0,0 +1,184 @@
+#ifndef _GP_GUI_INSTANCE_ARRAY_H_
+#define _GP_GUI_INSTANCE_ARRAY_H_
+
+/// @file    gp_gui_instance_array.h
+/// @brief   Per instance transforms and colors of a prototype instancing primitive set
+/// @note    The prototype is the vertex / index data of the primitive set itself, it is drawn once per instance.
+/// A transform is stored as the xyz of the 4 columns of an affine matrix (12 floats, the implicit last row is
+/// 0 0 0 1), a color as 4 bytes RGBA. Colors are optional : without them every instance uses the set color.
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+    class InstanceArray
+    {
+        public :
+        /// @brief Floats per instance transform (4 columns x xyz)
+        static constexpr size_t TRANSFORM_COMPONENTS = 12;
+
+        /// @brief Bytes per instance color (RGBA)
+        static constexpr size_t COLOR_COMPONENTS = 4;
+
+        size_t size() const                     { return m_transforms.size() / TRANSFORM_COMPONENTS; }
+        bool empty() const                      { return m_transforms.empty(); }
+        bool hasColors() const                  { return !m_colors.empty(); }
+
+        /// @brief Incremented by every edit, drivers compare it to know when to upload again
+        uint32_t version() const                { return m_version; }
+
+        void reserve(const size_t& num_instances)
+        {
+            m_transforms.reserve(num_instances * TRANSFORM_COMPONENTS);
+            if(hasColors()) m_colors.reserve(num_instances * COLOR_COMPONENTS);
+        }
+
+        void clear()
+        {
+            m_transforms.clear();
+            m_colors.clear();
+            ++m_version;
+        }
+
+        /// @brief Append an instance drawn with the set color
+        /// @param matrix  column major 4x4 (glm::mat4 memory layout), the last row is ignored
+        /// @throws std::runtime_error if the other instances have their own color
+        void push_instance(const std::array<float, 16>& matrix)
+        {
+            if(hasColors())
+                throw std::runtime_error("InstanceArray::push_instance : the instances of this set have colors, pass one");
+            append_transform(matrix);
+            ++m_version;
+        }
+
+        /// @brief Append an instance with its own color
+        /// @throws std::runtime_error if instances without color were pushed before
+        void push_instance(const std::array<float, 16>& matrix, const std::array<uint8_t, 4>& color)
+        {
+            if(!empty() && !hasColors())
+                throw std::runtime_error("InstanceArray::push_instance : the instances of this set use the set color");
+            append_transform(matrix);
+            m_colors.insert(m_colors.end(), color.begin(), color.end());
+            ++m_version;
+        }
+
+        /// @brief Replace every instance at once
+        /// @param transforms  TRANSFORM_COMPONENTS floats per instance
+        /// @param colors      COLOR_COMPONENTS bytes per instance, or empty
+        void assign(std::vector<float>&& transforms, std::vector<uint8_t>&& colors)
+        {
+            if(transforms.size() % TRANSFORM_COMPONENTS != 0)
+                throw std::runtime_error("InstanceArray::assign : transform array size is not a multiple of 12");
+            if(!colors.empty() && colors.size() / COLOR_COMPONENTS != transforms.size() / TRANSFORM_COMPONENTS)
+                throw std::runtime_error("InstanceArray::assign : expected one RGBA color per instance");
+
+            m_transforms = std::move(transforms);
+            m_colors = std::move(colors);
+            ++m_version;
+        }
+
+        void set_transform(const size_t& instance, const std::array<float, 16>& matrix)
+        {
+            float* transform = &m_transforms.at(instance * TRANSFORM_COMPONENTS);
+            for(size_t column = 0; column < 4; ++column)
+                for(size_t row = 0; row < 3; ++row)
+                    transform[column * 3 + row] = matrix[column * 4 + row];
+            ++m_version;
+        }
+
+        void set_color(const size_t& instance, const std::array<uint8_t, 4>& color)
+        {
+            if(!hasColors())
+                throw std::runtime_error("InstanceArray::set_color : the instances of this set use the set color");
+            std::copy(color.begin(), color.end(), m_colors.begin() + instance * COLOR_COMPONENTS);
+            ++m_version;
+        }
+
+        /// @brief Transform of an instance expanded back to a column major 4x4 matrix
+        std::array<float, 16> get_matrix(const size_t& instance) const
+        {
+            const float* transform = &m_transforms[instance * TRANSFORM_COMPONENTS];
+            return { transform[0], transform[1],  transform[2],  0.0f,
+                     transform[3], transform[4],  transform[5],  0.0f,
+                     transform[6], transform[7],  transform[8],  0.0f,
+                     transform[9], transform[10], transform[11], 1.0f };
+        }
+
+        const uint8_t* get_color(const size_t& instance) const { return &m_colors[instance * COLOR_COMPONENTS]; }
+
+        const std::vector<float>&   transforms() const { return m_transforms; }
+        const std::vector<uint8_t>& colors() const     { return m_colors; }
+
+        /// @brief Union of the prototype box {min_x, min_y, min_z, max_x, max_y, max_z} placed at every instance
+        /// @note  Cached until the instances or the prototype box change
+        std::array<float, 6> get_bounding_box(const std::array<float, 6>& prototype_box) const
+        {
+            if(m_bounding_box_version == m_version && m_bounding_box_prototype == prototype_box)
+                return m_bounding_box;
+
+            typedef std::array<float, 6> bbox_t;
+            const float inf = std::numeric_limits<float>::infinity();
+            const bbox_t empty_box = {inf, inf, inf, -inf, -inf, -inf};
+
+            /// Transformed AABB of an affine map : per row, the center moves and the half extent is |M| * extent
+            const float center[3]  = { (prototype_box[0] + prototype_box[3]) * 0.5f, (prototype_box[1] + prototype_box[4]) * 0.5f, (prototype_box[2] + prototype_box[5]) * 0.5f };
+            const float extent[3]  = { (prototype_box[3] - prototype_box[0]) * 0.5f, (prototype_box[4] - prototype_box[1]) * 0.5f, (prototype_box[5] - prototype_box[2]) * 0.5f };
+
+            auto reduce_chunk = [&](size_t begin, size_t end) -> bbox_t
+            {
+                bbox_t box = empty_box;
+                for(size_t i = begin; i < end; ++i)
+                {
+                    const float* t = &m_transforms[i * TRANSFORM_COMPONENTS];
+                    for(int row = 0; row < 3; ++row)
+                    {
+                        const float c = t[row] * center[0] + t[3 + row] * center[1] + t[6 + row] * center[2] + t[9 + row];
+                        const float e = std::abs(t[row]) * extent[0] + std::abs(t[3 + row]) * extent[1] + std::abs(t[6 + row]) * extent[2];
+                        box[row]     = std::min(box[row], c - e);
+                        box[row + 3] = std::max(box[row + 3], c + e);
+                    }
+                }
+                return box;
+            };
+
+            auto merge = [](const bbox_t& a, const bbox_t& b) -> bbox_t
+            {
+                return {std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]),
+                        std::max(a[3], b[3]), std::max(a[4], b[4]), std::max(a[5], b[5])};
+            };
+
+            m_bounding_box = empty() ? bbox_t{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}
+                                     : Parallel::parallel_reduce(size_t(0), size(), empty_box, reduce_chunk, merge);
+            m_bounding_box_prototype = prototype_box;
+            m_bounding_box_version = m_version;
+            return m_bounding_box;
+        }
+
+        private :
+        void append_transform(const std::array<float, 16>& matrix)
+        {
+            for(size_t column = 0; column < 4; ++column)
+                for(size_t row = 0; row < 3; ++row)
+                    m_transforms.push_back(matrix[column * 4 + row]);
+        }
+
+        std::vector<float>   m_transforms;
+        std::vector<uint8_t> m_colors;
+        uint32_t             m_version = 1;
+
+        mutable std::array<float, 6> m_bounding_box = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        mutable std::array<float, 6> m_bounding_box_prototype = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        mutable uint32_t             m_bounding_box_version = 0;
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_INSTANCE_ARRAY_H_
@@ -0,0 +1,163 @@
+#ifndef _GP_GUI_INTERNED_TABLE_H_
+#define _GP_GUI_INTERNED_TABLE_H_
+
+/// @file    gp_gui_interned_table.h
+/// @brief   Dense, insertion ordered table of named objects with interned integer IDs
+/// @note    Entries live contiguously in a vector (iteration is a linear walk), the name -> ID map is only a
+/// secondary index for lookups by name. The interface follows std::unordered_map (find, operator[], erase,
+/// iteration over {name, value} pairs) so it drops in where a map of names was used.
+/// An ID stays valid until an entry is erased : erasing keeps the order and shifts the IDs of later entries, which
+/// moves generation() on so handles taken before can detect it. Generations are drawn from one process wide counter,
+/// so a handle never matches another table, copies included.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
+
+namespace GridPro_GFX {
+
+    template<typename T>
+    class InternedTable
+    {
+        public :
+        typedef std::pair<std::string, std::shared_ptr<T>> value_type;
+        typedef typename std::vector<value_type>::iterator       iterator;
+        typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+        static constexpr uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+
+        InternedTable() = default;
+
+        /// A copy has the same IDs but a generation of its own, handles of the source do not validate against it
+        InternedTable(const InternedTable& other)
+            : m_entries(other.m_entries), m_ids(other.m_ids)
+        {
+        }
+
+        /// Moving hands the generation over with the entries, handles follow them to the new table
+        InternedTable(InternedTable&& other)
+            : m_entries(std::move(other.m_entries)), m_ids(std::move(other.m_ids)), m_generation(other.m_generation)
+        {
+            other.clear();
+        }
+
+        /// Assigning replaces every entry, the new generation matches no old handle of either table
+        InternedTable& operator=(const InternedTable& other)
+        {
+            if(this == &other) return *this;
+            m_entries = other.m_entries;
+            m_ids = other.m_ids;
+            m_generation = next_generation();
+            return *this;
+        }
+
+        InternedTable& operator=(InternedTable&& other)
+        {
+            if(this == &other) return *this;
+            m_entries = std::move(other.m_entries);
+            m_ids = std::move(other.m_ids);
+            m_generation = next_generation();
+            other.clear();
+            return *this;
+        }
+
+        iterator begin()                        { return m_entries.begin(); }
+        iterator end()                          { return m_entries.end(); }
+        const_iterator begin() const            { return m_entries.begin(); }
+        const_iterator end() const              { return m_entries.end(); }
+
+        size_t size() const                     { return m_entries.size(); }
+        bool empty() const                      { return m_entries.empty(); }
+
+        /// @brief Changes every time IDs shift (erase, clear)
+        uint32_t generation() const             { return m_generation; }
+
+        /// @brief Interned ID of a name, INVALID_ID if absent
+        uint32_t find_id(const std::string& name) const
+        {
+            auto it = m_ids.find(name);
+            return it == m_ids.end() ? INVALID_ID : it->second;
+        }
+
+        bool contains_id(const uint32_t& id) const { return id < m_entries.size(); }
+
+        iterator find(const std::string& name)
+        {
+            const uint32_t id = find_id(name);
+            return id == INVALID_ID ? m_entries.end() : m_entries.begin() + id;
+        }
+
+        const_iterator find(const std::string& name) const
+        {
+            const uint32_t id = find_id(name);
+            return id == INVALID_ID ? m_entries.end() : m_entries.begin() + id;
+        }
+
+        /// @brief Entry by ID (no check, see contains_id)
+        value_type& at_id(const uint32_t& id)             { return m_entries[id]; }
+        const value_type& at_id(const uint32_t& id) const { return m_entries[id]; }
+
+        /// @brief Value by name, appended (null) if absent
+        /// @warning Appending may reallocate : references and iterators into the table do not survive it
+        std::shared_ptr<T>& operator[](const std::string& name)
+        {
+            return m_entries[intern(name)].second;
+        }
+
+        /// @brief ID of a name, appending a null entry if absent
+        uint32_t intern(const std::string& name)
+        {
+            auto inserted = m_ids.emplace(name, static_cast<uint32_t>(m_entries.size()));
+            if(inserted.second)
+                m_entries.emplace_back(name, nullptr);
+            return inserted.first->second;
+        }
+
+        /// @brief Remove an entry, keeping the order of the others
+        iterator erase(iterator position)
+        {
+            const size_t id = static_cast<size_t>(position - m_entries.begin());
+            m_ids.erase(position->first);
+            iterator next = m_entries.erase(position);
+            for(size_t i = id; i < m_entries.size(); ++i)
+                m_ids[m_entries[i].first] = static_cast<uint32_t>(i);
+            m_generation = next_generation();
+            return next;
+        }
+
+        size_t erase(const std::string& name)
+        {
+            iterator it = find(name);
+            if(it == m_entries.end()) return 0;
+            erase(it);
+            return 1;
+        }
+
+        void clear()
+        {
+            m_entries.clear();
+            m_ids.clear();
+            m_generation = next_generation();
+        }
+
+        private :
+        static uint32_t next_generation()
+        {
+            static std::atomic<uint32_t> counter(0);
+            return ++counter;
+        }
+
+        std::vector<value_type> m_entries;
+        std::unordered_map<std::string, uint32_t> m_ids;
+        uint32_t m_generation = next_generation();
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_INTERNED_TABLE_H_
@@ -0,0 +1,69 @@
+#ifndef _GP_GUI_MESH_OPTIMIZER_H_
+#define _GP_GUI_MESH_OPTIMIZER_H_
+
+/// @file    gp_gui_mesh_optimizer.h
+/// @brief   Triangle and vertex reordering for indexed triangle lists, vertex welding and primitive cleanup
+/// @note    The passes are meant to run in order : vertex cache (Tipsify), overdraw (cluster sort) and
+/// vertex fetch (first use order). None of them changes the rendered image, only the GPU cost of drawing it.
+/// Reference : Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../Viewers/export.h"
+
+namespace GridPro_GFX {
+
+namespace MeshOptimizer {
+
+    /// @brief Post transform cache size assumed by the passes (a FIFO of this many vertices)
+    constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+
+    /// @brief Clusters may cost up to this factor of the mesh's cache miss ratio to allow sorting them for overdraw
+    constexpr float DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+    /// @brief Result of a weld / cleanup pass
+    struct LIB_API CleanupStatistics
+    {
+        size_t num_vertices_before    = 0;
+        size_t num_vertices_after     = 0;
+        size_t num_primitives_removed = 0;
+    };
+
+    /// @brief Reorder triangles so that consecutive triangles reuse vertices still in the post transform cache
+    LIB_API void optimize_vertex_cache(uint32_t* indices, const size_t& num_indices, const size_t& num_vertices,
+                                       const uint32_t& cache_size = DEFAULT_CACHE_SIZE);
+
+    /// @brief Split a cache optimized triangle order into clusters and draw outward facing clusters first
+    /// @note  Keeps the vertex cache efficiency within threshold of its current value
+    LIB_API void optimize_overdraw(uint32_t* indices, const size_t& num_indices, const float* positions, const size_t& num_vertices,
+                                   const size_t& stride_bytes, const float& threshold = DEFAULT_OVERDRAW_THRESHOLD,
+                                   const uint32_t& cache_size = DEFAULT_CACHE_SIZE);
+
+    /// @brief Order vertices by first use in the index array
+    /// @return old vertex index -> new vertex index. Unreferenced vertices go to the end in their original order
+    LIB_API std::vector<uint32_t> compute_vertex_fetch_remap(const uint32_t* indices, const size_t& num_indices, const size_t& num_vertices);
+
+    /// @brief Average cache miss ratio (transformed vertices per triangle) of a FIFO cache, 0.5 is ideal and 3 is worst
+    LIB_API float compute_acmr(const uint32_t* indices, const size_t& num_indices, const size_t& num_vertices,
+                               const uint32_t& cache_size = DEFAULT_CACHE_SIZE);
+
+    /// @brief Find coincident vertices : every vertex maps to the smallest vertex index within tolerance of it
+    /// @param attribute_keys  optional key per vertex (a hash of its normal and color), only vertices with equal keys merge
+    /// @note  Spatial hash on a grid with cells no smaller than tolerance, searched in parallel. Chains of close
+    /// vertices (a near b near c) end on one vertex. tolerance 0 merges bitwise equal positions only
+    LIB_API std::vector<uint32_t> compute_weld_map(const float* positions, const size_t& num_vertices, const size_t& stride_bytes,
+                                                   const float& tolerance, const uint64_t* attribute_keys = nullptr);
+
+    /// @brief Drop primitives with fewer than min_distinct different vertices, and repeats of a primitive (same
+    /// vertices in the same winding), keeping the first occurrence
+    /// @return number of primitives removed
+    LIB_API size_t remove_degenerate_primitives(std::vector<uint32_t>& indices, const uint32_t& vertices_per_primitive,
+                                                const uint32_t& min_distinct);
+
+} // namespace MeshOptimizer
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_MESH_OPTIMIZER_H_
@@ -0,0 +1,71 @@
+#ifndef _GP_GUI_MESH_SIMPLIFIER_H_
+#define _GP_GUI_MESH_SIMPLIFIER_H_
+
+/// @file    gp_gui_mesh_simplifier.h
+/// @brief   Quadric error metric (Garland-Heckbert) simplification of triangle meshes into a chain of levels of detail
+/// @note    Collapses are half edge collapses onto existing vertices, so every level indexes the vertex array of the
+/// original mesh. A level is only an index array: positions, normals and colors are shared by all levels.
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../Viewers/export.h"
+
+namespace GridPro_GFX {
+
+    /// @brief Controls for building a chain of levels of detail
+    struct LIB_API SimplificationOptions
+    {
+        /// @brief Number of simplified levels to build (in addition to the original mesh)
+        uint32_t num_levels;
+
+        /// @brief Triangle count of a level relative to the previous one
+        float level_ratio;
+
+        /// @brief Largest allowed geometric error relative to the bounding box diagonal. Simplification stops there
+        float max_error;
+
+        /// @brief Keep open boundaries in place (boundary vertices only slide along the boundary)
+        bool preserve_boundaries;
+
+        /// @brief Edges with a dihedral angle above this (degrees) are feature edges and are kept like boundaries
+        float feature_angle;
+
+        SimplificationOptions() : num_levels(4), level_ratio(0.5f), max_error(0.05f), preserve_boundaries(true), feature_angle(45.0f) {}
+    };
+
+    /// @brief One simplified level of a triangle mesh
+    struct LIB_API LodLevel
+    {
+        /// @brief Triangles indexing the vertex array of the original mesh
+        std::vector<uint32_t> indices;
+
+        /// @brief Approximate geometric error of the level in world units
+        float error;
+    };
+
+    class LIB_API MeshSimplifier
+    {
+        public :
+        /// @param positions     first position (3 floats), the arrays are only read during build_lod_chain
+        /// @param stride_bytes  distance between two positions (12 for packed xyz, the vertex stride for interleaved data)
+        /// @param indices       triangle indices, nullptr for a non indexed mesh (3 consecutive vertices per triangle)
+        MeshSimplifier(const float* positions, const size_t& num_vertices, const size_t& stride_bytes,
+                       const uint32_t* indices, const size_t& num_indices);
+
+        /// @brief Simplify the mesh and snapshot a level every time the triangle count drops by level_ratio
+        /// @return Levels from finest to coarsest. Fewer than num_levels are returned if max_error is reached first
+        std::vector<LodLevel> build_lod_chain(const SimplificationOptions& options) const;
+
+        private :
+        const float*    m_positions;
+        size_t          m_num_vertices;
+        size_t          m_stride_bytes;
+        const uint32_t* m_indices;
+        size_t          m_num_indices;
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_MESH_SIMPLIFIER_H_
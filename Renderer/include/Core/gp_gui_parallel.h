@@ -0,0 +1,133 @@
+#ifndef _GP_GUI_PARALLEL_H_
+#define _GP_GUI_PARALLEL_H_
+
+/// @file    gp_gui_parallel.h
+/// @brief   Minimal fork-join helpers for the CPU side geometry processing
+/// @note    Work is split into contiguous chunks, one per worker. Small inputs run inline on the
+/// calling thread so the helpers can be used unconditionally in the hot paths.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+namespace GridPro_GFX {
+
+namespace Parallel {
+
+    /// @brief Default minimum number of items a worker has to get before a thread is spawned for it
+    static constexpr size_t DEFAULT_GRAIN_SIZE = 1 << 16;
+
+    /// @brief Number of workers to use for a given amount of work
+    inline uint32_t num_workers(const size_t& num_items, const size_t& grain_size = DEFAULT_GRAIN_SIZE)
+    {
+        const uint32_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+        const size_t   max_by_grain     = std::max<size_t>(1, num_items / std::max<size_t>(1, grain_size));
+        return static_cast<uint32_t>(std::min<size_t>(hardware_threads, max_by_grain));
+    }
+
+    /// @brief Run fn(chunk_begin, chunk_end, worker_id) over [begin, end) split into contiguous chunks
+    /// @note  The first exception thrown by a worker is rethrown on the calling thread
+    template<typename Fn>
+    void parallel_for(const size_t& begin, const size_t& end, Fn&& fn, const size_t& grain_size = DEFAULT_GRAIN_SIZE)
+    {
+        if(end <= begin) return;
+
+        const size_t   num_items = end - begin;
+        const uint32_t workers   = num_workers(num_items, grain_size);
+
+        if(workers == 1)
+        {
+            fn(begin, end, 0u);
+            return;
+        }
+
+        const size_t chunk = (num_items + workers - 1) / workers;
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(workers);
+        threads.reserve(workers - 1);
+
+        auto run_chunk = [&](uint32_t worker_id)
+        {
+            const size_t chunk_begin = begin + size_t(worker_id) * chunk;
+            const size_t chunk_end   = std::min(end, chunk_begin + chunk);
+            if(chunk_begin >= chunk_end) return;
+            try { fn(chunk_begin, chunk_end, worker_id); }
+            catch(...) { errors[worker_id] = std::current_exception(); }
+        };
+
+        for(uint32_t worker_id = 1; worker_id < workers; ++worker_id)
+            threads.emplace_back(run_chunk, worker_id);
+
+        run_chunk(0);
+
+        for(auto& thread : threads)
+            thread.join();
+
+        for(auto& error : errors)
+            if(error) std::rethrow_exception(error);
+    }
+
+    /// @brief Reduce [begin, end) with map(chunk_begin, chunk_end) -> T per chunk and reduce(T, T) -> T across chunks
+    template<typename T, typename MapFn, typename ReduceFn>
+    T parallel_reduce(const size_t& begin, const size_t& end, const T& identity, MapFn&& map, ReduceFn&& reduce,
+                      const size_t& grain_size = DEFAULT_GRAIN_SIZE)
+    {
+        if(end <= begin) return identity;
+
+        const uint32_t workers = num_workers(end - begin, grain_size);
+        std::vector<T> partials(workers, identity);
+
+        parallel_for(begin, end, [&](size_t chunk_begin, size_t chunk_end, uint32_t worker_id)
+        {
+            partials[worker_id] = map(chunk_begin, chunk_end);
+        }, grain_size);
+
+        T result = identity;
+        for(const T& partial : partials)
+            result = reduce(result, partial);
+        return result;
+    }
+
+    /// @brief Sort [first, last) : chunks are sorted by the workers, then merged pairwise in parallel rounds
+    template<typename RandomIt, typename Compare>
+    void parallel_sort(RandomIt first, RandomIt last, Compare comp, const size_t& grain_size = DEFAULT_GRAIN_SIZE)
+    {
+        const size_t num_items = static_cast<size_t>(last - first);
+        const uint32_t workers = num_workers(num_items, grain_size);
+        if(workers == 1)
+        {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        const size_t chunk = (num_items + workers - 1) / workers;
+        parallel_for(0, workers, [&](size_t chunk_begin, size_t chunk_end, uint32_t)
+        {
+            for(size_t c = chunk_begin; c < chunk_end; ++c)
+                std::sort(first + std::min(num_items, c * chunk), first + std::min(num_items, (c + 1) * chunk), comp);
+        }, 1);
+
+        for(size_t width = chunk; width < num_items; width *= 2)
+        {
+            const size_t num_merges = (num_items + 2 * width - 1) / (2 * width);
+            parallel_for(0, num_merges, [&](size_t merge_begin, size_t merge_end, uint32_t)
+            {
+                for(size_t m = merge_begin; m < merge_end; ++m)
+                {
+                    const size_t lo  = m * 2 * width;
+                    const size_t mid = std::min(num_items, lo + width);
+                    const size_t hi  = std::min(num_items, lo + 2 * width);
+                    if(mid < hi) std::inplace_merge(first + lo, first + mid, first + hi, comp);
+                }
+            }, 1);
+        }
+    }
+
+} // namespace Parallel
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_PARALLEL_H_
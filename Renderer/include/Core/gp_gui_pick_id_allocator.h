@@ -0,0 +1,166 @@
+#ifndef _GP_GUI_PICK_ID_ALLOCATOR_H_
+#define _GP_GUI_PICK_ID_ALLOCATOR_H_
+
+/// @file    gp_gui_pick_id_allocator.h
+/// @brief   Allocator of contiguous pick (color) ID ranges, one range per pickable entity
+/// @note    Released ranges are merged with their free neighbours and reused best fit, a range ending at the top of the
+/// used space gives it back instead. Resizing keeps the start of a range whenever the IDs after it are free, so
+/// editing one entity leaves every other range, and the pick colors the drivers generated from it, untouched.
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace GridPro_GFX {
+
+    class PickIdAllocator
+    {
+        public :
+        /// @brief Returned when the ID space is exhausted (0 is the background color, never allocated)
+        static constexpr uint32_t INVALID_ID = 0;
+
+        /// @brief Pick IDs are read back from 24 bit RGB colors
+        static constexpr uint32_t PICK_ID_LIMIT = 1u << 24;
+
+        /// @param first_id  lowest ID handed out
+        /// @param end_id    one past the highest ID handed out
+        explicit PickIdAllocator(const uint32_t& first_id = 1, const uint32_t& end_id = PICK_ID_LIMIT)
+            : m_first(first_id), m_end(end_id), m_top(first_id) {}
+
+        /// @brief One past the highest allocated ID, first_id when nothing is allocated
+        uint32_t top() const                    { return m_top; }
+
+        /// @brief Number of free ranges below top()
+        size_t num_free_ranges() const          { return m_free_by_start.size(); }
+
+        /// @brief Start of a free range of count IDs, INVALID_ID if none is left
+        uint32_t allocate(const uint32_t& count)
+        {
+            if(count == 0) return INVALID_ID;
+
+            /// Smallest free range holding count IDs
+            auto fit = m_free_by_size.lower_bound(std::make_pair(count, uint32_t(0)));
+            if(fit != m_free_by_size.end())
+            {
+                const uint32_t start = fit->second;
+                const uint32_t size  = fit->first;
+                remove_free(start, size);
+                if(size > count)
+                    insert_free(start + count, size - count);
+                return start;
+            }
+
+            if(m_end - m_top < count) return INVALID_ID;
+
+            const uint32_t start = m_top;
+            m_top += count;
+            return start;
+        }
+
+        /// @brief Give [start, start + count) back
+        void release(uint32_t start, uint32_t count)
+        {
+            if(count == 0) return;
+
+            /// Merge with the free range ending at start
+            auto next = m_free_by_start.lower_bound(start);
+            if(next != m_free_by_start.begin())
+            {
+                auto previous = std::prev(next);
+                if(previous->first + previous->second == start)
+                {
+                    start  = previous->first;
+                    count += previous->second;
+                    remove_free(previous->first, previous->second);
+                }
+            }
+
+            /// Merge with the free range starting at the end
+            next = m_free_by_start.find(start + count);
+            if(next != m_free_by_start.end())
+            {
+                count += next->second;
+                remove_free(next->first, next->second);
+            }
+
+            if(start + count == m_top)
+            {
+                m_top = start;
+                return;
+            }
+
+            insert_free(start, count);
+        }
+
+        /// @brief Grow or shrink the range [start, start + old_count)
+        /// @return New start : start itself when the range can change in place, INVALID_ID (range released) if no
+        /// range of new_count IDs is left
+        uint32_t resize(const uint32_t& start, const uint32_t& old_count, const uint32_t& new_count)
+        {
+            if(old_count == 0) return allocate(new_count);
+            if(new_count == old_count) return start;
+
+            if(new_count < old_count)
+            {
+                release(start + new_count, old_count - new_count);
+                return new_count == 0 ? INVALID_ID : start;
+            }
+
+            const uint32_t tail = start + old_count;
+            const uint32_t need = new_count - old_count;
+
+            if(tail == m_top && m_end - m_top >= need)
+            {
+                m_top += need;
+                return start;
+            }
+
+            auto next = m_free_by_start.find(tail);
+            if(next != m_free_by_start.end() && next->second >= need)
+            {
+                const uint32_t size = next->second;
+                remove_free(tail, size);
+                if(size > need)
+                    insert_free(tail + need, size - need);
+                return start;
+            }
+
+            release(start, old_count);
+            return allocate(new_count);
+        }
+
+        void clear()
+        {
+            m_free_by_start.clear();
+            m_free_by_size.clear();
+            m_top = m_first;
+        }
+
+        private :
+        void insert_free(const uint32_t& start, const uint32_t& count)
+        {
+            m_free_by_start.emplace(start, count);
+            m_free_by_size.emplace(count, start);
+        }
+
+        void remove_free(const uint32_t& start, const uint32_t& count)
+        {
+            m_free_by_start.erase(start);
+            m_free_by_size.erase(std::make_pair(count, start));
+        }
+
+        uint32_t m_first;
+        uint32_t m_end;
+        uint32_t m_top;
+
+        /// Free ranges below m_top : start -> count for merging, {count, start} for best fit
+        std::map<uint32_t, uint32_t>           m_free_by_start;
+        std::set<std::pair<uint32_t, uint32_t>> m_free_by_size;
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_PICK_ID_ALLOCATOR_H_
@@ -0,0 +1,68 @@
+#ifndef _GP_GUI_PRIMITIVE_COLOR_ARRAY_H_
+#define _GP_GUI_PRIMITIVE_COLOR_ARRAY_H_
+
+/// @file    gp_gui_primitive_color_array.h
+/// @brief   One RGBA color per primitive of a primitive set (ColorScheme::PER_PRIMITIVE)
+/// @note    Primitive i is the one picked as primitive i : the i-th point, line or triangle of list sets, the i-th quad
+/// or polygon of triangulated sets (through the triangulation primitive IDs), the i-th triangle or segment of strips,
+/// the i-th strip of multi strip sets (see gp_gui_strip_array.h).
+/// The 3.3 driver samples the array as a texture buffer at gl_PrimitiveID, so indexed meshes keep their shared
+/// vertices. The 2.1 driver expands the colors onto unshared vertices.
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace GridPro_GFX {
+
+    class PrimitiveColorArray
+    {
+        public :
+        /// @brief Bytes per primitive color (RGBA)
+        static constexpr size_t COLOR_COMPONENTS = 4;
+
+        size_t size() const                     { return m_colors.size() / COLOR_COMPONENTS; }
+        bool empty() const                      { return m_colors.empty(); }
+
+        /// @brief Incremented by every edit, drivers compare it to know when to upload again
+        uint32_t version() const                { return m_version; }
+
+        /// @brief Replace every color at once
+        /// @param colors  COLOR_COMPONENTS bytes per primitive
+        void assign(std::vector<uint8_t>&& colors)
+        {
+            if(colors.size() % COLOR_COMPONENTS != 0)
+                throw std::runtime_error("PrimitiveColorArray::assign : color array size is not a multiple of 4");
+            m_colors = std::move(colors);
+            ++m_version;
+        }
+
+        void set_color(const size_t& primitive, const std::array<uint8_t, 4>& color)
+        {
+            if(primitive >= size())
+                throw std::runtime_error("PrimitiveColorArray::set_color : primitive out of range");
+            std::copy(color.begin(), color.end(), m_colors.begin() + primitive * COLOR_COMPONENTS);
+            ++m_version;
+        }
+
+        void clear()
+        {
+            m_colors.clear();
+            ++m_version;
+        }
+
+        const uint8_t* get_color(const size_t& primitive) const { return &m_colors[primitive * COLOR_COMPONENTS]; }
+
+        const std::vector<uint8_t>& colors() const { return m_colors; }
+
+        private :
+        std::vector<uint8_t> m_colors;
+        uint32_t             m_version = 1;
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_PRIMITIVE_COLOR_ARRAY_H_
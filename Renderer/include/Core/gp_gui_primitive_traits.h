@@ -0,0 +1,215 @@
+#ifndef _GP_GUI_PRIMITIVE_TRAITS_H_
+#define _GP_GUI_PRIMITIVE_TRAITS_H_
+
+/// @file    gp_gui_primitive_traits.h
+/// @brief   Compile time description of every GL primitive type, and the one switch that turns a runtime type into it
+/// @note    Kernels take the traits as a template parameter. dispatch_primitive_type() switches once per call, the
+/// per vertex loops then see constants (a list's vertices_per_primitive, a strip's vertex step) instead of a switch
+/// on the primitive type for every element.
+///
+/// Primitive p of a set is the p-th point, line, triangle or quad GL assembles from its vertex sequence (the indices
+/// of an indexed set, the positions otherwise). Its provoking vertex is the last one (the first one of a polygon),
+/// which is the vertex whose color fills the primitive with flat shading.
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "gp_gui_typedefs.h"
+
+namespace GridPro_GFX {
+
+    /// @brief Traits of one primitive type, specialized below for GL_POINTS .. GL_POLYGON
+    /// @note  vertices_per_primitive : corners of one primitive (3 for polygons, the triangles of the fan picking used)
+    /// is_list : every vertex belongs to a single primitive
+    /// num_primitives(n) : primitives assembled from n vertices
+    /// corner(p, k, n) : position in the vertex sequence of corner k of primitive p
+    /// num_corners(n) : corners of one primitive (n for a polygon)
+    /// provoked_primitive(v, n) : primitive whose provoking vertex is v (the nearest one for vertices provoking none)
+    template<GLenum Type> struct PrimitiveTypeTraits;
+
+    template<> struct PrimitiveTypeTraits<GL_POINTS>
+    {
+        static constexpr GLenum   type = GL_POINTS;
+        static constexpr uint32_t vertices_per_primitive = 1;
+        static constexpr bool     is_list = true;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n; }
+        static constexpr size_t corner(const size_t& p, const uint32_t&, const size_t&)         { return p; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 1; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_LINES>
+    {
+        static constexpr GLenum   type = GL_LINES;
+        static constexpr uint32_t vertices_per_primitive = 2;
+        static constexpr bool     is_list = true;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n / 2; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t&)       { return 2 * p + k; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 2; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v / 2; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_LINE_STRIP>
+    {
+        static constexpr GLenum   type = GL_LINE_STRIP;
+        static constexpr uint32_t vertices_per_primitive = 2;
+        static constexpr bool     is_list = false;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n >= 2 ? n - 1 : 0; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t&)       { return p + k; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 2; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v > 0 ? v - 1 : 0; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_LINE_LOOP>
+    {
+        static constexpr GLenum   type = GL_LINE_LOOP;
+        static constexpr uint32_t vertices_per_primitive = 2;
+        static constexpr bool     is_list = false;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n >= 2 ? n : 0; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t& n)     { return (p + k) % n; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 2; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t& n)            { return v > 0 ? v - 1 : n - 1; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_TRIANGLES>
+    {
+        static constexpr GLenum   type = GL_TRIANGLES;
+        static constexpr uint32_t vertices_per_primitive = 3;
+        static constexpr bool     is_list = true;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n / 3; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t&)       { return 3 * p + k; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 3; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v / 3; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_TRIANGLE_STRIP>
+    {
+        static constexpr GLenum   type = GL_TRIANGLE_STRIP;
+        static constexpr uint32_t vertices_per_primitive = 3;
+        static constexpr bool     is_list = false;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n >= 3 ? n - 2 : 0; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t&)       { return p + k; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 3; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v > 1 ? v - 2 : 0; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_TRIANGLE_FAN>
+    {
+        static constexpr GLenum   type = GL_TRIANGLE_FAN;
+        static constexpr uint32_t vertices_per_primitive = 3;
+        static constexpr bool     is_list = false;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n >= 3 ? n - 2 : 0; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t&)       { return k == 0 ? 0 : p + k; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 3; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v > 1 ? v - 2 : 0; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_QUADS>
+    {
+        static constexpr GLenum   type = GL_QUADS;
+        static constexpr uint32_t vertices_per_primitive = 4;
+        static constexpr bool     is_list = true;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n / 4; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t&)       { return 4 * p + k; }
+        static constexpr size_t num_corners(const size_t&)                                       { return 4; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v / 4; }
+    };
+
+    /// Quad p of a strip is (v[2p], v[2p+1], v[2p+3], v[2p+2]), in boundary order
+    template<> struct PrimitiveTypeTraits<GL_QUAD_STRIP>
+    {
+        static constexpr GLenum   type = GL_QUAD_STRIP;
+        static constexpr uint32_t vertices_per_primitive = 4;
+        static constexpr bool     is_list = false;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n >= 4 ? (n - 2) / 2 : 0; }
+        static constexpr size_t corner(const size_t& p, const uint32_t& k, const size_t&)       { return 2 * p + (k ^ (k >> 1)); }
+        static constexpr size_t num_corners(const size_t&)                                       { return 4; }
+        static constexpr size_t provoked_primitive(const size_t& v, const size_t&)              { return v > 2 ? (v - 2) / 2 : 0; }
+    };
+
+    template<> struct PrimitiveTypeTraits<GL_POLYGON>
+    {
+        static constexpr GLenum   type = GL_POLYGON;
+        static constexpr uint32_t vertices_per_primitive = 3;
+        static constexpr bool     is_list = false;
+        static constexpr size_t num_primitives(const size_t& n)                                  { return n >= 3 ? 1 : 0; }
+        static constexpr size_t corner(const size_t&, const uint32_t& k, const size_t&)         { return k; }
+        static constexpr size_t num_corners(const size_t& n)                                     { return n; }
+        static constexpr size_t provoked_primitive(const size_t&, const size_t&)                { return 0; }
+    };
+
+    /// @brief Runtime row of the traits table, for callers that only need the constants
+    struct PrimitiveTraits
+    {
+        GLenum   type;
+        uint32_t vertices_per_primitive;
+        bool     is_list;
+    };
+
+    template<GLenum Type>
+    constexpr PrimitiveTraits make_primitive_traits()
+    {
+        return { Type, PrimitiveTypeTraits<Type>::vertices_per_primitive, PrimitiveTypeTraits<Type>::is_list };
+    }
+
+    /// @brief Traits of GL_POINTS (0) .. GL_POLYGON (9), indexed by the GL enum
+    constexpr PrimitiveTraits PRIMITIVE_TRAITS_TABLE[] =
+    {
+        make_primitive_traits<GL_POINTS>(),         make_primitive_traits<GL_LINES>(),
+        make_primitive_traits<GL_LINE_LOOP>(),      make_primitive_traits<GL_LINE_STRIP>(),
+        make_primitive_traits<GL_TRIANGLES>(),      make_primitive_traits<GL_TRIANGLE_STRIP>(),
+        make_primitive_traits<GL_TRIANGLE_FAN>(),   make_primitive_traits<GL_QUADS>(),
+        make_primitive_traits<GL_QUAD_STRIP>(),     make_primitive_traits<GL_POLYGON>()
+    };
+
+    constexpr size_t NUM_PRIMITIVE_TYPES = sizeof(PRIMITIVE_TRAITS_TABLE) / sizeof(PRIMITIVE_TRAITS_TABLE[0]);
+
+    static_assert(GL_POINTS == 0 && GL_POLYGON == NUM_PRIMITIVE_TYPES - 1, "PRIMITIVE_TRAITS_TABLE is indexed by the GL primitive enums");
+    static_assert(PRIMITIVE_TRAITS_TABLE[GL_LINE_STRIP].type == GL_LINE_STRIP && PRIMITIVE_TRAITS_TABLE[GL_QUAD_STRIP].type == GL_QUAD_STRIP,
+                  "PRIMITIVE_TRAITS_TABLE rows are out of order");
+
+    inline bool is_primitive_type(const GLenum& type)   { return type < NUM_PRIMITIVE_TYPES; }
+
+    /// @throws std::runtime_error if type is not a GL primitive type (GL_NONE_NULL included)
+    inline const PrimitiveTraits& get_primitive_traits(const GLenum& type)
+    {
+        if(!is_primitive_type(type))
+            throw std::runtime_error("get_primitive_traits : not a primitive type : " + std::to_string(type));
+        return PRIMITIVE_TRAITS_TABLE[type];
+    }
+
+    /// @brief Call fn(PrimitiveTypeTraits<type>()) : the only switch on the primitive type of a kernel call
+    /// @throws std::runtime_error if type is not a GL primitive type
+    template<typename Fn>
+    decltype(auto) dispatch_primitive_type(const GLenum& type, Fn&& fn)
+    {
+        switch(type)
+        {
+            case GL_POINTS:         return fn(PrimitiveTypeTraits<GL_POINTS>());
+            case GL_LINES:          return fn(PrimitiveTypeTraits<GL_LINES>());
+            case GL_LINE_LOOP:      return fn(PrimitiveTypeTraits<GL_LINE_LOOP>());
+            case GL_LINE_STRIP:     return fn(PrimitiveTypeTraits<GL_LINE_STRIP>());
+            case GL_TRIANGLES:      return fn(PrimitiveTypeTraits<GL_TRIANGLES>());
+            case GL_TRIANGLE_STRIP: return fn(PrimitiveTypeTraits<GL_TRIANGLE_STRIP>());
+            case GL_TRIANGLE_FAN:   return fn(PrimitiveTypeTraits<GL_TRIANGLE_FAN>());
+            case GL_QUADS:          return fn(PrimitiveTypeTraits<GL_QUADS>());
+            case GL_QUAD_STRIP:     return fn(PrimitiveTypeTraits<GL_QUAD_STRIP>());
+            case GL_POLYGON:        return fn(PrimitiveTypeTraits<GL_POLYGON>());
+            default:                throw std::runtime_error("dispatch_primitive_type : not a primitive type : " + std::to_string(type));
+        }
+    }
+
+    /// @brief Call fn(uint16_t()) for GL_UNSIGNED_SHORT indices, fn(uint32_t()) otherwise
+    template<typename Fn>
+    decltype(auto) dispatch_index_type(const GLenum& index_type, Fn&& fn)
+    {
+        if(index_type == GL_UNSIGNED_SHORT)
+            return fn(uint16_t());
+        return fn(uint32_t());
+    }
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_PRIMITIVE_TRAITS_H_
@@ -2,12 +2,18 @@
 #define GP_GUI_SCENE_H
 
 #include <unordered_map>
+#include <unordered_set>
 #include <deque>
 #include <memory>
+#include <array>
+#include <vector>
 
 #include "ecs.h"
 
 #include "gp_gui_forward_structs.h"
+#include "gp_gui_slot_map.h"
+#include "gp_gui_pick_id_allocator.h"
+#include "gp_gui_draw_buckets.h"
 
 namespace GridPro_GFX
 {
@@ -45,9 +51,18 @@ namespace GridPro_GFX
          // The Only Functions you'll ever need ------------------------+
          /// Creates an entity to the scene
          /// Load a geometry descriptor to the scene
-         void commit_geometry(const std::string& in_name, const float& in_layer, const std::shared_ptr<GeometryDescriptor>& geometry_descriptor);
+         /// @return Handle of the entity, valid until it is destroyed
+         EntityId commit_geometry(const std::string& in_name, const float& in_layer, const std::shared_ptr<GeometryDescriptor>& geometry_descriptor);
+         bool commit_geometry(const EntityId& entity_id, const float& in_layer, const std::shared_ptr<GeometryDescriptor>& geometry_descriptor);
 
          std::shared_ptr<GeometryDescriptor>& get_geometry(const std::string& in_name);
+         std::shared_ptr<GeometryDescriptor>& get_geometry(const EntityId& entity_id);
+
+         /// @brief Entity handles
+         /// @note  Every entity keyed function has an EntityId overload, the std::string one looks the name up once and
+         /// forwards to it. Resolve names once with find_entity() and keep the handle on paths run per frame or per mouse move
+         EntityId find_entity(const std::string& entity_key) const;
+         const std::string& get_entity_key(const EntityId& entity_id) const;
 
          /// Updates all Systems
          void update(const float& layer);
@@ -65,21 +80,55 @@ namespace GridPro_GFX
          /// @brief Commit to the render device for display
          void commit_all();
          bool commit_entity(const std::string& entity_key);
+         bool commit_entity(const EntityId& entity_id);
          bool commit_layer(const float& layer);
          bool uncommit_entity(const std::string& entity_key);
+         bool uncommit_entity(const EntityId& entity_id);
          bool uncommit_layer(const float& layer);
 
+         /// @brief Call fn(ecs::Entity&) for the committed entities of a layer
+         /// @note  Walks the layer's draw bucket only, the render devices use it so a layer pass never visits other layers
+         template<typename Fn>
+         void for_each_committed_entity(const float& layer, Fn&& fn)
+         {
+             draw_buckets.for_each_visible(layer, [&](const uint32_t& slot) { fn(Entity_DataBase.get_at(slot)->entity); });
+         }
+
+         /// @brief Call fn(ecs::Entity&) for the committed entities of every layer, in slot order
+         template<typename Fn>
+         void for_each_committed_entity(Fn&& fn)
+         {
+             draw_buckets.for_each_visible([&](const uint32_t& slot) { fn(Entity_DataBase.get_at(slot)->entity); });
+         }
+
          /// @brief Destroy an entity
          bool destroy_entity(const std::string& entity_key);
+         bool destroy_entity(const EntityId& entity_id);
          void destroy_entities_in_layer(const float& layer);
          bool remove_entity_from_registry(const std::string& entity_key);
+         bool remove_entity_from_registry(const EntityId& entity_id);
 
          std::vector<std::pair<std::string, uint32_t>> pick_matrix(const float& center_x, const float& center_y, const float& width, const float& height);
          std::vector<std::pair<std::string, uint32_t>> pick_polygon(const std::vector<float>& polygon_points);
 
+         /// @brief Map pick (color) IDs read back from the pick buffer to {entity key, sub entity ID} pairs
+         /// @note  One sorted sweep over the reservation intervals for the whole vector, the pairs keep the order of
+         /// color_ids. IDs belonging to no reservation (background, stale IDs) are skipped
+         std::vector<std::pair<std::string, uint32_t>> resolve_color_ids(const std::vector<uint32_t>& color_ids);
+
+         ///------------------------------------------------------------+
+         /// @brief Bounding boxes {min_x, min_y, min_z, max_x, max_y, max_z}
+         /// @note  Union of the cached per primitive set boxes, so no vertex is touched unless an entity changed
+         std::array<float, 6> get_bounding_box(const std::vector<std::string>& entity_keys);
+         std::array<float, 6> get_layer_bounding_box(const float& layer);
+
+         /// @brief Union of all entities except the background, foreground 2D and hidden layers
+         std::array<float, 6> get_scene_bounding_box();
+
          ///------------------------------------------------------------+
          /// @brief Getters and Setters
          bool has_entity(const std::string& entity_key);
+         bool has_entity(const EntityId& entity_id) const;
 
 
          SceneState::RenderMode get_render_mode() const;
@@ -92,20 +141,50 @@ namespace GridPro_GFX
          void clear_screen(const float& r, const float& g, const float& b, const float& a);
 
     private:
+         friend class Entity_Handle;
          Entity_Handle get_entity(const std::string& entity_key);
+         Entity_Handle get_entity(const EntityId& entity_id);
          bool initialize_render_devices();
          void update_color_reservations();
+         void update_entity_color_reservation(const uint32_t& slot);
+         void release_color_reservation(const uint32_t& slot);
          uint32_t get_actual_id(const uint32_t& color_id);
+         const unique_color_reservation* find_color_reservation(const uint32_t& color_id);
+         const std::vector<unique_color_reservation>& get_color_reservation_intervals();
          void reset_scene_registry();
 
      private :
      /// @brief Registry of Entities
      /// @note The Below Data Structures are used to Book Keep the Entities and their Color Reservations
-     std::deque<ecs::Entity> Entity_DataBase;
-     std::unordered_map<std::string, uint32_t> SceneEntityRegistry;
-     std::unordered_map<uint32_t, std::string> EntityIdxKeyMapRegistry;
+     /// @note The slot index of an entity is its kernel ID (the key of the color reservations), it never changes while
+     /// the entity lives and is reused once it is destroyed
+     struct SceneEntity
+     {
+         SceneEntity(const ecs::Entity& in_entity, const std::string& in_key) : entity(in_entity), key(in_key) {}
+         ecs::Entity entity;
+         std::string key;
+     };
+
+     SlotMap<SceneEntity> Entity_DataBase;
+     std::unordered_map<std::string, EntityId> SceneEntityRegistry;
      std::unordered_map<uint32_t, unique_color_reservation> unique_colr_reservations;
 
+     /// @brief Pick ID ranges of the reservations, the first 10000 IDs are never handed out
+     /// @note  Only the entities committed or destroyed since the last pick pass get a new range (pending_color_reservations
+     /// holds their slots), the others keep theirs and their drivers keep their pick colors
+     PickIdAllocator pick_id_allocator = PickIdAllocator(10000);
+     std::unordered_set<uint32_t> pending_color_reservations;
+
+     /// @brief The reservations sorted by _Min_ColorID_ (the ranges never overlap), binary searched to resolve a pick ID
+     /// @note  Rebuilt from unique_colr_reservations on first use after the reservations change
+     std::vector<unique_color_reservation> color_reservation_intervals;
+     bool need_to_rebuild_color_intervals = true;
+
+     /// @brief Slots of the entities grouped by layer, with a bit set for the committed ones
+     /// @note  Kept in step with the commit_component of each entity by commit_geometry() and the commit / uncommit
+     /// functions, so the commit flag is never polled per frame
+     DrawBuckets draw_buckets;
+
      /// @brief ECS Managers
      ecs::EntityManager RenderableEntitiesManager;
      ecs::SystemManager RenderSystemsManager;  
@@ -120,7 +199,6 @@ namespace GridPro_GFX
      /// @warning Critical : Render Device Validation
      private:
      bool has_a_valid_render_device;
-     bool need_to_update_color_reservations;
      
     };
 
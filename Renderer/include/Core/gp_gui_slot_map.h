@@ -0,0 +1,160 @@
+#ifndef _GP_GUI_SLOT_MAP_H_
+#define _GP_GUI_SLOT_MAP_H_
+
+/// @file    gp_gui_slot_map.h
+/// @brief   Generational slot map : O(1) insert, lookup and erase through handles that stay valid until their entry is erased
+/// @note    An erased slot goes on a free list and is reused by the next insert with its generation incremented, so a
+/// handle to the erased entry no longer matches and contains() / get() reject it. Slot indices never move, they can be
+/// used as dense IDs (the scene uses them as kernel IDs). Slots live in a deque : inserting never moves the other values,
+/// pointers to them stay valid until they are erased.
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+
+namespace GridPro_GFX {
+
+    /// @brief Stable reference to a slot map entry
+    struct SlotHandle
+    {
+        static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        uint32_t index      = INVALID_INDEX;
+        uint32_t generation = 0;
+
+        bool is_null() const                    { return index == INVALID_INDEX; }
+
+        bool operator==(const SlotHandle& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const SlotHandle& other) const { return !(*this == other); }
+    };
+
+    /// @brief Stable handle of a scene entity : the handle of its slot in the scene's entity slot map
+    typedef SlotHandle EntityId;
+
+    template<typename T>
+    class SlotMap
+    {
+        public :
+        /// @brief Number of live entries
+        size_t size() const                     { return m_size; }
+        bool empty() const                      { return m_size == 0; }
+
+        /// @brief Number of slots, live or free : slot indices are below it
+        size_t slot_count() const               { return m_slots.size(); }
+
+        /// @brief Construct a value in a free slot (the most recently freed one) or a new slot
+        template<typename... Args>
+        SlotHandle emplace(Args&&... args)
+        {
+            uint32_t index;
+            if(m_free_head != SlotHandle::INVALID_INDEX)
+            {
+                index = m_free_head;
+                m_free_head = m_slots[index].next_free;
+            }
+            else
+            {
+                index = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+
+            Slot& slot = m_slots[index];
+            slot.value.emplace(std::forward<Args>(args)...);
+            slot.next_free = SlotHandle::INVALID_INDEX;
+            ++m_size;
+            return SlotHandle{index, slot.generation};
+        }
+
+        bool contains(const SlotHandle& handle) const
+        {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation && m_slots[handle.index].value.has_value();
+        }
+
+        /// @brief Value of a handle, nullptr if it was erased
+        T* get(const SlotHandle& handle)             { return contains(handle) ? &(*m_slots[handle.index].value) : nullptr; }
+        const T* get(const SlotHandle& handle) const { return contains(handle) ? &(*m_slots[handle.index].value) : nullptr; }
+
+        /// @brief Value of a slot index, nullptr if the slot is free
+        T* get_at(const size_t& index)               { return index < m_slots.size() && m_slots[index].value ? &(*m_slots[index].value) : nullptr; }
+        const T* get_at(const size_t& index) const   { return index < m_slots.size() && m_slots[index].value ? &(*m_slots[index].value) : nullptr; }
+
+        /// @brief Handle of the live entry of a slot index, a null handle if the slot is free
+        SlotHandle handle_at(const size_t& index) const
+        {
+            if(get_at(index) == nullptr) return SlotHandle();
+            return SlotHandle{static_cast<uint32_t>(index), m_slots[index].generation};
+        }
+
+        /// @brief Destroy the value of a handle and free its slot
+        /// @return false if the handle was already erased
+        bool erase(const SlotHandle& handle)
+        {
+            if(!contains(handle)) return false;
+
+            Slot& slot = m_slots[handle.index];
+            slot.value.reset();
+            ++slot.generation;
+            slot.next_free = m_free_head;
+            m_free_head = handle.index;
+            --m_size;
+            return true;
+        }
+
+        /// @brief Erase every entry, no handle taken before matches afterwards
+        void clear()
+        {
+            m_free_head = SlotHandle::INVALID_INDEX;
+            for(size_t i = m_slots.size(); i-- > 0;)
+            {
+                Slot& slot = m_slots[i];
+                if(slot.value)
+                {
+                    slot.value.reset();
+                    ++slot.generation;
+                }
+                slot.next_free = m_free_head;
+                m_free_head = static_cast<uint32_t>(i);
+            }
+            m_size = 0;
+        }
+
+        /// @brief Call fn(handle, value) for every live entry, in slot order
+        template<typename Fn>
+        void for_each(Fn&& fn)
+        {
+            for(size_t i = 0; i < m_slots.size(); ++i)
+            {
+                if(m_slots[i].value)
+                    fn(SlotHandle{static_cast<uint32_t>(i), m_slots[i].generation}, *m_slots[i].value);
+            }
+        }
+
+        private :
+        struct Slot
+        {
+            std::optional<T> value;
+            uint32_t         generation = 0;
+            uint32_t         next_free  = SlotHandle::INVALID_INDEX;
+        };
+
+        std::deque<Slot> m_slots;
+        uint32_t         m_free_head = SlotHandle::INVALID_INDEX;
+        size_t           m_size      = 0;
+    };
+
+} // namespace GridPro_GFX
+
+/// Handles can key unordered containers, a stale handle never equals the live one reusing its slot
+template<>
+struct std::hash<GridPro_GFX::SlotHandle>
+{
+    size_t operator()(const GridPro_GFX::SlotHandle& handle) const noexcept
+    {
+        return std::hash<uint64_t>()((uint64_t(handle.generation) << 32) | handle.index);
+    }
+};
+
+#endif // _GP_GUI_SLOT_MAP_H_
@@ -0,0 +1,126 @@
+#ifndef _GP_GUI_STRIP_ARRAY_H_
+#define _GP_GUI_STRIP_ARRAY_H_
+
+/// @file    gp_gui_strip_array.h
+/// @brief   Boundaries of the strips packed into one GL_LINE_STRIP, GL_LINE_LOOP, GL_TRIANGLE_STRIP or GL_TRIANGLE_FAN set
+/// @note    Strip i is the vertices [offset(i), offset(i + 1)) of the set : indices of an indexed set, positions of a
+/// non indexed one. The OpenGL 3.3 driver draws every strip with one glDrawElements, the strips separated by the
+/// primitive restart index, the OpenGL 2.1 driver with one glMultiDrawArrays / glMultiDrawElements. Strips are the
+/// pickable primitives of the set, so strip i is picked (and colored, with ColorScheme::PER_PRIMITIVE) as primitive i.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+#include "gp_gui_typedefs.h"
+#include "gp_gui_index_buffer.h"
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+    class StripArray
+    {
+        public :
+        StripArray() : m_offsets(1, 0) {}
+
+        size_t size() const                     { return m_offsets.size() - 1; }
+        bool empty() const                      { return size() == 0; }
+
+        /// @brief Incremented by every edit, drivers compare it to know when to rebuild their draw lists
+        uint32_t version() const                { return m_version; }
+
+        /// @brief Number of vertices covered by the strips, the vertex count of the set they describe
+        uint32_t get_num_vertices() const       { return m_offsets.back(); }
+
+        uint32_t get_first(const size_t& strip) const  { return m_offsets[strip]; }
+        uint32_t get_count(const size_t& strip) const  { return m_offsets[strip + 1] - m_offsets[strip]; }
+
+        /// @brief Strip i covers [offsets()[i], offsets()[i + 1]), size() + 1 entries starting with 0
+        const std::vector<uint32_t>& offsets() const { return m_offsets; }
+
+        /// @brief Append a strip of num_vertices vertices after the last one
+        void push_strip(const uint32_t& num_vertices)
+        {
+            m_offsets.push_back(m_offsets.back() + num_vertices);
+            ++m_version;
+        }
+
+        /// @brief Replace every strip at once
+        /// @param offsets  number of strips + 1 non decreasing entries, the first one 0
+        void assign(std::vector<uint32_t>&& offsets)
+        {
+            if(offsets.empty() || offsets.front() != 0 || !std::is_sorted(offsets.begin(), offsets.end()))
+                throw std::runtime_error("StripArray::assign : strip offsets must start at 0 and never decrease");
+            m_offsets = std::move(offsets);
+            ++m_version;
+        }
+
+        void reserve(const size_t& num_strips)  { m_offsets.reserve(num_strips + 1); }
+
+        void clear()
+        {
+            m_offsets.assign(1, 0);
+            ++m_version;
+        }
+
+        /// @brief Strip holding vertex (a position in the vertex sequence of the set, not a vertex ID)
+        size_t find_strip(const size_t& vertex) const
+        {
+            return static_cast<size_t>(std::upper_bound(m_offsets.begin(), m_offsets.end(), static_cast<uint32_t>(vertex)) - m_offsets.begin()) - 1;
+        }
+
+        /// @brief Number of points, lines or triangles GL assembles from a strip of num_vertices vertices
+        static size_t primitives_per_strip(const GLenum& primitive_type, const size_t& num_vertices)
+        {
+            switch(primitive_type)
+            {
+                case GL_LINE_STRIP:     return num_vertices >= 2 ? num_vertices - 1 : 0;
+                case GL_LINE_LOOP:      return num_vertices >= 2 ? num_vertices : 0;
+                case GL_TRIANGLE_STRIP:
+                case GL_TRIANGLE_FAN:   return num_vertices >= 3 ? num_vertices - 2 : 0;
+                default:                return 0;
+            }
+        }
+
+        /// @brief Index list of every strip separated by PRIMITIVE_RESTART_INDEX, for a single restart enabled draw
+        /// @note  Narrowed by CompactIndexArray like any index list, the separators become 0xFFFF in 16 bit lists
+        /// @param indices       index array of the set, nullptr for a non indexed set (the strips index their positions)
+        /// @param restart_list  receives size() - 1 restart indices between the strip vertices
+        /// @param primitive_ids receives the strip of every primitive the list draws (gl_PrimitiveID -> strip) : the
+        /// primitive ID counter runs across restarts, the table turns it back into a pick ID
+        void build_restart_list(const GLenum& primitive_type, const uint32_t* indices,
+                                std::vector<uint32_t>& restart_list, std::vector<uint32_t>& primitive_ids) const
+        {
+            restart_list.clear();
+            primitive_ids.clear();
+            if(empty()) return;
+
+            /// Strip s starts s restart indices after its first vertex
+            restart_list.resize(get_num_vertices() + size() - 1);
+            uint32_t* list = restart_list.data();
+            Parallel::parallel_for(0, size(), [&](size_t begin, size_t end, uint32_t)
+            {
+                for(size_t strip = begin; strip < end; ++strip)
+                {
+                    uint32_t* out = list + m_offsets[strip] + strip;
+                    for(uint32_t v = m_offsets[strip]; v < m_offsets[strip + 1]; ++v)
+                        *out++ = indices ? indices[v] : v;
+                    if(strip + 1 < size())
+                        *out = PRIMITIVE_RESTART_INDEX;
+                }
+            }, 256);
+
+            for(size_t strip = 0; strip < size(); ++strip)
+                primitive_ids.insert(primitive_ids.end(), primitives_per_strip(primitive_type, get_count(strip)), static_cast<uint32_t>(strip));
+        }
+
+        private :
+        std::vector<uint32_t> m_offsets;
+        uint32_t              m_version = 1;
+    };
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_STRIP_ARRAY_H_
@@ -0,0 +1,75 @@
+#ifndef _GP_GUI_TESSELLATOR_H_
+#define _GP_GUI_TESSELLATOR_H_
+
+/// @file    gp_gui_tessellator.h
+/// @brief   Batched refinement of indexed triangle meshes by edge midpoint subdivision
+/// @note    Splitting is decided per edge, never per triangle, so both triangles of an edge agree on its midpoint and
+/// the output has no T-junctions. A triangle with 3 split edges becomes 4, with 2 or 1 split edges it is closed with
+/// 3 or 2 triangles. Midpoints are shared through an edge -> midpoint table and appended after the input vertices,
+/// which keep their IDs, so other index buffers into the same vertices stay valid.
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../Viewers/export.h"
+
+namespace GridPro_GFX {
+
+    /// @brief Controls for a refinement pass
+    struct LIB_API TessellationOptions
+    {
+        /// @brief Maximum number of subdivision rounds (a triangle becomes at most 4^max_level triangles)
+        uint32_t max_level;
+
+        /// @brief Adaptive : only edges longer than this are split (0 disables the length test)
+        float max_edge_length;
+
+        /// @brief Adaptive : only edges whose end normals differ by more than this many degrees are split (0 disables
+        /// the curvature test, needs vertex normals)
+        float max_normal_angle;
+
+        /// @note  With both tests disabled every edge of the selected triangles is split, max_level times
+        TessellationOptions() : max_level(2), max_edge_length(0.0f), max_normal_angle(0.0f) {}
+    };
+
+    /// @brief Refined mesh. Vertex arrays start with the input vertices, midpoints follow
+    struct LIB_API TessellationResult
+    {
+        std::vector<float>    positions;
+        std::vector<float>    normals;      ///< interpolated and renormalized, empty without input normals
+        std::vector<uint8_t>  colors;       ///< averaged, empty without input colors
+        std::vector<uint32_t> indices;
+
+        /// @brief Input triangle every output triangle was cut from
+        std::vector<uint32_t> source_triangles;
+
+        size_t get_num_triangles() const        { return source_triangles.size(); }
+    };
+
+namespace Tessellator {
+
+    /// @brief Input mesh of a refinement pass (arrays are only read)
+    struct LIB_API TriangleMesh
+    {
+        const float*    positions        = nullptr;   ///< xyz per vertex
+        size_t          num_vertices     = 0;
+        const float*    normals          = nullptr;   ///< xyz per vertex, or nullptr
+        const uint8_t*  colors           = nullptr;   ///< color_components bytes per vertex, or nullptr
+        size_t          color_components = 4;
+        const uint32_t* indices          = nullptr;   ///< 3 per triangle, nullptr for 3 consecutive vertices per triangle
+        size_t          num_triangles    = 0;
+    };
+
+    /// @brief Refine the selected triangles of a mesh, in parallel
+    /// @param selected_triangles  triangles to refine, empty for all. Unselected neighbours are only split where
+    /// needed to stay crack free
+    /// @throws std::runtime_error if an index or a selected triangle is out of range
+    LIB_API TessellationResult tessellate(const TriangleMesh& mesh, const TessellationOptions& options,
+                                          const std::vector<uint32_t>& selected_triangles = std::vector<uint32_t>());
+
+} // namespace Tessellator
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_TESSELLATOR_H_
@@ -0,0 +1,55 @@
+#ifndef _GP_GUI_TRIANGULATOR_H_
+#define _GP_GUI_TRIANGULATOR_H_
+
+/// @file    gp_gui_triangulator.h
+/// @brief   Conversion of quads, quad strips and polygons into indexed triangles for the core profile drivers
+/// @note    The triangles index the vertex array of the source primitive set, nothing is duplicated. Every triangle
+/// remembers the primitive it was cut from so picking and highlighting keep reporting the original primitive IDs.
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "../Viewers/export.h"
+
+namespace GridPro_GFX {
+
+    /// @brief Indexed triangle form of a QUADS, QUAD_STRIP or POLYGON primitive set
+    struct LIB_API Triangulation
+    {
+        /// @brief Triangles indexing the vertex array of the source primitive set
+        std::vector<uint32_t> indices;
+
+        /// @brief Original primitive of every triangle (gl_PrimitiveID of the triangles -> primitive ID of the set)
+        std::vector<uint32_t> primitive_ids;
+
+        /// @brief Outline of the original primitives as GL_LINES, without the diagonals added by the triangulation
+        std::vector<uint32_t> edge_indices;
+
+        size_t get_num_triangles() const        { return primitive_ids.size(); }
+    };
+
+namespace Triangulator {
+
+    /// @brief Split every quad along its shorter diagonal
+    /// @param corners  4 vertex indices per quad, nullptr for non indexed quads (4 consecutive vertices per quad)
+    /// @note  Quads are independent, they are split in parallel
+    LIB_API Triangulation triangulate_quads(const uint32_t* corners, const size_t& num_quads,
+                                            const float* positions, const size_t& num_vertices, const size_t& stride_bytes);
+
+    /// @brief Triangulate a GL_QUAD_STRIP : quad i is (v[2i], v[2i+1], v[2i+3], v[2i+2])
+    /// @param strip  vertex indices of the strip, nullptr for a non indexed strip
+    LIB_API Triangulation triangulate_quad_strip(const uint32_t* strip, const size_t& num_strip_vertices,
+                                                 const float* positions, const size_t& num_vertices, const size_t& stride_bytes);
+
+    /// @brief Ear clip a GL_POLYGON (one simple, possibly concave, planar polygon). Every triangle maps to primitive 0
+    /// @param loop  vertex indices of the polygon boundary, nullptr for a non indexed polygon
+    /// @note  The polygon is projected on the plane of its Newell normal. Triangles keep the winding of the boundary
+    LIB_API Triangulation triangulate_polygon(const uint32_t* loop, const size_t& num_loop_vertices,
+                                              const float* positions, const size_t& num_vertices, const size_t& stride_bytes);
+
+} // namespace Triangulator
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_TRIANGULATOR_H_
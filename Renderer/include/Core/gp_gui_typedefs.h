@@ -137,6 +137,11 @@ typedef double		    GLclampd;	/* double precision float in [0,1] */
 
 #endif
 
+/* Packed vertex formats (core since OpenGL 3.3, not part of the legacy headers) */
+#ifndef GL_INT_2_10_10_10_REV
+#define GL_INT_2_10_10_10_REV   0x8D9F
+#endif
+
 // Special Layers 
 
 #define GL_LAYER_HIDDEN      -1.0f
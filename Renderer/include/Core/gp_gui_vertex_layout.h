@@ -0,0 +1,451 @@
+#ifndef _GP_GUI_VERTEX_LAYOUT_H_
+#define _GP_GUI_VERTEX_LAYOUT_H_
+
+/// @file    gp_gui_vertex_layout.h
+/// @brief   Compile time description of interleaved vertex formats
+/// @note    A layout is declared as a list of attribute tags, e.g. VertexLayout<Pos3f, Normal3f, Color4ub>.
+/// The stride, offsets and GL formats are evaluated at compile time and flattened into a
+/// VertexLayoutInfo that the render kernels consume at runtime without knowing the template.
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "gp_gui_typedefs.h"
+
+namespace GridPro_GFX {
+
+    /// @brief Semantic of a vertex attribute
+    enum VertexAttribSemantic : uint8_t {
+        ATTRIB_POSITION = 0,
+        ATTRIB_NORMAL   = 1,
+        ATTRIB_COLOR    = 2,
+        ATTRIB_MAX      = 3
+    };
+
+    /*
+     * Attribute Tags
+     */
+
+    /// @brief 3 component float position
+    struct Pos3f {
+        using value_type = float;
+        static constexpr VertexAttribSemantic semantic = ATTRIB_POSITION;
+        static constexpr uint32_t components = 3;
+        static constexpr GLenum   gl_type    = GL_FLOAT;
+        static constexpr bool     normalized = false;
+        static constexpr uint32_t size       = components * sizeof(value_type);
+    };
+
+    /// @brief 3 component float normal
+    struct Normal3f {
+        using value_type = float;
+        static constexpr VertexAttribSemantic semantic = ATTRIB_NORMAL;
+        static constexpr uint32_t components = 3;
+        static constexpr GLenum   gl_type    = GL_FLOAT;
+        static constexpr bool     normalized = false;
+        static constexpr uint32_t size       = components * sizeof(value_type);
+    };
+
+    /// @brief RGB unsigned byte color
+    struct Color3ub {
+        using value_type = uint8_t;
+        static constexpr VertexAttribSemantic semantic = ATTRIB_COLOR;
+        static constexpr uint32_t components = 3;
+        static constexpr GLenum   gl_type    = GL_UNSIGNED_BYTE;
+        static constexpr bool     normalized = false;
+        static constexpr uint32_t size       = components * sizeof(value_type);
+    };
+
+    /// @brief RGBA unsigned byte color
+    struct Color4ub {
+        using value_type = uint8_t;
+        static constexpr VertexAttribSemantic semantic = ATTRIB_COLOR;
+        static constexpr uint32_t components = 4;
+        static constexpr GLenum   gl_type    = GL_UNSIGNED_BYTE;
+        static constexpr bool     normalized = false;
+        static constexpr uint32_t size       = components * sizeof(value_type);
+    };
+
+    /*
+     * Compressed Attribute Tags (decoded by the vertex fetch / vertex shader)
+     */
+
+    /// @brief 3 component 16 bit position, normalized to [0, 1] inside the quantization box
+    /// @note  Padded to 8 bytes so the following attributes stay 4 byte aligned
+    struct Pos3us {
+        using value_type = uint16_t;
+        static constexpr VertexAttribSemantic semantic = ATTRIB_POSITION;
+        static constexpr uint32_t components = 3;
+        static constexpr GLenum   gl_type    = GL_UNSIGNED_SHORT;
+        static constexpr bool     normalized = true;
+        static constexpr uint32_t size       = 4 * sizeof(value_type);
+    };
+
+    /// @brief Normal packed into 10:10:10:2 signed normalized integers
+    struct Normal3i10 {
+        using value_type = uint32_t;
+        static constexpr VertexAttribSemantic semantic = ATTRIB_NORMAL;
+        static constexpr uint32_t components = 4;
+        static constexpr GLenum   gl_type    = GL_INT_2_10_10_10_REV;
+        static constexpr bool     normalized = true;
+        static constexpr uint32_t size       = sizeof(value_type);
+    };
+
+    /// @brief RGBA unsigned byte color read as normalized floats
+    struct Color4unorm {
+        using value_type = uint8_t;
+        static constexpr VertexAttribSemantic semantic = ATTRIB_COLOR;
+        static constexpr uint32_t components = 4;
+        static constexpr GLenum   gl_type    = GL_UNSIGNED_BYTE;
+        static constexpr bool     normalized = true;
+        static constexpr uint32_t size       = components * sizeof(value_type);
+    };
+
+    /// @brief Runtime view of a single attribute inside an interleaved vertex
+    struct VertexAttribInfo {
+        VertexAttribSemantic semantic;
+        uint32_t components;
+        GLenum   gl_type;
+        bool     normalized;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    /// @brief Runtime view of a VertexLayout (what the VAOs actually read)
+    struct VertexLayoutInfo {
+        uint32_t stride = 0;
+        uint32_t num_attribs = 0;
+        std::array<VertexAttribInfo, ATTRIB_MAX> attribs = {};
+
+        /// @brief Get the attribute with a given semantic
+        /// @return nullptr if the layout does not carry the attribute
+        const VertexAttribInfo* find(VertexAttribSemantic semantic) const
+        {
+            for(uint32_t i = 0; i < num_attribs; ++i)
+                if(attribs[i].semantic == semantic) return &attribs[i];
+            return nullptr;
+        }
+
+        bool has(VertexAttribSemantic semantic) const { return find(semantic) != nullptr; }
+    };
+
+    namespace detail {
+
+        template<typename... Attribs>
+        struct attrib_pack_size;
+
+        template<>
+        struct attrib_pack_size<> { static constexpr uint32_t value = 0; };
+
+        template<typename First, typename... Rest>
+        struct attrib_pack_size<First, Rest...> {
+            static constexpr uint32_t value = First::size + attrib_pack_size<Rest...>::value;
+        };
+
+        template<typename Target, typename... Attribs>
+        struct attrib_offset;
+
+        template<typename Target>
+        struct attrib_offset<Target> { static constexpr uint32_t value = 0; static constexpr bool found = false; };
+
+        template<typename Target, typename First, typename... Rest>
+        struct attrib_offset<Target, First, Rest...> {
+            static constexpr bool found = std::is_same<Target, First>::value || attrib_offset<Target, Rest...>::found;
+            static constexpr uint32_t value = std::is_same<Target, First>::value ? 0 :
+                                              First::size + attrib_offset<Target, Rest...>::value;
+        };
+
+        template<VertexAttribSemantic S, typename... Attribs>
+        struct semantic_count;
+
+        template<VertexAttribSemantic S>
+        struct semantic_count<S> { static constexpr uint32_t value = 0; };
+
+        template<VertexAttribSemantic S, typename First, typename... Rest>
+        struct semantic_count<S, First, Rest...> {
+            static constexpr uint32_t value = (First::semantic == S ? 1 : 0) + semantic_count<S, Rest...>::value;
+        };
+
+        template<typename First, typename... Rest>
+        constexpr VertexAttribSemantic first_semantic() { return First::semantic; }
+
+        /// @brief Check that every attribute starts at a multiple of its component size
+        template<typename... Attribs>
+        constexpr bool attribs_aligned()
+        {
+            constexpr uint32_t sizes[]      = { Attribs::size... };
+            constexpr uint32_t alignments[] = { uint32_t(sizeof(typename Attribs::value_type))... };
+            uint32_t offset = 0;
+            for(size_t i = 0; i < sizeof...(Attribs); ++i)
+            {
+                if(offset % alignments[i] != 0) return false;
+                offset += sizes[i];
+            }
+            return true;
+        }
+    }
+
+    /// @brief Compile time vertex schema
+    /// @note  Position must be the first attribute so that a vertex can be addressed as float[3] (get_vertex_ref)
+    /// @note  Byte sized attributes (colors) have to come after the wider attributes to keep them aligned
+    template<typename... Attribs>
+    struct VertexLayout {
+        static_assert(sizeof...(Attribs) > 0 && sizeof...(Attribs) <= ATTRIB_MAX, "VertexLayout needs 1 to 3 attributes");
+        static_assert(detail::semantic_count<ATTRIB_POSITION, Attribs...>::value == 1, "VertexLayout needs exactly one position attribute");
+        static_assert(detail::semantic_count<ATTRIB_NORMAL,   Attribs...>::value <= 1, "VertexLayout can have at most one normal attribute");
+        static_assert(detail::semantic_count<ATTRIB_COLOR,    Attribs...>::value <= 1, "VertexLayout can have at most one color attribute");
+        static_assert(detail::first_semantic<Attribs...>() == ATTRIB_POSITION, "The position has to be the first attribute of a VertexLayout");
+        static_assert(detail::attribs_aligned<Attribs...>(), "VertexLayout attribute is misaligned. Put the color attribute last");
+
+        /// @brief Packed size of all the attributes
+        static constexpr uint32_t packed_size = detail::attrib_pack_size<Attribs...>::value;
+
+        /// @brief Size in bytes of one vertex (padded to 4 bytes)
+        static constexpr uint32_t stride = (packed_size + 3u) & ~3u;
+
+        static constexpr uint32_t num_attribs = sizeof...(Attribs);
+
+        /// @brief Byte offset of an attribute inside the vertex
+        template<typename Attrib>
+        static constexpr uint32_t offset_of()
+        {
+            static_assert(detail::attrib_offset<Attrib, Attribs...>::found, "Attribute is not part of this VertexLayout");
+            return detail::attrib_offset<Attrib, Attribs...>::value;
+        }
+
+        template<typename Attrib>
+        static constexpr bool has() { return detail::attrib_offset<Attrib, Attribs...>::found; }
+
+        static constexpr bool has(VertexAttribSemantic semantic)
+        {
+            return semantic == ATTRIB_POSITION ? true :
+                   semantic == ATTRIB_NORMAL   ? detail::semantic_count<ATTRIB_NORMAL, Attribs...>::value != 0 :
+                   semantic == ATTRIB_COLOR    ? detail::semantic_count<ATTRIB_COLOR,  Attribs...>::value != 0 : false;
+        }
+
+        /// @brief One vertex of this layout as a plain byte block
+        struct Vertex {
+            uint8_t bytes[stride];
+
+            template<typename Attrib>
+            typename Attrib::value_type* get()
+            { return reinterpret_cast<typename Attrib::value_type*>(bytes + offset_of<Attrib>()); }
+
+            template<typename Attrib>
+            const typename Attrib::value_type* get() const
+            { return reinterpret_cast<const typename Attrib::value_type*>(bytes + offset_of<Attrib>()); }
+        };
+
+        /// @brief Flatten the layout into its runtime description
+        static VertexLayoutInfo info()
+        {
+            VertexLayoutInfo layout_info;
+            layout_info.stride = stride;
+            layout_info.num_attribs = num_attribs;
+            uint32_t i = 0;
+            int expand[] = { 0, (layout_info.attribs[i++] = VertexAttribInfo{ Attribs::semantic, Attribs::components, Attribs::gl_type, Attribs::normalized,
+                                                                              offset_of<Attribs>(), Attribs::size }, 0)... };
+            (void)expand;
+            return layout_info;
+        }
+    };
+
+    /// @brief Interleaved vertex storage described by a VertexLayoutInfo
+    /// @note  The byte block is uploaded to the GPU as is. No repacking happens at upload time.
+    /// @note  The bytes are either owned or adopted from external memory (see adopt()). Copies are always owned.
+    class InterleavedVertexArray {
+    public:
+        /// @brief Called with the adopted pointer once no array references the external memory any more
+        using ReleaseCallback = std::function<void(void*)>;
+
+        InterleavedVertexArray() = default;
+        explicit InterleavedVertexArray(const VertexLayoutInfo& in_layout) : m_layout(in_layout) {}
+
+        /// @brief Copying an adopted array copies the vertices into owned storage
+        InterleavedVertexArray(const InterleavedVertexArray& other)
+            : m_layout(other.m_layout), m_bytes(other.data(), other.data() + other.size_bytes()) {}
+
+        InterleavedVertexArray(InterleavedVertexArray&& other) noexcept { swap(other); }
+
+        InterleavedVertexArray& operator=(InterleavedVertexArray other) { swap(other); return *this; }
+
+        void swap(InterleavedVertexArray& other) noexcept
+        {
+            std::swap(m_layout, other.m_layout);
+            m_bytes.swap(other.m_bytes);
+            std::swap(m_external, other.m_external);
+            std::swap(m_external_size, other.m_external_size);
+            m_external_owner.swap(other.m_external_owner);
+        }
+
+        /// @brief Wrap externally owned vertices without copying them
+        /// @note  The memory must stay valid until release is called. Anything that grows the array first moves
+        /// the vertices into owned storage, which also releases the external memory
+        static InterleavedVertexArray adopt(const VertexLayoutInfo& in_layout, void* vertices, size_t num_vertices, ReleaseCallback release)
+        {
+            std::shared_ptr<const void> owner(vertices, [release](const void* ptr) { if(release) release(const_cast<void*>(ptr)); });
+            return adopt(in_layout, vertices, num_vertices, std::move(owner));
+        }
+
+        /// @brief Wrap externally owned vertices kept alive by an owner handle (e.g. the object that mapped a file)
+        static InterleavedVertexArray adopt(const VertexLayoutInfo& in_layout, void* vertices, size_t num_vertices, std::shared_ptr<const void> owner)
+        {
+            InterleavedVertexArray adopted(in_layout);
+            adopted.m_external       = static_cast<uint8_t*>(vertices);
+            adopted.m_external_size  = num_vertices * in_layout.stride;
+            adopted.m_external_owner = std::move(owner);
+            return adopted;
+        }
+
+        /// @brief Check if the vertices live in adopted external memory
+        bool isAdopted() const                 { return m_external != nullptr; }
+
+        const VertexLayoutInfo& layout() const { return m_layout; }
+        uint32_t stride() const                { return m_layout.stride; }
+
+        /// @brief Number of vertices stored
+        size_t size() const       { return m_layout.stride ? size_bytes() / m_layout.stride : 0; }
+        size_t size_bytes() const { return m_external ? m_external_size : m_bytes.size(); }
+        bool   empty() const      { return size_bytes() == 0; }
+
+        uint8_t*       data()       { return m_external ? m_external : m_bytes.data(); }
+        const uint8_t* data() const { return m_external ? m_external : m_bytes.data(); }
+
+        std::vector<uint8_t>&       bytes()       { own_storage(); return m_bytes; }
+        const std::vector<uint8_t>& bytes() const { return m_bytes; }
+
+        void reserve(size_t num_vertices) { own_storage(); m_bytes.reserve(num_vertices * m_layout.stride); }
+        void resize(size_t num_vertices)  { own_storage(); m_bytes.resize(num_vertices * m_layout.stride); }
+        void clear()                      { release_external(); m_bytes.clear(); }
+
+        /// @brief Append raw vertices (must already match the layout)
+        void append(const void* vertices, size_t num_vertices)
+        {
+            own_storage();
+            const uint8_t* src = static_cast<const uint8_t*>(vertices);
+            m_bytes.insert(m_bytes.end(), src, src + num_vertices * m_layout.stride);
+        }
+
+        /// @brief Pointer to a vertex attribute, nullptr if the layout has no such attribute
+        template<typename T = float>
+        T* attrib(size_t vertex_id, VertexAttribSemantic semantic)
+        {
+            const VertexAttribInfo* attrib_info = m_layout.find(semantic);
+            if(attrib_info == nullptr) return nullptr;
+            return reinterpret_cast<T*>(data() + vertex_id * m_layout.stride + attrib_info->offset);
+        }
+
+        template<typename T = float>
+        const T* attrib(size_t vertex_id, VertexAttribSemantic semantic) const
+        {
+            const VertexAttribInfo* attrib_info = m_layout.find(semantic);
+            if(attrib_info == nullptr) return nullptr;
+            return reinterpret_cast<const T*>(data() + vertex_id * m_layout.stride + attrib_info->offset);
+        }
+
+        /// @brief Position of a vertex (position is always at offset 0)
+        /// @note  Only valid for Pos3f layouts
+        float*       position(size_t vertex_id)       { return reinterpret_cast<float*>(data() + vertex_id * m_layout.stride); }
+        const float* position(size_t vertex_id) const { return reinterpret_cast<const float*>(data() + vertex_id * m_layout.stride); }
+
+        /// @brief Gather vertices through an index list into a new array (used to flatten indexed sets)
+        InterleavedVertexArray gather(const std::vector<uint32_t>& in_indices) const
+        {
+            InterleavedVertexArray flattened(m_layout);
+            flattened.resize(in_indices.size());
+            const uint32_t vertex_stride = m_layout.stride;
+            for(size_t i = 0; i < in_indices.size(); ++i)
+                std::memcpy(flattened.m_bytes.data() + i * vertex_stride, data() + size_t(in_indices[i]) * vertex_stride, vertex_stride);
+            return flattened;
+        }
+
+    private:
+        /// @brief Move adopted vertices into owned storage before the array changes size
+        void own_storage()
+        {
+            if(m_external == nullptr) return;
+            m_bytes.assign(m_external, m_external + m_external_size);
+            release_external();
+        }
+
+        void release_external()
+        {
+            m_external = nullptr;
+            m_external_size = 0;
+            m_external_owner.reset();
+        }
+
+        VertexLayoutInfo     m_layout;
+        std::vector<uint8_t> m_bytes;
+
+        /// @brief Adopted external memory (nullptr when the bytes are owned)
+        uint8_t*                    m_external = nullptr;
+        size_t                      m_external_size = 0;
+        std::shared_ptr<const void> m_external_owner;
+    };
+
+    /// @brief Compressed GPU layouts. Used as upload formats only, the CPU side data stays in floats
+    using QuantizedLayout_P   = VertexLayout<Pos3us>;
+    using QuantizedLayout_PN  = VertexLayout<Pos3us, Normal3i10>;
+    using QuantizedLayout_PC  = VertexLayout<Pos3us, Color4unorm>;
+    using QuantizedLayout_PNC = VertexLayout<Pos3us, Normal3i10, Color4unorm>;
+
+    /// @brief Maps positions into / out of the 16 bit quantization box of a primitive set
+    /// @note  The vertex shader reconstructs the position as  pos = quantized * scale + offset
+    struct VertexQuantization {
+        std::array<float, 3> offset = {0.0f, 0.0f, 0.0f};
+        std::array<float, 3> scale  = {1.0f, 1.0f, 1.0f};
+
+        /// @brief Build the quantization box from a bounding box {min_x, min_y, min_z, max_x, max_y, max_z}
+        static VertexQuantization from_bounding_box(const std::array<float, 6>& bbox)
+        {
+            VertexQuantization quantization;
+            for(int axis = 0; axis < 3; ++axis)
+            {
+                const float extent = bbox[axis + 3] - bbox[axis];
+                quantization.offset[axis] = bbox[axis];
+                quantization.scale[axis]  = extent > 0.0f ? extent : 1.0f;
+            }
+            return quantization;
+        }
+
+        bool contains(const float& x, const float& y, const float& z) const
+        {
+            const float p[3] = {x, y, z};
+            for(int axis = 0; axis < 3; ++axis)
+                if(p[axis] < offset[axis] || p[axis] > offset[axis] + scale[axis]) return false;
+            return true;
+        }
+
+        void encode_position(const float* in_position, uint16_t* out_position) const
+        {
+            for(int axis = 0; axis < 3; ++axis)
+            {
+                float t = (in_position[axis] - offset[axis]) / scale[axis];
+                t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+                out_position[axis] = static_cast<uint16_t>(t * 65535.0f + 0.5f);
+            }
+            out_position[3] = 0;
+        }
+    };
+
+    /// @brief Pack a unit normal into GL_INT_2_10_10_10_REV (x in the low bits)
+    inline uint32_t pack_normal_2_10_10_10(const float& nx, const float& ny, const float& nz)
+    {
+        auto pack_snorm10 = [](float v) -> uint32_t {
+            v = v < -1.0f ? -1.0f : (v > 1.0f ? 1.0f : v);
+            const int32_t i = static_cast<int32_t>(v * 511.0f + (v < 0.0f ? -0.5f : 0.5f));
+            return static_cast<uint32_t>(i) & 0x3FFu;
+        };
+        return pack_snorm10(nx) | (pack_snorm10(ny) << 10) | (pack_snorm10(nz) << 20);
+    }
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_VERTEX_LAYOUT_H_
@@ -0,0 +1,40 @@
+#ifndef _GP_GUI_VERTEX_TRANSFORM_H_
+#define _GP_GUI_VERTEX_TRANSFORM_H_
+
+/// @file    gp_gui_vertex_transform.h
+/// @brief   Bulk in place transforms of xyz positions : translation, affine matrix and per vertex displacement
+/// @note    Positions are 3 floats at a byte stride (12 for packed arrays, the vertex stride for interleaved ones).
+/// Every kernel works on a contiguous range of vertices or on a list of vertex indices, uses SSE when the target
+/// has it and splits large inputs across threads.
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "../Viewers/export.h"
+
+namespace GridPro_GFX {
+
+namespace VertexTransform {
+
+    /// @brief Vertices per worker before a thread is spawned for it
+    constexpr size_t DEFAULT_GRAIN_SIZE = 1 << 15;
+
+    /// @param vertex_indices  vertices to move, nullptr for the contiguous vertices [0, num_vertices) from positions on
+    /// @warning Indices must be unique (a repeated index is moved twice, and from two threads)
+    LIB_API void translate(float* positions, const size_t& stride_bytes, const uint32_t* vertex_indices, const size_t& num_vertices,
+                           const std::array<float, 3>& translation);
+
+    /// @brief p = M * (p, 1) with M a column major 4x4 matrix (glm::mat4 memory layout), the last row is ignored
+    LIB_API void transform_affine(float* positions, const size_t& stride_bytes, const uint32_t* vertex_indices, const size_t& num_vertices,
+                                  const std::array<float, 16>& matrix);
+
+    /// @brief p_i += displacements[3i .. 3i+2]
+    LIB_API void displace(float* positions, const size_t& stride_bytes, const uint32_t* vertex_indices, const size_t& num_vertices,
+                          const float* displacements);
+
+} // namespace VertexTransform
+
+} // namespace GridPro_GFX
+
+#endif // _GP_GUI_VERTEX_TRANSFORM_H_
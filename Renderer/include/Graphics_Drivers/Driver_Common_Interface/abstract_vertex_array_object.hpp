@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <vector>
 #include "gp_gui_typedefs.h"
+#include "gp_gui_vertex_layout.h"
 
 namespace gridpro_gpu_metrics
 {
@@ -25,6 +26,7 @@ namespace GridPro_GFX
               NormalData   = nullptr;
               ColorData    = nullptr;
               IndexData    = nullptr;
+              InterleavedData = nullptr;
               m_vao = (0);
               m_vbo = (0);
               m_ibo = (0);
@@ -49,6 +51,9 @@ namespace GridPro_GFX
        
        virtual void perform_micro_vertex_update(const uint32_t& vertex_id, const float& pos_x, const float& pos_y, const float& pos_z) = 0;       
 
+       /// @brief Upload only the byte ranges the primitive set marked dirty, then clear them
+       virtual void upload_dirty_ranges() = 0;
+
        virtual void delete_vbo() = 0;
        virtual void delete_ibo() = 0;
        virtual void delete_vao() = 0;
@@ -58,8 +63,11 @@ namespace GridPro_GFX
        uint32_t get_vbo_size() const    { return m_vbo_curr_size; }
 
        /// @brief Get which vertex attribute data is present
-       bool has_normal_attrib() const { return (NormalData != nullptr && NormalData->size()) ? 1 : 0; }
-       bool has_color_attrib()  const { return (ColorData  != nullptr && ColorData->size())  ? 1 : 0; }
+       bool has_normal_attrib() const { return is_interleaved() ? InterleavedData->layout().has(ATTRIB_NORMAL) : (NormalData != nullptr && NormalData->size()) ? 1 : 0; }
+       bool has_color_attrib()  const { return is_interleaved() ? InterleavedData->layout().has(ATTRIB_COLOR)  : (ColorData  != nullptr && ColorData->size())  ? 1 : 0; }
+
+       /// @brief Get if the vertex data is a single interleaved array
+       bool is_interleaved() const    { return InterleavedData != nullptr; }
        
        /// @brief Get if element array buffer is present
        bool has_index_data() const    { return (IndexData != nullptr  && IndexData->size())  ? 1 : 0; }
@@ -80,6 +88,9 @@ namespace GridPro_GFX
        std::vector<GLubyte>*  ColorData;
        std::vector<uint32_t>* IndexData;
 
+       /// @brief Interleaved vertex data (nullptr when the attributes are stored separately)
+       InterleavedVertexArray* InterleavedData;
+
        std::vector<GLfloat>  DummyData1;
        std::vector<GLubyte>  DummyData2;
        std::vector<uint32_t> DummyData3;
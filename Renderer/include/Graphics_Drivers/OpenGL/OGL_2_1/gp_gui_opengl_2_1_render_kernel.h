@@ -38,14 +38,23 @@ namespace GridPro_GFX
         void init();
         void reset();
         void execute_draw_command(const GLenum &primitive_type = GL_NONE_NULL);
+        void draw_instances(const GLenum& primitive_type);
+        void draw_prototype(const GLenum& primitive_type);
         void point_mode_draw();
         void set_rasteriser_state();
         void reset_rasteriser_state();
         void set_blend_state();
         void set_depth_test();
+        size_t select_lod_level();
 
         // Member Variables
         std::shared_ptr<OpenGL_2_1::VertexArrayObject> m_vao;
+
+        /// @brief Set between set_rasteriser_state and reset_rasteriser_state of a wireframe pass
+        bool is_drawing_wireframe = false;
+
+        /// @brief Set for the display passes of a set drawn with its per primitive colors
+        bool is_using_primitive_colors = false;
     };
 }
 
@@ -1,7 +1,12 @@
 #ifndef GP_GUI_OPENGL_2_1_VERTEX_ARRAY_OBJECT_H
 #define GP_GUI_OPENGL_2_1_VERTEX_ARRAY_OBJECT_H
 
+#include <memory>
 #include "abstract_vertex_array_object.hpp"
+#include "gp_gui_mesh_simplifier.h"
+#include "gp_gui_index_buffer.h"
+#include "gp_gui_primitive_color_array.h"
+#include "gp_gui_strip_array.h"
 
 namespace GridPro_GFX
 {
@@ -23,11 +28,33 @@ namespace OpenGL_2_1
 
        void perform_micro_vertex_update(const uint32_t& vertex_id, const float& pos_x, const float& pos_y, const float& pos_z);       
 
+       void upload_dirty_ranges();
+
        void update_vertex_attributes(std::vector<float>* position_data, std::vector<float>* normal_data, std::vector<GLubyte>* color_data) ;
        void update_indices(std::vector<uint32_t>* index_data);
        void generate_unique_color_array();
        void set_selection_array_mode(const bool& selection_mode) { is_in_selection_mode = selection_mode; }
 
+       /// @brief Draw the next bind with the per primitive colors (reset by unbind)
+       /// @note  There is no gl_PrimitiveID in 2.1 : the colors are expanded onto the vertices, and indexed sets are
+       /// drawn from unshared copies of their vertices with glDrawArrays
+       void set_primitive_color_mode(const bool& primitive_color_mode) { is_in_primitive_color_mode = primitive_color_mode; }
+
+       /// @brief Indices of the primitive set in the narrowest type for its vertex count, refreshed on bind
+       const CompactIndexArray& get_indices() const { return m_compact_indices; }
+
+       /// @brief Indices of a simplified level (1 based) in the narrowest type, empty if the set has no such level
+       /// @note  The last level drawn stays cached with the LOD chain it came from
+       const CompactIndexArray& get_lod_indices(const size_t& level);
+
+       /// @brief Draw lists of a multi strip set for glMultiDrawArrays / glMultiDrawElements, refreshed on bind
+       /// @note  The firsts also address the unshared vertices drawn for selection and per primitive colors, which
+       /// keep the vertex order of the indices
+       GLsizei get_num_strips() const                  { return static_cast<GLsizei>(m_strip_counts.size()); }
+       const GLint*   get_strip_firsts() const         { return m_strip_firsts.data(); }
+       const GLsizei* get_strip_counts() const         { return m_strip_counts.data(); }
+       const void* const* get_strip_index_pointers() const { return m_strip_index_pointers.data(); }
+
        private :
        /// @brief Calculate the offsets for the vertex attributes
        void calculate_offsets();
@@ -39,10 +66,54 @@ namespace OpenGL_2_1
        void delete_vbo();
        void delete_ibo();
        void delete_vao();
+
+       /// @brief Re-encode the client side indices if the index array was replaced, resized or its vertex count changed
+       void update_compact_indices();
+
+       /// @brief Expand the per primitive colors (and unshare the vertices of indexed sets) if anything they depend on changed
+       void update_primitive_color_arrays();
+
+       /// @brief Rebuild the strip draw lists if the strips were edited or the client indices moved
+       void update_strip_draw_lists();
+
+       /// @brief De-index the positions (or xyz floats at base with stride_bytes) through the client indices, read
+       /// in their narrow type
+       void gather_indexed_positions(std::vector<float>& positions);
+       void gather_indexed_vec3(const uint8_t* base, const size_t& stride_bytes, std::vector<float>& out);
+
        uint32_t last_init_id, last_pick_entity_count, last_pick_vertices_per_primitve_count;
+       uint32_t last_pick_strip_version = 0;
+       GLenum last_pick_primitive_type = GL_POINTS;
        bool is_in_selection_mode;
        std::vector<GLubyte> m_unique_color_array;
        std::vector<float> flattened_vertex_array;
+
+       /// @brief Client side index arrays handed to glDrawElements, 16 bit for sets below 65536 vertices
+       CompactIndexArray m_compact_indices;
+       const std::vector<uint32_t>* m_compact_indices_source = nullptr;
+       CompactIndexArray m_compact_lod_indices;
+       std::shared_ptr<const std::vector<LodLevel>> m_compact_lod_chain;
+       size_t m_compact_lod_level = 0;
+
+       /// @brief One color per drawn vertex, and the unshared positions and normals of indexed sets
+       bool is_in_primitive_color_mode = false;
+       bool is_primitive_color_expansion_stale = true;
+       std::vector<GLubyte> m_expanded_colors;
+       std::vector<float>   m_expanded_positions;
+       std::vector<float>   m_expanded_normals;
+       std::shared_ptr<const PrimitiveColorArray> m_primitive_colors;
+       uint32_t m_primitive_color_version = 0;
+       const void* m_expanded_vertex_source = nullptr;
+       const std::vector<uint32_t>* m_expanded_index_source = nullptr;
+       uint32_t m_expanded_strip_version = 0;
+
+       /// @brief First vertex, vertex count and client index pointer of every strip of a multi strip set
+       std::shared_ptr<const StripArray> m_strips;
+       uint32_t m_strip_version = 0;
+       std::vector<GLint>   m_strip_firsts;
+       std::vector<GLsizei> m_strip_counts;
+       std::vector<const void*> m_strip_index_pointers;
+       const void* m_strip_index_base = nullptr;
     };
 }
 }    
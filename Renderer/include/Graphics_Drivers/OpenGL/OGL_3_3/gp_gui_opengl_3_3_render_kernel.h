@@ -40,17 +40,28 @@ namespace GridPro_GFX
         void init();
         void reset();
         void execute_draw_command(const GLenum &primitive_type = GL_NONE_NULL);
+        void draw_elements(const GLenum& mode, const GLsizei& count, const GLenum& index_type, const void* offset);
+        void draw_arrays(const GLenum& mode, const GLint& first, const GLsizei& count);
         void point_mode_draw();
         void set_rasteriser_state();
         void reset_rasteriser_state();
         void set_blend_state();
         void set_depth_test();
+        void set_dequantization_uniforms();
+        void set_fill_color_uniforms(const bool& is_fill_pass);
+        size_t select_lod_level();
         OpenGL_3_3::Shader* get_shader(const char* shader_name);
 
         // Member Variables
         OpenGL_3_3::Shader* m_shader;
         std::shared_ptr<OpenGL_3_3::VertexArrayObject> m_vao;
         std::shared_ptr<OpenGL_3_3::OpenGLTexture>     m_texture;
+
+        /// @brief Set between set_rasteriser_state and reset_rasteriser_state of a wireframe pass
+        bool is_drawing_wireframe = false;
+
+        /// @brief Set for the display passes of a set drawn with its per primitive colors
+        bool is_using_primitive_colors = false;
     };
 }
 
@@ -1,13 +1,24 @@
 #ifndef GP_GUI_OPENGL_3_3_VERTEX_ARRAY_OBJECT_H
 #define GP_GUI_OPENGL_3_3_VERTEX_ARRAY_OBJECT_H
 
+#include <memory>
 #include "abstract_vertex_array_object.hpp"
+#include "gp_gui_mesh_simplifier.h"
+#include "gp_gui_triangulator.h"
+#include "gp_gui_index_buffer.h"
+#include "gp_gui_instance_array.h"
+#include "gp_gui_primitive_color_array.h"
+#include "gp_gui_strip_array.h"
 
 namespace GridPro_GFX
 {
 
 namespace OpenGL_3_3
 {
+    /// @brief Attribute locations of the per instance data, the vertex attributes use 0 to 2 (see gp_gui_shader_src.h)
+    /// @note  The transform takes 4 consecutive locations, one vec3 column each
+    constexpr uint32_t INSTANCE_TRANSFORM_LOCATION = 4;
+    constexpr uint32_t INSTANCE_COLOR_LOCATION     = 8;
 
     class VertexArrayObject : public Abstract_VertexArrayObject
     {
@@ -23,9 +34,63 @@ namespace OpenGL_3_3
 
        void perform_micro_vertex_update(const uint32_t& vertex_id, const float& pos_x, const float& pos_y, const float& pos_z);       
 
+       void upload_dirty_ranges();
+
        void update_vertex_attributes(std::vector<float>* position_data, std::vector<float>* normal_data, std::vector<GLubyte>* color_data) ;
        void update_indices(std::vector<uint32_t>* index_data);
 
+       /// @brief GL type of the index buffer (GL_UNSIGNED_SHORT when the set has fewer than 65536 vertices)
+       GLenum get_index_type() const                          { return m_index_type; }
+
+       /// @brief Check if the VBO holds the compressed vertex format
+       bool is_quantized() const                              { return m_is_quantized; }
+
+       /// @brief Quantization box used to decode the positions in the vertex shader
+       const VertexQuantization& get_vertex_quantization() const { return m_quantization; }
+
+       /// @brief Bind the index buffer holding the simplified levels and get the range of one level
+       /// @note  All levels share one buffer, created on first use. Call unbind_lod_level() after drawing
+       /// @return false if the primitive set has no such level
+       bool bind_lod_level(const size_t& level, GLsizei& count, size_t& byte_offset, GLenum& index_type);
+
+       /// @brief Restore the index buffer of the full resolution level
+       void unbind_lod_level();
+
+       /// @brief Bind the triangles (or the GL_LINES outline) of a quad, quad strip or polygon set
+       /// @note  The set is triangulated and the buffers created on first use. Call unbind_triangulation() after drawing
+       /// @return false if the primitive set does not need a triangulation
+       bool bind_triangulation(const bool& outline, GLsizei& count, GLenum& index_type);
+
+       /// @brief Restore the index buffer of the primitive set
+       void unbind_triangulation()                            { unbind_lod_level(); }
+
+       /// @brief Bind the strips of a multi strip set as one restart index list (see gp_gui_strip_array.h)
+       /// @note  The list is built on first use and after every strip or index edit. Draw it with primitive restart
+       /// enabled at primitive_restart_index(index_type), then call unbind_strips()
+       /// @return false if the primitive set is not a multi strip set
+       bool bind_strips(GLsizei& count, GLenum& index_type);
+
+       /// @brief Restore the index buffer of the primitive set
+       void unbind_strips()                                   { unbind_lod_level(); }
+
+       /// @brief Bind the gl_PrimitiveID -> primitive ID table as a usamplerBuffer on a texture unit
+       /// @note  Triangles of a triangulation map to the primitive they were cut from, segments and triangles of a
+       /// multi strip set to their strip
+       /// @return false if the primitive set has neither a triangulation nor strips
+       bool bind_primitive_remap(const uint32_t& texture_unit);
+       void unbind_primitive_remap(const uint32_t& texture_unit);
+
+       /// @brief Bind the per primitive colors as a samplerBuffer (GL_RGBA8) on a texture unit, uploaded when they changed
+       /// @return false if the primitive set is not drawn with per primitive colors
+       bool bind_primitive_colors(const uint32_t& texture_unit);
+       void unbind_primitive_colors(const uint32_t& texture_unit)   { unbind_primitive_remap(texture_unit); }
+
+       /// @brief Number of instances to draw (uploaded by bind), 0 if the primitive set is not instanced
+       GLsizei get_num_instances() const                      { return m_num_instances; }
+
+       /// @brief Check if the instances carry their own colors
+       bool hasInstanceColors() const                         { return m_has_instance_colors; }
+
        private :
        /// @brief Calculate the offsets for the vertex attributes
        void calculate_offsets();
@@ -33,10 +98,87 @@ namespace OpenGL_3_3
        /// @brief Create the vertex buffer object
        void create_vbo();
        void create_ibo();
+
+       /// @brief Set the attribute pointers of an interleaved VBO from its layout
+       void set_interleaved_attrib_pointers();
+
+       /// @brief Encode the primitive set into the compressed vertex format (uploaded through the interleaved path)
+       void quantize_vertex_attributes();
+
+       /// @brief Re-encode and upload the dirty vertices of a compressed VBO
+       void upload_dirty_quantized_ranges();
+
+       /// @brief Upload the dirty ranges of the index buffer
+       void upload_dirty_index_ranges();
        
+       /// @brief Upload every simplified level back to back into the level of detail index buffer
+       void create_lod_ibo();
+
        void delete_vbo();
        void delete_ibo();
        void delete_vao();
+       void delete_lod_ibo();
+
+       /// @brief Triangulate the primitive set if needed and upload the triangles, outline and primitive ID table
+       bool update_triangulation_buffers();
+       void delete_triangulation_buffers();
+
+       /// @brief Upload the per instance transforms and colors and point the instance attributes of the VAO at them
+       void update_instance_buffer();
+       void delete_instance_buffer();
+
+       void delete_primitive_color_buffer();
+
+       /// @brief Build and upload the restart index list and the primitive -> strip table of a multi strip set
+       bool update_strip_buffers();
+       void delete_strip_buffers();
+
+       /// @brief Index width of the index buffer, chosen from the vertex count when it is uploaded
+       GLenum m_index_type = GL_UNSIGNED_INT;
+
+       bool m_is_quantized = false;
+       VertexQuantization     m_quantization;
+       InterleavedVertexArray m_quantized_vertices;
+
+       /// @brief Index buffer of the simplified levels, first index and index count of every level
+       uint32_t m_lod_ibo = 0;
+       std::shared_ptr<const std::vector<LodLevel>> m_lod_chain;
+       std::vector<std::pair<size_t, size_t>> m_lod_ranges;
+       GLenum m_lod_index_type = GL_UNSIGNED_INT;
+
+       /// @brief Triangles, outline edges and triangle -> primitive ID texture buffer of quad and polygon sets
+       uint32_t m_triangle_ibo = 0;
+       uint32_t m_edge_ibo = 0;
+       uint32_t m_primitive_remap_tbo = 0;
+       uint32_t m_primitive_remap_texture = 0;
+       std::shared_ptr<const Triangulation> m_triangulation;
+       GLenum m_triangulation_index_type = GL_UNSIGNED_INT;
+
+       /// @brief Per instance transforms (then colors) of a prototype instancing set, divisor 1 attributes of m_instance_vao
+       uint32_t m_instance_vbo = 0;
+       uint32_t m_instance_vao = 0;
+       uint32_t m_instance_version = 0;
+       std::shared_ptr<const InstanceArray> m_instances;
+       GLsizei m_num_instances = 0;
+       bool m_has_instance_colors = false;
+
+       /// @brief Texture buffer of the per primitive colors and the version it holds
+       uint32_t m_primitive_color_tbo = 0;
+       uint32_t m_primitive_color_texture = 0;
+       uint32_t m_primitive_color_version = 0;
+       std::shared_ptr<const PrimitiveColorArray> m_primitive_colors;
+
+       /// @brief Restart index list and primitive -> strip texture buffer of a multi strip set, with the strip version,
+       /// index count and vertex count they were built for (index edits reset m_strip_version)
+       uint32_t m_strip_ibo = 0;
+       uint32_t m_strip_remap_tbo = 0;
+       uint32_t m_strip_remap_texture = 0;
+       uint32_t m_strip_version = 0;
+       size_t   m_strip_num_indices = 0;
+       size_t   m_strip_num_positions = 0;
+       GLsizei  m_strip_list_size = 0;
+       GLenum   m_strip_index_type = GL_UNSIGNED_INT;
+       std::shared_ptr<const StripArray> m_strips;
     };
 }
 }    
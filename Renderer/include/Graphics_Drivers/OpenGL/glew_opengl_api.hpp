@@ -148,11 +148,26 @@ class GLEW_OpenGLFunctions_4_1_Core
         ::glDrawElements(mode, count, type, indices);
     }
 
+    void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+    {
+        ::glDrawArraysInstanced(mode, first, count, instancecount);
+    }
+
+    void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei instancecount)
+    {
+        ::glDrawElementsInstanced(mode, count, type, indices, instancecount);
+    }
+
     void glDrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const GLvoid *indices)
     {
         ::glDrawRangeElements(mode, start, end, count, type, indices);
     }
 
+    void glPrimitiveRestartIndex(GLuint index)
+    {
+        ::glPrimitiveRestartIndex(index);
+    }
+
     void glGenVertexArrays(GLsizei n, GLuint *arrays)
     {
         ::glGenVertexArrays(n, arrays);
@@ -243,6 +258,11 @@ class GLEW_OpenGLFunctions_4_1_Core
         ::glBindTexture(target, texture);
     }
 
+    void glTexBuffer(GLenum target, GLenum internalformat, GLuint buffer)
+    {
+        ::glTexBuffer(target, internalformat, buffer);
+    }
+
     void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *data)
     {
         ::glTexImage2D(target, level, internalformat, width, height, border, format, type, data);
@@ -15,13 +15,33 @@ static const char* BasicVertexShaderSource = R"(
 
     layout(location = 0) in vec3 VertexPos;
 
+    // Prototype instancing : per instance affine transform (4 vec3 columns) and color, see InstanceArray
+    layout(location = 4) in vec3 InstanceColumn0;
+    layout(location = 5) in vec3 InstanceColumn1;
+    layout(location = 6) in vec3 InstanceColumn2;
+    layout(location = 7) in vec3 InstanceColumn3;
+    layout(location = 8) in vec4 InstanceColor;
+    uniform int use_instancing;
+
+    flat out vec4 instance_color;
+
     uniform mat4 projection;
     uniform mat4 model; 
     uniform mat4 view; 
 
+    // Position dequantization (identity for float positions)
+    uniform vec3 dequant_scale;
+    uniform vec3 dequant_offset;
+
     void main()
     {    
-       gl_Position = projection * view * model * vec4(VertexPos, 1.0); 
+       mat4 instance_transform = mat4(1.0);
+       if(use_instancing != 0)
+         instance_transform = mat4(vec4(InstanceColumn0, 0.0), vec4(InstanceColumn1, 0.0), vec4(InstanceColumn2, 0.0), vec4(InstanceColumn3, 1.0));
+       instance_color = InstanceColor;
+
+       vec3 position = VertexPos * dequant_scale + dequant_offset;
+       gl_Position = projection * view * model * instance_transform * vec4(position, 1.0); 
     }
 )";
 
@@ -29,14 +49,34 @@ static const char* BasicFragmentShaderSource = R"(
 
     #version 330 core
 
+    flat in vec4 instance_color;
+
     out vec4 FragColor;
 
  // uniform sampler2D textureSampler;
 
     uniform vec4 object_color;
+    uniform int use_instance_color;
+
+    // Per primitive colors (ColorScheme::PER_PRIMITIVE), fetched at gl_PrimitiveID, see PrimitiveColorArray
+    uniform samplerBuffer primitive_colors;
+    uniform int use_primitive_color;
+
+    // Triangle -> primitive ID of triangulated quads and polygons
+    uniform usamplerBuffer primitive_remap;
+    uniform int use_primitive_remap;
  
     void main()
     {  
+       vec4 fill_color = object_color;
+       if(use_primitive_color != 0)
+       {
+         int primitive_id = gl_PrimitiveID;
+         if(use_primitive_remap != 0)
+           primitive_id = int(texelFetch(primitive_remap, gl_PrimitiveID).r);
+         fill_color = texelFetch(primitive_colors, primitive_id);
+       }
+
        vec3 mycolor = object_color.rgb;
        vec3 fragPos = gl_FragCoord.xyz;
        float depth  = gl_FragCoord.z;
@@ -45,7 +85,7 @@ static const char* BasicFragmentShaderSource = R"(
      //mycolor = mycolor - dimming_factor;
      //mycolor.r = clamp(mycolor.r, 0.1, 0.5);
      
-       FragColor = object_color;
+       FragColor = use_instance_color != 0 ? instance_color : fill_color;
        
      //FragColor = texture(textureSampler, uv);
     }
@@ -93,8 +133,15 @@ static const char* PerVertexColorVertexShaderSource = R"(
 
     #version 430 core
 
-    layout(location = 0) in vec3  VertexPos;
-    layout(location = 1) in uvec3 VertexColor;
+    layout(location = 0) in vec3 VertexPos;
+    layout(location = 1) in vec4 VertexColor;
+
+    // Prototype instancing : per instance affine transform (4 vec3 columns), see InstanceArray
+    layout(location = 4) in vec3 InstanceColumn0;
+    layout(location = 5) in vec3 InstanceColumn1;
+    layout(location = 6) in vec3 InstanceColumn2;
+    layout(location = 7) in vec3 InstanceColumn3;
+    uniform int use_instancing;
 
     out vec4 color;
 
@@ -102,11 +149,21 @@ static const char* PerVertexColorVertexShaderSource = R"(
     uniform mat4 model; 
     uniform mat4 view; 
 
+    // Position dequantization (identity for float positions)
+    uniform vec3 dequant_scale;
+    uniform vec3 dequant_offset;
+
     void main()
     {    
-       gl_Position = projection * view * model * vec4(VertexPos, 1.0); 
+       mat4 instance_transform = mat4(1.0);
+       if(use_instancing != 0)
+         instance_transform = mat4(vec4(InstanceColumn0, 0.0), vec4(InstanceColumn1, 0.0), vec4(InstanceColumn2, 0.0), vec4(InstanceColumn3, 1.0));
+
+       vec3 position = VertexPos * dequant_scale + dequant_offset;
+       gl_Position = projection * view * model * instance_transform * vec4(position, 1.0); 
        
-       vec3 out_color = normalize(vec3(VertexColor));
+       // Same result for raw [0, 255] and normalized [0, 1] colors
+       vec3 out_color = normalize(VertexColor.rgb);
        
        color = vec4(out_color, 1.0);
     }
@@ -135,6 +192,14 @@ const char* PhongsLightingVertexShaderSource = R"(
 layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 normal;
 
+// Prototype instancing : per instance affine transform (4 vec3 columns) and color, see InstanceArray
+layout(location = 4) in vec3 InstanceColumn0;
+layout(location = 5) in vec3 InstanceColumn1;
+layout(location = 6) in vec3 InstanceColumn2;
+layout(location = 7) in vec3 InstanceColumn3;
+layout(location = 8) in vec4 InstanceColor;
+uniform int use_instancing;
+uniform int use_instance_color;
 
 out vec3 fragNormal;
 out vec3 fragPosition;
@@ -151,14 +216,21 @@ uniform mat4 projection;
 
 uniform vec3 lightPosition;
 
-
+// Position dequantization (identity for float positions)
+uniform vec3 dequant_scale;
+uniform vec3 dequant_offset;
 
 void main()
 {
       
+    mat4 instance_transform = mat4(1.0);
+    if(use_instancing != 0)
+      instance_transform = mat4(vec4(InstanceColumn0, 0.0), vec4(InstanceColumn1, 0.0), vec4(InstanceColumn2, 0.0), vec4(InstanceColumn3, 1.0));
+    mat4 instance_model = model * instance_transform;
+
     // Transform vertex position and normal to world space
-    vec4 worldPosition = model * vec4(position, 1.0);
-    vec3 worldNormal = normalize(mat3(transpose(inverse(model))) * normal);
+    vec4 worldPosition = instance_model * vec4(position * dequant_scale + dequant_offset, 1.0);
+    vec3 worldNormal = normalize(mat3(transpose(inverse(instance_model))) * normal);
     
     // Compute the light direction
     fragLightDir = normalize(lightPosition - worldPosition.xyz);
@@ -167,7 +239,7 @@ void main()
     fragNormal = worldNormal;
     fragPosition = worldPosition.xyz;
      
-    vertexColor = object_color;
+    vertexColor = use_instance_color != 0 ? InstanceColor : object_color;
      //  vertexColor = vec3(0.8f, 0.4f , 0.8f );
     
 
@@ -198,7 +270,13 @@ uniform vec3 materialDiffuse;
 uniform vec3 materialSpecular;
 uniform float materialShininess;
 
+// Per primitive colors (ColorScheme::PER_PRIMITIVE), fetched at gl_PrimitiveID, see PrimitiveColorArray
+uniform samplerBuffer primitive_colors;
+uniform int use_primitive_color;
 
+// Triangle -> primitive ID of triangulated quads and polygons
+uniform usamplerBuffer primitive_remap;
+uniform int use_primitive_remap;
 
 // Gamma correction parameter
 const float gamma = 1.2;
@@ -239,7 +317,15 @@ specularColor *= mix(1.0, fresnelFactor, 0.5);
 // Compute the final color (ambient + diffuse + specular)
 vec3 ambientColor = lightAmbient * materialAmbient * 2.0f;
 vec3 finalColor = ambientColor + diffuseColor + specularColor;
-finalColor = finalColor * vertexColor.xyz;
+vec4 baseColor = vertexColor;
+if(use_primitive_color != 0)
+{
+  int primitive_id = gl_PrimitiveID;
+  if(use_primitive_remap != 0)
+    primitive_id = int(texelFetch(primitive_remap, gl_PrimitiveID).r);
+  baseColor = texelFetch(primitive_colors, primitive_id);
+}
+finalColor = finalColor * baseColor.xyz;
 
 // Apply gamma correction for more realistic lighting perception
 finalColor = pow(finalColor, vec3(1.0 / gamma));
@@ -374,13 +460,33 @@ static const char* SelectPrimitiveVertexShaderSource = R"(
 
     layout(location = 0) in vec3 VertexPos;
 
+    // Prototype instancing : per instance affine transform (4 vec3 columns), see InstanceArray
+    layout(location = 4) in vec3 InstanceColumn0;
+    layout(location = 5) in vec3 InstanceColumn1;
+    layout(location = 6) in vec3 InstanceColumn2;
+    layout(location = 7) in vec3 InstanceColumn3;
+    uniform int use_instancing;
+
+    // Instances are the pick entities of an instanced set
+    flat out int instance_id;
+
     uniform mat4 projection;
     uniform mat4 model; 
     uniform mat4 view; 
+
+    // Position dequantization (identity for float positions)
+    uniform vec3 dequant_scale;
+    uniform vec3 dequant_offset;
     
     void main()
     {            
-      gl_Position = projection * view * model * vec4(VertexPos, 1.0);
+      mat4 instance_transform = mat4(1.0);
+      if(use_instancing != 0)
+        instance_transform = mat4(vec4(InstanceColumn0, 0.0), vec4(InstanceColumn1, 0.0), vec4(InstanceColumn2, 0.0), vec4(InstanceColumn3, 1.0));
+      instance_id = gl_InstanceID;
+
+      vec3 position = VertexPos * dequant_scale + dequant_offset;
+      gl_Position = projection * view * model * instance_transform * vec4(position, 1.0);
     }
 )";
 
@@ -388,15 +494,28 @@ static const char* SelectPrimitiveFragmentShaderSource = R"(
 
     #version 410 core
 
+    flat in int instance_id;
+
     out vec4 FragColor;
 
     uniform int selection_init_id;
+    uniform int pick_by_instance;
+
+    // Triangle -> primitive ID of triangulated quads and polygons
+    uniform usamplerBuffer primitive_remap;
+    uniform int use_primitive_remap;
     
     void main()
     {  
       uint id = uint(selection_init_id);
 
-      uint PrimID = gl_PrimitiveID + id;
+      uint source_primitive = uint(gl_PrimitiveID);
+      if(use_primitive_remap != 0)
+        source_primitive = texelFetch(primitive_remap, gl_PrimitiveID).r;
+      if(pick_by_instance != 0)
+        source_primitive = uint(instance_id);
+
+      uint PrimID = source_primitive + id;
 
       vec3 unique_color = vec3(1.0, 1.0, 1.0);
 
@@ -414,13 +533,29 @@ static const char* SelectGeometryVertexShaderSource = R"(
 
     layout(location = 0) in vec3 VertexPos;
 
+    // Prototype instancing : per instance affine transform (4 vec3 columns), see InstanceArray
+    layout(location = 4) in vec3 InstanceColumn0;
+    layout(location = 5) in vec3 InstanceColumn1;
+    layout(location = 6) in vec3 InstanceColumn2;
+    layout(location = 7) in vec3 InstanceColumn3;
+    uniform int use_instancing;
+
     uniform mat4 projection;
     uniform mat4 model; 
     uniform mat4 view; 
+
+    // Position dequantization (identity for float positions)
+    uniform vec3 dequant_scale;
+    uniform vec3 dequant_offset;
     
     void main()
     {            
-      gl_Position = projection * view * model * vec4(VertexPos, 1.0);
+      mat4 instance_transform = mat4(1.0);
+      if(use_instancing != 0)
+        instance_transform = mat4(vec4(InstanceColumn0, 0.0), vec4(InstanceColumn1, 0.0), vec4(InstanceColumn2, 0.0), vec4(InstanceColumn3, 1.0));
+
+      vec3 position = VertexPos * dequant_scale + dequant_offset;
+      gl_Position = projection * view * model * instance_transform * vec4(position, 1.0);
     }
 )";
 
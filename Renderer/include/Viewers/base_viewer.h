@@ -11,6 +11,7 @@
 #include <functional>
 #include "export.h"
 #include "../Core/gp_gui_utils.h"
+#include "../Core/gp_gui_slot_map.h"
 
 namespace GridPro_GFX
 {
@@ -86,6 +87,10 @@ public:
     /// @param in_geometry Geometry Descriptor
     void commit_geometry(const std::string& in_name, const float& in_layer_id, const std::shared_ptr<GridPro_GFX::GeometryDescriptor>& in_geometry);
 
+    /// @brief Replace the geometry of an uploaded entity, no name lookup (dropped if the entity is gone by upload_commits())
+    void commit_geometry(const GridPro_GFX::EntityId& in_entity, const std::shared_ptr<GridPro_GFX::GeometryDescriptor>& in_geometry);
+    void commit_geometry(const GridPro_GFX::EntityId& in_entity, const float& in_layer_id, const std::shared_ptr<GridPro_GFX::GeometryDescriptor>& in_geometry);
+
     /// @brief  This function is used to commit the geometry to the 2D scene
     /// @param in_name
     /// @param in_geometry
@@ -103,16 +108,24 @@ public:
     /// @brief  This function is used to remove the geometry from the scene
     /// @param in_name Name of the Entity
     virtual void remove_geometry(const std::string& in_name);
+    void remove_geometry(const GridPro_GFX::EntityId& in_entity);
 
     /// @brief  This function is used to hide the geometry from the scene
     void hide_geometry(const std::string& in_name);
+    void hide_geometry(const GridPro_GFX::EntityId& in_entity);
 
     void show_geometry(const std::string& in_name);
+    void show_geometry(const GridPro_GFX::EntityId& in_entity);
 
     /// @brief This function is used to get back the geometry from the scene
     /// @param in_name Name of the Entity
     /// @return std::shared_ptr<GridPro_GFX::GeometryDescriptor>
     std::shared_ptr<GridPro_GFX::GeometryDescriptor>& get_geometry(const std::string &in_name);
+    std::shared_ptr<GridPro_GFX::GeometryDescriptor>& get_geometry(const GridPro_GFX::EntityId& in_entity);
+
+    /// @brief Handle of an uploaded entity, a null handle if no entity has this name (or it is still waiting in the commit stack)
+    /// @note  The EntityId overloads skip the name lookup, keep the handle where the same entity is addressed repeatedly
+    GridPro_GFX::EntityId find_entity(const std::string& in_name) const;
 
     /// @brief  This function is used to add a display layer
     /// @param in_layer_id
@@ -189,6 +202,7 @@ public:
     virtual void zoom_out();
 
     /// @brief  This function is used to frame the scene
+    /// @param  in_entity_name entity to frame, nullptr frames the whole scene
     virtual void frame_scene(const char* in_entity_name);
 
     void set_box_selection(bool status)
@@ -291,6 +305,7 @@ protected:
     void handle_polygon_selection();
     void handle_cluster_selection();
     bool handle_subentity_highlighting();
+    void show_hovered_sub_entity(const std::shared_ptr<GridPro_GFX::GeometryDescriptor>& in_geometry);
     bool handle_geometry_highlighting_and_node_manipulation(const float &x, const float &y, bool& need_redraw);
 
     void create_and_display_cor();
@@ -321,6 +336,8 @@ protected :
     std::shared_ptr<GridPro_GFX::GeometryDescriptor> m_polygon_selection_descriptor;
     std::shared_ptr<GridPro_GFX::GeometryDescriptor> m_workplane_descriptor;
 
+    /// Hidden entities. Names hidden before their entity is uploaded wait in m_hidden_geometries, upload_commits() moves them over
+    std::unordered_set<GridPro_GFX::EntityId> m_hidden_entities;
     std::unordered_set<std::string> m_hidden_geometries;
     std::unordered_set<float> m_current_displayed_layers;
     std::unordered_set<std::string> m_entities_manipulable_on_workplane;
@@ -329,7 +346,10 @@ protected :
     {
         explicit geometry_commit(const std::string &in_name, const float& in_layer_id, const std::shared_ptr<GridPro_GFX::GeometryDescriptor>& in_geometry) 
                  : name(in_name), layer_id(in_layer_id), geometry(in_geometry) {} 
+        explicit geometry_commit(const GridPro_GFX::EntityId &in_entity, const float& in_layer_id, const std::shared_ptr<GridPro_GFX::GeometryDescriptor>& in_geometry) 
+                 : entity(in_entity), layer_id(in_layer_id), geometry(in_geometry) {} 
         std::string name;
+        GridPro_GFX::EntityId entity;   ///< set instead of name for commits to an uploaded entity
         float layer_id;
         std::shared_ptr<GridPro_GFX::GeometryDescriptor> geometry;
     };
@@ -356,13 +376,17 @@ protected :
 
     struct currently_holded_node
     {
-        std::string entity_name;
+        GridPro_GFX::EntityId entity;
         uint32_t node_index;
     };
 
     currently_holded_node m_currently_holded_node;
 
-    std::string previouly_hovered_entity_name;
+    /// @brief Entity highlighted under the mouse, null if none
+    GridPro_GFX::EntityId m_hovered_entity;
+
+    /// @brief Point / line overlay of the hovered sub entity, resolved once it is uploaded so mouse moves address it by handle
+    GridPro_GFX::EntityId m_hovered_sub_entity;
 
     std::string previouly_hovered_sub_entity_name;
     
@@ -6,7 +6,7 @@
 namespace GridPro_GFX
 {
 
-    Entity_Handle::Entity_Handle() : entity_ptr(nullptr), scene_ptr(nullptr)
+    Entity_Handle::Entity_Handle() : entity_key(nullptr), entity_ptr(nullptr), scene_ptr(nullptr)
     {
     
     }
@@ -18,7 +18,11 @@ namespace GridPro_GFX
 
     bool Entity_Handle::is_valid() const
     {
-        return entity_ptr->is_valid() && scene_ptr != nullptr;
+        if(entity_ptr == nullptr || scene_ptr == nullptr)
+        {
+            return false;
+        }
+        return scene_ptr->Entity_DataBase.contains(slot_handle) && entity_ptr->is_valid();
     }
 
     void Entity_Handle::destroy()
@@ -29,18 +33,19 @@ namespace GridPro_GFX
             return;
         } 
 
-        if(entity_ptr->is_valid())
+        if(scene_ptr->Entity_DataBase.contains(slot_handle) && entity_ptr->is_valid())
         {
            entity_ptr->destroy(); 
         }
         
-        scene_ptr->remove_entity_from_registry(entity_key);  
+        scene_ptr->remove_entity_from_registry(slot_handle);  
         
     }
 
     const std::string& Entity_Handle::get_key() const
     {
-        return entity_key;
+        static const std::string null_entity_key = "NULL_ENTITY";
+        return entity_key != nullptr ? *entity_key : null_entity_key;
     }
 
 
@@ -1,5 +1,14 @@
 #include <iostream>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
 #include "gp_gui_geometry_descriptor.h"
+#include "gp_gui_parallel.h"
+#include "gp_gui_geometry_kernels.h"
+#include "gp_gui_mesh_optimizer.h"
 #include "gp_gui_debug.h"
 
 namespace GridPro_GFX {
@@ -10,6 +19,7 @@ namespace GridPro_GFX {
         positions =  std::make_shared<std::vector<float>>(0);
         currentPrimitiveSet = std::make_shared<PrimitiveSetInstance>(currentPrimitiveSetInstanceName, GL_POINTS, positions);
         primitives[currentPrimitiveSetInstanceName] = currentPrimitiveSet;
+        currentPrimitiveSetHandle = { primitives.find_id(currentPrimitiveSetInstanceName), primitives.generation() };
     }
     
     /// @brief Destructor
@@ -26,17 +36,20 @@ namespace GridPro_GFX {
 
     __INLINE__ void GeometryDescriptor::set_new_primitive_set(const std::string& name , GLenum Primitivetype) {
         currentPrimitiveSetInstanceName = name;
-        if(primitives.find(name) != primitives.end() && primitives[name] != nullptr)
+        const uint32_t set_id = primitives.intern(name);
+        std::shared_ptr<PrimitiveSetInstance>& primitiveSet = primitives.at_id(set_id).second;
+        if(primitiveSet != nullptr)
         {
-            primitives[name].reset();
+            primitiveSet.reset();
             GP_TRACE("Warning ! You are ovewriting an existing Primitive set with ID : ", name); 
         }  
         
         if(Primitivetype == 0x1B00) Primitivetype = GL_POINTS;
 
-        primitives[name] = std::make_shared<PrimitiveSetInstance>(name, Primitivetype, positions);
+        primitiveSet = std::make_shared<PrimitiveSetInstance>(name, Primitivetype, positions);
 
-        currentPrimitiveSet = primitives[name];    
+        currentPrimitiveSet = primitiveSet;
+        currentPrimitiveSetHandle = { set_id, primitives.generation() };
     }
 
   /// @brief Set the current primitive set
@@ -47,7 +60,8 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::set_current_primitive_set(const std::string& name , GLenum Primitivetype = GL_NONE_NULL) {
         currentPrimitiveSetInstanceName = name;
         if(Primitivetype == 0x1B00) Primitivetype = GL_POINTS;
-        if(primitives.find(name) == primitives.end())
+        uint32_t set_id = primitives.find_id(name);
+        if(set_id == InternedTable<PrimitiveSetInstance>::INVALID_ID)
         {
            if(Primitivetype == GL_NONE_NULL) 
            {
@@ -55,26 +69,47 @@ namespace GridPro_GFX {
               throw std::runtime_error(err);
            }
  
-           primitives[name] = std::make_shared<PrimitiveSetInstance>(name, Primitivetype, positions);
+           set_id = primitives.intern(name);
+           primitives.at_id(set_id).second = std::make_shared<PrimitiveSetInstance>(name, Primitivetype, positions);
            GP_TRACE("Warning ! You are creating a new Primitive set with ID : ", name , ". Use set_new_primitive_set() instead if you create a new PrimitiveSet");
         }
         else
         {
-            if(primitives[name]->get_primitive_type_enum() != Primitivetype)
+            if(primitives.at_id(set_id).second->get_primitive_type_enum() != Primitivetype)
                GP_TRACE("Warning ! You are trying to ovewrite an existing Primitive set with const Primitive type ID : ",  name ,
                           " !!!. Use set_new_primitive_set() instead if you create a new PrimitiveSet"); 
         }
-        currentPrimitiveSet = primitives[name];    
+        currentPrimitiveSet = primitives.at_id(set_id).second;
+        currentPrimitiveSetHandle = { set_id, primitives.generation() };
+    }
+
+    /// @brief Set the current primitive set from a handle
+    /// @param handle from get_primitive_set_handle()
+    __INLINE__ void GeometryDescriptor::set_current_primitive_set(const PrimitiveSetHandle& handle) {
+        if(!isValidHandle(handle))
+            throw std::runtime_error(std::string("set_current_primitive_set : primitive set handle is out of date"));
+
+        const InternedTable<PrimitiveSetInstance>::value_type& entry = primitives.at_id(handle.id);
+        currentPrimitiveSetInstanceName = entry.first;
+        currentPrimitiveSet = entry.second;
+        currentPrimitiveSetHandle = handle;
     }
 
     /// @brief Push a position vector (x, y, z) to the current primitive set
     __INLINE__ void GeometryDescriptor::push_pos3f(const float& x, const float& y, const float& z) {
-        
+        require_separate_attrib_storage("push_pos3f");
+
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::POSITION_ARRAY);
         primitiveSet->positions->push_back(x);
         primitiveSet->positions->push_back(y);
         primitiveSet->positions->push_back(z);
 
+        /// @brief   Grow the cached bounding boxes of every primitive set sharing these positions
+        for(auto& primitive : primitives)
+            if(primitive.second->positions == primitiveSet->positions)
+                primitive.second->expand_bounding_box(x, y, z);
+
         /// @brief   Set the dirty flag for positions
         /// @details This is used to indicate that the positions have been modified
         /// @warning You can remove this line for performance reasons only if you are sure that you manually set the dirty flag
@@ -85,7 +120,9 @@ namespace GridPro_GFX {
 
     /// @brief Push a normal vector (n1, n2, n3) to the current primitive set
     __INLINE__ void GeometryDescriptor::push_normal3f(const float& n1, const float& n2, const float& n3) {
+        require_separate_attrib_storage("push_normal3f");
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::NORMAL_ARRAY);
         primitiveSet->normals->push_back(n1);
         primitiveSet->normals->push_back(n2);
         primitiveSet->normals->push_back(n3);
@@ -100,6 +137,7 @@ namespace GridPro_GFX {
 
     /// @brief Push a color vector (r, g, b) ubytes to the current primitive set
     __INLINE__ void GeometryDescriptor::push_color3ub(const uint8_t& r, const uint8_t& g, const uint8_t& b) {
+        require_separate_attrib_storage("push_color3ub");
         
         /// @brief   Check if the color format is RGB
         /// @details If the color format is not RGB, throw a runtime error
@@ -110,6 +148,7 @@ namespace GridPro_GFX {
         #endif
 
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::COLOR_ARRAY);
         primitiveSet->colors->push_back(r);
         primitiveSet->colors->push_back(g);
         primitiveSet->colors->push_back(b);
@@ -124,6 +163,7 @@ namespace GridPro_GFX {
 
     /// @brief Push a color vector (r, g, b, a) to the current primitive set
     __INLINE__ void GeometryDescriptor::push_color4ub(const uint8_t& r, const uint8_t& g, const uint8_t& b , const uint8_t a) {
+        require_separate_attrib_storage("push_color4ub");
         
         /// @brief   Check if the color format is RGB
         /// @details If the color format is not RGB, throw a runtime error
@@ -134,6 +174,7 @@ namespace GridPro_GFX {
         #endif
 
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::COLOR_ARRAY);
         primitiveSet->colors->push_back(r);
         primitiveSet->colors->push_back(g);
         primitiveSet->colors->push_back(b);
@@ -150,6 +191,7 @@ namespace GridPro_GFX {
     /// @brief Push indices to the current primitive set
     __INLINE__ void GeometryDescriptor::push_index(const uint32_t& index) {
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::INDEX_ARRAY);
         primitiveSet->indices->push_back(index);
 
         /// @brief   Set the dirty flag for indices
@@ -162,24 +204,31 @@ namespace GridPro_GFX {
 
     /// @brief Push a position array to the current primitive set
     __INLINE__ void GeometryDescriptor::push_pos_array(const std::vector<float>& position_array) {
+        require_separate_attrib_storage("push_pos_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::POSITION_ARRAY);
         primitiveSet->positions->insert(primitiveSet->positions->end(), position_array.begin(), position_array.end());
+        invalidate_bounding_box();
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);     
     }
 
     /// @brief Push a normal array to the current primitive set
     __INLINE__ void GeometryDescriptor::push_normal_array(const std::vector<float>& normal_array) {
+        require_separate_attrib_storage("push_normal_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::NORMAL_ARRAY);
         primitiveSet->normals->insert(primitiveSet->normals->end(), normal_array.begin(), normal_array.end());
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);    
     }
 
     /// @brief Push a color array to the current primitive set
     __INLINE__ void GeometryDescriptor::push_color_array(const std::vector<uint8_t>& color_array) {
+        require_separate_attrib_storage("push_color_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::COLOR_ARRAY);
         primitiveSet->colors->insert(primitiveSet->colors->end(), color_array.begin(), color_array.end());
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
 
@@ -189,23 +238,29 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::push_index_array(const std::vector<uint32_t>& index_array) {
 
         auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::INDEX_ARRAY);
         primitiveSet->indices->insert(primitiveSet->indices->end(), index_array.begin(), index_array.end());
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_INDICES);
     }
 
     /// @brief Copy a position array to the current primitive set
     __INLINE__ void GeometryDescriptor::copy_pos_array(const std::vector<float>& position_array) {
+        require_separate_attrib_storage("copy_pos_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::POSITION_ARRAY));
         //primitiveSet->positions.reset();
         primitiveSet->positions = std::make_shared<std::vector<float>>(position_array);
+        invalidate_bounding_box();
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);
     }
 
     /// @brief Copy a normal array to the current primitive set
     __INLINE__ void GeometryDescriptor::copy_normal_array(const std::vector<float>& normal_array) {
+        require_separate_attrib_storage("copy_normal_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::NORMAL_ARRAY));
         //primitiveSet->normals.reset();
         primitiveSet->normals = std::make_shared<std::vector<float>>(normal_array);
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);
@@ -213,8 +268,10 @@ namespace GridPro_GFX {
 
     /// @brief Copy a color array to the current primitive set
     __INLINE__ void GeometryDescriptor::copy_color_array(const std::vector<uint8_t>& color_array) {
+        require_separate_attrib_storage("copy_color_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::COLOR_ARRAY));
         //primitiveSet->colors.reset();
         primitiveSet->colors = std::make_shared<std::vector<uint8_t>>(color_array);
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
@@ -224,6 +281,7 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::copy_index_array(const std::vector<uint32_t>& index_array) {
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::INDEX_ARRAY));
         //primitiveSet->indices.reset();
         primitiveSet->indices = std::make_shared<std::vector<uint32_t>>(index_array);
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_INDICES);
@@ -231,17 +289,22 @@ namespace GridPro_GFX {
 
     /// @brief Move a position array to the current primitive set
     __INLINE__ void GeometryDescriptor::move_pos_array(std::vector<float>&& position_array) {
+        require_separate_attrib_storage("move_pos_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::POSITION_ARRAY));
         //primitiveSet->positions.reset();
         primitiveSet->positions = std::make_shared<std::vector<float>>(std::move(position_array));
+        invalidate_bounding_box();
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS);
     }
 
     /// @brief Move a normal array to the current primitive set
     __INLINE__ void GeometryDescriptor::move_normal_array(std::vector<float>&& normal_array) {
+        require_separate_attrib_storage("move_normal_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::NORMAL_ARRAY));
         //primitiveSet->normals.reset();
         primitiveSet->normals = std::make_shared<std::vector<float>>(std::move(normal_array));
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_NORMALS);
@@ -249,8 +312,10 @@ namespace GridPro_GFX {
 
     /// @brief Move a color array to the current primitive set
     __INLINE__ void GeometryDescriptor::move_color_array(std::vector<uint8_t>&& color_array) {
+        require_separate_attrib_storage("move_color_array");
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::COLOR_ARRAY));
         //primitiveSet->colors.reset();
         primitiveSet->colors = std::make_shared<std::vector<uint8_t>>(std::move(color_array));
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_COLORS);
@@ -260,11 +325,295 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::move_index_array(std::vector<uint32_t>&& index_array) {
 
         auto& primitiveSet = currentPrimitiveSet;
+        primitiveSet->copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::INDEX_ARRAY));
         //primitiveSet->indices.reset();
         primitiveSet->indices = std::make_shared<std::vector<uint32_t>>(std::move(index_array));
         primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_INDICES);
     }
 
+    /// @brief Overwrite positions of the current primitive set in place
+    __INLINE__ void GeometryDescriptor::update_pos_array(const uint32_t& first_vertex, const std::vector<float>& position_array) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::POSITION_ARRAY);
+        const size_t num_vertices = position_array.size() / 3;
+        if(num_vertices == 0) return;
+
+        if(size_t(first_vertex) + num_vertices > primitiveSet->get_num_positions())
+            throw std::runtime_error(std::string("update_pos_array : range exceeds the positions of ") + currentPrimitiveSetInstanceName);
+
+        if(primitiveSet->isInterleaved())
+        {
+            InterleavedVertexArray& vertices = *primitiveSet->interleaved_vertices;
+            for(size_t i = 0; i < num_vertices; i++)
+                std::memcpy(vertices.position(first_vertex + i), &position_array[i * 3], 3 * sizeof(float));
+
+            primitiveSet->mark_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, size_t(first_vertex) * vertices.stride(), (first_vertex + num_vertices) * vertices.stride());
+            primitiveSet->invalidate_bounding_box();
+            return;
+        }
+
+        std::copy(position_array.begin(), position_array.begin() + num_vertices * 3, primitiveSet->positions->begin() + size_t(first_vertex) * 3);
+
+        /// Every primitive set sharing the positions owns a separate VBO, so all of them get the range
+        for(auto& primitive : primitives)
+            if(primitive.second->positions == primitiveSet->positions)
+                primitive.second->mark_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, size_t(first_vertex) * 3 * sizeof(float), (first_vertex + num_vertices) * 3 * sizeof(float));
+
+        invalidate_bounding_box();
+    }
+
+    /// @brief Overwrite normals of the current primitive set in place
+    __INLINE__ void GeometryDescriptor::update_normal_array(const uint32_t& first_vertex, const std::vector<float>& normal_array) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::NORMAL_ARRAY);
+        const size_t num_vertices = normal_array.size() / 3;
+        if(num_vertices == 0) return;
+
+        if(primitiveSet->isInterleaved())
+        {
+            InterleavedVertexArray& vertices = *primitiveSet->interleaved_vertices;
+            const VertexAttribInfo* normal_attrib = vertices.layout().find(ATTRIB_NORMAL);
+            if(normal_attrib == nullptr || normal_attrib->gl_type != GL_FLOAT)
+                throw std::runtime_error(std::string("update_normal_array : layout has no float normals in ") + currentPrimitiveSetInstanceName);
+
+            if(size_t(first_vertex) + num_vertices > vertices.size())
+                throw std::runtime_error(std::string("update_normal_array : range exceeds the vertices of ") + currentPrimitiveSetInstanceName);
+
+            for(size_t i = 0; i < num_vertices; i++)
+                std::memcpy(vertices.attrib<float>(first_vertex + i, ATTRIB_NORMAL), &normal_array[i * 3], 3 * sizeof(float));
+
+            primitiveSet->mark_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, size_t(first_vertex) * vertices.stride(), (first_vertex + num_vertices) * vertices.stride());
+            return;
+        }
+
+        if((size_t(first_vertex) + num_vertices) * 3 > primitiveSet->normals->size())
+            throw std::runtime_error(std::string("update_normal_array : range exceeds the normals of ") + currentPrimitiveSetInstanceName);
+
+        std::copy(normal_array.begin(), normal_array.begin() + num_vertices * 3, primitiveSet->normals->begin() + size_t(first_vertex) * 3);
+
+        for(auto& primitive : primitives)
+            if(primitive.second->normals == primitiveSet->normals)
+                primitive.second->mark_dirty_range(PrimitiveSetInstance::NORMAL_ARRAY, size_t(first_vertex) * 3 * sizeof(float), (first_vertex + num_vertices) * 3 * sizeof(float));
+    }
+
+    /// @brief Overwrite colors of the current primitive set in place
+    __INLINE__ void GeometryDescriptor::update_color_array(const uint32_t& first_vertex, const std::vector<uint8_t>& color_array) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::COLOR_ARRAY);
+        const size_t color_components = (primitiveSet->colorFormat == PrimitiveSetInstance::RGB ? 3 : 4);
+        const size_t num_vertices = color_array.size() / color_components;
+        if(num_vertices == 0) return;
+
+        if(primitiveSet->isInterleaved())
+        {
+            InterleavedVertexArray& vertices = *primitiveSet->interleaved_vertices;
+            const VertexAttribInfo* color_attrib = vertices.layout().find(ATTRIB_COLOR);
+            if(color_attrib == nullptr || color_attrib->gl_type != GL_UNSIGNED_BYTE)
+                throw std::runtime_error(std::string("update_color_array : layout has no ubyte colors in ") + currentPrimitiveSetInstanceName);
+
+            if(size_t(first_vertex) + num_vertices > vertices.size())
+                throw std::runtime_error(std::string("update_color_array : range exceeds the vertices of ") + currentPrimitiveSetInstanceName);
+
+            const size_t copy_components = std::min<size_t>(color_components, color_attrib->components);
+            for(size_t i = 0; i < num_vertices; i++)
+                std::memcpy(vertices.attrib<uint8_t>(first_vertex + i, ATTRIB_COLOR), &color_array[i * color_components], copy_components);
+
+            primitiveSet->mark_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, size_t(first_vertex) * vertices.stride(), (first_vertex + num_vertices) * vertices.stride());
+            return;
+        }
+
+        if((size_t(first_vertex) + num_vertices) * color_components > primitiveSet->colors->size())
+            throw std::runtime_error(std::string("update_color_array : range exceeds the colors of ") + currentPrimitiveSetInstanceName);
+
+        std::copy(color_array.begin(), color_array.begin() + num_vertices * color_components, primitiveSet->colors->begin() + size_t(first_vertex) * color_components);
+
+        for(auto& primitive : primitives)
+            if(primitive.second->colors == primitiveSet->colors)
+                primitive.second->mark_dirty_range(PrimitiveSetInstance::COLOR_ARRAY, size_t(first_vertex) * color_components, (first_vertex + num_vertices) * color_components);
+    }
+
+    /// @brief Overwrite indices of the current primitive set in place
+    __INLINE__ void GeometryDescriptor::update_index_array(const uint32_t& first_index, const std::vector<uint32_t>& index_array) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::INDEX_ARRAY);
+        if(index_array.empty()) return;
+
+        if(size_t(first_index) + index_array.size() > primitiveSet->indices->size())
+            throw std::runtime_error(std::string("update_index_array : range exceeds the indices of ") + currentPrimitiveSetInstanceName);
+
+        std::copy(index_array.begin(), index_array.end(), primitiveSet->indices->begin() + first_index);
+
+        for(auto& primitive : primitives)
+            if(primitive.second->indices == primitiveSet->indices)
+            {
+                primitive.second->mark_dirty_range(PrimitiveSetInstance::INDEX_ARRAY, size_t(first_index) * sizeof(uint32_t), (first_index + index_array.size()) * sizeof(uint32_t));
+                primitive.second->clear_triangulation();
+            }
+    }
+
+
+    /// @brief Give the current primitive set a private copy of a copy-on-write attribute buffer
+    __INLINE__ void GeometryDescriptor::detach_attrib_array(PrimitiveSetInstance::VertexAttribArrayType type) {
+        detach_attrib_array(currentPrimitiveSet, type);
+    }
+
+    __INLINE__ void GeometryDescriptor::detach_attrib_array(const std::shared_ptr<PrimitiveSetInstance>& primitiveSet, PrimitiveSetInstance::VertexAttribArrayType type) {
+
+        if(!primitiveSet->isCopyOnWrite(type)) return;
+
+        const uint32_t cow_bit = 1u << PrimitiveSetInstance::attrib_slot(type);
+
+        /// Every set of this descriptor aliasing the buffer moves to the same copy
+        auto detach_group = [&](auto member)
+        {
+            const auto shared = (*primitiveSet).*member;
+            if(shared == nullptr) return;
+
+            using Storage = typename std::decay<decltype(*shared)>::type;
+            bool is_descriptor_positions = false;
+            long local_owners = 1;
+            for(auto& primitive : primitives)
+                if((*primitive.second).*member == shared) ++local_owners;
+
+            if constexpr (std::is_same<Storage, std::vector<float>>::value)
+                if(positions == shared) { ++local_owners; is_descriptor_positions = true; }
+
+            /// Nobody outside this descriptor holds the buffer any more, nothing to copy
+            if(shared.use_count() <= local_owners) return;
+
+            const auto copy = std::make_shared<Storage>(*shared);
+            for(auto& primitive : primitives)
+                if((*primitive.second).*member == shared) (*primitive.second).*member = copy;
+
+            if constexpr (std::is_same<Storage, std::vector<float>>::value)
+                if(is_descriptor_positions) positions = copy;
+        };
+
+        switch(type)
+        {
+            case PrimitiveSetInstance::POSITION_ARRAY:
+                detach_group(&PrimitiveSetInstance::positions);
+                detach_group(&PrimitiveSetInstance::interleaved_vertices);
+                break;
+            case PrimitiveSetInstance::NORMAL_ARRAY: detach_group(&PrimitiveSetInstance::normals); break;
+            case PrimitiveSetInstance::COLOR_ARRAY:  detach_group(&PrimitiveSetInstance::colors);  break;
+            case PrimitiveSetInstance::INDEX_ARRAY:  detach_group(&PrimitiveSetInstance::indices); break;
+        }
+
+        for(auto& primitive : primitives)
+            if(primitive.second->attrib_storage(type) == primitiveSet->attrib_storage(type))
+                primitive.second->copy_on_write_flags &= ~cow_bit;
+    }
+
+    __INLINE__ void GeometryDescriptor::require_separate_attrib_storage(const char* caller) const {
+
+        if(currentPrimitiveSet->isInterleaved())
+            throw std::runtime_error(std::string(caller) + " : Primitive set with ID : " + currentPrimitiveSetInstanceName +
+                                     " is interleaved, its vertex attributes come from its vertex layout");
+    }
+
+    /// @brief Use externally owned interleaved vertices for the current primitive set
+    __INLINE__ void GeometryDescriptor::adopt_interleaved_vertices(const VertexLayoutInfo& layout, void* vertices, const size_t& num_vertices, InterleavedVertexArray::ReleaseCallback release) {
+
+        std::shared_ptr<const void> owner(vertices, [release](const void* ptr) { if(release) release(const_cast<void*>(ptr)); });
+        adopt_interleaved_vertices(layout, vertices, num_vertices, std::move(owner));
+    }
+
+    /// @brief Use externally owned interleaved vertices for the current primitive set
+    __INLINE__ void GeometryDescriptor::adopt_interleaved_vertices(const VertexLayoutInfo& layout, void* vertices, const size_t& num_vertices, std::shared_ptr<const void> owner) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+
+        if(layout.attribs[0].semantic != ATTRIB_POSITION || layout.attribs[0].gl_type != GL_FLOAT || layout.attribs[0].components != 3)
+        {
+            std::string err = std::string("Adopted vertices of Primitive set with ID : ") + primitiveSet->get_instance_name() + std::string(" need Pos3f positions first in the layout");
+            throw std::runtime_error(err);
+        }
+
+        /// The drivers read an interleaved set through its layout only, separate arrays it does not replace would be lost
+        const bool drops_normals = !primitiveSet->isInterleaved() && primitiveSet->normals->size() != 0 && !layout.has(ATTRIB_NORMAL);
+        const bool drops_colors  = !primitiveSet->isInterleaved() && primitiveSet->colors->size()  != 0 && !layout.has(ATTRIB_COLOR);
+        if(drops_normals || drops_colors)
+        {
+            std::string err = std::string("Adopted vertices of Primitive set with ID : ") + primitiveSet->get_instance_name() +
+                              std::string(" carry no ") + (drops_normals ? "normals" : "colors") + std::string(" but the set has separate ones, clear them first");
+            throw std::runtime_error(err);
+        }
+
+        primitiveSet->interleaved_vertices = std::make_shared<InterleavedVertexArray>(InterleavedVertexArray::adopt(layout, vertices, num_vertices, std::move(owner)));
+
+        /// Same as interleave_vertex_attributes, the separate arrays (empty, or carried by the layout) are replaced by the interleaved block
+        primitiveSet->positions = std::make_shared<std::vector<float>>(0);
+        primitiveSet->normals   = std::make_shared<std::vector<float>>(0);
+        primitiveSet->colors    = std::make_shared<std::vector<uint8_t>>(0);
+
+        if(const VertexAttribInfo* color_attrib = layout.find(ATTRIB_COLOR))
+            primitiveSet->colorFormat = (color_attrib->components == 4 ? PrimitiveSetInstance::RGBA : PrimitiveSetInstance::RGB);
+
+        primitiveSet->copy_on_write_flags &= ~((1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::POSITION_ARRAY)) |
+                                               (1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::NORMAL_ARRAY))   |
+                                               (1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::COLOR_ARRAY)));
+        primitiveSet->invalidate_bounding_box();
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS | PrimitiveSetInstance::DIRTY_NORMALS | PrimitiveSetInstance::DIRTY_COLORS);
+    }
+
+    /// @brief Use an externally owned xyz float array as the positions of the current primitive set
+    __INLINE__ void GeometryDescriptor::adopt_pos_array(float* position_array, const size_t& num_floats, InterleavedVertexArray::ReleaseCallback release) {
+
+        adopt_interleaved_vertices(VertexLayout<Pos3f>::info(), position_array, num_floats / 3, std::move(release));
+    }
+
+    /// @brief Use an externally owned xyz float array as the positions of the current primitive set
+    __INLINE__ void GeometryDescriptor::adopt_pos_array(float* position_array, const size_t& num_floats, std::shared_ptr<const void> owner) {
+
+        adopt_interleaved_vertices(VertexLayout<Pos3f>::info(), position_array, num_floats / 3, std::move(owner));
+    }
+
+    /// @brief Append raw interleaved vertices to the current primitive set
+    /// @param layout runtime layout of the vertices
+    /// @param vertices pointer to num_vertices * layout.stride bytes
+    /// @param num_vertices
+    __INLINE__ void GeometryDescriptor::push_interleaved_vertices(const VertexLayoutInfo& layout, const void* vertices, const size_t& num_vertices) {
+
+        auto& primitiveSet = currentPrimitiveSet;
+        detach_attrib_array(PrimitiveSetInstance::POSITION_ARRAY);
+
+        if(primitiveSet->interleaved_vertices == nullptr)
+        {
+            if(primitiveSet->get_num_positions() != 0)
+                primitiveSet->interleave_vertex_attributes(layout);
+            else
+            {
+                primitiveSet->interleaved_vertices = std::make_shared<InterleavedVertexArray>(layout);
+                primitiveSet->positions = std::make_shared<std::vector<float>>(0);
+            }
+        }
+
+        #ifdef _ENABLE_RUNTIME_SAFETY_CHECKS_
+        if(layout.attribs[0].gl_type != GL_FLOAT)
+        {
+            std::string err = std::string("Interleaved Primitive set with ID : ") + primitiveSet->get_instance_name() + std::string(" needs float positions. Use set_vertex_compression() for compressed uploads");
+            throw std::runtime_error(err);
+        }
+
+        if(primitiveSet->interleaved_vertices->stride() != layout.stride || primitiveSet->interleaved_vertices->layout().num_attribs != layout.num_attribs)
+        {
+            std::string err = std::string("Vertex layout mismatch in interleaved Primitive set with ID : ") + primitiveSet->get_instance_name();
+            throw std::runtime_error(err);
+        }
+        #endif
+
+        primitiveSet->interleaved_vertices->append(vertices, num_vertices);
+        primitiveSet->invalidate_bounding_box();
+
+        #ifdef _ENABLE_AUTOMATIC_DIRTY_FLAG_MANAGEMENT_
+        primitiveSet->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS | PrimitiveSetInstance::DIRTY_NORMALS | PrimitiveSetInstance::DIRTY_COLORS);
+        #endif
+    }
 
     /// @brief Other methods for dirty flags, etc. can be added here
     __INLINE__ void GeometryDescriptor::clearDirtyFlags() {
@@ -295,6 +644,15 @@ namespace GridPro_GFX {
         }
     }
 
+    /// @brief  Clear dirty flags for the primitive set behind a handle
+    /// @param handle
+    __INLINE__ void GeometryDescriptor::clearDirtyFlags(const PrimitiveSetHandle& handle) {
+
+        if (isValidHandle(handle)) {
+            primitives.at_id(handle.id).second->clearDirty();
+        }
+    }
+
     /// @brief get a primitive set by name
     /// @param name 
     /// @return std::weak_ptr<PrimitiveSetInstance>
@@ -306,6 +664,17 @@ namespace GridPro_GFX {
         }
         return std::weak_ptr<GeometryDescriptor::PrimitiveSetInstance>();
     }
+
+    /// @brief get a primitive set by handle
+    /// @param handle
+    /// @return std::weak_ptr<PrimitiveSetInstance>, expired if the handle is out of date
+    __INLINE__ std::weak_ptr<GeometryDescriptor::PrimitiveSetInstance> GeometryDescriptor::get_primitive_set(const PrimitiveSetHandle& handle) {
+
+        if (isValidHandle(handle)) {
+            return primitives.at_id(handle.id).second;
+        }
+        return std::weak_ptr<GeometryDescriptor::PrimitiveSetInstance>();
+    }
     
     /// @brief get the current primitive set as a weak pointer
     /// @details lock the weak pointer to get a shared pointer
@@ -313,6 +682,11 @@ namespace GridPro_GFX {
     /// @return std::weak_ptr<PrimitiveSetInstance> current primitive set
     __INLINE__ std::weak_ptr<GeometryDescriptor::PrimitiveSetInstance> GeometryDescriptor::get_current_primitive_set() {
 
+        if (isValidHandle(currentPrimitiveSetHandle)) {
+            return primitives.at_id(currentPrimitiveSetHandle.id).second;
+        }
+
+        /// Removing a set shifts the IDs, the current set is looked up by name again
         auto it = primitives.find(currentPrimitiveSetInstanceName);
         if (it != primitives.end()) {
             return it->second;
@@ -338,12 +712,19 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::copy_vertex_attributes(const std::string& src, const std::string& dst) {
         auto it = primitives.find(src);
         if (it != primitives.end()) {
+            /// Held by value, inserting dst may move the entries of the table
+            const std::shared_ptr<PrimitiveSetInstance> source = it->second;
             if(primitives.find(dst) == primitives.end())
-                primitives[dst] = std::make_shared<PrimitiveSetInstance>(dst, (it->second)->get_primitive_type_enum(), positions); 
-            
-            *(primitives[dst]->normals)   = *((it->second)->normals);
-            *(primitives[dst]->colors)    = *((it->second)->colors);
-            *(primitives[dst]->indices)   = *((it->second)->indices);
+                primitives[dst] = std::make_shared<PrimitiveSetInstance>(dst, source->get_primitive_type_enum(), positions); 
+
+            /// dst may still share its buffers with a clone, they are detached before being overwritten
+            const std::shared_ptr<PrimitiveSetInstance> destination = primitives[dst];
+            detach_attrib_array(destination, PrimitiveSetInstance::NORMAL_ARRAY);
+            detach_attrib_array(destination, PrimitiveSetInstance::COLOR_ARRAY);
+            detach_attrib_array(destination, PrimitiveSetInstance::INDEX_ARRAY);
+            *(destination->normals)   = *(source->normals);
+            *(destination->colors)    = *(source->colors);
+            *(destination->indices)   = *(source->indices);
         }
         std::string err = std::string("Primitive set not found : ") + src + std::string(" or ") + dst;
         throw std::runtime_error(err);
@@ -354,7 +735,8 @@ namespace GridPro_GFX {
         auto it = primitives.find(src);
         if (it != primitives.end()) {
 
-            primitives[dst] = std::move((it->second));
+            std::shared_ptr<PrimitiveSetInstance> source = std::move(it->second);
+            primitives[dst] = std::move(source);
             /*
             primitives[dst]->positions = std::move((it->second)->positions);
             primitives[dst]->normals   = std::move((it->second)->normals);
@@ -370,12 +752,13 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::share_vertex_attributes(const std::string& src, const std::string& dst) {
         auto it = primitives.find(src);
         if (it != primitives.end()) {
+            const std::shared_ptr<PrimitiveSetInstance> source = it->second;
             if(primitives.find(dst) == primitives.end())
-                primitives[dst] = std::make_shared<PrimitiveSetInstance>(dst, (it->second)->get_primitive_type_enum(), positions);
+                primitives[dst] = std::make_shared<PrimitiveSetInstance>(dst, source->get_primitive_type_enum(), positions);
 
-            primitives[dst]->normals   = ((it->second)->normals);
-            primitives[dst]->colors    = ((it->second)->colors);
-            primitives[dst]->indices   = ((it->second)->indices);
+            primitives[dst]->normals   = (source->normals);
+            primitives[dst]->colors    = (source->colors);
+            primitives[dst]->indices   = (source->indices);
         }
         std::string err = std::string("Primitive set not found : ") + src + std::string(" or ") + dst;
         throw std::runtime_error(err);
@@ -385,11 +768,13 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::copy_all_primitive_sets(const GeometryDescriptor& src) {
         
         for(auto& primitive_set : src.primitives) {
-            primitives[primitive_set.first] = std::make_shared<PrimitiveSetInstance>(primitive_set.first, primitive_set.second->get_primitive_type_enum(), positions);
+            const std::shared_ptr<PrimitiveSetInstance> destination = std::make_shared<PrimitiveSetInstance>(primitive_set.first, primitive_set.second->get_primitive_type_enum(), positions);
 
-            *(primitives[primitive_set.first]->normals)   = *(primitive_set.second->normals);
-            *(primitives[primitive_set.first]->colors)    = *(primitive_set.second->colors);
-            *(primitives[primitive_set.first]->indices)   = *(primitive_set.second->indices);
+            /// Fresh buffers, never written through a pointer src or a clone of it may still hold
+            destination->normals = std::make_shared<std::vector<float>>(*(primitive_set.second->normals));
+            destination->colors  = std::make_shared<std::vector<uint8_t>>(*(primitive_set.second->colors));
+            destination->indices = std::make_shared<std::vector<uint32_t>>(*(primitive_set.second->indices));
+            primitives[primitive_set.first] = destination;
         }
 
     }
@@ -412,11 +797,13 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::share_attrib_array(const std::string& src , const std::string& dst , PrimitiveSetInstance::VertexAttribArrayType type) {
         auto it = primitives.find(src);
         if (it != primitives.end()) {
-            auto& primitiveSet = it->second;
+            const std::shared_ptr<PrimitiveSetInstance> primitiveSet = it->second;
             switch (type)
             {
             case PrimitiveSetInstance::POSITION_ARRAY:
                 primitives[dst]->positions = primitiveSet->positions;
+                primitives[dst]->interleaved_vertices = primitiveSet->interleaved_vertices;
+                primitives[dst]->invalidate_bounding_box();
                 break;
             case PrimitiveSetInstance::NORMAL_ARRAY:
                 primitives[dst]->normals = primitiveSet->normals;
@@ -442,20 +829,25 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::copy_attrib_array(const std::string& src , const std::string& dst , PrimitiveSetInstance::VertexAttribArrayType type) {
         auto it = primitives.find(src);
         if (it != primitives.end()) {
-            auto& primitiveSet = it->second;
+            const std::shared_ptr<PrimitiveSetInstance> primitiveSet = it->second;
+            const std::shared_ptr<PrimitiveSetInstance> destination = primitives[dst];
+            detach_attrib_array(destination, type);
             switch (type)
             {
             case PrimitiveSetInstance::POSITION_ARRAY:
-                *(primitives[dst]->positions) = *(primitiveSet->positions);
+                *(destination->positions) = *(primitiveSet->positions);
+                for (auto& primitive : primitives)
+                    if (primitive.second->positions == destination->positions)
+                        primitive.second->invalidate_bounding_box();
                 break;
             case PrimitiveSetInstance::NORMAL_ARRAY:
-                *(primitives[dst]->normals)   = *(primitiveSet->normals);
+                *(destination->normals)   = *(primitiveSet->normals);
                 break;  
             case PrimitiveSetInstance::COLOR_ARRAY:
-                *(primitives[dst]->colors)    = *(primitiveSet->colors);
+                *(destination->colors)    = *(primitiveSet->colors);
                 break;  
             case PrimitiveSetInstance::INDEX_ARRAY:
-                *(primitives[dst]->indices)   = *(primitiveSet->indices);
+                *(destination->indices)   = *(primitiveSet->indices);
                 break;
             }
             return;
@@ -490,18 +882,21 @@ namespace GridPro_GFX {
     /// @brief Share Pointer to the Positions
     __INLINE__ void GeometryDescriptor::share_positions_shared_ptr(std::shared_ptr<std::vector<float>> &in_position)
     {
+        require_separate_attrib_storage("share_positions_shared_ptr");
         currentPrimitiveSet->share_position_shared_ptr(in_position);
     }
 
     /// @brief Share Pointer to the Normals
     __INLINE__ void GeometryDescriptor::share_normals_shared_ptr(std::shared_ptr<std::vector<float>> &in_normal)
     {
+        require_separate_attrib_storage("share_normals_shared_ptr");
         currentPrimitiveSet->share_normals_shared_ptr(in_normal);
     }
 
     /// @brief Share Pointer to the Colors
     __INLINE__ void GeometryDescriptor::share_colors_shared_ptr(std::shared_ptr<std::vector<uint8_t>> &in_color)
     {
+        require_separate_attrib_storage("share_colors_shared_ptr");
         currentPrimitiveSet->share_colors_shared_ptr(in_color);
     }
 
@@ -690,6 +1085,13 @@ namespace GridPro_GFX {
     {
         currentPrimitiveSet->set_line_width(width);
     }
+
+    /// @brief  Enable the compressed GPU vertex format for the current primitive set
+    /// @param bool flag
+    __INLINE__ void GeometryDescriptor::set_vertex_compression(const bool& flag)
+    {
+        currentPrimitiveSet->set_vertex_compression(flag);
+    }
     
     /// @brief  Update the vertex at a given index
     /// @param std::array<float, 3> translation_vector
@@ -697,11 +1099,12 @@ namespace GridPro_GFX {
     __INLINE__ void GeometryDescriptor::translate_vertex(const std::array<float, 3>& translation_vector, const uint32_t& index = 0xffffffff)
     {
         std::array<float, 3> position;
-        float* old_pos = currentPrimitiveSet->get_vertex_ref(index);
+        const float* old_pos = currentPrimitiveSet->get_vertex_ref(index);
+        if(old_pos == nullptr) return;
         position[0] = old_pos[0] + translation_vector[0];
         position[1] = old_pos[1] + translation_vector[1];
         position[2] = old_pos[2] + translation_vector[2];
-        currentPrimitiveSet->update_vertex(position, index);
+        update_vertex(position, index);
     }
 
     /// @brief  Update the vertex at a given index
@@ -709,7 +1112,192 @@ namespace GridPro_GFX {
     /// @param uint32_t index
     __INLINE__ void GeometryDescriptor::update_vertex(const std::array<float, 3>& position, const uint32_t& index = 0xffffffff)
     {
+        const float* old_pos = get_vertex_write_ref(index);
+        if(old_pos == nullptr) return;
+        const std::array<float, 3> old_position = {old_pos[0], old_pos[1], old_pos[2]};
+
         currentPrimitiveSet->update_vertex(position, index);
+
+        /// Other primitive sets sharing the positions see the same move, and their VBOs need the same upload
+        const void* storage = currentPrimitiveSet->attrib_storage(PrimitiveSetInstance::POSITION_ARRAY);
+        for(auto& primitive : primitives)
+            if(primitive.second != currentPrimitiveSet && primitive.second->attrib_storage(PrimitiveSetInstance::POSITION_ARRAY) == storage)
+            {
+                primitive.second->update_bounding_box(old_position, position);
+                primitive.second->record_vertex_update(index);
+            }
+    }
+
+    __INLINE__ float* GeometryDescriptor::get_vertex_write_ref(const uint32_t& index)
+    {
+        detach_attrib_array(PrimitiveSetInstance::POSITION_ARRAY);
+        return currentPrimitiveSet->vertex_data(index);
+    }
+
+    /// @brief Detach the positions of the current primitive set and expose them for a bulk write
+    /// @param stride_bytes  set to the distance between two positions
+    /// @return nullptr if the set has no positions
+    __INLINE__ float* GeometryDescriptor::begin_position_write(size_t& stride_bytes)
+    {
+        detach_attrib_array(PrimitiveSetInstance::POSITION_ARRAY);
+        if(currentPrimitiveSet->get_num_positions() == 0) return nullptr;
+
+        if(currentPrimitiveSet->isInterleaved())
+        {
+            stride_bytes = currentPrimitiveSet->interleaved_vertices->stride();
+            return currentPrimitiveSet->interleaved_vertices->position(0);
+        }
+
+        stride_bytes = 3 * sizeof(float);
+        return currentPrimitiveSet->positions->data();
+    }
+
+    /// @brief Record a bulk write on the current positions as one range, on every set drawing from them
+    __INLINE__ void GeometryDescriptor::end_position_write(const size_t& first_vertex, const size_t& end_vertex)
+    {
+        if(first_vertex >= end_vertex) return;
+
+        const void* storage = currentPrimitiveSet->attrib_storage(PrimitiveSetInstance::POSITION_ARRAY);
+        for(auto& primitive : primitives)
+            if(primitive.second == currentPrimitiveSet || primitive.second->attrib_storage(PrimitiveSetInstance::POSITION_ARRAY) == storage)
+            {
+                primitive.second->record_vertex_update_range(first_vertex, end_vertex);
+                primitive.second->invalidate_bounding_box();
+            }
+    }
+
+    namespace {
+
+        /// Sorted, unique copy of a vertex selection. Sorting keeps the threads on disjoint, ascending memory
+        std::vector<uint32_t> sorted_vertex_selection(const std::vector<uint32_t>& vertex_indices, const size_t& num_positions, const char* caller)
+        {
+            std::vector<uint32_t> selection(vertex_indices);
+            std::sort(selection.begin(), selection.end());
+            selection.erase(std::unique(selection.begin(), selection.end()), selection.end());
+            if(!selection.empty() && selection.back() >= num_positions)
+                throw std::runtime_error(std::string(caller) + " : vertex index out of range");
+            return selection;
+        }
+
+        /// Sorted, unique selection with the displacements of repeated indices summed in their original order,
+        /// so no two threads update the same vertex and the result does not depend on the scheduling
+        std::vector<uint32_t> sorted_vertex_displacements(const std::vector<uint32_t>& vertex_indices, const std::vector<float>& displacements,
+                                                          const size_t& num_positions, std::vector<float>& combined, const char* caller)
+        {
+            std::vector<uint32_t> order(vertex_indices.size());
+            std::iota(order.begin(), order.end(), 0u);
+            std::stable_sort(order.begin(), order.end(), [&](const uint32_t& a, const uint32_t& b) { return vertex_indices[a] < vertex_indices[b]; });
+
+            std::vector<uint32_t> selection;
+            selection.reserve(order.size());
+            combined.clear();
+            combined.reserve(displacements.size());
+            for(const uint32_t& i : order)
+            {
+                const float* displacement = &displacements[size_t(i) * 3];
+                if(!selection.empty() && selection.back() == vertex_indices[i])
+                {
+                    float* sum = &combined[combined.size() - 3];
+                    sum[0] += displacement[0]; sum[1] += displacement[1]; sum[2] += displacement[2];
+                    continue;
+                }
+                selection.push_back(vertex_indices[i]);
+                combined.insert(combined.end(), displacement, displacement + 3);
+            }
+
+            if(!selection.empty() && selection.back() >= num_positions)
+                throw std::runtime_error(std::string(caller) + " : vertex index out of range");
+            return selection;
+        }
+
+        void validate_vertex_range(const size_t& first_vertex, const size_t& num_vertices, const size_t& num_positions, const char* caller)
+        {
+            if(first_vertex > num_positions || num_vertices > num_positions - first_vertex)
+                throw std::runtime_error(std::string(caller) + " : vertex range out of range");
+        }
+
+    } // namespace
+
+    /// @brief Translate a selection of vertices of the current primitive set
+    __INLINE__ void GeometryDescriptor::translate_vertices(const std::array<float, 3>& translation_vector, const std::vector<uint32_t>& vertex_indices)
+    {
+        const std::vector<uint32_t> selection = sorted_vertex_selection(vertex_indices, currentPrimitiveSet->get_num_positions(), "translate_vertices");
+        if(selection.empty()) return;
+
+        size_t stride = 0;
+        float* positions = begin_position_write(stride);
+        VertexTransform::translate(positions, stride, selection.data(), selection.size(), translation_vector);
+        end_position_write(selection.front(), size_t(selection.back()) + 1);
+    }
+
+    /// @brief Translate a contiguous range of vertices of the current primitive set
+    __INLINE__ void GeometryDescriptor::translate_vertices(const std::array<float, 3>& translation_vector, const size_t& first_vertex, const size_t& num_vertices)
+    {
+        validate_vertex_range(first_vertex, num_vertices, currentPrimitiveSet->get_num_positions(), "translate_vertices");
+        if(num_vertices == 0) return;
+
+        size_t stride = 0;
+        float* positions = begin_position_write(stride);
+        positions = reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(positions) + first_vertex * stride);
+        VertexTransform::translate(positions, stride, nullptr, num_vertices, translation_vector);
+        end_position_write(first_vertex, first_vertex + num_vertices);
+    }
+
+    /// @brief Apply an affine matrix to a selection of vertices of the current primitive set
+    __INLINE__ void GeometryDescriptor::transform_vertices(const std::array<float, 16>& matrix, const std::vector<uint32_t>& vertex_indices)
+    {
+        const std::vector<uint32_t> selection = sorted_vertex_selection(vertex_indices, currentPrimitiveSet->get_num_positions(), "transform_vertices");
+        if(selection.empty()) return;
+
+        size_t stride = 0;
+        float* positions = begin_position_write(stride);
+        VertexTransform::transform_affine(positions, stride, selection.data(), selection.size(), matrix);
+        end_position_write(selection.front(), size_t(selection.back()) + 1);
+    }
+
+    /// @brief Apply an affine matrix to a contiguous range of vertices of the current primitive set
+    __INLINE__ void GeometryDescriptor::transform_vertices(const std::array<float, 16>& matrix, const size_t& first_vertex, const size_t& num_vertices)
+    {
+        validate_vertex_range(first_vertex, num_vertices, currentPrimitiveSet->get_num_positions(), "transform_vertices");
+        if(num_vertices == 0) return;
+
+        size_t stride = 0;
+        float* positions = begin_position_write(stride);
+        positions = reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(positions) + first_vertex * stride);
+        VertexTransform::transform_affine(positions, stride, nullptr, num_vertices, matrix);
+        end_position_write(first_vertex, first_vertex + num_vertices);
+    }
+
+    /// @brief Displace a selection of vertices, displacements[3i .. 3i+2] moves vertex_indices[i]
+    __INLINE__ void GeometryDescriptor::displace_vertices(const std::vector<float>& displacements, const std::vector<uint32_t>& vertex_indices)
+    {
+        if(displacements.size() != vertex_indices.size() * 3)
+            throw std::runtime_error("displace_vertices : expected 3 displacement components per vertex index");
+        std::vector<float> combined;
+        const std::vector<uint32_t> selection = sorted_vertex_displacements(vertex_indices, displacements, currentPrimitiveSet->get_num_positions(), combined, "displace_vertices");
+        if(selection.empty()) return;
+
+        size_t stride = 0;
+        float* positions = begin_position_write(stride);
+        VertexTransform::displace(positions, stride, selection.data(), selection.size(), combined.data());
+        end_position_write(selection.front(), size_t(selection.back()) + 1);
+    }
+
+    /// @brief Add a displacement field to the contiguous vertices starting at first_vertex
+    __INLINE__ void GeometryDescriptor::displace_vertices(const std::vector<float>& displacements, const size_t& first_vertex)
+    {
+        if(displacements.size() % 3 != 0)
+            throw std::runtime_error("displace_vertices : displacement field size is not a multiple of 3");
+
+        const size_t num_vertices = displacements.size() / 3;
+        validate_vertex_range(first_vertex, num_vertices, currentPrimitiveSet->get_num_positions(), "displace_vertices");
+        if(num_vertices == 0) return;
+
+        size_t stride = 0;
+        float* positions = begin_position_write(stride);
+        positions = reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(positions) + first_vertex * stride);
+        VertexTransform::displace(positions, stride, nullptr, num_vertices, displacements.data());
+        end_position_write(first_vertex, first_vertex + num_vertices);
     }
 
     /// @brief check if the Node Manipulation is enabled
@@ -733,56 +1321,730 @@ namespace GridPro_GFX {
         return currentPrimitiveSet->get_bounding_box();
     }
 
-    GeometryDescriptor::PrimitiveSetInstance::PrimitiveSetInstance(
-        const std::string &_InstanceName, GLenum _PrimitiveType,
-        const std::shared_ptr<std::vector<float>> &geometry_pos_array)
-        : InstanceName(_InstanceName), primitiveType(static_cast<PrimitiveType>(_PrimitiveType)),
+    /// @brief Get the union of the Bounding Boxes of all drawable primitive sets
+    /// @return std::array<float, 6>
+    __INLINE__ std::array<float, 6> GeometryDescriptor::get_total_bounding_box() const
+    {
+        std::array<float, 6> total = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        bool is_empty = true;
+        for(const auto& primitive : primitives)
+        {
+            if(!primitive.second->isDrawable()) continue;
+            const std::array<float, 6> bbox = primitive.second->get_instanced_bounding_box();
+            if(is_empty) { total = bbox; is_empty = false; continue; }
+            for(int axis = 0; axis < 3; axis++)
+            {
+                total[axis]     = std::min(total[axis], bbox[axis]);
+                total[axis + 3] = std::max(total[axis + 3], bbox[axis + 3]);
+            }
+        }
+        return total;
+    }
 
-          colorFormat(RGB), colorScheme(PER_PRIMITIVE_SET), shadingModel(FLAT), wireframeMode(WIREFRAME_NONE),
+    /// @brief Set the Bounding Box of the current primitive set
+    /// @param std::array<float, 6> bounding_box
+    __INLINE__ void GeometryDescriptor::set_bounding_box(const std::array<float, 6>& bounding_box)
+    {
+        currentPrimitiveSet->set_bounding_box(bounding_box);
+    }
 
-          materialProperty(COLOR_MATERIAL), blendfunc(BLEND_NONE), pickScheme(PICK_NONE), dirtyFlags(DIRTY_NONE),
+    /// @brief Drop the cached bounding box of every primitive set sharing the current position array
+    __INLINE__ void GeometryDescriptor::build_lod_chain(const SimplificationOptions& options)
+    {
+        if (currentPrimitiveSet->primitiveType != PrimitiveSetInstance::TRIANGLES)
+            throw std::runtime_error(std::string("build_lod_chain : Primitive set ") + currentPrimitiveSetInstanceName + " is not GL_TRIANGLES");
 
-          is_hover_highlightable(false), is_already_hover_highlighted(false),
+        PrimitiveSetInstance& set = *currentPrimitiveSet;
+        const float* pos = set.isInterleaved() ? set.interleaved_vertices->position(0) : set.positions->data();
+        const size_t stride = set.isInterleaved() ? set.interleaved_vertices->stride() : 3 * sizeof(float);
+        const uint32_t* index_data = set.indices->empty() ? nullptr : set.indices->data();
 
-          is_select_highlightable(false), is_select_highlighted(false),
+        MeshSimplifier simplifier(pos, set.get_num_positions(), stride, index_data, set.indices->size());
+        set.set_lod_chain(simplifier.build_lod_chain(options));
+        GP_TRACE("Built ", set.get_num_lod_levels() - 1, " levels of detail for primitive set ", currentPrimitiveSetInstanceName);
+    }
 
-          is_using_custom_highlight_color(false), is_node_manipulation_enabled(false),
+    __INLINE__ void GeometryDescriptor::clear_lod_chain()
+    {
+        currentPrimitiveSet->clear_lod_chain();
+    }
 
-          color(0, 0, 255, 255), highlightcolor(255, 255, 255, 255), selection_highlight_color(0, 0, 255, 255),
+    __INLINE__ void GeometryDescriptor::triangulate_primitive_set()
+    {
+        PrimitiveSetInstance& set = *currentPrimitiveSet;
+        if (!set.requiresTriangulation())
+            throw std::runtime_error(std::string("triangulate_primitive_set : Primitive set ") + currentPrimitiveSetInstanceName + " is not GL_QUADS, GL_QUAD_STRIP or GL_POLYGON");
 
-          custom_highlight_color(0, 255, 0, 255), wireframecolor(0, 0, 200, 255),
+        const float* pos = set.isInterleaved() ? set.interleaved_vertices->position(0) : set.positions->data();
+        const size_t stride = set.isInterleaved() ? set.interleaved_vertices->stride() : 3 * sizeof(float);
+        const size_t num_positions = set.get_num_positions();
+        const uint32_t* index_data = set.indices->empty() ? nullptr : set.indices->data();
+        const size_t num_vertices = set.get_num_vertices();
+
+        switch (set.primitiveType)
+        {
+            case PrimitiveSetInstance::QUADS:
+                set.set_triangulation(Triangulator::triangulate_quads(index_data, num_vertices / 4, pos, num_positions, stride));
+                break;
+            case PrimitiveSetInstance::QUAD_STRIP:
+                set.set_triangulation(Triangulator::triangulate_quad_strip(index_data, num_vertices, pos, num_positions, stride));
+                break;
+            default:
+                set.set_triangulation(Triangulator::triangulate_polygon(index_data, num_vertices, pos, num_positions, stride));
+                break;
+        }
+        GP_TRACE("Triangulated ", currentPrimitiveSetInstanceName, " into ", set.triangulation->get_num_triangles(), " triangles");
+    }
 
-          line_width(1.0f), point_size(10.0f),
+    __INLINE__ void GeometryDescriptor::set_instance_prototype(const GeometryDescriptor& prototype)
+    {
+        const std::shared_ptr<PrimitiveSetInstance> source = prototype.currentPrimitiveSet;
+        if (source == nullptr || source->get_num_positions() == 0)
+            throw std::runtime_error(std::string("set_instance_prototype : prototype of ") + currentPrimitiveSetInstanceName + " has no vertices");
 
-          material_ambient({0.1f, 0.1f, 0.1f, 1.0f}), material_diffuse({0.1f, 0.1f, 0.1f, 1.0f}),
+        PrimitiveSetInstance& set = *currentPrimitiveSet;
+        if (&set == source.get())
+            return;
 
-          material_specular({0.3f, 0.3f, 0.8f, 1.0f}), material_emission({0.0f, 0.0f, 0.0f, 1.0f}),
-          material_shininess(32.0f)
+        if (set.get_primitive_type() != source->get_primitive_type())
+            throw std::runtime_error(std::string("set_instance_prototype : primitive type of ") + currentPrimitiveSetInstanceName + " differs from its prototype");
+
+        set.positions            = source->positions;
+        set.normals              = source->normals;
+        set.colors               = source->colors;
+        set.indices              = source->indices;
+        set.interleaved_vertices = source->interleaved_vertices;
+        set.lod_chain                        = source->lod_chain;
+        set.lod_base_num_positions           = source->lod_base_num_positions;
+        set.lod_base_num_indices             = source->lod_base_num_indices;
+        set.triangulation                    = source->triangulation;
+        set.triangulation_base_num_positions = source->triangulation_base_num_positions;
+        set.triangulation_base_num_indices   = source->triangulation_base_num_indices;
+        set.strips                           = source->strips;
+
+        /// Both sides keep reading the same buffers until one of them writes
+        set.set_copy_on_write_all();
+        source->set_copy_on_write_all();
+
+        set.invalidate_bounding_box();
+        set.clear_dirty_ranges();
+        set.setDirty(PrimitiveSetInstance::DIRTY_POSITIONS | PrimitiveSetInstance::DIRTY_NORMALS | PrimitiveSetInstance::DIRTY_COLORS | PrimitiveSetInstance::DIRTY_INDICES);
+        instances_for_write();
+    }
+
+    __INLINE__ InstanceArray& GeometryDescriptor::instances_for_write()
     {
-        positions = geometry_pos_array;
-        normals = std::make_shared<std::vector<float>>(0);
-        colors = std::make_shared<std::vector<uint8_t>>(0);
-        indices = std::make_shared<std::vector<uint32_t>>(0);
-        pickScheme = PICK_NONE;
+        std::shared_ptr<InstanceArray>& instances = currentPrimitiveSet->instances;
+        if (instances == nullptr)
+            instances = std::make_shared<InstanceArray>();
+        else if (instances.use_count() > 1)
+            instances = std::make_shared<InstanceArray>(*instances);
+        return *instances;
     }
 
-    std::shared_ptr<GeometryDescriptor::PrimitiveSetInstance> GeometryDescriptor::PrimitiveSetInstance::clone()
+    __INLINE__ void GeometryDescriptor::push_instance(const std::array<float, 16>& matrix)
     {
-        std::shared_ptr<PrimitiveSetInstance> clone =
-            std::make_shared<PrimitiveSetInstance>(InstanceName, static_cast<GLenum>(primitiveType), positions);
+        instances_for_write().push_instance(matrix);
+    }
 
-        PrimitiveSetInstance &clone_instance = *clone;
+    __INLINE__ void GeometryDescriptor::push_instance(const std::array<float, 16>& matrix, const std::array<uint8_t, 4>& color)
+    {
+        instances_for_write().push_instance(matrix, color);
+    }
 
-        clone_instance.colorFormat = colorFormat;
-        clone_instance.colorScheme = colorScheme;
-        clone_instance.shadingModel = shadingModel;
-        clone_instance.wireframeMode = wireframeMode;
-        clone_instance.materialProperty = materialProperty;
-        clone_instance.blendfunc = blendfunc;
-        clone_instance.pickScheme = pickScheme;
-        clone_instance.dirtyFlags = dirtyFlags;
-        clone_instance.is_hover_highlightable = is_hover_highlightable;
-        clone_instance.is_already_hover_highlighted = is_already_hover_highlighted;
+    __INLINE__ void GeometryDescriptor::move_instance_arrays(std::vector<float>&& transforms, std::vector<uint8_t>&& colors)
+    {
+        instances_for_write().assign(std::move(transforms), std::move(colors));
+    }
+
+    __INLINE__ void GeometryDescriptor::update_instance_transform(const size_t& instance, const std::array<float, 16>& matrix)
+    {
+        if (instance >= currentPrimitiveSet->get_num_instances())
+            throw std::runtime_error(std::string("update_instance_transform : instance out of range in ") + currentPrimitiveSetInstanceName);
+        instances_for_write().set_transform(instance, matrix);
+    }
+
+    __INLINE__ void GeometryDescriptor::update_instance_color(const size_t& instance, const std::array<uint8_t, 4>& color)
+    {
+        if (instance >= currentPrimitiveSet->get_num_instances())
+            throw std::runtime_error(std::string("update_instance_color : instance out of range in ") + currentPrimitiveSetInstanceName);
+        instances_for_write().set_color(instance, color);
+    }
+
+    __INLINE__ void GeometryDescriptor::reserve_instances(const size_t& num_instances)
+    {
+        instances_for_write().reserve(num_instances);
+    }
+
+    __INLINE__ void GeometryDescriptor::clear_instances()
+    {
+        if (currentPrimitiveSet->isInstanced())
+            instances_for_write().clear();
+    }
+
+    __INLINE__ PrimitiveColorArray& GeometryDescriptor::primitive_colors_for_write()
+    {
+        std::shared_ptr<PrimitiveColorArray>& primitive_colors = currentPrimitiveSet->primitive_colors;
+        if (primitive_colors == nullptr)
+            primitive_colors = std::make_shared<PrimitiveColorArray>();
+        else if (primitive_colors.use_count() > 1)
+            primitive_colors = std::make_shared<PrimitiveColorArray>(*primitive_colors);
+        return *primitive_colors;
+    }
+
+    __INLINE__ void GeometryDescriptor::move_primitive_color_array(std::vector<uint8_t>&& colors)
+    {
+        primitive_colors_for_write().assign(std::move(colors));
+        currentPrimitiveSet->set_color_scheme(PrimitiveSetInstance::PER_PRIMITIVE);
+    }
+
+    __INLINE__ void GeometryDescriptor::update_primitive_color(const size_t& primitive, const std::array<uint8_t, 4>& color)
+    {
+        if (currentPrimitiveSet->primitive_colors == nullptr || primitive >= currentPrimitiveSet->primitive_colors->size())
+            throw std::runtime_error(std::string("update_primitive_color : primitive out of range in ") + currentPrimitiveSetInstanceName);
+        primitive_colors_for_write().set_color(primitive, color);
+    }
+
+    __INLINE__ void GeometryDescriptor::clear_primitive_colors()
+    {
+        currentPrimitiveSet->primitive_colors.reset();
+        if (currentPrimitiveSet->get_color_scheme() == PrimitiveSetInstance::PER_PRIMITIVE)
+            currentPrimitiveSet->set_color_scheme(PrimitiveSetInstance::PER_PRIMITIVE_SET);
+    }
+
+    __INLINE__ StripArray& GeometryDescriptor::strips_for_write()
+    {
+        std::shared_ptr<StripArray>& strips = currentPrimitiveSet->strips;
+        if (strips == nullptr)
+            strips = std::make_shared<StripArray>();
+        else if (strips.use_count() > 1)
+            strips = std::make_shared<StripArray>(*strips);
+        return *strips;
+    }
+
+    namespace {
+
+        /// Throw unless the set is a strip type whose num_vertices vertices (indices or positions) all belong to its
+        /// strips, none for a new set
+        void check_strip_append(const GeometryDescriptor::PrimitiveSetInstance& set, const size_t& num_vertices, const char* caller)
+        {
+            if(!set.supportsStrips())
+                throw std::runtime_error(std::string(caller) + " : " + set.get_instance_name() + " is not a line strip, line loop, triangle strip or triangle fan set");
+
+            const size_t strip_vertices = set.isMultiStrip() ? set.get_strips()->get_num_vertices() : 0;
+            if(strip_vertices != num_vertices)
+                throw std::runtime_error(std::string(caller) + " : " + set.get_instance_name() + " has vertices outside its strips");
+        }
+    }
+
+    __INLINE__ void GeometryDescriptor::push_strip(const std::vector<float>& positions)
+    {
+        if (currentPrimitiveSet->get_num_indices() != 0 || currentPrimitiveSet->isInterleaved())
+            throw std::runtime_error(std::string("push_strip : ") + currentPrimitiveSetInstanceName + " is indexed or interleaved, use push_strip_indices");
+        check_strip_append(*currentPrimitiveSet, currentPrimitiveSet->get_num_positions(), "push_strip");
+        if (positions.size() % 3 != 0)
+            throw std::runtime_error(std::string("push_strip : position array size is not a multiple of 3 in ") + currentPrimitiveSetInstanceName);
+
+        push_pos_array(positions);
+        strips_for_write().push_strip(static_cast<uint32_t>(positions.size() / 3));
+    }
+
+    __INLINE__ void GeometryDescriptor::push_strip_indices(const std::vector<uint32_t>& strip_indices)
+    {
+        check_strip_append(*currentPrimitiveSet, currentPrimitiveSet->get_num_indices(), "push_strip_indices");
+        push_index_array(strip_indices);
+        strips_for_write().push_strip(static_cast<uint32_t>(strip_indices.size()));
+    }
+
+    __INLINE__ void GeometryDescriptor::move_strip_offsets(std::vector<uint32_t>&& strip_offsets)
+    {
+        if (!currentPrimitiveSet->supportsStrips())
+            throw std::runtime_error(std::string("move_strip_offsets : ") + currentPrimitiveSetInstanceName + " is not a line strip, line loop, triangle strip or triangle fan set");
+        if (strip_offsets.empty() || strip_offsets.back() != currentPrimitiveSet->get_num_vertices())
+            throw std::runtime_error(std::string("move_strip_offsets : strip offsets do not end at the vertex count of ") + currentPrimitiveSetInstanceName);
+
+        strips_for_write().assign(std::move(strip_offsets));
+    }
+
+    __INLINE__ void GeometryDescriptor::clear_strips()
+    {
+        currentPrimitiveSet->strips.reset();
+    }
+
+    __INLINE__ bool GeometryDescriptor::collect_vertex_sharing_sets(std::vector<std::shared_ptr<PrimitiveSetInstance>>& group) const
+    {
+        group.clear();
+        const void* storage = currentPrimitiveSet->attrib_storage(PrimitiveSetInstance::POSITION_ARRAY);
+        bool is_order_independent = true;
+        for (auto& primitive : primitives)
+        {
+            if (primitive.second->attrib_storage(PrimitiveSetInstance::POSITION_ARRAY) != storage)
+                continue;
+            if (primitive.second != currentPrimitiveSet && primitive.second->indices->empty() && primitive.second->primitiveType != PrimitiveSetInstance::POINTS)
+                is_order_independent = false;
+            group.push_back(primitive.second);
+        }
+        return is_order_independent;
+    }
+
+    __INLINE__ std::vector<uint32_t> GeometryDescriptor::optimize_vertex_order(const bool& reorder_vertices)
+    {
+        const std::shared_ptr<PrimitiveSetInstance> primitiveSet = currentPrimitiveSet;
+        if (primitiveSet->primitiveType != PrimitiveSetInstance::TRIANGLES || primitiveSet->indices->empty())
+            throw std::runtime_error(std::string("optimize_vertex_order : Primitive set ") + currentPrimitiveSetInstanceName + " is not an indexed GL_TRIANGLES set");
+
+        detach_attrib_array(PrimitiveSetInstance::INDEX_ARRAY);
+        std::vector<uint32_t>& index_array = *primitiveSet->indices;
+        const size_t num_vertices = primitiveSet->get_num_positions();
+        const float* pos = primitiveSet->isInterleaved() ? primitiveSet->interleaved_vertices->position(0) : primitiveSet->positions->data();
+        const size_t stride = primitiveSet->isInterleaved() ? primitiveSet->interleaved_vertices->stride() : 3 * sizeof(float);
+
+        const float acmr_before = MeshOptimizer::compute_acmr(index_array.data(), index_array.size(), num_vertices);
+        MeshOptimizer::optimize_vertex_cache(index_array.data(), index_array.size(), num_vertices);
+        MeshOptimizer::optimize_overdraw(index_array.data(), index_array.size(), pos, num_vertices, stride);
+        GP_TRACE("Vertex cache miss ratio of ", currentPrimitiveSetInstanceName, " : ", acmr_before, " -> ",
+                 MeshOptimizer::compute_acmr(index_array.data(), index_array.size(), num_vertices));
+
+        for (auto& primitive : primitives)
+            if (primitive.second->indices == primitiveSet->indices)
+                primitive.second->mark_dirty_range(PrimitiveSetInstance::INDEX_ARRAY, 0, index_array.size() * sizeof(uint32_t));
+
+        if (!reorder_vertices)
+            return {};
+
+        /// Every set drawing from the same vertices has to follow the new order
+        std::vector<std::shared_ptr<PrimitiveSetInstance>> group;
+        if (!collect_vertex_sharing_sets(group))
+        {
+            GP_TRACE("optimize_vertex_order : vertices of ", currentPrimitiveSetInstanceName, " are shared with a non indexed set, only the triangles were reordered");
+            return {};
+        }
+
+        /// Shared copy-on-write buffers get a private copy before they are permuted
+        const std::shared_ptr<PrimitiveSetInstance> current = currentPrimitiveSet;
+        for (auto& member : group)
+        {
+            currentPrimitiveSet = member;
+            detach_attrib_array(PrimitiveSetInstance::POSITION_ARRAY);
+            detach_attrib_array(PrimitiveSetInstance::NORMAL_ARRAY);
+            detach_attrib_array(PrimitiveSetInstance::COLOR_ARRAY);
+            detach_attrib_array(PrimitiveSetInstance::INDEX_ARRAY);
+        }
+        currentPrimitiveSet = current;
+
+        const std::vector<uint32_t> remap = MeshOptimizer::compute_vertex_fetch_remap(index_array.data(), index_array.size(), num_vertices);
+        std::vector<uint32_t> new_order(num_vertices);
+        for (size_t v = 0; v < num_vertices; v++)
+            new_order[remap[v]] = uint32_t(v);
+
+        /// Buffers shared by several sets of the group are permuted once
+        std::vector<const void*> permuted;
+        auto claim = [&](const void* storage) -> bool
+        {
+            if (storage == nullptr || std::find(permuted.begin(), permuted.end(), storage) != permuted.end())
+                return false;
+            permuted.push_back(storage);
+            return true;
+        };
+
+        auto permute = [&](auto& array, const size_t& components)
+        {
+            if (!claim(&array) || array.size() != num_vertices * components)
+                return false;
+            typename std::decay<decltype(array)>::type reordered(array.size());
+            for (size_t v = 0; v < num_vertices; v++)
+                std::copy_n(array.begin() + v * components, components, reordered.begin() + size_t(remap[v]) * components);
+            array.swap(reordered);
+            return true;
+        };
+
+        for (auto& member : group)
+        {
+            PrimitiveSetInstance& set = *member;
+            if (set.isInterleaved())
+            {
+                if (claim(set.interleaved_vertices.get()))
+                    *set.interleaved_vertices = set.interleaved_vertices->gather(new_order);
+            }
+            else
+            {
+                permute(*set.positions, 3);
+            }
+
+            permute(*set.normals, 3);
+            permute(*set.colors, set.colorFormat == PrimitiveSetInstance::RGBA ? 4 : 3);
+
+            if (claim(set.indices.get()))
+                for (uint32_t& index : *set.indices)
+                    index = remap[index];
+
+            if (set.lod_chain)
+            {
+                std::vector<LodLevel> levels = *set.lod_chain;
+                for (LodLevel& level : levels)
+                    for (uint32_t& index : level.indices)
+                        index = remap[index];
+                set.lod_chain = std::make_shared<const std::vector<LodLevel>>(std::move(levels));
+            }
+
+            if (set.triangulation)
+            {
+                Triangulation remapped = *set.triangulation;
+                for (uint32_t& index : remapped.indices)
+                    index = remap[index];
+                for (uint32_t& index : remapped.edge_indices)
+                    index = remap[index];
+                set.triangulation = std::make_shared<const Triangulation>(std::move(remapped));
+            }
+
+            const size_t vertex_bytes = set.isInterleaved() ? num_vertices * set.interleaved_vertices->stride() : num_vertices * 3 * sizeof(float);
+            set.mark_dirty_range(PrimitiveSetInstance::POSITION_ARRAY, 0, vertex_bytes);
+            if (!set.isInterleaved())
+            {
+                set.mark_dirty_range(PrimitiveSetInstance::NORMAL_ARRAY, 0, set.normals->size() * sizeof(float));
+                set.mark_dirty_range(PrimitiveSetInstance::COLOR_ARRAY, 0, set.colors->size());
+            }
+            set.mark_dirty_range(PrimitiveSetInstance::INDEX_ARRAY, 0, set.indices->size() * sizeof(uint32_t));
+        }
+
+        return remap;
+    }
+
+namespace {
+
+    /// Primitive shape for the cleanup : vertices per primitive and distinct vertices needed to cover any area.
+    /// Strips, fans, loops and polygons are connected through their order and are only welded
+    void primitive_cleanup_shape(const GeometryDescriptor::PrimitiveSetInstance::PrimitiveType& type, uint32_t& vertices_per_primitive, uint32_t& min_distinct)
+    {
+        using PrimitiveSetInstance = GeometryDescriptor::PrimitiveSetInstance;
+        switch (type)
+        {
+            case PrimitiveSetInstance::POINTS:    vertices_per_primitive = 1; min_distinct = 1; break;
+            case PrimitiveSetInstance::LINES:     vertices_per_primitive = 2; min_distinct = 2; break;
+            case PrimitiveSetInstance::TRIANGLES: vertices_per_primitive = 3; min_distinct = 3; break;
+            case PrimitiveSetInstance::QUADS:     vertices_per_primitive = 4; min_distinct = 3; break;
+            default:                              vertices_per_primitive = 0; min_distinct = 0; break;
+        }
+    }
+
+    uint64_t hash_bytes(const void* data, const size_t& size, uint64_t hash)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+        return hash;
+    }
+
+} // namespace
+
+    __INLINE__ MeshOptimizer::CleanupStatistics GeometryDescriptor::weld_vertices(const float& tolerance, const bool& compare_attributes)
+    {
+        const std::shared_ptr<PrimitiveSetInstance> primitiveSet = currentPrimitiveSet;
+        PrimitiveSetInstance& set = *primitiveSet;
+
+        MeshOptimizer::CleanupStatistics statistics;
+        const size_t num_vertices = set.get_num_positions();
+        statistics.num_vertices_before = statistics.num_vertices_after = num_vertices;
+        if (num_vertices == 0)
+            return statistics;
+
+        /// Sets sharing the vertices are welded along, unless one of them draws them in vertex order
+        std::vector<std::shared_ptr<PrimitiveSetInstance>> group;
+        const bool is_private_copy = !collect_vertex_sharing_sets(group);
+        if (is_private_copy)
+        {
+            GP_TRACE("weld_vertices : vertices of ", currentPrimitiveSetInstanceName, " are shared with a non indexed set, welding a private copy");
+            group.assign(1, primitiveSet);
+        }
+
+        const float* pos = set.isInterleaved() ? set.interleaved_vertices->position(0) : set.positions->data();
+        const size_t stride = set.isInterleaved() ? set.interleaved_vertices->stride() : 3 * sizeof(float);
+        const size_t color_components = (set.colorFormat == PrimitiveSetInstance::RGBA) ? 4 : 3;
+        const bool has_vertex_normals = !set.isInterleaved() && set.normals->size() == num_vertices * 3;
+        const bool has_vertex_colors  = !set.isInterleaved() && set.colors->size() == num_vertices * color_components;
+
+        /// Everything but the position has to match for two vertices to merge
+        std::vector<uint64_t> attribute_keys;
+        if (compare_attributes && (set.isInterleaved() ? stride > 3 * sizeof(float) : (has_vertex_normals || has_vertex_colors)))
+        {
+            attribute_keys.resize(num_vertices);
+            Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+            {
+                for (size_t v = begin; v < end; v++)
+                {
+                    uint64_t hash = 0xCBF29CE484222325ull;
+                    if (set.isInterleaved())
+                        hash = hash_bytes(set.interleaved_vertices->data() + v * stride + 3 * sizeof(float), stride - 3 * sizeof(float), hash);
+                    if (has_vertex_normals)
+                        hash = hash_bytes(set.normals->data() + v * 3, 3 * sizeof(float), hash);
+                    if (has_vertex_colors)
+                        hash = hash_bytes(set.colors->data() + v * color_components, color_components, hash);
+                    attribute_keys[v] = hash;
+                }
+            });
+        }
+
+        const std::vector<uint32_t> weld_map = MeshOptimizer::compute_weld_map(pos, num_vertices, stride, tolerance,
+                                                                               attribute_keys.empty() ? nullptr : attribute_keys.data());
+
+        /// Weld and clean every index buffer of the group once. A non indexed current set becomes indexed
+        std::vector<std::pair<const std::vector<uint32_t>*, std::shared_ptr<std::vector<uint32_t>>>> welded_indices;
+        for (auto& member : group)
+        {
+            const std::vector<uint32_t>* source = member->indices.get();
+            if (member != primitiveSet && source->empty())
+                continue;
+            if (std::find_if(welded_indices.begin(), welded_indices.end(), [&](const auto& entry) { return entry.first == source; }) != welded_indices.end())
+                continue;
+
+            auto welded = std::make_shared<std::vector<uint32_t>>(source->empty() ? num_vertices : source->size());
+            Parallel::parallel_for(0, welded->size(), [&](size_t begin, size_t end, uint32_t)
+            {
+                for (size_t i = begin; i < end; i++)
+                    (*welded)[i] = weld_map[source->empty() ? i : (*source)[i]];
+            });
+
+            uint32_t vertices_per_primitive = 0, min_distinct = 0;
+            primitive_cleanup_shape(member->primitiveType, vertices_per_primitive, min_distinct);
+            if (vertices_per_primitive != 0)
+            {
+                const size_t removed = MeshOptimizer::remove_degenerate_primitives(*welded, vertices_per_primitive, min_distinct);
+                if (member == primitiveSet) statistics.num_primitives_removed = removed;
+            }
+            welded_indices.emplace_back(source, welded);
+        }
+
+        /// Keep the referenced representatives in their original order. Non indexed point sets of the group
+        /// draw every vertex, so they keep all representatives
+        std::vector<uint8_t> referenced(num_vertices, 0);
+        for (auto& entry : welded_indices)
+            for (const uint32_t& index : *entry.second)
+                referenced[index] = 1;
+        for (auto& member : group)
+            if (member != primitiveSet && member->indices->empty())
+                for (size_t v = 0; v < num_vertices; v++)
+                    if (weld_map[v] == v) referenced[v] = 1;
+
+        std::vector<uint32_t> compact(num_vertices, 0);
+        std::vector<uint32_t> new_order;
+        new_order.reserve(num_vertices);
+        for (size_t v = 0; v < num_vertices; v++)
+            if (referenced[v])
+            {
+                compact[v] = uint32_t(new_order.size());
+                new_order.push_back(uint32_t(v));
+            }
+        const size_t num_welded = new_order.size();
+
+        for (auto& entry : welded_indices)
+            Parallel::parallel_for(0, entry.second->size(), [&](size_t begin, size_t end, uint32_t)
+            {
+                for (size_t i = begin; i < end; i++)
+                    (*entry.second)[i] = compact[(*entry.second)[i]];
+            });
+
+        /// Gather the kept vertices into new buffers. Clones and sets outside the group keep the old ones
+        auto gather = [&](const auto& source, const size_t& components)
+        {
+            auto gathered = std::make_shared<typename std::decay<decltype(source)>::type>(num_welded * components);
+            Parallel::parallel_for(0, num_welded, [&](size_t begin, size_t end, uint32_t)
+            {
+                for (size_t v = begin; v < end; v++)
+                    std::copy_n(source.begin() + size_t(new_order[v]) * components, components, gathered->begin() + v * components);
+            });
+            return gathered;
+        };
+
+        auto replace_group_buffer = [&](auto member_ptr, const size_t& components)
+        {
+            const auto old_buffer = (*primitiveSet).*member_ptr;
+            if (old_buffer == nullptr || old_buffer->size() != num_vertices * components)
+                return;
+
+            const auto new_buffer = gather(*old_buffer, components);
+            for (auto& member : group)
+                if ((*member).*member_ptr == old_buffer) (*member).*member_ptr = new_buffer;
+
+            if constexpr (std::is_same<typename std::decay<decltype(*old_buffer)>::type, std::vector<float>>::value)
+                if (positions == old_buffer && !is_private_copy) positions = new_buffer;
+        };
+
+        if (set.isInterleaved())
+        {
+            const auto old_vertices = set.interleaved_vertices;
+            const auto new_vertices = std::make_shared<InterleavedVertexArray>(old_vertices->gather(new_order));
+            for (auto& member : group)
+                if (member->interleaved_vertices == old_vertices) member->interleaved_vertices = new_vertices;
+        }
+        else
+        {
+            replace_group_buffer(&PrimitiveSetInstance::positions, 3);
+        }
+        replace_group_buffer(&PrimitiveSetInstance::normals, 3);
+        replace_group_buffer(&PrimitiveSetInstance::colors, color_components);
+
+        for (auto& member : group)
+        {
+            for (auto& entry : welded_indices)
+                if (member->indices.get() == entry.first)
+                {
+                    member->indices = entry.second;
+                    break;
+                }
+
+            member->copy_on_write_flags = 0;
+            member->clear_dirty_ranges();
+            member->invalidate_bounding_box();
+            member->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS | PrimitiveSetInstance::DIRTY_NORMALS | PrimitiveSetInstance::DIRTY_COLORS | PrimitiveSetInstance::DIRTY_INDICES);
+        }
+
+        statistics.num_vertices_after = num_welded;
+        GP_TRACE("weld_vertices : ", currentPrimitiveSetInstanceName, " ", num_vertices, " -> ", num_welded, " vertices, ",
+                 statistics.num_primitives_removed, " primitives removed");
+        return statistics;
+    }
+
+    __INLINE__ std::vector<uint32_t> GeometryDescriptor::tessellate_primitive_set(const TessellationOptions& options, const std::vector<uint32_t>& triangles)
+    {
+        const std::shared_ptr<PrimitiveSetInstance> primitiveSet = currentPrimitiveSet;
+        PrimitiveSetInstance& set = *primitiveSet;
+        if (set.primitiveType != PrimitiveSetInstance::TRIANGLES)
+            throw std::runtime_error(std::string("tessellate_primitive_set : Primitive set ") + currentPrimitiveSetInstanceName + " is not a GL_TRIANGLES set");
+        if (set.isInterleaved())
+            throw std::runtime_error(std::string("tessellate_primitive_set : Primitive set ") + currentPrimitiveSetInstanceName + " is interleaved, tessellate before interleaving");
+
+        const size_t num_vertices = set.get_num_positions();
+        const size_t color_components = (set.colorFormat == PrimitiveSetInstance::RGBA) ? 4 : 3;
+        const bool has_vertex_normals = set.normals->size() == num_vertices * 3;
+        const bool has_vertex_colors  = set.colors->size() == num_vertices * color_components;
+
+        Tessellator::TriangleMesh mesh;
+        mesh.positions        = set.positions->data();
+        mesh.num_vertices     = num_vertices;
+        mesh.normals          = has_vertex_normals ? set.normals->data() : nullptr;
+        mesh.colors           = has_vertex_colors ? set.colors->data() : nullptr;
+        mesh.color_components = color_components;
+        mesh.indices          = set.indices->empty() ? nullptr : set.indices->data();
+        mesh.num_triangles    = (set.indices->empty() ? num_vertices : set.indices->size()) / 3;
+        if (mesh.num_triangles == 0)
+            return {};
+
+        TessellationResult result = Tessellator::tessellate(mesh, options, triangles);
+
+        /// Midpoints are appended, so indexed sets sharing the vertices keep drawing the same triangles. A non indexed
+        /// set of the group would draw the midpoints too, the current set then gets private arrays
+        std::vector<std::shared_ptr<PrimitiveSetInstance>> group;
+        bool is_private_copy = !collect_vertex_sharing_sets(group);
+        for (auto& member : group)
+            if (member != primitiveSet && member->indices->empty())
+                is_private_copy = true;
+        if (is_private_copy)
+        {
+            GP_TRACE("tessellate_primitive_set : vertices of ", currentPrimitiveSetInstanceName, " are shared with a non indexed set, tessellating a private copy");
+            group.assign(1, primitiveSet);
+        }
+
+        auto replace_group_buffer = [&](auto member_ptr, auto&& new_array)
+        {
+            const auto old_buffer = (*primitiveSet).*member_ptr;
+            const auto new_buffer = std::make_shared<typename std::decay<decltype(new_array)>::type>(std::move(new_array));
+            for (auto& member : group)
+                if ((*member).*member_ptr == old_buffer) (*member).*member_ptr = new_buffer;
+
+            if constexpr (std::is_same<typename std::decay<decltype(new_array)>::type, std::vector<float>>::value)
+                if (positions == old_buffer && !is_private_copy) positions = new_buffer;
+        };
+
+        replace_group_buffer(&PrimitiveSetInstance::positions, std::move(result.positions));
+        if (has_vertex_normals) replace_group_buffer(&PrimitiveSetInstance::normals, std::move(result.normals));
+        if (has_vertex_colors)  replace_group_buffer(&PrimitiveSetInstance::colors, std::move(result.colors));
+        set.indices = std::make_shared<std::vector<uint32_t>>(std::move(result.indices));
+        set.copy_on_write_flags &= ~(1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::INDEX_ARRAY));
+
+        const uint32_t vertex_slots = (1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::POSITION_ARRAY)) |
+                                      (1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::NORMAL_ARRAY)) |
+                                      (1u << PrimitiveSetInstance::attrib_slot(PrimitiveSetInstance::COLOR_ARRAY));
+        for (auto& member : group)
+        {
+            member->copy_on_write_flags &= ~vertex_slots;
+            member->clear_dirty_ranges();
+            member->invalidate_bounding_box();
+            member->setDirty(PrimitiveSetInstance::DIRTY_POSITIONS | PrimitiveSetInstance::DIRTY_NORMALS | PrimitiveSetInstance::DIRTY_COLORS | PrimitiveSetInstance::DIRTY_INDICES);
+        }
+
+        GP_TRACE("tessellate_primitive_set : ", currentPrimitiveSetInstanceName, " ", mesh.num_triangles, " -> ", result.get_num_triangles(),
+                 " triangles, ", num_vertices, " -> ", set.get_num_positions(), " vertices");
+        return std::move(result.source_triangles);
+    }
+
+    __INLINE__ void GeometryDescriptor::invalidate_bounding_box()
+    {
+        for(auto& primitive : primitives)
+            if(primitive.second->positions == currentPrimitiveSet->positions)
+                primitive.second->invalidate_bounding_box();
+        currentPrimitiveSet->invalidate_bounding_box();
+    }
+
+    GeometryDescriptor::PrimitiveSetInstance::PrimitiveSetInstance(
+        const std::string &_InstanceName, GLenum _PrimitiveType,
+        const std::shared_ptr<std::vector<float>> &geometry_pos_array)
+        : InstanceName(_InstanceName), primitiveType(static_cast<PrimitiveType>(_PrimitiveType)),
+
+          colorFormat(RGB), colorScheme(PER_PRIMITIVE_SET), shadingModel(FLAT), wireframeMode(WIREFRAME_NONE),
+
+          materialProperty(COLOR_MATERIAL), blendfunc(BLEND_NONE), pickScheme(PICK_NONE),
+
+          m_bounding_box_num_positions(0), is_bounding_box_valid(false), dirtyFlags(DIRTY_NONE), use_vertex_compression(false), copy_on_write_flags(0),
+
+          lod_base_num_positions(0), lod_base_num_indices(0),
+
+          triangulation_base_num_positions(0), triangulation_base_num_indices(0),
+
+          material_ambient({0.1f, 0.1f, 0.1f, 1.0f}), material_diffuse({0.1f, 0.1f, 0.1f, 1.0f}),
+
+          material_specular({0.3f, 0.3f, 0.8f, 1.0f}), material_emission({0.0f, 0.0f, 0.0f, 1.0f}),
+          material_shininess(32.0f),
+
+          is_hover_highlightable(false), is_already_hover_highlighted(false),
+
+          is_select_highlightable(false), is_select_highlighted(false),
+
+          is_using_custom_highlight_color(false), is_node_manipulation_enabled(false),
+
+          color(0, 0, 255, 255), highlightcolor(255, 255, 255, 255), selection_highlight_color(0, 0, 255, 255),
+
+          custom_highlight_color(0, 255, 0, 255), wireframecolor(0, 0, 200, 255),
+
+          line_width(1.0f), point_size(10.0f)
+    {
+        positions = geometry_pos_array;
+        normals = std::make_shared<std::vector<float>>(0);
+        colors = std::make_shared<std::vector<uint8_t>>(0);
+        indices = std::make_shared<std::vector<uint32_t>>(0);
+        pickScheme = PICK_NONE;
+    }
+
+    std::shared_ptr<GeometryDescriptor::PrimitiveSetInstance> GeometryDescriptor::PrimitiveSetInstance::clone()
+    {
+        std::shared_ptr<PrimitiveSetInstance> clone =
+            std::make_shared<PrimitiveSetInstance>(InstanceName, static_cast<GLenum>(primitiveType), positions);
+
+        PrimitiveSetInstance &clone_instance = *clone;
+
+        clone_instance.colorFormat = colorFormat;
+        clone_instance.colorScheme = colorScheme;
+        clone_instance.shadingModel = shadingModel;
+        clone_instance.wireframeMode = wireframeMode;
+        clone_instance.materialProperty = materialProperty;
+        clone_instance.blendfunc = blendfunc;
+        clone_instance.pickScheme = pickScheme;
+        clone_instance.dirtyFlags = dirtyFlags;
+        clone_instance.use_vertex_compression = use_vertex_compression;
+        clone_instance.m_bounding_box = m_bounding_box;
+        clone_instance.m_bounding_box_num_positions = m_bounding_box_num_positions;
+        clone_instance.is_bounding_box_valid = is_bounding_box_valid;
+        clone_instance.is_hover_highlightable = is_hover_highlightable;
+        clone_instance.is_already_hover_highlighted = is_already_hover_highlighted;
         clone_instance.is_select_highlightable = is_select_highlightable;
         clone_instance.is_select_highlighted = is_select_highlighted;
         clone_instance.is_using_custom_highlight_color = is_using_custom_highlight_color;
@@ -799,44 +2061,145 @@ namespace GridPro_GFX {
         clone_instance.material_specular = material_specular;
         clone_instance.material_emission = material_emission;
         clone_instance.material_shininess = material_shininess;
-        clone_instance.positions = std::make_shared<std::vector<float>>(*positions);
-        clone_instance.normals = std::make_shared<std::vector<float>>(*normals);
-        clone_instance.colors = std::make_shared<std::vector<uint8_t>>(*colors);
-        clone_instance.indices = std::make_shared<std::vector<uint32_t>>(*indices);
+        // Both sides share the attribute buffers until one of them writes
+        clone_instance.positions = positions;
+        clone_instance.normals = normals;
+        clone_instance.colors = colors;
+        clone_instance.indices = indices;
+        clone_instance.interleaved_vertices = interleaved_vertices;
+        clone_instance.lod_chain = lod_chain;
+        clone_instance.lod_base_num_positions = lod_base_num_positions;
+        clone_instance.lod_base_num_indices = lod_base_num_indices;
+        clone_instance.triangulation = triangulation;
+        clone_instance.triangulation_base_num_positions = triangulation_base_num_positions;
+        clone_instance.triangulation_base_num_indices = triangulation_base_num_indices;
+        clone_instance.instances = instances;
+        clone_instance.primitive_colors = primitive_colors;
+        clone_instance.strips = strips;
+        clone_instance.set_copy_on_write_all();
+        set_copy_on_write_all();
         return clone;
     }
 
+    size_t GeometryDescriptor::PrimitiveSetInstance::select_lod_level(const float& screen_size_pixels, const float& max_pixel_error) const
+    {
+        if (!hasLodChain() || screen_size_pixels <= 0.0f)
+            return 0;
+
+        const std::array<float, 6> bb = get_bounding_box();
+        const float dx = bb[3] - bb[0], dy = bb[4] - bb[1], dz = bb[5] - bb[2];
+        const float diagonal = std::sqrt(dx * dx + dy * dy + dz * dz);
+        if (!(diagonal > 0.0f))
+            return 0;
+
+        const float pixels_per_unit = screen_size_pixels / diagonal;
+        size_t level = 0;
+        for (size_t i = 0; i < lod_chain->size(); i++)
+        {
+            if ((*lod_chain)[i].error * pixels_per_unit > max_pixel_error)
+                break;
+            level = i + 1;
+        }
+        return level;
+    }
+
     std::array<float, 6> GeometryDescriptor::PrimitiveSetInstance::get_bounding_box() const
     {
-        if (m_bounding_box)
-            return (*m_bounding_box);
+        const size_t num_positions = get_num_positions();
 
-        struct point
+        if (is_bounding_box_valid && m_bounding_box_num_positions == num_positions)
+            return m_bounding_box;
+
+        using bbox_t = std::array<float, 6>;
+        const float inf = std::numeric_limits<float>::infinity();
+        const bbox_t empty_box = {inf, inf, inf, -inf, -inf, -inf};
+
+        const float *pos = isInterleaved() ? nullptr : positions->data();
+        const size_t stride = isInterleaved() ? interleaved_vertices->stride() / sizeof(float) : 3;
+        const float *base = isInterleaved() ? interleaved_vertices->position(0) : pos;
+
+        // Per chunk min / max with branch free updates (vectorizes for the tightly packed float arrays)
+        auto reduce_chunk = [&](size_t begin, size_t end) -> bbox_t
         {
-            float x, y, z;
+            float min_x = inf, min_y = inf, min_z = inf;
+            float max_x = -inf, max_y = -inf, max_z = -inf;
+            for (size_t i = begin; i < end; i++)
+            {
+                const float *p = base + i * stride;
+                min_x = std::min(min_x, p[0]); max_x = std::max(max_x, p[0]);
+                min_y = std::min(min_y, p[1]); max_y = std::max(max_y, p[1]);
+                min_z = std::min(min_z, p[2]); max_z = std::max(max_z, p[2]);
+            }
+            return {min_x, min_y, min_z, max_x, max_y, max_z};
         };
-        point min, max;
 
-        for (int i = 0; i < positions->size(); i += 3)
+        auto merge = [](const bbox_t &a, const bbox_t &b) -> bbox_t
         {
-            const auto &pos = *positions;
-            if (min.x > pos[0])
-                min.x = pos[0];
-            if (min.x > pos[1])
-                min.x = pos[1];
-            if (min.x > pos[2])
-                min.x = pos[2];
+            return {std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]),
+                    std::max(a[3], b[3]), std::max(a[4], b[4]), std::max(a[5], b[5])};
+        };
+
+        bbox_t bbox = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        if (num_positions != 0)
+            bbox = Parallel::parallel_reduce(size_t(0), num_positions, empty_box, reduce_chunk, merge);
 
-            if (max.x < pos[0])
-                max.x = pos[1];
-            if (max.y < pos[1])
-                max.x = pos[2];
-            if (max.y < pos[2])
-                max.x = pos[3];
+        m_bounding_box = bbox;
+        m_bounding_box_num_positions = num_positions;
+        is_bounding_box_valid = true;
+
+        return m_bounding_box;
+    }
+
+    void GeometryDescriptor::PrimitiveSetInstance::expand_bounding_box(const float &x, const float &y, const float &z)
+    {
+        // Only an up to date box covering all but the new position can be grown in place
+        if (!is_bounding_box_valid || m_bounding_box_num_positions + 1 != get_num_positions())
+        {
+            is_bounding_box_valid = false;
+            return;
         }
 
-        return {min.x, min.y, min.z, max.x, max.y, max.z};
+        if (m_bounding_box_num_positions == 0)
+            m_bounding_box = {x, y, z, x, y, z};
+        else
+        {
+            m_bounding_box[0] = std::min(m_bounding_box[0], x);
+            m_bounding_box[1] = std::min(m_bounding_box[1], y);
+            m_bounding_box[2] = std::min(m_bounding_box[2], z);
+            m_bounding_box[3] = std::max(m_bounding_box[3], x);
+            m_bounding_box[4] = std::max(m_bounding_box[4], y);
+            m_bounding_box[5] = std::max(m_bounding_box[5], z);
+        }
+        m_bounding_box_num_positions++;
+    }
+
+    void GeometryDescriptor::PrimitiveSetInstance::update_bounding_box(const std::array<float, 3> &old_position,
+                                                                       const std::array<float, 3> &new_position)
+    {
+        if (!isBoundingBoxValid())
+        {
+            is_bounding_box_valid = false;
+            return;
+        }
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float &min_value = m_bounding_box[axis];
+            float &max_value = m_bounding_box[axis + 3];
+
+            // The vertex was defining this face and moved inwards. The box may shrink, recompute lazily
+            if ((old_position[axis] == min_value && new_position[axis] > min_value) ||
+                (old_position[axis] == max_value && new_position[axis] < max_value))
+            {
+                is_bounding_box_valid = false;
+                return;
+            }
+
+            min_value = std::min(min_value, new_position[axis]);
+            max_value = std::max(max_value, new_position[axis]);
+        }
     }
+
     /// @brief Set Selected Highlighted
     void GeometryDescriptor::PrimitiveSetInstance::set_selection_highlights(const bool &selection_highlight_flag)
     {
@@ -864,13 +2227,30 @@ namespace GridPro_GFX {
     {
         std::vector<float> primitive;
 
-        for (size_t i = 0; i < get_num_vertices_per_primitive(); i++)
+        /// The primitives of a multi strip set are whole strips
+        if (isMultiStrip())
         {
-            std::array<float, 3> vertex = get_primitive_vertex(i + (index * get_num_vertices_per_primitive()));
-            primitive.push_back(vertex[0]);
-            primitive.push_back(vertex[1]);
-            primitive.push_back(vertex[2]);
+            for (uint32_t v = strips->get_first(index); v < strips->get_first(index + 1); v++)
+            {
+                std::array<float, 3> vertex = get_primitive_vertex(v);
+                primitive.insert(primitive.end(), vertex.begin(), vertex.end());
+            }
+            return primitive;
         }
+
+        /// Corners follow the assembly of the primitive type : shared by neighbours in strips, wrapping in loops
+        const size_t num_vertices = get_num_vertices();
+        dispatch_primitive_type(get_primitive_type_enum(), [&](auto traits)
+        {
+            using Traits = decltype(traits);
+            const size_t num_corners = Traits::num_corners(num_vertices);
+            primitive.reserve(num_corners * 3);
+            for (uint32_t k = 0; k < num_corners; k++)
+            {
+                std::array<float, 3> vertex = get_primitive_vertex(static_cast<uint32_t>(Traits::corner(index, k, num_vertices)));
+                primitive.insert(primitive.end(), vertex.begin(), vertex.end());
+            }
+        });
         return primitive;
     }
 
@@ -882,7 +2262,7 @@ namespace GridPro_GFX {
         if (pickScheme == PICK_BY_VERTEX)
         {
             std::vector<float> primitive;
-            float *vertex = get_vertex_ref(index);
+            const float *vertex = get_vertex_ref(index);
             primitive.push_back(vertex[0]);
             primitive.push_back(vertex[1]);
             primitive.push_back(vertex[2]);
@@ -905,6 +2285,12 @@ namespace GridPro_GFX {
 
     std::array<float, 3> GeometryDescriptor::PrimitiveSetInstance::get_primitive_vertex(const uint32_t &index)
     {
+        if (isInterleaved())
+        {
+            const float *vertex = interleaved_vertices->position(indices->size() == 0 ? index : (*indices)[index]);
+            return {vertex[0], vertex[1], vertex[2]};
+        }
+
         if (indices->size() == 0)
             return {(*positions)[index * 3], (*positions)[index * 3 + 1], (*positions)[index * 3 + 2]};
         else
@@ -912,12 +2298,20 @@ namespace GridPro_GFX {
                     (*positions)[((*indices)[index]) * 3 + 2]};
     }
 
-    float *GeometryDescriptor::PrimitiveSetInstance::get_vertex_ref(const uint32_t &index)
+    const float *GeometryDescriptor::PrimitiveSetInstance::get_vertex_ref(const uint32_t &index) const
     {
-        if (index < get_num_vertices())
-            return &(*positions)[index * 3];
-        else
+        if (index >= get_num_vertices())
             return nullptr;
+
+        if (isInterleaved())
+            return index < interleaved_vertices->size() ? interleaved_vertices->position(index) : nullptr;
+
+        return &(*positions)[index * 3];
+    }
+
+    float *GeometryDescriptor::PrimitiveSetInstance::vertex_data(const uint32_t &index)
+    {
+        return const_cast<float *>(get_vertex_ref(index));
     }
 
     void GeometryDescriptor::PrimitiveSetInstance::set_pickable_entities_range(const size_t &min, size_t &max)
@@ -936,73 +2330,21 @@ namespace GridPro_GFX {
             return nullptr;
 
         std::shared_ptr<GeometryDescriptor> tesselated_primitive = std::make_shared<GeometryDescriptor>();
+        const std::vector<float> primitive = get_primitive(index);
 
-        std::vector<float> primitive = get_primitive(index);
-
-        struct Point
-        {
-            float x, y, z;
-        };
-
-        auto calculateMidpoint = [](const Point &p1, const Point &p2) -> Point {
-            return {(p1.x + p2.x) / 2, (p1.y + p2.y) / 2, (p1.z + p2.z) / 2};
-        };
+        Tessellator::TriangleMesh mesh;
+        mesh.positions     = primitive.data();
+        mesh.num_vertices  = 3;
+        mesh.num_triangles = 1;
 
-        auto triangle_tesslator = [&](std::array<Point, 3> &parent_triangle,
-                                      uint32_t tessellation_level) -> std::vector<float> {
-            std::vector<Point> tessellated_vertices;
-
-            auto tessellate = [&](auto &&self, const std::array<Point, 3> &triangle, int level) {
-                if (level == 0)
-                {
-                    // Add the vertices of the triangle to the output
-                    tessellated_vertices.insert(tessellated_vertices.end(), triangle.begin(), triangle.end());
-                    return;
-                }
-
-                // Calculate midpoints of the edges
-                Point mid1 = calculateMidpoint(triangle[0], triangle[1]);
-                Point mid2 = calculateMidpoint(triangle[1], triangle[2]);
-                Point mid3 = calculateMidpoint(triangle[2], triangle[0]);
-
-                // Create 4 new triangles
-                std::array<Point, 3> t1 = {triangle[0], mid1, mid3};
-                std::array<Point, 3> t2 = {mid1, triangle[1], mid2};
-                std::array<Point, 3> t3 = {mid3, mid2, triangle[2]};
-                std::array<Point, 3> t4 = {mid1, mid2, mid3};
-
-                // Recursively tessellate the new triangles
-                self(self, t1, level - 1);
-                self(self, t2, level - 1);
-                self(self, t3, level - 1);
-                self(self, t4, level - 1);
-            };
-
-            // Start tessellation
-            tessellate(tessellate, parent_triangle, tessellation_level);
-
-            std::vector<float> tessellated_float_vertices(tessellated_vertices.size() * 3);
-
-            for (size_t i = 0; i < tessellated_vertices.size(); i++)
-            {
-                tessellated_float_vertices[i * 3] = tessellated_vertices[i].x;
-                tessellated_float_vertices[i * 3 + 1] = tessellated_vertices[i].y;
-                tessellated_float_vertices[i * 3 + 2] = tessellated_vertices[i].z;
-            }
-
-            return tessellated_float_vertices;
-        };
-
-        tesselated_primitive->set_current_primitive_set("Tesselated_Primitive", get_primitive_type_enum());
-
-        if (get_primitive_type_enum() == GL_TRIANGLES)
-        {
-            std::vector<float> all_tessellated_triangles =
-                triangle_tesslator(reinterpret_cast<std::array<Point, 3> &>(primitive[0]), tessellation_level);
-            tesselated_primitive->move_pos_array(std::move(all_tessellated_triangles));
-            tesselated_primitive->set_pick_scheme(GL_PICK_BY_PRIMITIVE);
-        }
+        TessellationOptions options;
+        options.max_level = tessellation_level;
+        TessellationResult result = Tessellator::tessellate(mesh, options);
 
+        tesselated_primitive->set_current_primitive_set("Tesselated_Primitive", GL_TRIANGLES);
+        tesselated_primitive->move_pos_array(std::move(result.positions));
+        tesselated_primitive->move_index_array(std::move(result.indices));
+        tesselated_primitive->set_pick_scheme(GL_PICK_BY_PRIMITIVE);
         return tesselated_primitive;
     }
 
@@ -1016,6 +2358,14 @@ namespace GridPro_GFX {
         if (get_num_indices() > 0)
             valid &= get_num_indices() % get_num_vertices_per_primitive() == 0;
 
+        // Interleaved vertices carry one normal and color per position by construction
+        if (isInterleaved())
+        {
+            if (!valid)
+                throw std::runtime_error(std::string("Interleaved GeometryDescriptor with ID: [") + InstanceName + std::string("] failed validation"));
+            return valid;
+        }
+
         if (get_num_normals() > 0)
         {
             // flatten_normal_array();
@@ -1071,20 +2421,22 @@ namespace GridPro_GFX {
         if (indices_vector().size() == 0)
             return;
 
-        std::vector<float> temp_positions(get_num_vertices() * 3);
+        detach_attrib_array(POSITION_ARRAY);
 
-        auto &indices = indices_vector();
-        auto &positions = positions_vector();
-        const uint32_t num_vertices = get_num_vertices();
-        for (size_t i = 0; i < num_vertices; i++)
+        if (isInterleaved())
         {
-            temp_positions[i * 3 + 0] = positions[indices[i] * 3 + 0];
-            temp_positions[i * 3 + 1] = positions[indices[i] * 3 + 1];
-            temp_positions[i * 3 + 2] = positions[indices[i] * 3 + 2];
+            *interleaved_vertices = interleaved_vertices->gather(*indices);
+            release_indices_ref();
+            invalidate_bounding_box();
+            return;
         }
 
+        std::vector<float> temp_positions(get_num_vertices() * 3);
+        GeometryKernels::gather_vec3(reinterpret_cast<const uint8_t*>(positions->data()), 3 * sizeof(float), indices->data(), indices->size(), temp_positions.data());
+
         *(this->positions) = (std::move(temp_positions));
         release_indices_ref();
+        invalidate_bounding_box();
     }
 
     void GeometryDescriptor::PrimitiveSetInstance::flatten_normal_array()
@@ -1092,6 +2444,10 @@ namespace GridPro_GFX {
         if (indices_vector().size() == 0)
             return;
 
+        // Interleaved normals are flattened together with the positions
+        if (isInterleaved())
+            return;
+
         if (normals->size() == 0)
             return;
 
@@ -1102,17 +2458,9 @@ namespace GridPro_GFX {
 
         if (normals->size() != indices_vector().size() * 3)
         {
+            detach_attrib_array(NORMAL_ARRAY);
             std::vector<float> temp_normals(indices_vector().size() * 3);
-
-            auto &indices = indices_vector();
-            auto &normals = normals_vector();
-            const uint32_t num_vertices = get_num_vertices();
-            for (size_t i = 0; i < num_vertices; i++)
-            {
-                temp_normals[i * 3 + 0] = normals[indices[i] * 3 + 0];
-                temp_normals[i * 3 + 1] = normals[indices[i] * 3 + 1];
-                temp_normals[i * 3 + 2] = normals[indices[i] * 3 + 2];
-            }
+            GeometryKernels::gather_vec3(reinterpret_cast<const uint8_t*>(normals->data()), 3 * sizeof(float), indices->data(), indices->size(), temp_normals.data());
 
             *(this->normals) = (std::move(temp_normals));
         }
@@ -1120,39 +2468,258 @@ namespace GridPro_GFX {
 
     std::vector<float> GeometryDescriptor::PrimitiveSetInstance::get_flattened_position_array()
     {
-        if (indices_vector().size() == 0)
+        if (!isInterleaved() && indices_vector().size() == 0)
             return positions_vector();
+
+        const uint8_t* base = isInterleaved() ? interleaved_vertices->data() : reinterpret_cast<const uint8_t*>(positions->data());
+        const size_t stride_bytes = isInterleaved() ? interleaved_vertices->stride() : 3 * sizeof(float);
+
         std::vector<float> temp_positions(get_num_vertices() * 3);
+        if (indices->size())
+            GeometryKernels::gather_vec3(base, stride_bytes, indices->data(), indices->size(), temp_positions.data());
+        else
+            GeometryKernels::copy_vec3(base, stride_bytes, get_num_positions(), temp_positions.data());
+        return temp_positions;
+    }
+
+    void GeometryDescriptor::PrimitiveSetInstance::interleave_vertex_attributes(const VertexLayoutInfo &layout)
+    {
+        const size_t num_positions = positions->size() / 3;
+        const uint32_t color_components = (colorFormat == RGB ? 3 : 4);
 
-        auto &indices = indices_vector();
-        auto &positions = positions_vector();
-        const uint32_t num_vertices = get_num_vertices();
-        for (size_t i = 0; i < num_vertices; i++)
+        const VertexAttribInfo *normal_attrib = layout.find(ATTRIB_NORMAL);
+        const VertexAttribInfo *color_attrib = layout.find(ATTRIB_COLOR);
+
+        if (layout.attribs[0].gl_type != GL_FLOAT || (normal_attrib && normal_attrib->gl_type != GL_FLOAT))
         {
-            temp_positions[i * 3 + 0] = positions[indices[i] * 3 + 0];
-            temp_positions[i * 3 + 1] = positions[indices[i] * 3 + 1];
-            temp_positions[i * 3 + 2] = positions[indices[i] * 3 + 2];
+            std::string err = std::string("Cannot interleave Primitive set with ID : ") + InstanceName +
+                              std::string(". Interleaved storage needs float positions and normals. Use set_vertex_compression() for compressed uploads");
+            throw std::runtime_error(err);
         }
-        return temp_positions;
+
+        /// The layout replaces the separate arrays, it has to carry every attribute the set has
+        if ((!normal_attrib && normals->size() != 0) || (!color_attrib && colors->size() != 0))
+        {
+            std::string err = std::string("Cannot interleave Primitive set with ID : ") + InstanceName +
+                              std::string(". The layout has no ") + (!normal_attrib && normals->size() != 0 ? "normals" : "colors") + std::string(" but the set has some");
+            throw std::runtime_error(err);
+        }
+
+        if (normal_attrib && normals->size() != 0 && normals->size() != positions->size())
+        {
+            std::string err = std::string("Cannot interleave Primitive set with ID : ") + InstanceName +
+                              std::string(". Number of normals is not equal to number of positions");
+            throw std::runtime_error(err);
+        }
+
+        if (color_attrib && colors->size() != 0 && colors->size() / color_components != num_positions)
+        {
+            std::string err = std::string("Cannot interleave Primitive set with ID : ") + InstanceName +
+                              std::string(". Number of colors is not equal to number of positions");
+            throw std::runtime_error(err);
+        }
+
+        std::shared_ptr<InterleavedVertexArray> packed = std::make_shared<InterleavedVertexArray>(layout);
+        packed->resize(num_positions);
+
+        for (size_t i = 0; i < num_positions; i++)
+        {
+            std::memcpy(packed->position(i), &(*positions)[i * 3], 3 * sizeof(float));
+
+            if (normal_attrib)
+            {
+                float *normal = packed->attrib<float>(i, ATTRIB_NORMAL);
+                if (normals->size())
+                    std::memcpy(normal, &(*normals)[i * 3], 3 * sizeof(float));
+                else
+                    normal[0] = normal[1] = normal[2] = 0.0f;
+            }
+
+            if (color_attrib)
+            {
+                uint8_t *color = packed->attrib<uint8_t>(i, ATTRIB_COLOR);
+                for (uint32_t c = 0; c < color_attrib->components; c++)
+                {
+                    if (colors->size() && c < color_components)
+                        color[c] = (*colors)[i * color_components + c];
+                    else
+                        color[c] = 255;
+                }
+            }
+        }
+
+        interleaved_vertices = packed;
+
+        if (color_attrib)
+            colorFormat = (color_attrib->components == 4 ? RGBA : RGB);
+
+        // Detach from the shared position array and release the separate attribute arrays
+        positions = std::make_shared<std::vector<float>>(0);
+        normals = std::make_shared<std::vector<float>>(0);
+        colors = std::make_shared<std::vector<uint8_t>>(0);
+
+        copy_on_write_flags &= ~((1u << attrib_slot(POSITION_ARRAY)) | (1u << attrib_slot(NORMAL_ARRAY)) | (1u << attrib_slot(COLOR_ARRAY)));
+        dirtyFlags |= (DIRTY_POSITIONS | DIRTY_NORMALS | DIRTY_COLORS);
+    }
+
+    void GeometryDescriptor::PrimitiveSetInstance::detach_attrib_array(VertexAttribArrayType type)
+    {
+        if (!isCopyOnWrite(type))
+            return;
+
+        switch (type)
+        {
+        case POSITION_ARRAY:
+            if (positions.use_count() > 1)
+                positions = std::make_shared<std::vector<float>>(*positions);
+            if (interleaved_vertices && interleaved_vertices.use_count() > 1)
+                interleaved_vertices = std::make_shared<InterleavedVertexArray>(*interleaved_vertices);
+            break;
+        case NORMAL_ARRAY:
+            if (normals.use_count() > 1)
+                normals = std::make_shared<std::vector<float>>(*normals);
+            break;
+        case COLOR_ARRAY:
+            if (colors.use_count() > 1)
+                colors = std::make_shared<std::vector<uint8_t>>(*colors);
+            break;
+        case INDEX_ARRAY:
+            if (indices.use_count() > 1)
+                indices = std::make_shared<std::vector<uint32_t>>(*indices);
+            break;
+        }
+
+        copy_on_write_flags &= ~(1u << attrib_slot(type));
+    }
+
+    InterleavedVertexArray GeometryDescriptor::PrimitiveSetInstance::build_quantized_vertex_array(VertexQuantization &quantization) const
+    {
+        // Quantization box is the bounding box of the positions
+        quantization = VertexQuantization::from_bounding_box(get_bounding_box());
+
+        const bool has_normals = has_normal_attrib();
+        const bool has_colors = has_color_attrib();
+
+        VertexLayoutInfo layout;
+        if (has_normals && has_colors) layout = QuantizedLayout_PNC::info();
+        else if (has_normals)          layout = QuantizedLayout_PN::info();
+        else if (has_colors)           layout = QuantizedLayout_PC::info();
+        else                           layout = QuantizedLayout_P::info();
+
+        InterleavedVertexArray quantized(layout);
+        quantized.resize(get_num_positions());
+        encode_quantized_vertices(quantization, quantized, 0, quantized.size());
+
+        return quantized;
+    }
+
+    void GeometryDescriptor::PrimitiveSetInstance::encode_quantized_vertices(const VertexQuantization &quantization, InterleavedVertexArray &quantized,
+                                                                             const size_t &first, const size_t &last) const
+    {
+        const uint32_t color_components = (colorFormat == RGB ? 3 : 4);
+
+        auto position_at = [&](size_t i) -> const float * {
+            return isInterleaved() ? interleaved_vertices->position(i) : &(*positions)[i * 3];
+        };
+
+        auto normal_at = [&](size_t i) -> const float * {
+            if (isInterleaved())
+                return interleaved_vertices->attrib<float>(i, ATTRIB_NORMAL);
+            return (i * 3 + 2 < normals->size()) ? &(*normals)[i * 3] : nullptr;
+        };
+
+        auto color_at = [&](size_t i, uint32_t &components) -> const uint8_t * {
+            if (isInterleaved())
+            {
+                components = interleaved_vertices->layout().find(ATTRIB_COLOR)->components;
+                return interleaved_vertices->attrib<uint8_t>(i, ATTRIB_COLOR);
+            }
+            components = color_components;
+            return ((i + 1) * color_components <= colors->size()) ? &(*colors)[i * color_components] : nullptr;
+        };
+
+        const VertexLayoutInfo &layout = quantized.layout();
+        const VertexAttribInfo *normal_attrib = layout.find(ATTRIB_NORMAL);
+        const VertexAttribInfo *color_attrib = layout.find(ATTRIB_COLOR);
+        const size_t end = std::min(last, std::min(quantized.size(), get_num_positions()));
+
+        Parallel::parallel_for(first, end, [&](size_t chunk_begin, size_t chunk_end, uint32_t)
+        {
+            for (size_t i = chunk_begin; i < chunk_end; i++)
+            {
+                uint8_t *vertex = quantized.data() + i * layout.stride;
+
+                quantization.encode_position(position_at(i), reinterpret_cast<uint16_t *>(vertex));
+
+                if (normal_attrib)
+                {
+                    const float *normal = normal_at(i);
+                    const uint32_t packed = normal ? pack_normal_2_10_10_10(normal[0], normal[1], normal[2]) : 0u;
+                    std::memcpy(vertex + normal_attrib->offset, &packed, sizeof(uint32_t));
+                }
+
+                if (color_attrib)
+                {
+                    uint32_t components = 0;
+                    const uint8_t *color = color_at(i, components);
+                    uint8_t *out_color = vertex + color_attrib->offset;
+                    for (uint32_t c = 0; c < 4; c++)
+                        out_color[c] = (color && c < components) ? color[c] : 255;
+                }
+            }
+        });
+    }
+
+    DirtyRangeSet GeometryDescriptor::PrimitiveSetInstance::get_dirty_vertex_ranges() const
+    {
+        DirtyRangeSet vertex_ranges;
+
+        auto add_vertex_ranges = [&](const DirtyRangeSet &byte_ranges, size_t bytes_per_vertex)
+        {
+            for (const DirtyRangeSet::Range &range : byte_ranges.ranges())
+                vertex_ranges.add(range.begin / bytes_per_vertex, (range.end + bytes_per_vertex - 1) / bytes_per_vertex);
+        };
+
+        if (isInterleaved())
+        {
+            add_vertex_ranges(dirty_ranges[attrib_slot(POSITION_ARRAY)], interleaved_vertices->stride());
+            return vertex_ranges;
+        }
+
+        add_vertex_ranges(dirty_ranges[attrib_slot(POSITION_ARRAY)], 3 * sizeof(float));
+        add_vertex_ranges(dirty_ranges[attrib_slot(NORMAL_ARRAY)],   3 * sizeof(float));
+        add_vertex_ranges(dirty_ranges[attrib_slot(COLOR_ARRAY)],    (colorFormat == RGB ? 3 : 4));
+        return vertex_ranges;
     }
 
     void GeometryDescriptor::PrimitiveSetInstance::update_vertex(const std::array<float, 3> &position,
                                                                  const uint32_t &index)
     {
-        float *vertex = get_vertex_ref(index);
+        float *vertex = vertex_data(index);
 
         if (vertex == nullptr)
         {
             return;
         }
 
+        update_bounding_box({vertex[0], vertex[1], vertex[2]}, position);
+
         vertex[0] = position[0];
         vertex[1] = position[1];
         vertex[2] = position[2];
 
-        batch_vertex_update update;
-        update.m_position = position;
-        update.index = index;
-        batch_vertex_updates.push_back(update);
+        vertex_update_journal.record(index);
+    }
+
+    void GeometryDescriptor::PrimitiveSetInstance::flush_vertex_updates()
+    {
+        if (vertex_update_journal.empty())
+            return;
+
+        const size_t stride = isInterleaved() ? interleaved_vertices->stride() : 3 * sizeof(float);
+        for (const DirtyRangeSet::Range& range : vertex_update_journal.ranges().ranges())
+            mark_dirty_range(POSITION_ARRAY, range.begin * stride, range.end * stride);
+
+        vertex_update_journal.clear();
     }
     } // namespace GridPro_GFX
@@ -0,0 +1,553 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "gp_gui_geometry_file.h"
+#include "gp_gui_geometry_descriptor.h"
+#include "gp_gui_primitive_traits.h"
+#include "gp_gui_debug.h"
+
+namespace GridPro_GFX {
+
+namespace GeometryFile {
+
+namespace {
+
+    typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSetInstance;
+
+    size_t align_up(const size_t& offset)
+    {
+        return (offset + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+    }
+
+    /// Whole file mapped with private copy-on-write pages : the adopted arrays can be edited, the file never changes
+    class MappedFile
+    {
+        public :
+        explicit MappedFile(const std::string& path)
+        {
+#ifdef _WIN32
+            m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+                throw std::runtime_error(std::string("GeometryFile : cannot open ") + path);
+
+            LARGE_INTEGER file_size;
+            GetFileSizeEx(m_file, &file_size);
+            m_size = static_cast<size_t>(file_size.QuadPart);
+
+            m_mapping = m_size ? CreateFileMappingA(m_file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+            if (m_mapping != nullptr)
+                m_data = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_COPY, 0, 0, 0));
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                throw std::runtime_error(std::string("GeometryFile : cannot open ") + path);
+
+            struct stat file_stat;
+            if (::fstat(fd, &file_stat) == 0)
+                m_size = static_cast<size_t>(file_stat.st_size);
+
+            if (m_size)
+            {
+                void* data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                m_data = data == MAP_FAILED ? nullptr : static_cast<uint8_t*>(data);
+            }
+            ::close(fd);
+#endif
+            if (m_data == nullptr)
+            {
+                release();
+                throw std::runtime_error(std::string("GeometryFile : cannot map ") + path);
+            }
+        }
+
+        ~MappedFile() { release(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        uint8_t* data() const { return m_data; }
+        size_t   size() const { return m_size; }
+
+        private :
+        void release()
+        {
+#ifdef _WIN32
+            if (m_data != nullptr)    UnmapViewOfFile(m_data);
+            if (m_mapping != nullptr) CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#else
+            if (m_data != nullptr) ::munmap(m_data, m_size);
+#endif
+            m_data = nullptr;
+        }
+
+#ifdef _WIN32
+        HANDLE   m_file    = INVALID_HANDLE_VALUE;
+        HANDLE   m_mapping = nullptr;
+#endif
+        uint8_t* m_data = nullptr;
+        size_t   m_size = 0;
+    };
+
+    bool is_valid_header(const FileHeader& header)
+    {
+        return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.endian_tag == ENDIAN_TAG &&
+               header.version == FORMAT_VERSION && header.header_size == sizeof(FileHeader) && header.set_record_size == sizeof(SetRecord);
+    }
+
+    /// Array blocks in file order : a record points into them, the writer streams them after the set table
+    struct PendingBlock
+    {
+        uint64_t    offset;
+        const void* data;
+        uint64_t    size_bytes;
+    };
+
+    class BlockLayout
+    {
+        public :
+        explicit BlockLayout(const uint64_t& first_offset) : m_end(first_offset) {}
+
+        /// Place an array once per storage, later sets pointing at the same storage refer to the first one
+        ArrayBlock place(const void* storage, const void* data, const size_t& size_bytes, const uint32_t& set_index)
+        {
+            ArrayBlock block = {0, size_bytes, NOT_SHARED, 0};
+            if (size_bytes == 0)
+                return block;
+
+            if (storage != nullptr)
+            {
+                auto it = m_placed.find(storage);
+                if (it != m_placed.end())
+                {
+                    block = it->second;
+                    block.shared_from = m_owner[storage];
+                    return block;
+                }
+            }
+
+            m_end = align_up(m_end);
+            block.offset = m_end;
+            m_blocks.push_back({m_end, data, size_bytes});
+            m_end += size_bytes;
+
+            if (storage != nullptr)
+            {
+                m_placed[storage] = block;
+                m_owner[storage] = set_index;
+            }
+            return block;
+        }
+
+        const std::vector<PendingBlock>& blocks() const { return m_blocks; }
+        uint64_t end() const                            { return m_end; }
+
+        private :
+        uint64_t m_end;
+        std::vector<PendingBlock> m_blocks;
+        std::unordered_map<const void*, ArrayBlock> m_placed;
+        std::unordered_map<const void*, uint32_t>   m_owner;
+    };
+
+    void copy_color(uint8_t (&dst)[4], const PrimitiveSetInstance::Color& color)
+    {
+        dst[0] = color.r; dst[1] = color.g; dst[2] = color.b; dst[3] = color.a;
+    }
+
+    SetRecord make_set_record(const PrimitiveSetInstance& set)
+    {
+        SetRecord record;
+        std::memset(&record, 0, sizeof(record));
+
+        record.primitive_type = set.get_primitive_type_enum();
+        record.color_format   = set.get_color_format_enum();
+        record.color_scheme   = set.get_color_scheme_enum();
+        record.shading_model  = set.get_shading_model_enum();
+        record.wireframe_mode = set.get_wireframe_mode_enum();
+        record.blend_func     = set.get_blend_func_enum();
+        record.pick_scheme    = set.get_pick_scheme_enum();
+        record.line_width     = set.get_line_width();
+        record.point_size     = set.get_point_size();
+
+        record.flags = (set.isHighlightable() ? uint32_t(SET_HOVER_HIGHLIGHTABLE) : 0u) |
+                       (set.isSelectionHighlightable() ? uint32_t(SET_SELECTION_HIGHLIGHTABLE) : 0u) |
+                       (set.isUsingCustomHighlightColor() ? uint32_t(SET_CUSTOM_HIGHLIGHT_COLOR) : 0u) |
+                       (set.isVertexCompressionEnabled() ? uint32_t(SET_VERTEX_COMPRESSION) : 0u);
+
+        copy_color(record.fill_color, set.color);
+        copy_color(record.wireframe_color, set.wireframecolor);
+        copy_color(record.highlight_color, set.highlightcolor);
+        copy_color(record.selection_color, set.selection_highlight_color);
+        copy_color(record.custom_highlight_color, set.custom_highlight_color);
+
+        std::memcpy(record.material_ambient,  set.material_ambient.data(),  sizeof(record.material_ambient));
+        std::memcpy(record.material_diffuse,  set.material_diffuse.data(),  sizeof(record.material_diffuse));
+        std::memcpy(record.material_specular, set.material_specular.data(), sizeof(record.material_specular));
+        std::memcpy(record.material_emission, set.material_emission.data(), sizeof(record.material_emission));
+        record.material_shininess = set.material_shininess;
+
+        const std::array<float, 6> bounding_box = set.get_bounding_box();
+        std::memcpy(record.bounding_box, bounding_box.data(), sizeof(record.bounding_box));
+        return record;
+    }
+
+    /// Bytes of an interleaved attribute, 0 for a type or component count no vertex layout uses
+    uint32_t attrib_bytes(const uint32_t& gl_type, const uint32_t& components)
+    {
+        if (components < 1 || components > 4)
+            return 0;
+
+        switch (gl_type)
+        {
+            case GL_FLOAT:              return components * uint32_t(sizeof(float));
+            case GL_UNSIGNED_SHORT:     return components * uint32_t(sizeof(uint16_t));
+            case GL_UNSIGNED_BYTE:      return components * uint32_t(sizeof(uint8_t));
+            case GL_INT_2_10_10_10_REV: return components == 4 ? 4 : 0;
+            default:                    return 0;
+        }
+    }
+
+    /// Attributes the drivers can read : known semantic and type, inside the vertex, xyz float positions first
+    bool is_valid_attrib(const AttribRecord& attrib, const uint32_t& index, const uint32_t& vertex_stride)
+    {
+        if (attrib.semantic >= ATTRIB_MAX || attrib.size == 0 || attrib.size != attrib_bytes(attrib.gl_type, attrib.components) ||
+            uint64_t(attrib.offset) + attrib.size > vertex_stride)
+            return false;
+
+        return index != 0 || (attrib.semantic == ATTRIB_POSITION && attrib.gl_type == GL_FLOAT && attrib.components == 3 && attrib.offset == 0);
+    }
+
+    /// Bounds checked view of an array block of the mapping
+    template<typename T>
+    T* block_data(const MappedFile& file, const ArrayBlock& block, const std::string& set_name)
+    {
+        if (block.size_bytes == 0)
+            return nullptr;
+        if (block.offset % BLOCK_ALIGNMENT != 0 || block.offset > file.size() || block.size_bytes > file.size() - block.offset || block.size_bytes % sizeof(T) != 0)
+            throw std::runtime_error(std::string("GeometryFile : corrupt array block in primitive set ") + set_name);
+        return reinterpret_cast<T*>(file.data() + block.offset);
+    }
+
+    template<typename T>
+    std::vector<T> block_copy(const MappedFile& file, const ArrayBlock& block, const std::string& set_name)
+    {
+        const T* data = block_data<const T>(file, block, set_name);
+        return data ? std::vector<T>(data, data + block.size_bytes / sizeof(T)) : std::vector<T>();
+    }
+
+    void apply_set_record(PrimitiveSetInstance& set, const SetRecord& record)
+    {
+        set.set_color_format(static_cast<GLenum>(record.color_format));
+        set.set_color_scheme(record.color_scheme);
+        set.set_shading_model(static_cast<GLenum>(record.shading_model));
+        set.set_wireframe_mode(static_cast<GLenum>(record.wireframe_mode));
+        set.set_blend_func(static_cast<GLenum>(record.blend_func));
+        set.set_pick_scheme(record.pick_scheme);
+        set.set_line_width(record.line_width);
+        set.set_point_size(record.point_size);
+        set.set_vertex_compression((record.flags & SET_VERTEX_COMPRESSION) != 0);
+
+        set.is_hover_highlightable          = (record.flags & SET_HOVER_HIGHLIGHTABLE) != 0;
+        set.is_select_highlightable         = (record.flags & SET_SELECTION_HIGHLIGHTABLE) != 0;
+        set.is_using_custom_highlight_color = (record.flags & SET_CUSTOM_HIGHLIGHT_COLOR) != 0;
+
+        auto to_color = [](const uint8_t (&c)[4]) { return PrimitiveSetInstance::Color(c[0], c[1], c[2], c[3]); };
+        set.color                     = to_color(record.fill_color);
+        set.wireframecolor            = to_color(record.wireframe_color);
+        set.highlightcolor            = to_color(record.highlight_color);
+        set.selection_highlight_color = to_color(record.selection_color);
+        set.custom_highlight_color    = to_color(record.custom_highlight_color);
+
+        std::memcpy(set.material_ambient.data(),  record.material_ambient,  sizeof(record.material_ambient));
+        std::memcpy(set.material_diffuse.data(),  record.material_diffuse,  sizeof(record.material_diffuse));
+        std::memcpy(set.material_specular.data(), record.material_specular, sizeof(record.material_specular));
+        std::memcpy(set.material_emission.data(), record.material_emission, sizeof(record.material_emission));
+        set.material_shininess = record.material_shininess;
+    }
+
+} // namespace
+
+    void write(const GeometryDescriptor& descriptor, const std::string& path)
+    {
+        const auto& primitive_sets = descriptor.primitives;
+
+        FileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version          = FORMAT_VERSION;
+        header.endian_tag       = ENDIAN_TAG;
+        header.header_size      = sizeof(FileHeader);
+        header.set_record_size  = sizeof(SetRecord);
+        header.num_sets         = static_cast<uint32_t>(primitive_sets.size());
+        header.set_table_offset = align_up(sizeof(FileHeader));
+
+        const std::array<float, 6> bounding_box = descriptor.get_total_bounding_box();
+        std::memcpy(header.bounding_box, bounding_box.data(), sizeof(header.bounding_box));
+
+        /// Names follow the set table, the array blocks follow the names
+        uint64_t names_offset = header.set_table_offset + uint64_t(header.num_sets) * sizeof(SetRecord);
+        uint64_t names_size = 0;
+        for (const auto& entry : primitive_sets)
+            names_size += entry.first.size();
+
+        std::vector<SetRecord> records;
+        records.reserve(header.num_sets);
+        BlockLayout layout(names_offset + names_size);
+
+        uint32_t set_index = 0;
+        uint64_t name_offset = names_offset;
+        for (const auto& entry : primitive_sets)
+        {
+            PrimitiveSetInstance& set = *entry.second;
+            SetRecord record = make_set_record(set);
+            record.name_offset = name_offset;
+            record.name_size   = static_cast<uint32_t>(entry.first.size());
+            name_offset += entry.first.size();
+
+            if (set.isInterleaved())
+            {
+                const std::shared_ptr<InterleavedVertexArray> vertices = set.get_interleaved_weak_ptr().lock();
+                const VertexLayoutInfo& vertex_layout = vertices->layout();
+                record.vertex_stride = vertex_layout.stride;
+                record.num_attribs   = vertex_layout.num_attribs;
+                for (uint32_t i = 0; i < vertex_layout.num_attribs; ++i)
+                {
+                    const VertexAttribInfo& attrib = vertex_layout.attribs[i];
+                    record.attribs[i] = {attrib.semantic, attrib.components, attrib.gl_type, attrib.normalized ? 1u : 0u, attrib.offset, attrib.size};
+                }
+                record.vertices = layout.place(vertices.get(), vertices->data(), vertices->size_bytes(), set_index);
+            }
+            else
+            {
+                const std::vector<float>& positions = set.positions_vector();
+                record.vertices = layout.place(&positions, positions.data(), positions.size() * sizeof(float), set_index);
+            }
+
+            const std::vector<float>&    normals = set.normals_vector();
+            const std::vector<uint8_t>&  colors  = set.colors_vector();
+            const std::vector<uint32_t>& indices = set.indices_vector();
+            record.normals = layout.place(&normals, normals.data(), normals.size() * sizeof(float), set_index);
+            record.colors  = layout.place(&colors,  colors.data(),  colors.size(), set_index);
+            record.indices = layout.place(&indices, indices.data(), indices.size() * sizeof(uint32_t), set_index);
+
+            if (const std::shared_ptr<const InstanceArray> instances = set.get_instances())
+            {
+                record.instance_transforms = layout.place(nullptr, instances->transforms().data(), instances->transforms().size() * sizeof(float), set_index);
+                record.instance_colors     = layout.place(nullptr, instances->colors().data(), instances->colors().size(), set_index);
+            }
+
+            if (const std::shared_ptr<const StripArray> strips = set.get_strips())
+                record.strip_offsets = layout.place(nullptr, strips->offsets().data(), strips->offsets().size() * sizeof(uint32_t), set_index);
+
+            records.push_back(record);
+            ++set_index;
+        }
+        header.file_size = layout.end();
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            throw std::runtime_error(std::string("GeometryFile::write : cannot create ") + path);
+
+        static const char padding[BLOCK_ALIGNMENT] = {};
+        auto pad_to = [&](const uint64_t& offset)
+        {
+            const uint64_t position = static_cast<uint64_t>(file.tellp());
+            if (offset > position)
+                file.write(padding, static_cast<std::streamsize>(offset - position));
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad_to(header.set_table_offset);
+        file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(SetRecord)));
+        for (const auto& entry : primitive_sets)
+            file.write(entry.first.data(), static_cast<std::streamsize>(entry.first.size()));
+
+        for (const PendingBlock& block : layout.blocks())
+        {
+            pad_to(block.offset);
+            file.write(static_cast<const char*>(block.data), static_cast<std::streamsize>(block.size_bytes));
+        }
+
+        if (!file.good())
+            throw std::runtime_error(std::string("GeometryFile::write : write failed for ") + path);
+
+        GP_TRACE("Wrote ", header.num_sets, " primitive sets to ", path, " (", header.file_size, " bytes)");
+    }
+
+    std::shared_ptr<GeometryDescriptor> read(const std::string& path, const ReadMode& mode)
+    {
+        const std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(path);
+
+        if (file->size() < sizeof(FileHeader))
+            throw std::runtime_error(std::string("GeometryFile::read : truncated file ") + path);
+
+        FileHeader header;
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (!is_valid_header(header))
+            throw std::runtime_error(std::string("GeometryFile::read : not a version ") + std::to_string(FORMAT_VERSION) + " geometry file of this byte order : " + path);
+
+        if (header.file_size != file->size() || header.set_table_offset > file->size() ||
+            uint64_t(header.num_sets) * sizeof(SetRecord) > file->size() - header.set_table_offset)
+            throw std::runtime_error(std::string("GeometryFile::read : truncated file ") + path);
+
+        std::vector<SetRecord> records(header.num_sets);
+        std::memcpy(records.data(), file->data() + header.set_table_offset, records.size() * sizeof(SetRecord));
+
+        std::vector<std::string> names;
+        names.reserve(records.size());
+        for (const SetRecord& record : records)
+        {
+            if (record.name_offset > file->size() || record.name_size > file->size() - record.name_offset)
+                throw std::runtime_error(std::string("GeometryFile::read : corrupt primitive set name in ") + path);
+            names.emplace_back(reinterpret_cast<const char*>(file->data() + record.name_offset), record.name_size);
+        }
+
+        /// Adopted vertices keep the mapping alive, it is unmapped with the last primitive set using it
+        std::shared_ptr<const void> owner = file;
+
+        /// An adopted set is interleaved and takes no separate normals or colors : the vertices of a set having some,
+        /// or shared with a set having some, are copied even in MAP mode
+        std::vector<bool> can_adopt(records.size(), mode == ReadMode::MAP);
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            const SetRecord& record = records[i];
+            if (record.normals.size_bytes == 0 && record.colors.size_bytes == 0)
+                continue;
+            can_adopt[i] = false;
+            if (record.vertices.shared_from != NOT_SHARED && record.vertices.shared_from < i)
+                can_adopt[record.vertices.shared_from] = false;
+        }
+
+        auto descriptor = std::make_shared<GeometryDescriptor>();
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            const SetRecord&   record = records[i];
+            const std::string& name   = names[i];
+
+            auto shared_set = [&](const ArrayBlock& block) -> const std::string*
+            {
+                if (block.shared_from == NOT_SHARED)
+                    return nullptr;
+                if (block.shared_from >= i)
+                    throw std::runtime_error(std::string("GeometryFile::read : corrupt shared array in primitive set ") + name);
+                return &names[block.shared_from];
+            };
+
+            if (!is_primitive_type(static_cast<GLenum>(record.primitive_type)))
+                throw std::runtime_error(std::string("GeometryFile::read : unknown primitive type in primitive set ") + name);
+
+            /// Stale or corrupt files must not reach the uploads and kernels, which trust the vertex count and the layout
+            const uint64_t vertex_size = record.vertex_stride != 0 ? record.vertex_stride : 3 * sizeof(float);
+            if (record.vertices.size_bytes % vertex_size != 0)
+                throw std::runtime_error(std::string("GeometryFile::read : vertex array is not a whole number of vertices in primitive set ") + name);
+
+            const uint64_t num_vertices = record.vertices.size_bytes / vertex_size;
+            if (const uint32_t* indices = block_data<const uint32_t>(*file, record.indices, name))
+            {
+                if (std::any_of(indices, indices + record.indices.size_bytes / sizeof(uint32_t), [&](const uint32_t& index) { return index >= num_vertices; }))
+                    throw std::runtime_error(std::string("GeometryFile::read : index out of the vertices in primitive set ") + name);
+            }
+
+            descriptor->set_current_primitive_set(name, static_cast<GLenum>(record.primitive_type));
+
+            if (const std::string* source = shared_set(record.vertices))
+                descriptor->share_attrib_array(*source, name, PrimitiveSetInstance::POSITION_ARRAY);
+            else if (record.vertex_stride != 0)
+            {
+                if (record.num_attribs > ATTRIB_MAX)
+                    throw std::runtime_error(std::string("GeometryFile::read : corrupt vertex layout in primitive set ") + name);
+
+                VertexLayoutInfo vertex_layout;
+                vertex_layout.stride = record.vertex_stride;
+                vertex_layout.num_attribs = record.num_attribs;
+                for (uint32_t a = 0; a < record.num_attribs; ++a)
+                {
+                    const AttribRecord& attrib = record.attribs[a];
+                    if (!is_valid_attrib(attrib, a, record.vertex_stride))
+                        throw std::runtime_error(std::string("GeometryFile::read : corrupt vertex attribute in primitive set ") + name);
+
+                    vertex_layout.attribs[a] = {static_cast<VertexAttribSemantic>(attrib.semantic), attrib.components, static_cast<GLenum>(attrib.gl_type),
+                                                attrib.normalized != 0, attrib.offset, attrib.size};
+                }
+
+                uint8_t* vertices = block_data<uint8_t>(*file, record.vertices, name);
+                if (vertices != nullptr && can_adopt[i])
+                    descriptor->adopt_interleaved_vertices(vertex_layout, vertices, num_vertices, owner);
+                else if (vertices != nullptr)
+                    descriptor->push_interleaved_vertices(vertex_layout, vertices, num_vertices);
+            }
+            else
+            {
+                float* positions = block_data<float>(*file, record.vertices, name);
+                if (positions != nullptr && can_adopt[i])
+                    descriptor->adopt_pos_array(positions, record.vertices.size_bytes / sizeof(float), owner);
+                else if (positions != nullptr)
+                    descriptor->move_pos_array(block_copy<float>(*file, record.vertices, name));
+            }
+
+            if (const std::string* source = shared_set(record.normals))
+                descriptor->share_attrib_array(*source, name, PrimitiveSetInstance::NORMAL_ARRAY);
+            else if (record.normals.size_bytes)
+                descriptor->move_normal_array(block_copy<float>(*file, record.normals, name));
+
+            if (const std::string* source = shared_set(record.colors))
+                descriptor->share_attrib_array(*source, name, PrimitiveSetInstance::COLOR_ARRAY);
+            else if (record.colors.size_bytes)
+                descriptor->move_color_array(block_copy<uint8_t>(*file, record.colors, name));
+
+            if (const std::string* source = shared_set(record.indices))
+                descriptor->share_attrib_array(*source, name, PrimitiveSetInstance::INDEX_ARRAY);
+            else if (record.indices.size_bytes)
+                descriptor->move_index_array(block_copy<uint32_t>(*file, record.indices, name));
+
+            if (record.instance_transforms.size_bytes)
+                descriptor->move_instance_arrays(block_copy<float>(*file, record.instance_transforms, name),
+                                                 block_copy<uint8_t>(*file, record.instance_colors, name));
+
+            if (record.strip_offsets.size_bytes)
+                descriptor->move_strip_offsets(block_copy<uint32_t>(*file, record.strip_offsets, name));
+
+            PrimitiveSetInstance& set = *descriptor->currentPrimitiveSet;
+            apply_set_record(set, record);
+
+            /// The stored box saves a pass over the vertices of every set
+            set.set_bounding_box({record.bounding_box[0], record.bounding_box[1], record.bounding_box[2],
+                                  record.bounding_box[3], record.bounding_box[4], record.bounding_box[5]});
+        }
+
+        GP_TRACE("Read ", header.num_sets, " primitive sets from ", path, mode == ReadMode::MAP ? " (mapped)" : " (copied)");
+        return descriptor;
+    }
+
+    bool is_readable(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        FileHeader header;
+        if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+            return false;
+
+        file.seekg(0, std::ios::end);
+        return is_valid_header(header) && static_cast<uint64_t>(file.tellg()) == header.file_size;
+    }
+
+} // namespace GeometryFile
+
+} // namespace GridPro_GFX
@@ -0,0 +1,473 @@
+#include <cmath>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <array>
+#include <limits>
+#include "gp_gui_mesh_optimizer.h"
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+namespace MeshOptimizer {
+
+namespace {
+
+    /// FIFO post transform cache. A vertex is cached while fewer than cache_size misses happened since it was loaded
+    class FifoCache
+    {
+        public :
+        FifoCache(size_t num_vertices, uint32_t cache_size) : m_stamps(num_vertices, 0), m_time(cache_size + 1), m_cache_size(cache_size) {}
+
+        /// @brief Evict everything (by moving time past every stamp)
+        void flush()                    { m_time += m_cache_size + 1; }
+
+        /// @return true on a miss
+        bool access(uint32_t v)
+        {
+            if(m_time - m_stamps[v] <= m_cache_size) return false;
+            m_stamps[v] = m_time++;
+            return true;
+        }
+
+        private :
+        std::vector<uint32_t> m_stamps;
+        uint32_t m_time;
+        uint32_t m_cache_size;
+    };
+
+    void validate_indices(const uint32_t* indices, const size_t& num_indices, const size_t& num_vertices)
+    {
+        if(num_indices % 3 != 0)
+            throw std::runtime_error(std::string("MeshOptimizer : index count is not a multiple of 3"));
+
+        for(size_t i = 0; i < num_indices; ++i)
+            if(indices[i] >= num_vertices)
+                throw std::runtime_error(std::string("MeshOptimizer : index out of range of the vertex array"));
+    }
+
+} // namespace
+
+    void optimize_vertex_cache(uint32_t* indices, const size_t& num_indices, const size_t& num_vertices, const uint32_t& cache_size)
+    {
+        validate_indices(indices, num_indices, num_vertices);
+        const size_t num_triangles = num_indices / 3;
+        if(num_triangles < 2) return;
+
+        /// Vertex -> triangle adjacency in compressed rows
+        std::vector<uint32_t> live(num_vertices, 0);
+        for(size_t i = 0; i < num_indices; ++i) ++live[indices[i]];
+
+        std::vector<uint32_t> offsets(num_vertices + 1, 0);
+        for(size_t v = 0; v < num_vertices; ++v) offsets[v + 1] = offsets[v] + live[v];
+
+        std::vector<uint32_t> adjacency(num_indices);
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for(size_t i = 0; i < num_indices; ++i) adjacency[fill[indices[i]]++] = uint32_t(i / 3);
+        }
+
+        /// Tipsify : fan around a vertex, then continue with the candidate that is still in cache and has
+        /// the fewest live triangles left, falling back to recently used vertices (dead end stack) and
+        /// finally to the next vertex in input order
+        std::vector<uint32_t> cache_time(num_vertices, 0);
+        std::vector<uint8_t>  emitted(num_triangles, 0);
+        std::vector<uint32_t> dead_end;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> output;
+        output.reserve(num_indices);
+
+        uint32_t time = cache_size + 1;
+        size_t cursor = 0;
+
+        auto skip_dead_end = [&]() -> int64_t
+        {
+            while(!dead_end.empty())
+            {
+                const uint32_t v = dead_end.back();
+                dead_end.pop_back();
+                if(live[v] > 0) return v;
+            }
+            while(cursor < num_vertices)
+            {
+                if(live[cursor] > 0) return int64_t(cursor);
+                ++cursor;
+            }
+            return -1;
+        };
+
+        int64_t fanning = skip_dead_end();
+        while(fanning >= 0)
+        {
+            candidates.clear();
+            for(uint32_t k = offsets[fanning]; k < offsets[fanning + 1]; ++k)
+            {
+                const uint32_t t = adjacency[k];
+                if(emitted[t]) continue;
+                emitted[t] = 1;
+
+                for(int c = 0; c < 3; ++c)
+                {
+                    const uint32_t v = indices[t * 3 + c];
+                    output.push_back(v);
+                    dead_end.push_back(v);
+                    candidates.push_back(v);
+                    --live[v];
+                    if(time - cache_time[v] > cache_size) cache_time[v] = time++;
+                }
+            }
+
+            int64_t next = -1;
+            int64_t best_priority = -1;
+            for(const uint32_t& v : candidates)
+            {
+                if(live[v] == 0) continue;
+
+                /// Prefer vertices that stay in cache while their remaining fan is emitted
+                int64_t priority = 0;
+                if(int64_t(time - cache_time[v]) + 2 * int64_t(live[v]) <= int64_t(cache_size))
+                    priority = time - cache_time[v];
+
+                if(priority > best_priority)
+                {
+                    best_priority = priority;
+                    next = v;
+                }
+            }
+
+            fanning = (next >= 0) ? next : skip_dead_end();
+        }
+
+        std::memcpy(indices, output.data(), num_indices * sizeof(uint32_t));
+    }
+
+    void optimize_overdraw(uint32_t* indices, const size_t& num_indices, const float* positions, const size_t& num_vertices,
+                           const size_t& stride_bytes, const float& threshold, const uint32_t& cache_size)
+    {
+        validate_indices(indices, num_indices, num_vertices);
+        const size_t num_triangles = num_indices / 3;
+        if(num_triangles < 2) return;
+
+        /// Hard boundaries : a triangle missing the cache on all corners starts a new cluster, the triangle
+        /// order does not rely on the cache contents across it
+        std::vector<size_t> hard_starts;
+        {
+            FifoCache cache(num_vertices, cache_size);
+            for(size_t t = 0; t < num_triangles; ++t)
+            {
+                int misses = 0;
+                for(int c = 0; c < 3; ++c) misses += cache.access(indices[t * 3 + c]);
+                if(t == 0 || misses == 3) hard_starts.push_back(t);
+            }
+            hard_starts.push_back(num_triangles);
+        }
+
+        /// Soft boundaries : a hard cluster is cut as soon as its prefix, drawn with a cold cache, already
+        /// is within threshold of the miss ratio of the whole cluster. The pieces can then be drawn in any
+        /// order without losing more than threshold of vertex cache efficiency
+        std::vector<size_t> cluster_starts;
+        {
+            FifoCache cache(num_vertices, cache_size);
+            for(size_t h = 0; h + 1 < hard_starts.size(); ++h)
+            {
+                const size_t begin = hard_starts[h], end = hard_starts[h + 1];
+
+                cache.flush();
+                size_t cluster_misses = 0;
+                for(size_t t = begin; t < end; ++t)
+                    for(int c = 0; c < 3; ++c) cluster_misses += cache.access(indices[t * 3 + c]);
+                const float cluster_acmr = float(cluster_misses) / float(end - begin);
+
+                cache.flush();
+                cluster_starts.push_back(begin);
+                size_t misses = 0, triangles = 0;
+                for(size_t t = begin; t < end; ++t)
+                {
+                    for(int c = 0; c < 3; ++c) misses += cache.access(indices[t * 3 + c]);
+                    ++triangles;
+
+                    if(t + 1 < end && float(misses) <= threshold * cluster_acmr * float(triangles))
+                    {
+                        cluster_starts.push_back(t + 1);
+                        cache.flush();
+                        misses = 0;
+                        triangles = 0;
+                    }
+                }
+            }
+        }
+        cluster_starts.push_back(num_triangles);
+        const size_t num_clusters = cluster_starts.size() - 1;
+        if(num_clusters < 2) return;
+
+        const unsigned char* base = reinterpret_cast<const unsigned char*>(positions);
+        auto position = [&](uint32_t v, double p[3])
+        {
+            float value[3];
+            std::memcpy(value, base + size_t(v) * stride_bytes, sizeof(value));
+            p[0] = value[0]; p[1] = value[1]; p[2] = value[2];
+        };
+
+        /// Area weighted centroid and normal per cluster
+        std::vector<double> cluster_data(num_clusters * 6, 0.0);
+        double mesh_centroid[3] = {0.0, 0.0, 0.0};
+        double mesh_area = 0.0;
+        for(size_t k = 0; k < num_clusters; ++k)
+        {
+            double* data = &cluster_data[k * 6];
+            double area_sum = 0.0;
+            for(size_t t = cluster_starts[k]; t < cluster_starts[k + 1]; ++t)
+            {
+                double a[3], b[3], c[3];
+                position(indices[t * 3 + 0], a);
+                position(indices[t * 3 + 1], b);
+                position(indices[t * 3 + 2], c);
+
+                const double e1[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+                const double e2[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+                const double n[3]  = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+                const double area  = 0.5 * std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+
+                for(int i = 0; i < 3; ++i)
+                {
+                    const double centroid = (a[i] + b[i] + c[i]) / 3.0;
+                    data[i]     += centroid * area;
+                    data[3 + i] += n[i];
+                    mesh_centroid[i] += centroid * area;
+                }
+                area_sum += area;
+            }
+            mesh_area += area_sum;
+            if(area_sum > 0.0)
+                for(int i = 0; i < 3; ++i) data[i] /= area_sum;
+        }
+        if(mesh_area > 0.0)
+            for(int i = 0; i < 3; ++i) mesh_centroid[i] /= mesh_area;
+
+        /// Clusters facing away from the mesh centre are likely in front, so they are drawn first
+        std::vector<double> sort_key(num_clusters, 0.0);
+        for(size_t k = 0; k < num_clusters; ++k)
+        {
+            const double* data = &cluster_data[k * 6];
+            const double length = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+            if(length <= 0.0) continue;
+            sort_key[k] = ((data[0] - mesh_centroid[0]) * data[3] + (data[1] - mesh_centroid[1]) * data[4] + (data[2] - mesh_centroid[2]) * data[5]) / length;
+        }
+
+        std::vector<uint32_t> order(num_clusters);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sort_key[a] > sort_key[b]; });
+
+        std::vector<uint32_t> output;
+        output.reserve(num_indices);
+        for(const uint32_t& k : order)
+            output.insert(output.end(), indices + cluster_starts[k] * 3, indices + cluster_starts[k + 1] * 3);
+
+        std::memcpy(indices, output.data(), num_indices * sizeof(uint32_t));
+    }
+
+    std::vector<uint32_t> compute_vertex_fetch_remap(const uint32_t* indices, const size_t& num_indices, const size_t& num_vertices)
+    {
+        validate_indices(indices, num_indices, num_vertices);
+
+        const uint32_t unused = ~0u;
+        std::vector<uint32_t> remap(num_vertices, unused);
+        uint32_t next = 0;
+        for(size_t i = 0; i < num_indices; ++i)
+            if(remap[indices[i]] == unused) remap[indices[i]] = next++;
+
+        for(size_t v = 0; v < num_vertices; ++v)
+            if(remap[v] == unused) remap[v] = next++;
+
+        return remap;
+    }
+
+    float compute_acmr(const uint32_t* indices, const size_t& num_indices, const size_t& num_vertices, const uint32_t& cache_size)
+    {
+        if(num_indices < 3) return 0.0f;
+
+        FifoCache cache(num_vertices, cache_size);
+        size_t misses = 0;
+        for(size_t i = 0; i < num_indices; ++i)
+            misses += cache.access(indices[i]);
+
+        return float(misses) / float(num_indices / 3);
+    }
+
+    std::vector<uint32_t> compute_weld_map(const float* positions, const size_t& num_vertices, const size_t& stride_bytes,
+                                           const float& tolerance, const uint64_t* attribute_keys)
+    {
+        std::vector<uint32_t> weld_map(num_vertices);
+        if(num_vertices == 0) return weld_map;
+
+        const unsigned char* base = reinterpret_cast<const unsigned char*>(positions);
+        auto position = [&](size_t v) -> std::array<float, 3>
+        {
+            std::array<float, 3> p;
+            std::memcpy(p.data(), base + v * stride_bytes, sizeof(float) * 3);
+            return p;
+        };
+
+        using bbox_t = std::array<float, 6>;
+        const float inf = std::numeric_limits<float>::infinity();
+        const bbox_t bb = Parallel::parallel_reduce<bbox_t>(0, num_vertices, bbox_t{inf, inf, inf, -inf, -inf, -inf},
+            [&](size_t begin, size_t end)
+            {
+                bbox_t box{inf, inf, inf, -inf, -inf, -inf};
+                for(size_t v = begin; v < end; ++v)
+                {
+                    const std::array<float, 3> p = position(v);
+                    for(int axis = 0; axis < 3; ++axis)
+                    {
+                        box[axis]     = std::min(box[axis], p[axis]);
+                        box[axis + 3] = std::max(box[axis + 3], p[axis]);
+                    }
+                }
+                return box;
+            },
+            [](const bbox_t& a, const bbox_t& b)
+            {
+                return bbox_t{std::min(a[0], b[0]), std::min(a[1], b[1]), std::min(a[2], b[2]),
+                              std::max(a[3], b[3]), std::max(a[4], b[4]), std::max(a[5], b[5])};
+            });
+
+        /// Cells are packed 21 bits per axis, so they grow beyond tolerance for very large extents.
+        /// With tolerance 0 the key hashes the exact position instead and only its own cell is searched
+        const bool exact = !(tolerance > 0.0f);
+        const float extent = std::max({bb[3] - bb[0], bb[4] - bb[1], bb[5] - bb[2], 0.0f});
+        const float cell_size = exact ? 1.0f : std::max(tolerance, extent / float(1 << 20));
+        const float tolerance_sq = tolerance * tolerance;
+
+        auto cell_of = [&](const std::array<float, 3>& p, int axis) -> int64_t
+        {
+            return int64_t(std::floor((p[axis] - bb[axis]) / cell_size));
+        };
+        auto pack = [](int64_t x, int64_t y, int64_t z) -> uint64_t
+        {
+            return (uint64_t(x) << 42) | (uint64_t(y) << 21) | uint64_t(z);
+        };
+        auto key_of = [&](size_t v) -> uint64_t
+        {
+            const std::array<float, 3> p = position(v);
+            if(!exact)
+                return pack(cell_of(p, 0), cell_of(p, 1), cell_of(p, 2));
+
+            uint32_t bits[3];
+            for(int axis = 0; axis < 3; ++axis)
+            {
+                const float value = p[axis] + 0.0f; /// folds -0 onto +0
+                std::memcpy(&bits[axis], &value, sizeof(float));
+            }
+            uint64_t h = bits[0];
+            h = h * 0x9E3779B97F4A7C15ull ^ bits[1];
+            h = h * 0x9E3779B97F4A7C15ull ^ bits[2];
+            return h ^ (h >> 31);
+        };
+
+        std::vector<std::pair<uint64_t, uint32_t>> cells(num_vertices);
+        Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; ++v) cells[v] = {key_of(v), uint32_t(v)};
+        });
+        Parallel::parallel_sort(cells.begin(), cells.end(), std::less<std::pair<uint64_t, uint32_t>>());
+
+        auto matches = [&](size_t v, size_t u) -> bool
+        {
+            if(attribute_keys && attribute_keys[v] != attribute_keys[u]) return false;
+            const std::array<float, 3> a = position(v), b = position(u);
+            if(exact) return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+            const float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+            return dx * dx + dy * dy + dz * dz <= tolerance_sq;
+        };
+
+        /// Smallest matching vertex among the cells around v. Cells are sorted by vertex index, so a scan stops
+        /// at the first index that cannot improve on the current best
+        std::vector<uint32_t> nearest(num_vertices);
+        Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t v = begin; v < end; ++v)
+            {
+                uint32_t best = uint32_t(v);
+                auto scan_cell = [&](uint64_t key)
+                {
+                    auto it = std::lower_bound(cells.begin(), cells.end(), std::make_pair(key, uint32_t(0)));
+                    for(; it != cells.end() && it->first == key && it->second < best; ++it)
+                        if(matches(v, it->second)) { best = it->second; break; }
+                };
+
+                if(exact)
+                    scan_cell(key_of(v));
+                else
+                {
+                    const std::array<float, 3> p = position(v);
+                    const int64_t cx = cell_of(p, 0), cy = cell_of(p, 1), cz = cell_of(p, 2);
+                    for(int64_t x = std::max<int64_t>(cx - 1, 0); x <= cx + 1; ++x)
+                        for(int64_t y = std::max<int64_t>(cy - 1, 0); y <= cy + 1; ++y)
+                            for(int64_t z = std::max<int64_t>(cz - 1, 0); z <= cz + 1; ++z)
+                                scan_cell(pack(x, y, z));
+                }
+                nearest[v] = best;
+            }
+        });
+
+        /// nearest[v] <= v, so resolving in index order follows every chain to its end
+        for(size_t v = 0; v < num_vertices; ++v)
+            weld_map[v] = (nearest[v] == v) ? uint32_t(v) : weld_map[nearest[v]];
+
+        return weld_map;
+    }
+
+    size_t remove_degenerate_primitives(std::vector<uint32_t>& indices, const uint32_t& vertices_per_primitive, const uint32_t& min_distinct)
+    {
+        const size_t n = vertices_per_primitive;
+        if(n == 0 || n > 4)
+            throw std::runtime_error(std::string("MeshOptimizer : remove_degenerate_primitives supports 1 to 4 vertices per primitive"));
+
+        const size_t num_primitives = indices.size() / n;
+        using prim_t = std::array<uint32_t, 4>;
+
+        /// Canonical form : rotated so the smallest index comes first (keeps the winding), padded with ~0
+        std::vector<std::pair<prim_t, uint32_t>> keys(num_primitives);
+        std::vector<uint8_t> keep(num_primitives, 1);
+        Parallel::parallel_for(0, num_primitives, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t p = begin; p < end; ++p)
+            {
+                const uint32_t* v = &indices[p * n];
+                uint32_t distinct = 0;
+                for(size_t i = 0; i < n; ++i)
+                {
+                    bool repeated = false;
+                    for(size_t j = 0; j < i; ++j) repeated |= (v[i] == v[j]);
+                    distinct += !repeated;
+                }
+                if(distinct < min_distinct) keep[p] = 0;
+
+                const size_t first = size_t(std::min_element(v, v + n) - v);
+                prim_t key;
+                key.fill(~0u);
+                for(size_t i = 0; i < n; ++i) key[i] = v[(first + i) % n];
+                keys[p] = {key, uint32_t(p)};
+            }
+        });
+
+        Parallel::parallel_sort(keys.begin(), keys.end(), std::less<std::pair<prim_t, uint32_t>>());
+        for(size_t i = 1; i < keys.size(); ++i)
+            if(keys[i].first == keys[i - 1].first) keep[keys[i].second] = 0;
+
+        size_t out = 0;
+        for(size_t p = 0; p < num_primitives; ++p)
+        {
+            if(!keep[p]) continue;
+            if(out != p) std::copy_n(indices.begin() + p * n, n, indices.begin() + out * n);
+            ++out;
+        }
+        indices.resize(out * n);
+        return num_primitives - out;
+    }
+
+} // namespace MeshOptimizer
+
+} // namespace GridPro_GFX
@@ -0,0 +1,489 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+#include <string>
+#include "gp_gui_mesh_simplifier.h"
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+namespace {
+
+    /// Constraint planes of boundary and feature edges are weighted heavier than face planes so those edges
+    /// only move along themselves
+    constexpr double FEATURE_EDGE_WEIGHT = 100.0;
+
+    /// Collapses turning a surviving triangle normal further than acos(MIN_NORMAL_COSINE) are rejected
+    constexpr double MIN_NORMAL_COSINE = 0.2;
+
+    /// Below this share of removed triangles, a trailing partial level is not worth another index array
+    constexpr double MIN_LEVEL_REDUCTION = 0.9;
+
+    struct Vec3
+    {
+        double x, y, z;
+        Vec3 operator-(const Vec3& o) const { return Vec3{x - o.x, y - o.y, z - o.z}; }
+        double dot(const Vec3& o) const     { return x * o.x + y * o.y + z * o.z; }
+        Vec3 cross(const Vec3& o) const     { return Vec3{y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x}; }
+        double length() const               { return std::sqrt(dot(*this)); }
+    };
+
+    /// Symmetric 4x4 error quadric of the Garland-Heckbert metric, upper triangle only
+    struct Quadric
+    {
+        double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+        /// Quadric of the plane n.p + d = 0 (n unit length)
+        static Quadric from_plane(const Vec3& n, const double& d, const double& weight)
+        {
+            Quadric q;
+            q.a2 = weight * n.x * n.x; q.ab = weight * n.x * n.y; q.ac = weight * n.x * n.z; q.ad = weight * n.x * d;
+            q.b2 = weight * n.y * n.y; q.bc = weight * n.y * n.z; q.bd = weight * n.y * d;
+            q.c2 = weight * n.z * n.z; q.cd = weight * n.z * d;
+            q.d2 = weight * d * d;
+            return q;
+        }
+
+        Quadric& operator+=(const Quadric& o)
+        {
+            a2 += o.a2; ab += o.ab; ac += o.ac; ad += o.ad; b2 += o.b2;
+            bc += o.bc; bd += o.bd; c2 += o.c2; cd += o.cd; d2 += o.d2;
+            return *this;
+        }
+
+        /// Sum of squared (weighted) distances of p to the accumulated planes
+        double evaluate(const Vec3& p) const
+        {
+            const double error = a2 * p.x * p.x + 2 * ab * p.x * p.y + 2 * ac * p.x * p.z + 2 * ad * p.x
+                               + b2 * p.y * p.y + 2 * bc * p.y * p.z + 2 * bd * p.y
+                               + c2 * p.z * p.z + 2 * cd * p.z
+                               + d2;
+            return std::max(error, 0.0);
+        }
+    };
+
+    /// FREE vertices collapse along any edge, BORDER vertices only along their boundary / feature edge,
+    /// LOCKED vertices (corners, feature edge end points, non manifold vertices) never move
+    enum class VertexKind : uint8_t { FREE, BORDER, LOCKED };
+
+    struct Collapse
+    {
+        double   cost;
+        uint32_t from, to;
+        uint32_t from_version, to_version;
+        bool operator>(const Collapse& o) const { return cost > o.cost; }
+    };
+
+    inline uint64_t edge_key(uint32_t a, uint32_t b)
+    {
+        if(a > b) std::swap(a, b);
+        return (uint64_t(a) << 32) | b;
+    }
+
+    struct PositionKey
+    {
+        uint32_t bits[3];
+        bool operator==(const PositionKey& o) const { return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2]; }
+    };
+
+    struct PositionKeyHash
+    {
+        size_t operator()(const PositionKey& k) const
+        {
+            uint64_t h = k.bits[0];
+            h = h * 0x9E3779B97F4A7C15ull ^ k.bits[1];
+            h = h * 0x9E3779B97F4A7C15ull ^ k.bits[2];
+            return size_t(h ^ (h >> 29));
+        }
+    };
+
+    /// Working state of one simplification run. Vertices are welded by position first so that attribute
+    /// seams (same position, different normal or color) do not show up as boundaries
+    class QuadricSimplifier
+    {
+        public :
+        QuadricSimplifier(const float* positions, size_t num_vertices, size_t stride_bytes,
+                          const uint32_t* indices, size_t num_indices)
+        {
+            weld(positions, num_vertices, stride_bytes);
+
+            const size_t num_triangles = (indices ? num_indices : num_vertices) / 3;
+            corners.resize(num_triangles * 3);
+            if(indices)
+                std::memcpy(corners.data(), indices, corners.size() * sizeof(uint32_t));
+            else
+                for(size_t i = 0; i < corners.size(); ++i) corners[i] = uint32_t(i);
+
+            for(const uint32_t& corner : corners)
+                if(corner >= num_vertices)
+                    throw std::runtime_error(std::string("MeshSimplifier : index out of range of the position array"));
+
+            triangles.resize(corners.size());
+            Parallel::parallel_for(0, corners.size(), [&](size_t begin, size_t end, uint32_t)
+            {
+                for(size_t i = begin; i < end; ++i) triangles[i] = canonical[corners[i]];
+            });
+
+            alive.assign(num_triangles, 0);
+            vertex_triangles.resize(points.size());
+            for(size_t t = 0; t < num_triangles; ++t)
+            {
+                const uint32_t* v = &triangles[t * 3];
+                if(v[0] == v[1] || v[1] == v[2] || v[0] == v[2]) continue;
+                alive[t] = 1;
+                ++num_alive;
+                for(int c = 0; c < 3; ++c) vertex_triangles[v[c]].push_back(uint32_t(t));
+            }
+            base_triangles = num_alive;
+        }
+
+        std::vector<LodLevel> run(const SimplificationOptions& options)
+        {
+            std::vector<LodLevel> levels;
+            if(num_alive == 0 || options.num_levels == 0) return levels;
+
+            classify(options);
+            seed_queue();
+
+            const double ratio = std::min(std::max(double(options.level_ratio), 0.01), 0.99);
+            const double error_limit = std::max(double(options.max_error), 0.0) * diagonal;
+            double target = base_triangles * ratio;
+            double max_error = 0.0;
+            size_t last_emitted = base_triangles;
+
+            while(levels.size() < options.num_levels && !queue.empty())
+            {
+                const Collapse candidate = queue.top();
+                queue.pop();
+
+                if(removed[candidate.from] || removed[candidate.to]) continue;
+                if(version[candidate.from] != candidate.from_version || version[candidate.to] != candidate.to_version) continue;
+
+                const double error = std::sqrt(candidate.cost);
+                if(error > error_limit) break;
+                if(!is_valid_collapse(candidate.from, candidate.to)) continue;
+
+                collapse(candidate.from, candidate.to);
+                max_error = std::max(max_error, error);
+
+                if(num_alive <= target)
+                {
+                    levels.push_back(snapshot(float(max_error)));
+                    last_emitted = num_alive;
+                    target = num_alive * ratio;
+                }
+            }
+
+            if(levels.size() < options.num_levels && num_alive < last_emitted * MIN_LEVEL_REDUCTION)
+                levels.push_back(snapshot(float(max_error)));
+
+            return levels;
+        }
+
+        private :
+        void weld(const float* positions, size_t num_vertices, size_t stride_bytes)
+        {
+            canonical.resize(num_vertices);
+            std::unordered_map<PositionKey, uint32_t, PositionKeyHash> lookup;
+            lookup.reserve(num_vertices);
+
+            const unsigned char* base = reinterpret_cast<const unsigned char*>(positions);
+            Vec3 lo{ std::numeric_limits<double>::max(),  std::numeric_limits<double>::max(),  std::numeric_limits<double>::max()};
+            Vec3 hi{-std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(), -std::numeric_limits<double>::max()};
+
+            for(size_t i = 0; i < num_vertices; ++i)
+            {
+                float p[3];
+                std::memcpy(p, base + i * stride_bytes, sizeof(p));
+
+                PositionKey key;
+                for(int c = 0; c < 3; ++c)
+                {
+                    const float value = p[c] + 0.0f; /// folds -0 onto +0
+                    std::memcpy(&key.bits[c], &value, sizeof(float));
+                }
+
+                auto inserted = lookup.emplace(key, uint32_t(points.size()));
+                if(inserted.second)
+                {
+                    points.push_back(Vec3{p[0], p[1], p[2]});
+                    representative.push_back(uint32_t(i));
+                    lo = Vec3{std::min(lo.x, double(p[0])), std::min(lo.y, double(p[1])), std::min(lo.z, double(p[2]))};
+                    hi = Vec3{std::max(hi.x, double(p[0])), std::max(hi.y, double(p[1])), std::max(hi.z, double(p[2]))};
+                }
+                canonical[i] = inserted.first->second;
+            }
+
+            diagonal = points.empty() ? 0.0 : (hi - lo).length();
+            quadrics.resize(points.size());
+            kind.assign(points.size(), VertexKind::FREE);
+            removed.assign(points.size(), 0);
+            version.assign(points.size(), 0);
+        }
+
+        Vec3 face_normal(const uint32_t* v) const
+        {
+            return (points[v[1]] - points[v[0]]).cross(points[v[2]] - points[v[0]]);
+        }
+
+        /// Accumulate face quadrics and find boundary, feature and non manifold edges
+        void classify(const SimplificationOptions& options)
+        {
+            const size_t num_triangles = alive.size();
+            std::vector<Vec3> normals(num_triangles, Vec3{0, 0, 0});
+
+            for(size_t t = 0; t < num_triangles; ++t)
+            {
+                if(!alive[t]) continue;
+                const uint32_t* v = &triangles[t * 3];
+                Vec3 n = face_normal(v);
+                const double length = n.length();
+                if(length <= 0.0) continue;
+                n = Vec3{n.x / length, n.y / length, n.z / length};
+                normals[t] = n;
+
+                const Quadric q = Quadric::from_plane(n, -n.dot(points[v[0]]), 1.0);
+                for(int c = 0; c < 3; ++c) quadrics[v[c]] += q;
+            }
+
+            /// Sorting (edge, triangle) pairs groups the triangles of every edge together
+            std::vector<std::pair<uint64_t, uint32_t>> edges;
+            edges.reserve(num_alive * 3);
+            for(size_t t = 0; t < num_triangles; ++t)
+            {
+                if(!alive[t]) continue;
+                const uint32_t* v = &triangles[t * 3];
+                for(int c = 0; c < 3; ++c)
+                    edges.emplace_back(edge_key(v[c], v[(c + 1) % 3]), uint32_t(t));
+            }
+            std::sort(edges.begin(), edges.end());
+
+            const double feature_cosine = std::cos(double(options.feature_angle) * 3.14159265358979323846 / 180.0);
+            std::vector<uint32_t> feature_degree(points.size(), 0);
+
+            for(size_t i = 0; i < edges.size();)
+            {
+                size_t j = i;
+                while(j < edges.size() && edges[j].first == edges[i].first) ++j;
+
+                const uint32_t a = uint32_t(edges[i].first >> 32);
+                const uint32_t b = uint32_t(edges[i].first & 0xFFFFFFFFu);
+                const size_t count = j - i;
+
+                if(count > 2)
+                {
+                    kind[a] = kind[b] = VertexKind::LOCKED;
+                }
+                else
+                {
+                    const bool boundary = (count == 1) && options.preserve_boundaries;
+                    const bool feature  = (count == 2) && normals[edges[i].second].dot(normals[edges[i + 1].second]) < feature_cosine;
+
+                    if(boundary || feature)
+                    {
+                        feature_edges.insert(edges[i].first);
+                        ++feature_degree[a];
+                        ++feature_degree[b];
+
+                        const Vec3 direction = points[b] - points[a];
+                        const double length_sq = direction.dot(direction);
+                        for(size_t k = i; k < j; ++k)
+                        {
+                            Vec3 n = direction.cross(normals[edges[k].second]);
+                            const double length = n.length();
+                            if(length <= 0.0) continue;
+                            n = Vec3{n.x / length, n.y / length, n.z / length};
+                            const Quadric q = Quadric::from_plane(n, -n.dot(points[a]), FEATURE_EDGE_WEIGHT * length_sq);
+                            quadrics[a] += q;
+                            quadrics[b] += q;
+                        }
+                    }
+                }
+                i = j;
+            }
+
+            for(size_t v = 0; v < points.size(); ++v)
+            {
+                if(kind[v] == VertexKind::LOCKED || feature_degree[v] == 0) continue;
+                kind[v] = (feature_degree[v] == 2) ? VertexKind::BORDER : VertexKind::LOCKED;
+            }
+        }
+
+        bool can_move(uint32_t from, uint32_t to) const
+        {
+            switch(kind[from])
+            {
+                case VertexKind::FREE   : return true;
+                case VertexKind::BORDER : return feature_edges.count(edge_key(from, to)) != 0;
+                default                 : return false;
+            }
+        }
+
+        void push_candidate(uint32_t from, uint32_t to)
+        {
+            if(!can_move(from, to)) return;
+            Quadric q = quadrics[from];
+            q += quadrics[to];
+            queue.push(Collapse{q.evaluate(points[to]), from, to, version[from], version[to]});
+        }
+
+        void gather_neighbours(uint32_t v, std::vector<uint32_t>& out) const
+        {
+            out.clear();
+            for(const uint32_t& t : vertex_triangles[v])
+            {
+                if(!alive[t]) continue;
+                for(int c = 0; c < 3; ++c)
+                    if(triangles[t * 3 + c] != v) out.push_back(triangles[t * 3 + c]);
+            }
+            std::sort(out.begin(), out.end());
+            out.erase(std::unique(out.begin(), out.end()), out.end());
+        }
+
+        void seed_queue()
+        {
+            std::vector<uint32_t> neighbours;
+            for(uint32_t v = 0; v < uint32_t(points.size()); ++v)
+            {
+                gather_neighbours(v, neighbours);
+                for(const uint32_t& n : neighbours) push_candidate(v, n);
+            }
+        }
+
+        /// Link condition (the collapse keeps the surface manifold) and no flipped or degenerate triangles
+        bool is_valid_collapse(uint32_t from, uint32_t to)
+        {
+            size_t shared_triangles = 0;
+            for(const uint32_t& t : vertex_triangles[from])
+            {
+                if(!alive[t]) continue;
+                const uint32_t* v = &triangles[t * 3];
+                if(v[0] == to || v[1] == to || v[2] == to) { ++shared_triangles; continue; }
+
+                const Vec3 before = face_normal(v);
+                uint32_t moved[3] = {v[0], v[1], v[2]};
+                for(int c = 0; c < 3; ++c) if(moved[c] == from) moved[c] = to;
+                const Vec3 after = face_normal(moved);
+
+                const double before_length = before.length();
+                const double after_length  = after.length();
+                if(after_length <= 1e-12 * before_length || after_length <= 0.0) return false;
+                if(before.dot(after) < MIN_NORMAL_COSINE * before_length * after_length) return false;
+            }
+
+            gather_neighbours(from, from_neighbours);
+            gather_neighbours(to, to_neighbours);
+            size_t common = 0;
+            for(size_t i = 0, j = 0; i < from_neighbours.size() && j < to_neighbours.size();)
+            {
+                if(from_neighbours[i] < to_neighbours[j]) ++i;
+                else if(from_neighbours[i] > to_neighbours[j]) ++j;
+                else { ++common; ++i; ++j; }
+            }
+            return common == shared_triangles;
+        }
+
+        void collapse(uint32_t from, uint32_t to)
+        {
+            /// Feature edges leaving the removed vertex now leave the surviving one
+            gather_neighbours(from, from_neighbours);
+            for(const uint32_t& n : from_neighbours)
+                if(n != to && feature_edges.count(edge_key(from, n)))
+                    feature_edges.insert(edge_key(to, n));
+
+            for(const uint32_t& t : vertex_triangles[from])
+            {
+                if(!alive[t]) continue;
+                uint32_t* v = &triangles[t * 3];
+                if(v[0] == to || v[1] == to || v[2] == to)
+                {
+                    alive[t] = 0;
+                    --num_alive;
+                    continue;
+                }
+                for(int c = 0; c < 3; ++c) if(v[c] == from) v[c] = to;
+                vertex_triangles[to].push_back(t);
+            }
+
+            std::vector<uint32_t>& survivors = vertex_triangles[to];
+            survivors.erase(std::remove_if(survivors.begin(), survivors.end(), [&](uint32_t t) { return !alive[t]; }), survivors.end());
+            std::vector<uint32_t>().swap(vertex_triangles[from]);
+
+            quadrics[to] += quadrics[from];
+            removed[from] = 1;
+            ++version[to];
+
+            gather_neighbours(to, to_neighbours);
+            for(const uint32_t& n : to_neighbours)
+            {
+                push_candidate(n, to);
+                push_candidate(to, n);
+            }
+        }
+
+        /// Emit the surviving triangles with indices into the original vertex array. Corners whose vertex
+        /// survived keep their original index (and with it normals and colors), moved corners take the
+        /// first original vertex at the position they moved to
+        LodLevel snapshot(float error) const
+        {
+            LodLevel level;
+            level.error = error;
+            level.indices.reserve(num_alive * 3);
+            for(size_t t = 0; t < alive.size(); ++t)
+            {
+                if(!alive[t]) continue;
+                for(int c = 0; c < 3; ++c)
+                {
+                    const uint32_t original = corners[t * 3 + c];
+                    const uint32_t vertex   = triangles[t * 3 + c];
+                    level.indices.push_back(canonical[original] == vertex ? original : representative[vertex]);
+                }
+            }
+            return level;
+        }
+
+        std::vector<uint32_t> canonical;        /// original vertex -> welded vertex
+        std::vector<uint32_t> representative;   /// welded vertex -> first original vertex
+        std::vector<Vec3>     points;
+        std::vector<Quadric>  quadrics;
+        std::vector<VertexKind> kind;
+        std::vector<uint8_t>  removed;
+        std::vector<uint32_t> version;
+
+        std::vector<uint32_t> corners;          /// original indices, 3 per triangle
+        std::vector<uint32_t> triangles;        /// welded indices, 3 per triangle
+        std::vector<uint8_t>  alive;
+        std::vector<std::vector<uint32_t>> vertex_triangles;
+        std::unordered_set<uint64_t> feature_edges;
+
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+        std::vector<uint32_t> from_neighbours, to_neighbours;
+
+        size_t num_alive = 0;
+        size_t base_triangles = 0;
+        double diagonal = 0.0;
+    };
+
+} // namespace
+
+    MeshSimplifier::MeshSimplifier(const float* positions, const size_t& num_vertices, const size_t& stride_bytes,
+                                   const uint32_t* indices, const size_t& num_indices)
+    : m_positions(positions), m_num_vertices(num_vertices), m_stride_bytes(stride_bytes), m_indices(indices), m_num_indices(num_indices)
+    {
+        if(m_stride_bytes < 3 * sizeof(float))
+            throw std::runtime_error(std::string("MeshSimplifier : position stride smaller than 3 floats"));
+    }
+
+    std::vector<LodLevel> MeshSimplifier::build_lod_chain(const SimplificationOptions& options) const
+    {
+        if(m_positions == nullptr || m_num_vertices == 0) return {};
+        QuadricSimplifier simplifier(m_positions, m_num_vertices, m_stride_bytes, m_indices, m_num_indices);
+        return simplifier.run(options);
+    }
+
+} // namespace GridPro_GFX
@@ -1,5 +1,8 @@
 
 
+#include <algorithm>
+#include <numeric>
+
 #include "gp_gui_entity_handle.h" // Warning : This has Circular Dependency with gp_gui_scene.h
 #include "gp_gui_scene.h"
 
@@ -26,7 +29,6 @@ namespace GridPro_GFX
         // Critical ! Do not remove this line  !!!
         PublisherInstance->set_scene_ptr(this);
         initialize_render_devices(); 
-        need_to_update_color_reservations = false;
     }
 
     bool Scene_Manager::initialize_render_devices()
@@ -80,8 +82,6 @@ namespace GridPro_GFX
 
     bool Scene_Manager::switch_driver(const GLenum& input_driver)
     {
-        need_to_update_color_reservations = true;
-          
         if(input_driver == GL_DRIVER_OPENGL_2_1)
         {
             GP_PRINT("Switching to OpenGL_2_1");
@@ -267,11 +267,13 @@ namespace GridPro_GFX
         if (layer == GL_LAYER_PICKABLE)
         {
             const uint32_t color_id = scene_subscription.getPickEvent().getColorID();
-            if ((color_id) != 0 && color_id <= last_color_id)
+            const unique_color_reservation* reservation = (color_id != 0 && color_id <= last_color_id) ? find_color_reservation(color_id) : nullptr;
+            if (reservation != nullptr)
             {
-                scene_subscription.getPickEvent().setEntityKey(EntityIdxKeyMapRegistry[get_actual_id(color_id)]);
-                scene_subscription.getPickEvent().setEntityID(get_actual_id(color_id));
-                scene_subscription.getPickEvent().setSubEntityID(color_id - (unique_colr_reservations[get_actual_id(color_id)]._Min_ColorID_));
+                scene_subscription.getPickEvent().setEntityKey(Entity_DataBase.get_at(reservation->_EntityID_)->key);
+                scene_subscription.getPickEvent().setEntityHandle(Entity_DataBase.handle_at(reservation->_EntityID_));
+                scene_subscription.getPickEvent().setEntityID(reservation->_EntityID_);
+                scene_subscription.getPickEvent().setSubEntityID(color_id - reservation->_Min_ColorID_);
             }
         }
 
@@ -286,17 +288,7 @@ namespace GridPro_GFX
             return picked_entities;
         }
         
-        std::vector<uint32_t> picked_color_ids = PublisherInstance->frame_buffer()->pick_matrix(center_x, center_y, width, height);
-
-        for (auto color_id : picked_color_ids)
-        {
-            if (color_id != 0 && color_id <= last_color_id)
-            {
-                picked_entities.emplace_back(EntityIdxKeyMapRegistry[get_actual_id(color_id)], color_id - (unique_colr_reservations[get_actual_id(color_id)]._Min_ColorID_));
-            }
-        }
-        
-        return picked_entities;
+        return resolve_color_ids(PublisherInstance->frame_buffer()->pick_matrix(center_x, center_y, width, height));
     }
     
     std::vector<std::pair<std::string, uint32_t>> Scene_Manager::pick_polygon(const std::vector<float>& polygon_points)
@@ -307,16 +299,65 @@ namespace GridPro_GFX
             return picked_entities;
         }
         
-        std::vector<uint32_t> picked_color_ids = PublisherInstance->frame_buffer()->scanline_polygon(polygon_points);
+        return resolve_color_ids(PublisherInstance->frame_buffer()->scanline_polygon(polygon_points));
+    }
 
-        for (auto color_id : picked_color_ids)
+    std::vector<std::pair<std::string, uint32_t>> Scene_Manager::resolve_color_ids(const std::vector<uint32_t>& color_ids)
+    {
+        std::vector<std::pair<std::string, uint32_t>> picked_entities;
+        const std::vector<unique_color_reservation>& intervals = get_color_reservation_intervals();
+        if (color_ids.empty() || intervals.empty())
         {
-            if (color_id != 0 && color_id <= last_color_id)
+            return picked_entities;
+        }
+
+        // Visit the IDs in increasing order so the interval cursor only moves forward : O(n log n + entities)
+        // instead of a search per ID. Scanline picks come sorted already, box picks do not
+        std::vector<uint32_t> order(color_ids.size());
+        std::iota(order.begin(), order.end(), 0u);
+        if (!std::is_sorted(color_ids.begin(), color_ids.end()))
+        {
+            std::sort(order.begin(), order.end(), [&](const uint32_t& a, const uint32_t& b) { return color_ids[a] < color_ids[b]; });
+        }
+
+        constexpr uint32_t NO_INTERVAL = 0xFFFFFFFF;
+        std::vector<uint32_t> hit_interval(color_ids.size(), NO_INTERVAL);
+        size_t interval = 0;
+        for (const uint32_t& i : order)
+        {
+            const uint32_t color_id = color_ids[i];
+            while (interval < intervals.size() && intervals[interval]._Max_ColorID_ < color_id)
             {
-                picked_entities.emplace_back(EntityIdxKeyMapRegistry[get_actual_id(color_id)], color_id - (unique_colr_reservations[get_actual_id(color_id)]._Min_ColorID_));
+                ++interval;
+            }
+            if (interval == intervals.size())
+            {
+                break;
+            }
+            if (color_id >= intervals[interval]._Min_ColorID_)
+            {
+                hit_interval[i] = static_cast<uint32_t>(interval);
             }
         }
-        
+
+        // Entity keys are fetched once per hit entity, not once per hit
+        std::vector<const std::string*> interval_keys(intervals.size(), nullptr);
+        picked_entities.reserve(color_ids.size());
+        for (size_t i = 0; i < color_ids.size(); ++i)
+        {
+            if (hit_interval[i] == NO_INTERVAL)
+            {
+                continue;
+            }
+            const unique_color_reservation& reservation = intervals[hit_interval[i]];
+            const std::string*& key = interval_keys[hit_interval[i]];
+            if (key == nullptr)
+            {
+                key = &Entity_DataBase.get_at(reservation._EntityID_)->key;
+            }
+            picked_entities.emplace_back(*key, color_ids[i] - reservation._Min_ColorID_);
+        }
+
         return picked_entities;
     }
 
@@ -347,6 +388,7 @@ namespace GridPro_GFX
         scene_subscription.getPickEvent().setColorID(0);
         scene_subscription.getPickEvent().SetEventType(EventType::None);
         scene_subscription.getPickEvent().setEntityKey("NULL_ENTITY");
+        scene_subscription.getPickEvent().setEntityHandle(EntityId());
         scene_subscription.getPickEvent().setDepth(depth);
 
         if (!get_scene_state().is_render_systems_enabled())
@@ -354,13 +396,15 @@ namespace GridPro_GFX
             return;
         }
 
-        if ((color_id) != 0 && color_id <= last_color_id)
+        const unique_color_reservation* reservation = (color_id != 0 && color_id <= last_color_id) ? find_color_reservation(color_id) : nullptr;
+        if (reservation != nullptr)
         {
             scene_subscription.getPickEvent().setColorID(color_id);
             scene_subscription.getPickEvent().SetEventType(EventType::PickedEntity);
-            scene_subscription.getPickEvent().setEntityKey(EntityIdxKeyMapRegistry[get_actual_id(color_id)]);
-            scene_subscription.getPickEvent().setEntityID(get_actual_id(color_id));
-            scene_subscription.getPickEvent().setSubEntityID(color_id - (unique_colr_reservations[get_actual_id(color_id)]._Min_ColorID_));
+            scene_subscription.getPickEvent().setEntityKey(Entity_DataBase.get_at(reservation->_EntityID_)->key);
+            scene_subscription.getPickEvent().setEntityHandle(Entity_DataBase.handle_at(reservation->_EntityID_));
+            scene_subscription.getPickEvent().setEntityID(reservation->_EntityID_);
+            scene_subscription.getPickEvent().setSubEntityID(color_id - reservation->_Min_ColorID_);
             scene_subscription.getPickEvent().setDepth(depth);
         }
     }
@@ -371,7 +415,7 @@ namespace GridPro_GFX
     /// @details  Use this function to check if the entity exists in the scene
     bool Scene_Manager::has_entity(const std::string &entity_key)
     {
-        std::unordered_map<std::string, uint32_t>::iterator it = this->SceneEntityRegistry.find(entity_key);
+        std::unordered_map<std::string, EntityId>::iterator it = this->SceneEntityRegistry.find(entity_key);
         if (it != SceneEntityRegistry.end())
         {
             return true;
@@ -382,6 +426,28 @@ namespace GridPro_GFX
         }
     }
 
+    bool Scene_Manager::has_entity(const EntityId &entity_id) const
+    {
+        return Entity_DataBase.contains(entity_id);
+    }
+
+    /// @brief Get the handle of an entity
+    /// @param entity_key
+    /// @return EntityId, a null handle if no entity has this key
+    EntityId Scene_Manager::find_entity(const std::string &entity_key) const
+    {
+        std::unordered_map<std::string, EntityId>::const_iterator it = SceneEntityRegistry.find(entity_key);
+        return it != SceneEntityRegistry.end() ? it->second : EntityId();
+    }
+
+    /// @brief Get the key of an entity, "NULL_ENTITY" if the handle is no longer valid
+    const std::string& Scene_Manager::get_entity_key(const EntityId &entity_id) const
+    {
+        static const std::string null_entity_key = "NULL_ENTITY";
+        const SceneEntity* scene_entity = Entity_DataBase.get(entity_id);
+        return scene_entity != nullptr ? scene_entity->key : null_entity_key;
+    }
+
     /// @brief Get the entity object from the scene
     /// @param entity_key
     /// @return Entity_Handle
@@ -391,16 +457,12 @@ namespace GridPro_GFX
     Entity_Handle Scene_Manager::get_entity(const std::string &entity_key)
     {
         // Check if key exists
-        std::unordered_map<std::string, uint32_t>::iterator it = this->SceneEntityRegistry.find(entity_key);
+        std::unordered_map<std::string, EntityId>::iterator it = this->SceneEntityRegistry.find(entity_key);
 
         // If key Exists Retrieve it
         if (it != SceneEntityRegistry.end())
         {
-            Entity_Handle entt_handle;
-            entt_handle.entity_ptr = &Entity_DataBase[SceneEntityRegistry[entity_key]];
-            entt_handle.scene_ptr = this;
-            entt_handle.entity_key = entity_key;
-            return entt_handle;
+            return get_entity(it->second);
         }
         // Else Create a new one
         else
@@ -408,23 +470,22 @@ namespace GridPro_GFX
             GP_TRACE("Creating Entity : ", entity_key);
             GP_TRACE("Total Entity Count : ", (Entity_DataBase.size()));
 
-            uint32_t curr_assign_id = (Entity_DataBase.size());
-
-            // Register the Entity key-idx pairs
-            SceneEntityRegistry[entity_key] = curr_assign_id; /// store Entity key index pair in registry
-            EntityIdxKeyMapRegistry[curr_assign_id] = entity_key;
+            // Create and store entity in a free slot, the slot index is the entity's kernel ID
+            const EntityId slot_handle = Entity_DataBase.emplace(this->RenderableEntitiesManager.create(), entity_key);
+            const uint32_t curr_assign_id = slot_handle.index;
+            ecs::Entity& entity = Entity_DataBase.get(slot_handle)->entity;
 
-            // Create and store entity in the entity deque
-            Entity_DataBase.emplace_back(this->RenderableEntitiesManager.create());
+            // Register the Entity key-handle pair
+            SceneEntityRegistry[entity_key] = slot_handle; /// store Entity key handle pair in registry
 
             // Load a Render Kernel based on avaliable devices
             if(RenderSystemsManager.has<OpenGL_3_3_RenderDevice>())
             {  
-              Entity_DataBase.back().add<OpenGL_3_3_RenderKernel>().set_kernel_id(curr_assign_id); 
+              entity.add<OpenGL_3_3_RenderKernel>().set_kernel_id(curr_assign_id); 
             }
             else if(RenderSystemsManager.has<OpenGL_2_1_RenderDevice>())
             {  
-              Entity_DataBase.back().add<OpenGL_2_1_RenderKernel>().set_kernel_id(curr_assign_id);
+              entity.add<OpenGL_2_1_RenderKernel>().set_kernel_id(curr_assign_id);
             }
             else
             {
@@ -432,30 +493,57 @@ namespace GridPro_GFX
             }
             // Add a Commit Component to the entity
 
-            Entity_DataBase.back().add<commit_component>();
+            entity.add<commit_component>();
 
             // Add a entity tag component to the entity
-            Entity_DataBase.back().add<tag_component>(entity_key);
-
-            // Create a indirect EntityHandle and return it
-            Entity_Handle entt_handle;
-            entt_handle.entity_ptr = &(Entity_DataBase.back());
-            entt_handle.scene_ptr = this;
-            entt_handle.entity_key = entity_key;
+            entity.add<tag_component>(entity_key);
 
             GP_TRACE("Success in Entity Creation : ", entity_key);
 
-            return entt_handle;
+            // Create a indirect EntityHandle and return it
+            return get_entity(slot_handle);
         }
     }
 
+    /// @brief Get the entity object of a handle
+    /// @note  No string is copied, the handle points to the key stored with the entity
+    /// @note  An invalid handle gives an Entity_Handle whose is_valid() is false
+    Entity_Handle Scene_Manager::get_entity(const EntityId &entity_id)
+    {
+        Entity_Handle entt_handle;
+        SceneEntity* scene_entity = Entity_DataBase.get(entity_id);
+        if (scene_entity != nullptr)
+        {
+            entt_handle.entity_ptr = &scene_entity->entity;
+            entt_handle.entity_key = &scene_entity->key;
+            entt_handle.slot_handle = entity_id;
+            entt_handle.scene_ptr = this;
+        }
+        return entt_handle;
+    }
+
     /// @brief Load a geometry descriptor
     /// @param geometry_descriptor
     /// @details  Use this function to load a geometry descriptor into the Appropriate Render Device kernel
-    void Scene_Manager::commit_geometry(const std::string &in_name, const float &in_layer_id, const std::shared_ptr<GeometryDescriptor> &geometry_descriptor)
+    /// @return Handle of the entity, created if no entity has this name
+    EntityId Scene_Manager::commit_geometry(const std::string &in_name, const float &in_layer_id, const std::shared_ptr<GeometryDescriptor> &geometry_descriptor)
     {
         GP_TRACE("Committing Geometry : ", in_name, " to the Scene");
-        Entity_Handle entt_handle = get_entity(in_name);
+        const EntityId entity_id = get_entity(in_name).slot_handle;
+        commit_geometry(entity_id, in_layer_id, geometry_descriptor);
+        return entity_id;
+    }
+
+    /// @brief Load a geometry descriptor into an existing entity
+    /// @return false if the handle is no longer valid
+    bool Scene_Manager::commit_geometry(const EntityId &entity_id, const float &in_layer_id, const std::shared_ptr<GeometryDescriptor> &geometry_descriptor)
+    {
+        if (!has_entity(entity_id))
+        {
+            GP_TRACE("Entity handle ", entity_id.index, " does not exist in the scene");
+            return false;
+        }
+        Entity_Handle entt_handle = get_entity(entity_id);
 
         if(has_a_valid_render_device)
         {
@@ -470,16 +558,21 @@ namespace GridPro_GFX
             }
             
             entt_handle.GetComponent<GridPro_GFX::commit_component>()->set_layer_id(in_layer_id)->commit();
+            draw_buckets.insert(entity_id.index, in_layer_id);
+            draw_buckets.set_visible(entity_id.index, true);
+
+            // Only this entity's pick range is revisited, an entity that was never pickable has none to give back
             GLenum pick_scheme = (*geometry_descriptor)->get_pick_scheme_enum();
-            if(pick_scheme != 0)
+            if(pick_scheme != 0 || unique_colr_reservations.count(entity_id.index) != 0)
             {
-                need_to_update_color_reservations = true;
+                pending_color_reservations.insert(entity_id.index);
             }
         }
         else
         {
             GP_ERROR("No Compatible Render Device Found");
         }
+        return true;
     }
     
     /// @brief Get the geometry descriptor
@@ -487,9 +580,22 @@ namespace GridPro_GFX
     /// @details  Use this function to Get a geometry descriptor from the Appropriate Render Device kernel
     std::shared_ptr<GeometryDescriptor>& Scene_Manager::get_geometry(const std::string& in_name)
     {
-        if(has_entity(in_name))
+        const EntityId entity_id = find_entity(in_name);
+        if(entity_id.is_null())
+        {
+            GP_ERROR("No Entity With Name : ", in_name, "found while retrieving the geometry");
+            throw(std::runtime_error("No Entity With Name : " + in_name + "found while retrieving the geometry"));
+        }
+        return get_geometry(entity_id);
+    }
+
+    /// @brief Get the geometry descriptor of an entity handle
+    /// @throws std::runtime_error if the handle is no longer valid
+    std::shared_ptr<GeometryDescriptor>& Scene_Manager::get_geometry(const EntityId& entity_id)
+    {
+        if(has_entity(entity_id))
         {
-            Entity_Handle entt_handle = get_entity(in_name);
+            Entity_Handle entt_handle = get_entity(entity_id);
 
             if(RenderSystemsManager.has<OpenGL_3_3_RenderDevice>())
             {
@@ -507,8 +613,8 @@ namespace GridPro_GFX
         }
         else
         {
-            GP_ERROR("No Entity With Name : ", in_name, "found while retrieving the geometry");
-            throw(std::runtime_error("No Entity With Name : " + in_name + "found while retrieving the geometry"));
+            GP_ERROR("No Entity With Handle : ", entity_id.index, " found while retrieving the geometry");
+            throw(std::runtime_error("No Entity With Handle : " + std::to_string(entity_id.index) + " found while retrieving the geometry"));
         }
     }    
 
@@ -519,37 +625,25 @@ namespace GridPro_GFX
     /// @details  Use this function to remove the entity from the scene
     bool Scene_Manager::remove_entity_from_registry(const std::string &entity_key)
     {
-        // Reassigning IDs
-        std::unordered_map<std::string, uint32_t>::iterator idx = SceneEntityRegistry.begin();
-
-        while (idx != SceneEntityRegistry.end())
-        {
-            if (idx->second > SceneEntityRegistry[entity_key])
-            {
-                --(idx->second);
-            }
-            ++idx;
-        }
+        return remove_entity_from_registry(find_entity(entity_key));
+    }
 
-        std::deque<ecs::Entity>::iterator it = Entity_DataBase.begin();
+    bool Scene_Manager::remove_entity_from_registry(const EntityId &entity_id)
+    {
+        // Other entities keep their slots (and kernel IDs), the freed slot is reused by the next entity
+        const SceneEntity* scene_entity = Entity_DataBase.get(entity_id);
 
-        while ((*it != (Entity_DataBase[SceneEntityRegistry[entity_key]])))
+        if (scene_entity == nullptr)
         {
-            if (it == Entity_DataBase.end())
-                break;
-            ++it;
+            return false;
         }
 
-        if (it != Entity_DataBase.end())
-        {
-            Entity_DataBase.erase(it);
-            EntityIdxKeyMapRegistry.erase(SceneEntityRegistry[entity_key]);
-            unique_colr_reservations.erase(SceneEntityRegistry[entity_key]);
-            SceneEntityRegistry.erase(entity_key);
-            return true;
-        }
+        SceneEntityRegistry.erase(scene_entity->key);
+        release_color_reservation(entity_id.index);
+        pending_color_reservations.erase(entity_id.index);
+        draw_buckets.remove(entity_id.index);
 
-        return false;
+        return Entity_DataBase.erase(entity_id);
     }
 
     /// @brief Destroy the entity from the scene
@@ -558,16 +652,15 @@ namespace GridPro_GFX
     /// @details  Use this function to destroy the entity from the scene
     bool Scene_Manager::destroy_entity(const std::string &entity_key)
     {
-        if (has_entity(entity_key))
-        {
-            Entity_Handle entt_handle = get_entity(entity_key);
-            
-            GeometryDescriptor* geometry_descriptor = entt_handle.GetComponent<OpenGL_3_3_RenderKernel>()->get_descriptor().get();
+        return destroy_entity(find_entity(entity_key));
+    }
 
-            if((*geometry_descriptor)->get_pick_scheme_enum() != 0); 
-            {
-               need_to_update_color_reservations = true;
-            }
+    bool Scene_Manager::destroy_entity(const EntityId &entity_id)
+    {
+        if (has_entity(entity_id))
+        {
+            // The pick range goes back to the allocator in remove_entity_from_registry
+            Entity_Handle entt_handle = get_entity(entity_id);
             entt_handle.destroy();
 
             return true;
@@ -575,43 +668,82 @@ namespace GridPro_GFX
         return false;
     }
 
+    /// @brief Merge b into a. An empty box (max < min) is treated as no box
+    static void merge_bounding_box(std::array<float, 6>& a, bool& a_is_empty, const std::array<float, 6>& b)
+    {
+        if(a_is_empty)
+        {
+            a = b;
+            a_is_empty = false;
+            return;
+        }
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            a[axis]     = std::min(a[axis], b[axis]);
+            a[axis + 3] = std::max(a[axis + 3], b[axis + 3]);
+        }
+    }
+
+    /// @brief Get the union of the bounding boxes of the given entities
+    /// @param entity_keys
+    /// @details  Unknown entities are skipped
+    std::array<float, 6> Scene_Manager::get_bounding_box(const std::vector<std::string>& entity_keys)
+    {
+        std::array<float, 6> bounding_box = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+        bool is_empty = true;
+
+        for(const std::string& entity_key : entity_keys)
+        {
+            if(!has_entity(entity_key))
+                continue;
+
+            const std::shared_ptr<GeometryDescriptor>& geometry_descriptor = get_geometry(entity_key);
+            if(geometry_descriptor == nullptr || !geometry_descriptor->hasAnyDrawables())
+                continue;
+
+            merge_bounding_box(bounding_box, is_empty, geometry_descriptor->get_total_bounding_box());
+        }
+        return bounding_box;
+    }
+
+    /// @brief Get the union of the bounding boxes of all entities in a layer
+    /// @param layer
+    std::array<float, 6> Scene_Manager::get_layer_bounding_box(const float& layer)
+    {
+        std::vector<std::string> entity_keys;
+        for (const uint32_t& slot : draw_buckets.slots(layer))
+        {
+            entity_keys.push_back(Entity_DataBase.get_at(slot)->key);
+        }
+        return get_bounding_box(entity_keys);
+    }
+
+    /// @brief Get the union of the bounding boxes of all the scene entities
+    /// @details  Background, 2D overlay and hidden layers are helpers (grids, axes, selection polygons) and are not part of the scene extent
+    std::array<float, 6> Scene_Manager::get_scene_bounding_box()
+    {
+        std::vector<std::string> entity_keys;
+        for (auto entity : RenderableEntitiesManager.with<commit_component>())
+        {
+            const float layer = entity.get<commit_component>().layer_id();
+            if (layer == GL_LAYER_BACKGROUND || layer == GL_LAYER_BACKGROUND_2D || layer == GL_LAYER_FOREGROUND_2D || layer == GL_LAYER_HIDDEN)
+                continue;
+            entity_keys.push_back(entity.get<tag_component>().tag_name_ref());
+        }
+        return get_bounding_box(entity_keys);
+    }
+
     /// @brief Destroy all entities in the given layer
     /// @param layer
     /// @details  Use this function to destroy all entities in the given layer
     void Scene_Manager::destroy_entities_in_layer(const float &layer)
     {
-        for (auto entity : RenderableEntitiesManager.with<commit_component>())
+        // Destroying an entity takes it out of the bucket, walk a copy
+        const std::vector<uint32_t> layer_slots = draw_buckets.slots(layer);
+        for (const uint32_t& slot : layer_slots)
         {
-            if (entity.get<commit_component>().layer_id() == layer)
-            {
-                std::string entity_name(std::move(entity.get<tag_component>().tag_name_ref()));
-                
-                GeometryDescriptor* geometry_descriptor;
-
-                if(RenderSystemsManager.has<OpenGL_3_3_RenderDevice>())
-                {
-                    geometry_descriptor = entity.get<OpenGL_3_3_RenderKernel>().get_descriptor().get();
-                }
-                else if(RenderSystemsManager.has<OpenGL_2_1_RenderDevice>())
-                {
-                    geometry_descriptor = entity.get<OpenGL_2_1_RenderKernel>().get_descriptor().get();
-                }
-                else
-                {
-                    GP_ERROR("No RenderDevice found when destroying the entity");
-                    throw std::runtime_error("No RenderDevice found when destroying the entity");
-                }
-
-                if ((*geometry_descriptor)->get_pick_scheme_enum() != 0)
-                {
-                    need_to_update_color_reservations = true;
-                }
-                
-                if (entity.is_valid())
-                    entity.destroy();
-
-                remove_entity_from_registry(entity_name);
-            }
+            destroy_entity(Entity_DataBase.handle_at(slot));
         }
         GP_PRINT("Destroyed all entities in layer : ", layer);
     }
@@ -619,87 +751,152 @@ namespace GridPro_GFX
     /// @brief Update the color reservations
     /// @details  Use this function to update the color reservations
     /// @note This function is called before the scene is updated so that pick ids are reserved for each entity properly
+    /// @note Only the entities committed since the last call are visited, see update_entity_color_reservation()
     void Scene_Manager::update_color_reservations()
     {
-        if(need_to_update_color_reservations == false)
+        if(pending_color_reservations.empty())
         {
             return;
         }
-        else
+
+        for (const uint32_t& slot : pending_color_reservations)
         {
-            need_to_update_color_reservations = false;
+            update_entity_color_reservation(slot);
         }
+        pending_color_reservations.clear();
 
-        std::deque<ecs::Entity>::iterator end = Entity_DataBase.end();
-
-        std::deque<ecs::Entity>::iterator it = Entity_DataBase.begin();
+        last_color_id = pick_id_allocator.top() - 1;
+    }
 
-        uint32_t reserved_color_id_end = 10000;
+    /// @brief Reserve pick IDs for one entity
+    /// @details The entity keeps its range while its pickable entity count does not change, grows or shrinks it in place
+    /// when the neighbouring IDs allow, and moves to another free range otherwise. No other entity is touched
+    void Scene_Manager::update_entity_color_reservation(const uint32_t &slot)
+    {
+        SceneEntity* scene_entity = Entity_DataBase.get_at(slot);
+        if (scene_entity == nullptr)
+        {
+            release_color_reservation(slot);
+            return;
+        }
+        ecs::Entity* it = &scene_entity->entity;
 
-        for (it; it != end; ++it)
+        GeometryDescriptor* MeshComponent = nullptr; 
+        
+        // get entity's mesh component
+        if(RenderSystemsManager.has<OpenGL_3_3_RenderDevice>())
+        {
+           MeshComponent = (it->get<OpenGL_3_3_RenderKernel>().get_descriptor().get());
+        }
+        else if(RenderSystemsManager.has<OpenGL_2_1_RenderDevice>())
+        {
+           MeshComponent = (it->get<OpenGL_2_1_RenderKernel>().get_descriptor().get());
+        }
+        else
         {
-            // Temporary Color reservation
-            unique_color_reservation colr_reserv;
+            GP_ERROR("No RenderKernel and RenderDevice while setting Unique Color Reservation");
+            return;
+        } 
 
-            // Set its Minima of color id based on previous entity max color id
-            colr_reserv._Min_ColorID_ = reserved_color_id_end;
+        const uint32_t count = (MeshComponent == nullptr || (*MeshComponent)->get_pick_scheme_enum() == GL_PICK_NONE) ? 0 :
+                               static_cast<uint32_t>((*MeshComponent)->get_pickable_entities_count());
 
-            GeometryDescriptor* MeshComponent = nullptr; 
-            
-            // get entity's mesh component
-            // set color reservation id so that we can know to whom the reservation belongs to 
-            if(RenderSystemsManager.has<OpenGL_3_3_RenderDevice>())
-            {
-               MeshComponent = (it->get<OpenGL_3_3_RenderKernel>().get_descriptor().get());
-               colr_reserv._EntityID_ = it->get<OpenGL_3_3_RenderKernel>().get_kernel_id();
-            }
-            else if(RenderSystemsManager.has<OpenGL_2_1_RenderDevice>())
-            {
-               MeshComponent = (it->get<OpenGL_2_1_RenderKernel>().get_descriptor().get());
-               colr_reserv._EntityID_ = it->get<OpenGL_2_1_RenderKernel>().get_kernel_id();
-            }
-            else
-            {
-                GP_ERROR("No RenderKernel and RenderDevice while setting Unique Color Reservation");
-                return;
-            } 
+        std::unordered_map<uint32_t, unique_color_reservation>::iterator reserved = unique_colr_reservations.find(slot);
+        if (count == 0)
+        {
+            release_color_reservation(slot);
+            return;
+        }
 
+        uint32_t start;
+        if (reserved == unique_colr_reservations.end())
+        {
+            start = pick_id_allocator.allocate(count);
+        }
+        else
+        {
+            const uint32_t old_count = reserved->second._Max_ColorID_ - reserved->second._Min_ColorID_ + 1;
+            start = pick_id_allocator.resize(reserved->second._Min_ColorID_, old_count, count);
+        }
 
-            if((*MeshComponent)->get_pick_scheme_enum() == GL_PICK_NONE) continue; 
-            
-            // Based on previous entitiy mac color id,  let the mesh calculate how many ids it needs
-            MeshComponent->set_color_id_reserve_start(reserved_color_id_end);
+        if (start == PickIdAllocator::INVALID_ID)
+        {
+            GP_ERROR("Out of pick IDs while reserving IDs for Entity : ", scene_entity->key);
+            unique_colr_reservations.erase(slot);
+            need_to_rebuild_color_intervals = true;
+            return;
+        }
 
-            // reflect the same in the color reservation component
-            colr_reserv._Max_ColorID_ = MeshComponent->get_color_id_reserve_end();
+        // A newly committed descriptor does not know its range yet, set it even when the range did not move
+        MeshComponent->set_color_id_reserve_start(start);
 
-            // After the mesh calculates the required ids by the current mesh set minima for next entity as max of previous entity
-            reserved_color_id_end = colr_reserv._Max_ColorID_ + 1;
+        const unique_color_reservation colr_reserv(slot, start, MeshComponent->get_color_id_reserve_end());
+        if (reserved == unique_colr_reservations.end() || reserved->second._Min_ColorID_ != colr_reserv._Min_ColorID_ ||
+            reserved->second._Max_ColorID_ != colr_reserv._Max_ColorID_)
+        {
+            unique_colr_reservations[slot] = colr_reserv;
+            need_to_rebuild_color_intervals = true;
+        }
 
-            unique_colr_reservations[colr_reserv._EntityID_] = colr_reserv;
+        GP_TRACE("RESERVED IDS for Entity : ", scene_entity->key, " = ", colr_reserv._Min_ColorID_, ", ", colr_reserv._Max_ColorID_);
+    }
 
-            GP_TRACE("RESERVED IDS for Entity : ", EntityIdxKeyMapRegistry[colr_reserv._EntityID_], " = ", colr_reserv._Min_ColorID_, ", ", colr_reserv._Max_ColorID_);
+    /// @brief Give the pick IDs of an entity back to the allocator
+    void Scene_Manager::release_color_reservation(const uint32_t &slot)
+    {
+        std::unordered_map<uint32_t, unique_color_reservation>::iterator reserved = unique_colr_reservations.find(slot);
+        if (reserved == unique_colr_reservations.end())
+        {
+            return;
         }
 
-        last_color_id = reserved_color_id_end - 1;
-
- 
+        pick_id_allocator.release(reserved->second._Min_ColorID_, reserved->second._Max_ColorID_ - reserved->second._Min_ColorID_ + 1);
+        unique_colr_reservations.erase(reserved);
+        need_to_rebuild_color_intervals = true;
     }
 
     uint32_t Scene_Manager::get_actual_id(const uint32_t &color_id)
     {
-        std::unordered_map<uint32_t, unique_color_reservation>::iterator it = unique_colr_reservations.begin();
-        std::unordered_map<uint32_t, unique_color_reservation>::iterator iter_end = unique_colr_reservations.end();
+        const unique_color_reservation* reservation = find_color_reservation(color_id);
+        return reservation != nullptr ? reservation->_EntityID_ : 0;
+    }
+
+    /// @brief Reservation whose range holds color_id, nullptr if none does
+    const unique_color_reservation* Scene_Manager::find_color_reservation(const uint32_t &color_id)
+    {
+        const std::vector<unique_color_reservation>& intervals = get_color_reservation_intervals();
+
+        // Last interval starting at or before color_id
+        std::vector<unique_color_reservation>::const_iterator it = std::upper_bound(intervals.begin(), intervals.end(), color_id,
+            [](const uint32_t& id, const unique_color_reservation& reservation) { return id < reservation._Min_ColorID_; });
+
+        if (it == intervals.begin())
+        {
+            return nullptr;
+        }
+        --it;
+        return color_id <= it->_Max_ColorID_ ? &(*it) : nullptr;
+    }
 
-        for (it; it != iter_end; ++it)
+    const std::vector<unique_color_reservation>& Scene_Manager::get_color_reservation_intervals()
+    {
+        if (need_to_rebuild_color_intervals)
         {
-            if (color_id >= it->second._Min_ColorID_ && color_id <= it->second._Max_ColorID_)
+            color_reservation_intervals.clear();
+            color_reservation_intervals.reserve(unique_colr_reservations.size());
+            for (const auto& reservation : unique_colr_reservations)
             {
-                return it->second._EntityID_;
+                // An entity reserving no ID would share its _Min_ColorID_ with the next one
+                if (reservation.second._Max_ColorID_ >= reservation.second._Min_ColorID_)
+                {
+                    color_reservation_intervals.push_back(reservation.second);
+                }
             }
+            std::sort(color_reservation_intervals.begin(), color_reservation_intervals.end(),
+                [](const unique_color_reservation& a, const unique_color_reservation& b) { return a._Min_ColorID_ < b._Min_ColorID_; });
+            need_to_rebuild_color_intervals = false;
         }
-
-        return 0;
+        return color_reservation_intervals;
     }
 
     void Scene_Manager::set_system_state(const bool &state)
@@ -736,62 +933,79 @@ namespace GridPro_GFX
 
     void Scene_Manager::commit_all()
     {
-        for (auto entity : RenderableEntitiesManager.with<commit_component>())
+        draw_buckets.for_each([&](const uint32_t& slot)
         {
-            entity.get<commit_component>().commit();
-        }
+            Entity_DataBase.get_at(slot)->entity.get<commit_component>().commit();
+            draw_buckets.set_visible(slot, true);
+        });
     }
 
     bool Scene_Manager::commit_entity(const std::string &entity_key)
     {
-        if (!has_entity(entity_key))
+        const EntityId entity_id = find_entity(entity_key);
+        if (entity_id.is_null())
         {
             GP_TRACE("Entity with key : ", entity_key, " does not exist in the scene");
             return false;
         }
-        Entity_Handle entt_handle = get_entity(entity_key);
-        entt_handle.GetComponent<commit_component>()->commit();
+        return commit_entity(entity_id);
+    }
+
+    bool Scene_Manager::commit_entity(const EntityId &entity_id)
+    {
+        SceneEntity* scene_entity = Entity_DataBase.get(entity_id);
+        if (scene_entity == nullptr)
+        {
+            return false;
+        }
+        scene_entity->entity.get<commit_component>().commit();
+        draw_buckets.set_visible(entity_id.index, true);
         return true;
     }
 
     bool Scene_Manager::uncommit_entity(const std::string &entity_key)
     {
-        if (!has_entity(entity_key))
+        const EntityId entity_id = find_entity(entity_key);
+        if (entity_id.is_null())
         {
             GP_TRACE("Entity with key : ", entity_key, " does not exist in the scene");
             return false;
         }
-        Entity_Handle entt_handle = get_entity(entity_key);
-        entt_handle.GetComponent<commit_component>()->uncommit();
+        return uncommit_entity(entity_id);
+    }
+
+    bool Scene_Manager::uncommit_entity(const EntityId &entity_id)
+    {
+        SceneEntity* scene_entity = Entity_DataBase.get(entity_id);
+        if (scene_entity == nullptr)
+        {
+            return false;
+        }
+        scene_entity->entity.get<commit_component>().uncommit();
+        draw_buckets.set_visible(entity_id.index, false);
         return true;
     }
 
     bool Scene_Manager::commit_layer(const float &layer)
     {
-        bool commit_status = false;
-        for (auto entity : RenderableEntitiesManager.with<commit_component>())
+        const std::vector<uint32_t>& layer_slots = draw_buckets.slots(layer);
+        for (const uint32_t& slot : layer_slots)
         {
-            if (entity.get<commit_component>().layer_id() == layer)
-            {
-                commit_status = true;
-                entity.get<commit_component>().commit();
-            }
+            Entity_DataBase.get_at(slot)->entity.get<commit_component>().commit();
+            draw_buckets.set_visible(slot, true);
         }
-        return commit_status;
+        return !layer_slots.empty();
     }
 
     bool Scene_Manager::uncommit_layer(const float &layer)
     {
-        bool commit_status = false;
-        for (auto entity : RenderableEntitiesManager.with<commit_component>())
+        const std::vector<uint32_t>& layer_slots = draw_buckets.slots(layer);
+        for (const uint32_t& slot : layer_slots)
         {
-            if (entity.get<commit_component>().layer_id() == layer)
-            {
-                commit_status = true;
-                entity.get<commit_component>().uncommit();
-            }
+            Entity_DataBase.get_at(slot)->entity.get<commit_component>().uncommit();
+            draw_buckets.set_visible(slot, false);
         }
-        return commit_status;
+        return !layer_slots.empty();
     }
 
     void Scene_Manager::clear_screen(const float &r, const float &g, const float &b, const float &a)
@@ -803,13 +1017,16 @@ namespace GridPro_GFX
     void Scene_Manager::reset_scene_registry()
     {
         SceneEntityRegistry.clear();
-        EntityIdxKeyMapRegistry.clear();
         unique_colr_reservations.clear();
+        color_reservation_intervals.clear();
+        need_to_rebuild_color_intervals = true;
+        pick_id_allocator.clear();
+        pending_color_reservations.clear();
+        draw_buckets.clear();
         Entity_DataBase.clear();
         ecs::EntityManager NewEntityManager;
         RenderableEntitiesManager = std::move(NewEntityManager);
         last_color_id = 0;
-        need_to_update_color_reservations = true;
 
     }
 } // namespace GridPro_GFX
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <array>
+#include "gp_gui_tessellator.h"
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+namespace Tessellator {
+
+namespace {
+
+    /// Triangles per worker before a thread is spawned for it
+    constexpr size_t GRAIN_SIZE = 1 << 14;
+
+    constexpr uint32_t NO_MIDPOINT = 0xFFFFFFFF;
+
+    inline uint64_t edge_key(uint32_t a, uint32_t b)
+    {
+        if (a > b) std::swap(a, b);
+        return (uint64_t(a) << 32) | b;
+    }
+
+    /// Vertex arrays growing by one block of midpoints per round
+    struct VertexData
+    {
+        std::vector<float>   positions;
+        std::vector<float>   normals;
+        std::vector<uint8_t> colors;
+        size_t               color_components = 0;
+
+        size_t size() const { return positions.size() / 3; }
+    };
+
+    /// Edge test of the adaptive modes. It only looks at the edge, so both triangles of an edge agree
+    class SplitCriterion
+    {
+        public :
+        SplitCriterion(const TessellationOptions& options, const VertexData& vertices)
+            : m_vertices(vertices),
+              m_max_length_squared(options.max_edge_length * options.max_edge_length),
+              m_min_cos_angle(std::cos(options.max_normal_angle * 3.14159265358979f / 180.0f)),
+              m_test_length(options.max_edge_length > 0.0f),
+              m_test_angle(options.max_normal_angle > 0.0f && !vertices.normals.empty()),
+              m_is_uniform(options.max_edge_length <= 0.0f && options.max_normal_angle <= 0.0f)
+        {
+        }
+
+        bool operator()(const uint32_t& a, const uint32_t& b) const
+        {
+            if (m_is_uniform)
+                return true;
+
+            if (m_test_length)
+            {
+                const float* pa = &m_vertices.positions[size_t(a) * 3];
+                const float* pb = &m_vertices.positions[size_t(b) * 3];
+                const float dx = pa[0] - pb[0], dy = pa[1] - pb[1], dz = pa[2] - pb[2];
+                if (dx * dx + dy * dy + dz * dz > m_max_length_squared)
+                    return true;
+            }
+
+            if (m_test_angle)
+            {
+                const float* na = &m_vertices.normals[size_t(a) * 3];
+                const float* nb = &m_vertices.normals[size_t(b) * 3];
+                const float length = std::sqrt((na[0] * na[0] + na[1] * na[1] + na[2] * na[2]) * (nb[0] * nb[0] + nb[1] * nb[1] + nb[2] * nb[2]));
+                if (length > 0.0f && (na[0] * nb[0] + na[1] * nb[1] + na[2] * nb[2]) < m_min_cos_angle * length)
+                    return true;
+            }
+            return false;
+        }
+
+        private :
+        const VertexData& m_vertices;
+        float m_max_length_squared;
+        float m_min_cos_angle;
+        bool  m_test_length;
+        bool  m_test_angle;
+        bool  m_is_uniform;
+    };
+
+    float distance_squared(const VertexData& vertices, const uint32_t& a, const uint32_t& b)
+    {
+        const float* pa = &vertices.positions[size_t(a) * 3];
+        const float* pb = &vertices.positions[size_t(b) * 3];
+        const float dx = pa[0] - pb[0], dy = pa[1] - pb[1], dz = pa[2] - pb[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    /// Children of one triangle for its split edges. Edge k runs from corner k to corner k + 1, mid[k] is its
+    /// midpoint or NO_MIDPOINT. Winding is kept. Returns the number of triangles written
+    size_t split_triangle(const uint32_t* corner, const uint32_t* mid, const VertexData& vertices, uint32_t* out)
+    {
+        const int num_split = int(mid[0] != NO_MIDPOINT) + int(mid[1] != NO_MIDPOINT) + int(mid[2] != NO_MIDPOINT);
+        auto emit = [&out](const uint32_t& a, const uint32_t& b, const uint32_t& c) { out[0] = a; out[1] = b; out[2] = c; out += 3; };
+
+        if (num_split == 0)
+        {
+            emit(corner[0], corner[1], corner[2]);
+            return 1;
+        }
+
+        if (num_split == 3)
+        {
+            emit(corner[0], mid[0], mid[2]);
+            emit(mid[0], corner[1], mid[1]);
+            emit(mid[2], mid[1], corner[2]);
+            emit(mid[0], mid[1], mid[2]);
+            return 4;
+        }
+
+        if (num_split == 1)
+        {
+            /// Rotate so the split edge is edge 0 : (v0, v1) with the opposite corner v2
+            const int k = mid[0] != NO_MIDPOINT ? 0 : (mid[1] != NO_MIDPOINT ? 1 : 2);
+            const uint32_t v0 = corner[k], v1 = corner[(k + 1) % 3], v2 = corner[(k + 2) % 3];
+            emit(v0, mid[k], v2);
+            emit(mid[k], v1, v2);
+            return 2;
+        }
+
+        /// Rotate so the edge left whole is edge 1 : (v1, v2), split edges 0 and 2 meet at v0
+        const int k = mid[0] == NO_MIDPOINT ? 2 : (mid[1] == NO_MIDPOINT ? 0 : 1);
+        const uint32_t v0 = corner[k], v1 = corner[(k + 1) % 3], v2 = corner[(k + 2) % 3];
+        const uint32_t m01 = mid[k], m20 = mid[(k + 2) % 3];
+        emit(v0, m01, m20);
+
+        /// The remaining quad (m01, v1, v2, m20) is cut along its shorter diagonal
+        if (distance_squared(vertices, m01, v2) <= distance_squared(vertices, v1, m20))
+        {
+            emit(m01, v1, v2);
+            emit(m01, v2, m20);
+        }
+        else
+        {
+            emit(m01, v1, m20);
+            emit(v1, v2, m20);
+        }
+        return 3;
+    }
+
+} // namespace
+
+    TessellationResult tessellate(const TriangleMesh& mesh, const TessellationOptions& options, const std::vector<uint32_t>& selected_triangles)
+    {
+        VertexData vertices;
+        vertices.positions.assign(mesh.positions, mesh.positions + mesh.num_vertices * 3);
+        if (mesh.normals)
+            vertices.normals.assign(mesh.normals, mesh.normals + mesh.num_vertices * 3);
+        if (mesh.colors)
+        {
+            vertices.color_components = mesh.color_components;
+            vertices.colors.assign(mesh.colors, mesh.colors + mesh.num_vertices * mesh.color_components);
+        }
+
+        /// Current triangles, whether they are refined further and the input triangle they come from
+        std::vector<uint32_t> triangles(mesh.num_triangles * 3);
+        std::vector<uint8_t>  is_selected(mesh.num_triangles, selected_triangles.empty() ? 1 : 0);
+        std::vector<uint32_t> source(mesh.num_triangles);
+
+        for (size_t t = 0; t < mesh.num_triangles; ++t)
+        {
+            source[t] = uint32_t(t);
+            for (size_t c = 0; c < 3; ++c)
+            {
+                const uint32_t index = mesh.indices ? mesh.indices[t * 3 + c] : uint32_t(t * 3 + c);
+                if (index >= mesh.num_vertices)
+                    throw std::runtime_error(std::string("Tessellator::tessellate : index ") + std::to_string(index) + " out of range");
+                triangles[t * 3 + c] = index;
+            }
+        }
+
+        for (const uint32_t& t : selected_triangles)
+        {
+            if (t >= mesh.num_triangles)
+                throw std::runtime_error(std::string("Tessellator::tessellate : triangle ") + std::to_string(t) + " out of range");
+            is_selected[t] = 1;
+        }
+
+        for (uint32_t level = 0; level < options.max_level; ++level)
+        {
+            const size_t num_triangles = source.size();
+            const SplitCriterion should_split(options, vertices);
+
+            /// 1. Edges to split, collected per worker then sorted into the edge -> midpoint table
+            std::vector<std::vector<uint64_t>> worker_edges(Parallel::num_workers(num_triangles, GRAIN_SIZE));
+            Parallel::parallel_for(0, num_triangles, [&](size_t begin, size_t end, uint32_t worker_id)
+            {
+                std::vector<uint64_t>& edges = worker_edges[worker_id];
+                for (size_t t = begin; t < end; ++t)
+                {
+                    if (!is_selected[t]) continue;
+                    const uint32_t* corner = &triangles[t * 3];
+                    for (int k = 0; k < 3; ++k)
+                        if (should_split(corner[k], corner[(k + 1) % 3]))
+                            edges.push_back(edge_key(corner[k], corner[(k + 1) % 3]));
+                }
+            }, GRAIN_SIZE);
+
+            std::vector<uint64_t> split_edges;
+            for (const auto& edges : worker_edges)
+                split_edges.insert(split_edges.end(), edges.begin(), edges.end());
+            worker_edges.clear();
+
+            Parallel::parallel_sort(split_edges.begin(), split_edges.end(), std::less<uint64_t>());
+            split_edges.erase(std::unique(split_edges.begin(), split_edges.end()), split_edges.end());
+            if (split_edges.empty())
+                break;
+
+            /// 2. Midpoint i of the table is vertex first_midpoint + i, so the vertex order does not depend on threads
+            const size_t first_midpoint = vertices.size();
+            const size_t num_midpoints  = split_edges.size();
+            vertices.positions.resize((first_midpoint + num_midpoints) * 3);
+            if (!vertices.normals.empty()) vertices.normals.resize((first_midpoint + num_midpoints) * 3);
+            if (!vertices.colors.empty())  vertices.colors.resize((first_midpoint + num_midpoints) * vertices.color_components);
+
+            Parallel::parallel_for(0, num_midpoints, [&](size_t begin, size_t end, uint32_t)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const size_t a = size_t(split_edges[i] >> 32), b = size_t(split_edges[i] & 0xFFFFFFFF), m = first_midpoint + i;
+                    for (int c = 0; c < 3; ++c)
+                        vertices.positions[m * 3 + c] = 0.5f * (vertices.positions[a * 3 + c] + vertices.positions[b * 3 + c]);
+
+                    if (!vertices.normals.empty())
+                    {
+                        float n[3], length = 0.0f;
+                        for (int c = 0; c < 3; ++c) { n[c] = vertices.normals[a * 3 + c] + vertices.normals[b * 3 + c]; length += n[c] * n[c]; }
+                        length = length > 0.0f ? 1.0f / std::sqrt(length) : 0.0f;
+                        for (int c = 0; c < 3; ++c) vertices.normals[m * 3 + c] = n[c] * length;
+                    }
+
+                    const size_t cc = vertices.color_components;
+                    for (size_t c = 0; !vertices.colors.empty() && c < cc; ++c)
+                        vertices.colors[m * cc + c] = uint8_t((uint32_t(vertices.colors[a * cc + c]) + vertices.colors[b * cc + c] + 1) / 2);
+                }
+            }, GRAIN_SIZE);
+
+            /// 3. Midpoints of every triangle (unselected neighbours pick up the splits of their selected neighbours)
+            std::vector<uint32_t> triangle_midpoints(num_triangles * 3);
+            std::vector<uint32_t> first_child(num_triangles + 1, 0);
+            Parallel::parallel_for(0, num_triangles, [&](size_t begin, size_t end, uint32_t)
+            {
+                for (size_t t = begin; t < end; ++t)
+                {
+                    const uint32_t* corner = &triangles[t * 3];
+                    uint32_t num_children = 1;
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        const uint64_t key = edge_key(corner[k], corner[(k + 1) % 3]);
+                        const auto it = std::lower_bound(split_edges.begin(), split_edges.end(), key);
+                        const bool is_split = it != split_edges.end() && *it == key;
+                        triangle_midpoints[t * 3 + k] = is_split ? uint32_t(first_midpoint + (it - split_edges.begin())) : NO_MIDPOINT;
+                        num_children += is_split ? 1 : 0;
+                    }
+                    first_child[t + 1] = num_children;
+                }
+            }, GRAIN_SIZE);
+
+            for (size_t t = 0; t < num_triangles; ++t)
+                first_child[t + 1] += first_child[t];
+
+            /// 4. Children inherit the selection and the source triangle of their parent
+            const size_t num_children = first_child[num_triangles];
+            std::vector<uint32_t> child_triangles(num_children * 3);
+            std::vector<uint8_t>  child_selected(num_children);
+            std::vector<uint32_t> child_source(num_children);
+            Parallel::parallel_for(0, num_triangles, [&](size_t begin, size_t end, uint32_t)
+            {
+                for (size_t t = begin; t < end; ++t)
+                {
+                    const size_t first = first_child[t];
+                    const size_t count = split_triangle(&triangles[t * 3], &triangle_midpoints[t * 3], vertices, &child_triangles[first * 3]);
+                    std::fill_n(child_selected.begin() + first, count, is_selected[t]);
+                    std::fill_n(child_source.begin() + first, count, source[t]);
+                }
+            }, GRAIN_SIZE);
+
+            triangles.swap(child_triangles);
+            is_selected.swap(child_selected);
+            source.swap(child_source);
+        }
+
+        TessellationResult result;
+        result.positions        = std::move(vertices.positions);
+        result.normals          = std::move(vertices.normals);
+        result.colors           = std::move(vertices.colors);
+        result.indices          = std::move(triangles);
+        result.source_triangles = std::move(source);
+        return result;
+    }
+
+} // namespace Tessellator
+
+} // namespace GridPro_GFX
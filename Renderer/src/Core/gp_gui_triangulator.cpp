@@ -0,0 +1,239 @@
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <array>
+#include <functional>
+#include "gp_gui_triangulator.h"
+#include "gp_gui_parallel.h"
+
+namespace GridPro_GFX {
+
+namespace Triangulator {
+
+namespace {
+
+    /// Reads positions through an optional index array (nullptr = identity) with a byte stride
+    struct VertexSource
+    {
+        const uint32_t* order;
+        const uint8_t*  bytes;
+        size_t          stride;
+
+        uint32_t vertex(size_t i) const         { return order ? order[i] : static_cast<uint32_t>(i); }
+        const float* position(uint32_t v) const { return reinterpret_cast<const float*>(bytes + size_t(v) * stride); }
+    };
+
+    void validate_vertices(const uint32_t* order, const size_t& count, const size_t& num_vertices, const char* caller)
+    {
+        if(order == nullptr)
+        {
+            if(count > num_vertices)
+                throw std::runtime_error(std::string(caller) + " : more vertices referenced than the vertex array holds");
+            return;
+        }
+
+        for(size_t i = 0; i < count; ++i)
+            if(order[i] >= num_vertices)
+                throw std::runtime_error(std::string(caller) + " : index out of range of the vertex array");
+    }
+
+    float distance_squared(const float* a, const float* b)
+    {
+        const float dx = a[0] - b[0], dy = a[1] - b[1], dz = a[2] - b[2];
+        return dx * dx + dy * dy + dz * dz;
+    }
+
+    /// Unique undirected edges as GL_LINES pairs. edges holds (min << 32 | max) keys and is consumed
+    std::vector<uint32_t> unique_edges(std::vector<uint64_t>& edges)
+    {
+        Parallel::parallel_sort(edges.begin(), edges.end(), std::less<uint64_t>());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        std::vector<uint32_t> edge_indices(edges.size() * 2);
+        Parallel::parallel_for(0, edges.size(), [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t e = begin; e < end; ++e)
+            {
+                edge_indices[2 * e]     = static_cast<uint32_t>(edges[e] >> 32);
+                edge_indices[2 * e + 1] = static_cast<uint32_t>(edges[e] & 0xFFFFFFFFu);
+            }
+        });
+        return edge_indices;
+    }
+
+    uint64_t edge_key(uint32_t a, uint32_t b)
+    {
+        return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+    }
+
+    /// Quads given by a corner lookup corner(q, k), k in [0, 4) in boundary order
+    template<typename CornerFn>
+    Triangulation split_quads(const size_t& num_quads, const VertexSource& source, CornerFn&& corner)
+    {
+        Triangulation triangulation;
+        triangulation.indices.resize(num_quads * 6);
+        triangulation.primitive_ids.resize(num_quads * 2);
+        std::vector<uint64_t> edges(num_quads * 4);
+
+        Parallel::parallel_for(0, num_quads, [&](size_t begin, size_t end, uint32_t)
+        {
+            for(size_t q = begin; q < end; ++q)
+            {
+                const uint32_t c[4] = { corner(q, 0), corner(q, 1), corner(q, 2), corner(q, 3) };
+
+                /// Cutting along the shorter diagonal gives the better shaped pair (and the only valid one for most concave quads)
+                const bool cut_13 = distance_squared(source.position(c[1]), source.position(c[3])) <
+                                    distance_squared(source.position(c[0]), source.position(c[2]));
+                uint32_t* tri = &triangulation.indices[q * 6];
+                if(cut_13)
+                {
+                    tri[0] = c[0]; tri[1] = c[1]; tri[2] = c[3];
+                    tri[3] = c[1]; tri[4] = c[2]; tri[5] = c[3];
+                }
+                else
+                {
+                    tri[0] = c[0]; tri[1] = c[1]; tri[2] = c[2];
+                    tri[3] = c[0]; tri[4] = c[2]; tri[5] = c[3];
+                }
+
+                triangulation.primitive_ids[2 * q]     = static_cast<uint32_t>(q);
+                triangulation.primitive_ids[2 * q + 1] = static_cast<uint32_t>(q);
+
+                for(int k = 0; k < 4; ++k)
+                    edges[4 * q + k] = edge_key(c[k], c[(k + 1) & 3]);
+            }
+        }, Parallel::DEFAULT_GRAIN_SIZE / 4);
+
+        triangulation.edge_indices = unique_edges(edges);
+        return triangulation;
+    }
+
+} // namespace
+
+    Triangulation triangulate_quads(const uint32_t* corners, const size_t& num_quads,
+                                    const float* positions, const size_t& num_vertices, const size_t& stride_bytes)
+    {
+        validate_vertices(corners, num_quads * 4, num_vertices, "triangulate_quads");
+        const VertexSource source{ corners, reinterpret_cast<const uint8_t*>(positions), stride_bytes };
+
+        return split_quads(num_quads, source, [&](size_t q, int k) { return source.vertex(q * 4 + k); });
+    }
+
+    Triangulation triangulate_quad_strip(const uint32_t* strip, const size_t& num_strip_vertices,
+                                         const float* positions, const size_t& num_vertices, const size_t& stride_bytes)
+    {
+        validate_vertices(strip, num_strip_vertices, num_vertices, "triangulate_quad_strip");
+        const VertexSource source{ strip, reinterpret_cast<const uint8_t*>(positions), stride_bytes };
+        const size_t num_quads = num_strip_vertices >= 4 ? (num_strip_vertices - 2) / 2 : 0;
+
+        /// The strip zig-zags, the boundary order of quad q is 2q, 2q+1, 2q+3, 2q+2
+        static const size_t strip_corner[4] = { 0, 1, 3, 2 };
+        return split_quads(num_quads, source, [&](size_t q, int k) { return source.vertex(2 * q + strip_corner[k]); });
+    }
+
+    Triangulation triangulate_polygon(const uint32_t* loop, const size_t& num_loop_vertices,
+                                      const float* positions, const size_t& num_vertices, const size_t& stride_bytes)
+    {
+        validate_vertices(loop, num_loop_vertices, num_vertices, "triangulate_polygon");
+        const VertexSource source{ loop, reinterpret_cast<const uint8_t*>(positions), stride_bytes };
+
+        Triangulation triangulation;
+        const size_t n = num_loop_vertices;
+        if(n < 3) return triangulation;
+
+        /// Newell normal, robust for concave and slightly non planar loops
+        double normal[3] = { 0.0, 0.0, 0.0 };
+        for(size_t i = 0; i < n; ++i)
+        {
+            const float* a = source.position(source.vertex(i));
+            const float* b = source.position(source.vertex((i + 1) % n));
+            normal[0] += (double(a[1]) - b[1]) * (double(a[2]) + b[2]);
+            normal[1] += (double(a[2]) - b[2]) * (double(a[0]) + b[0]);
+            normal[2] += (double(a[0]) - b[0]) * (double(a[1]) + b[1]);
+        }
+
+        /// Drop the dominant axis. With the cyclic choice of the other two, the 2D area has the sign of that component
+        int axis = 0;
+        for(int k = 1; k < 3; ++k)
+            if(std::fabs(normal[k]) > std::fabs(normal[axis])) axis = k;
+        const int u_axis = (axis + 1) % 3, v_axis = (axis + 2) % 3;
+        const double orientation = normal[axis] < 0.0 ? -1.0 : 1.0;
+
+        std::vector<std::array<double, 2>> points(n);
+        for(size_t i = 0; i < n; ++i)
+        {
+            const float* p = source.position(source.vertex(i));
+            points[i] = { p[u_axis], p[v_axis] };
+        }
+
+        auto signed_area = [&](size_t a, size_t b, size_t c)
+        {
+            return orientation * ((points[b][0] - points[a][0]) * (points[c][1] - points[a][1]) -
+                                  (points[b][1] - points[a][1]) * (points[c][0] - points[a][0]));
+        };
+
+        std::vector<size_t> prev(n), next(n);
+        for(size_t i = 0; i < n; ++i)
+        {
+            prev[i] = (i + n - 1) % n;
+            next[i] = (i + 1) % n;
+        }
+
+        auto is_ear = [&](size_t i)
+        {
+            const size_t a = prev[i], c = next[i];
+            if(signed_area(a, i, c) <= 0.0) return false;
+
+            for(size_t j = next[c]; j != a; j = next[j])
+                if(signed_area(a, i, j) >= 0.0 && signed_area(i, c, j) >= 0.0 && signed_area(c, a, j) >= 0.0)
+                    return false;
+            return true;
+        };
+
+        auto emit = [&](size_t a, size_t b, size_t c)
+        {
+            triangulation.indices.push_back(source.vertex(a));
+            triangulation.indices.push_back(source.vertex(b));
+            triangulation.indices.push_back(source.vertex(c));
+            triangulation.primitive_ids.push_back(0);
+        };
+
+        triangulation.indices.reserve((n - 2) * 3);
+        triangulation.primitive_ids.reserve(n - 2);
+
+        size_t remaining = n;
+        size_t i = 0;
+        size_t misses = 0;
+        while(remaining > 3)
+        {
+            /// A full turn without an ear means the loop is degenerate or self intersecting : clip anyway to terminate
+            if(is_ear(i) || misses > remaining)
+            {
+                emit(prev[i], i, next[i]);
+                next[prev[i]] = next[i];
+                prev[next[i]] = prev[i];
+                i = next[i];
+                --remaining;
+                misses = 0;
+            }
+            else
+            {
+                i = next[i];
+                ++misses;
+            }
+        }
+        emit(prev[i], i, next[i]);
+
+        triangulation.edge_indices.reserve(n * 2);
+        for(size_t k = 0; k < n; ++k)
+        {
+            triangulation.edge_indices.push_back(source.vertex(k));
+            triangulation.edge_indices.push_back(source.vertex((k + 1) % n));
+        }
+        return triangulation;
+    }
+
+} // namespace Triangulator
+
+} // namespace GridPro_GFX
@@ -0,0 +1,149 @@
+#include "gp_gui_vertex_transform.h"
+#include "gp_gui_parallel.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define GP_VERTEX_TRANSFORM_USE_SSE
+#endif
+
+namespace GridPro_GFX {
+
+namespace VertexTransform {
+
+namespace {
+
+    float* vertex_at(float* positions, const size_t& stride_bytes, const uint32_t* vertex_indices, const size_t& i)
+    {
+        const size_t vertex = vertex_indices ? vertex_indices[i] : i;
+        return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(positions) + vertex * stride_bytes);
+    }
+
+#ifdef GP_VERTEX_TRANSFORM_USE_SSE
+    /// xyz into the low 3 lanes without touching the float after z (it may be the end of the array)
+    inline __m128 load_xyz(const float* p)
+    {
+        const __m128 xy = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(p));
+        return _mm_movelh_ps(xy, _mm_load_ss(p + 2));
+    }
+
+    inline void store_xyz(float* p, const __m128 v)
+    {
+        _mm_storel_pi(reinterpret_cast<__m64*>(p), v);
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+#endif
+
+    /// Packed xyz range : 4 vertices are 12 floats, the translation repeats every 3 registers
+    void translate_packed(float* positions, const size_t& num_vertices, const std::array<float, 3>& t)
+    {
+        size_t v = 0;
+#ifdef GP_VERTEX_TRANSFORM_USE_SSE
+        const __m128 t0 = _mm_setr_ps(t[0], t[1], t[2], t[0]);
+        const __m128 t1 = _mm_setr_ps(t[1], t[2], t[0], t[1]);
+        const __m128 t2 = _mm_setr_ps(t[2], t[0], t[1], t[2]);
+        for (; v + 4 <= num_vertices; v += 4)
+        {
+            float* p = positions + v * 3;
+            _mm_storeu_ps(p,     _mm_add_ps(_mm_loadu_ps(p),     t0));
+            _mm_storeu_ps(p + 4, _mm_add_ps(_mm_loadu_ps(p + 4), t1));
+            _mm_storeu_ps(p + 8, _mm_add_ps(_mm_loadu_ps(p + 8), t2));
+        }
+#endif
+        for (; v < num_vertices; ++v)
+        {
+            positions[v * 3 + 0] += t[0];
+            positions[v * 3 + 1] += t[1];
+            positions[v * 3 + 2] += t[2];
+        }
+    }
+
+} // namespace
+
+    void translate(float* positions, const size_t& stride_bytes, const uint32_t* vertex_indices, const size_t& num_vertices,
+                   const std::array<float, 3>& translation)
+    {
+        Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+        {
+            if (vertex_indices == nullptr && stride_bytes == 3 * sizeof(float))
+            {
+                translate_packed(positions + begin * 3, end - begin, translation);
+                return;
+            }
+
+#ifdef GP_VERTEX_TRANSFORM_USE_SSE
+            const __m128 t = _mm_setr_ps(translation[0], translation[1], translation[2], 0.0f);
+            for (size_t i = begin; i < end; ++i)
+            {
+                float* p = vertex_at(positions, stride_bytes, vertex_indices, i);
+                store_xyz(p, _mm_add_ps(load_xyz(p), t));
+            }
+#else
+            for (size_t i = begin; i < end; ++i)
+            {
+                float* p = vertex_at(positions, stride_bytes, vertex_indices, i);
+                p[0] += translation[0];
+                p[1] += translation[1];
+                p[2] += translation[2];
+            }
+#endif
+        }, DEFAULT_GRAIN_SIZE);
+    }
+
+    void transform_affine(float* positions, const size_t& stride_bytes, const uint32_t* vertex_indices, const size_t& num_vertices,
+                          const std::array<float, 16>& m)
+    {
+        Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+        {
+#ifdef GP_VERTEX_TRANSFORM_USE_SSE
+            const __m128 c0 = _mm_loadu_ps(&m[0]);
+            const __m128 c1 = _mm_loadu_ps(&m[4]);
+            const __m128 c2 = _mm_loadu_ps(&m[8]);
+            const __m128 c3 = _mm_loadu_ps(&m[12]);
+            for (size_t i = begin; i < end; ++i)
+            {
+                float* p = vertex_at(positions, stride_bytes, vertex_indices, i);
+                const __m128 v = load_xyz(p);
+                __m128 r = _mm_add_ps(c3, _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0))));
+                r = _mm_add_ps(r, _mm_mul_ps(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+                r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+                store_xyz(p, r);
+            }
+#else
+            for (size_t i = begin; i < end; ++i)
+            {
+                float* p = vertex_at(positions, stride_bytes, vertex_indices, i);
+                const float x = p[0], y = p[1], z = p[2];
+                p[0] = m[0] * x + m[4] * y + m[8]  * z + m[12];
+                p[1] = m[1] * x + m[5] * y + m[9]  * z + m[13];
+                p[2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+            }
+#endif
+        }, DEFAULT_GRAIN_SIZE);
+    }
+
+    void displace(float* positions, const size_t& stride_bytes, const uint32_t* vertex_indices, const size_t& num_vertices,
+                  const float* displacements)
+    {
+        Parallel::parallel_for(0, num_vertices, [&](size_t begin, size_t end, uint32_t)
+        {
+#ifdef GP_VERTEX_TRANSFORM_USE_SSE
+            for (size_t i = begin; i < end; ++i)
+            {
+                float* p = vertex_at(positions, stride_bytes, vertex_indices, i);
+                store_xyz(p, _mm_add_ps(load_xyz(p), load_xyz(displacements + i * 3)));
+            }
+#else
+            for (size_t i = begin; i < end; ++i)
+            {
+                float* p = vertex_at(positions, stride_bytes, vertex_indices, i);
+                p[0] += displacements[i * 3 + 0];
+                p[1] += displacements[i * 3 + 1];
+                p[2] += displacements[i * 3 + 2];
+            }
+#endif
+        }, DEFAULT_GRAIN_SIZE);
+    }
+
+} // namespace VertexTransform
+
+} // namespace GridPro_GFX
@@ -4,6 +4,7 @@
 #include "gp_gui_opengl_2_1_render_kernel.h"
 
 #include "gp_gui_communications.h"
+#include "gp_gui_scene.h"
 
 #include "gp_gui_opengl_2_1_framebuffer.h"
 
@@ -96,16 +97,14 @@ void OpenGL_2_1_RenderDevice::update(float layer)
     {
         RendererAPI<QGL_2_1>()->glClearColor(0.0f, 0.0f, 0.0f, 1.0f); 
         RendererAPI<QGL_2_1>()->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        for (auto Entity : entities().with<OpenGL_2_1_RenderKernel, commit_component>())
+        Event::Publisher::GetInstance()->get_scene_ptr()->for_each_committed_entity([&](ecs::Entity& Entity)
         {
-            if(Entity.get<commit_component>().is_committed())
-            {
+            if(!Entity.has<OpenGL_2_1_RenderKernel>()) return;
             auto& render_kernel = Entity.get<OpenGL_2_1_RenderKernel>();
             bool  render_sucess = render_kernel.render_selection_mode();
             if(render_sucess)
             GP_TRACE("Entity : ", Entity.get<tag_component>().tag_name(), " Rendered in Select Mode");
-            }
-        }
+        });
 
         Event::Publisher::GetInstance()->frame_buffer_ogl_2_1()->update_current_frame_buffer(); 
         
@@ -121,44 +120,47 @@ void OpenGL_2_1_RenderDevice::update(float layer)
 
     else if (layer == GL_LAYER_DISPLAY_ALL)
     {
-        for (auto Entity : entities().with<OpenGL_2_1_RenderKernel, commit_component>())
+        Event::Publisher::GetInstance()->get_scene_ptr()->for_each_committed_entity([&](ecs::Entity& Entity)
         {
-            if(Entity.get<commit_component>().is_committed())
-            {
+            if(!Entity.has<OpenGL_2_1_RenderKernel>()) return;
             auto& render_kernel = Entity.get<OpenGL_2_1_RenderKernel>();
             bool  render_sucess = render_kernel.render_display_mode();
             if(render_sucess)
-            GP_TRACE("Entity : ", Entity.get<tag_component>().tag_name(), " Rendered in Display Mode"); 
-            }  
-        }
+            GP_TRACE("Entity : ", Entity.get<tag_component>().tag_name(), " Rendered in Display Mode");
+        });
         return;
     }
 
     else
     {
-        for (auto Entity : entities().with<OpenGL_2_1_RenderKernel, commit_component>())
+        Scene_Manager* scene = Event::Publisher::GetInstance()->get_scene_ptr();
+        auto render_display_mode = [&](ecs::Entity& Entity)
+        {
+            if(!Entity.has<OpenGL_2_1_RenderKernel>()) return;
+            auto& render_kernel = Entity.get<OpenGL_2_1_RenderKernel>();
+            bool  render_sucess = render_kernel.render_display_mode();
+            if(render_sucess)
+            GP_TRACE("Entity : ", Entity.get<tag_component>().tag_name(), " Rendered in Display Mode");
+        };
+
+        // The background layer is drawn with every layer pass
+        scene->for_each_committed_entity(GL_LAYER_BACKGROUND, render_display_mode);
+
+        if(layer != GL_LAYER_BACKGROUND)
         {
-            auto& scene_state  = Event::Publisher::GetInstance()->get_scene_state();
-            const float entity_layer_id = Entity.get<commit_component>().layer_id();
-            if (entity_layer_id == layer || entity_layer_id == GL_LAYER_BACKGROUND)
+            const bool is_2d_layer = (layer == GL_LAYER_FOREGROUND_2D || layer == GL_LAYER_BACKGROUND_2D);
+            auto& scene_state = Event::Publisher::GetInstance()->get_scene_state();
+
+            if(is_2d_layer)
+            {
+                scene_state.set_to_2d_mode();
+            }
+
+            scene->for_each_committed_entity(layer, render_display_mode);
+
+            if(is_2d_layer)
             {
-               if(entity_layer_id == GL_LAYER_FOREGROUND_2D || entity_layer_id == GL_LAYER_BACKGROUND_2D)
-               {
-                   scene_state.set_to_2d_mode();
-               }
-
-               if(Entity.get<commit_component>().is_committed())
-               {
-               auto& render_kernel = Entity.get<OpenGL_2_1_RenderKernel>();
-               bool  render_sucess = render_kernel.render_display_mode();
-               if(render_sucess)
-               GP_TRACE("Entity : ", Entity.get<tag_component>().tag_name(), " Rendered in Display Mode");
-               }
-               
-               if(entity_layer_id == GL_LAYER_FOREGROUND_2D || entity_layer_id == GL_LAYER_BACKGROUND_2D)
-               {
-                   scene_state.set_to_3d_mode();
-               }
+                scene_state.set_to_3d_mode();
             }
         }
     }
@@ -79,7 +79,7 @@ using namespace OpenGL_2_1;
           is_in_selection_mode = false;
           try
           {
-            if((*m_geometry_descriptor)->positions_vector().size() == 0) return false;
+            if((*m_geometry_descriptor)->get_num_positions() == 0) return false;
             
             SceneState& scene_state = Event::Publisher::GetInstance()->get_scene_state();
             // std::array<int, 4> viewport;
@@ -102,7 +102,7 @@ using namespace OpenGL_2_1;
               (*m_geometry_descriptor)->color.swap((*m_geometry_descriptor)->custom_highlight_color);
             }
 
-            if((*m_geometry_descriptor)->colors_vector().size() == 0)
+            if(!(*m_geometry_descriptor)->has_color_attrib())
             {
               use_per_vertex_color = false;
             }
@@ -111,12 +111,16 @@ using namespace OpenGL_2_1;
               use_per_vertex_color = true;
             }
 
+            /// Per primitive colors replace the vertex colors of fill passes (instance colors win, as in 3.3)
+            std::shared_ptr<const InstanceArray> instances = (*m_geometry_descriptor)->get_instances();
+            is_using_primitive_colors = (*m_geometry_descriptor)->hasPrimitiveColors() && !(instances && instances->hasColors());
+
             set_blend_state();
             set_depth_test();
 
             RendererAPI<QGL_2_1>()->glEnable(GL_COLOR_MATERIAL);
 
-            if(scene_state.enable_lighting == true && (*m_geometry_descriptor)->normals_vector().size() != 0)
+            if(scene_state.enable_lighting == true && (*m_geometry_descriptor)->has_normal_attrib())
             {
               RendererAPI<QGL_2_1>()->glEnable(GL_LIGHT0);
               RendererAPI<QGL_2_1>()->glEnable(GL_LIGHTING);
@@ -163,13 +167,14 @@ using namespace OpenGL_2_1;
 
             // Enable if you want to use the texture
             // m_shader->Set1i("textureSampler", *m_texture);
+            m_vao->set_primitive_color_mode(is_using_primitive_colors);
             m_vao->bind();
 
             //// Draw the geometry in fill mode if wireframe mode is overlay
             if((*m_geometry_descriptor)->get_wireframe_mode_enum() == GL_WIREFRAME_OVERLAY)
             {
                 glm::vec4 object_color = glm::make_vec4((*m_geometry_descriptor)->color.get_color().data());
-                if(!use_per_vertex_color)
+                if(!use_per_vertex_color && !is_using_primitive_colors)
                 {
                   RendererAPI<QGL_2_1>()->glColor4f(object_color.r, object_color.g, object_color.b, object_color.a);
                 }
@@ -178,7 +183,12 @@ using namespace OpenGL_2_1;
                 
                 //// Draw the in wireframe only or fill mode only based on the rasteriser state
                 glm::vec4 wireframe_color = glm::make_vec4((*m_geometry_descriptor)->wireframecolor.get_color().data());
-                if(!use_per_vertex_color)
+                if(is_using_primitive_colors)
+                {
+                    RendererAPI<QGL_2_1>()->glDisableClientState(GL_COLOR_ARRAY);
+                    RendererAPI<QGL_2_1>()->glColor4f(wireframe_color.r, wireframe_color.g, wireframe_color.b, wireframe_color.a);
+                }
+                else if(!use_per_vertex_color)
                 {
                     RendererAPI<QGL_2_1>()->glColor4f(wireframe_color.r, wireframe_color.g, wireframe_color.b, wireframe_color.a);
                 }
@@ -191,7 +201,12 @@ using namespace OpenGL_2_1;
             else if((*m_geometry_descriptor)->get_wireframe_mode_enum() == GL_WIREFRAME_ONLY)
             {
                 glm::vec4 wireframe_color = glm::make_vec4((*m_geometry_descriptor)->wireframecolor.get_color().data());
-                if (!(use_per_vertex_color))
+                if(is_using_primitive_colors)
+                {
+                  RendererAPI<QGL_2_1>()->glDisableClientState(GL_COLOR_ARRAY);
+                  RendererAPI<QGL_2_1>()->glColor4f(wireframe_color.r, wireframe_color.g, wireframe_color.b, wireframe_color.a);
+                }
+                else if (!(use_per_vertex_color))
                 {
                   RendererAPI<QGL_2_1>()->glColor4f(wireframe_color.r, wireframe_color.g, wireframe_color.b, wireframe_color.a);
                 }
@@ -204,7 +219,7 @@ using namespace OpenGL_2_1;
             else
             {
                 glm::vec4 object_color = glm::make_vec4((*m_geometry_descriptor)->color.get_color().data());
-                if(!(use_per_vertex_color))
+                if(!(use_per_vertex_color) && !is_using_primitive_colors)
                 {
                   RendererAPI<QGL_2_1>()->glDisableClientState(GL_COLOR_ARRAY);
                   RendererAPI<QGL_2_1>()->glColor4f(object_color.r, object_color.g, object_color.b, object_color.a);
@@ -226,6 +241,7 @@ using namespace OpenGL_2_1;
             // Unbind the all the objects
             // m_texture->unbind();
             m_vao->unbind();
+            is_using_primitive_colors = false;
 
             if(use_custom_highlight_color)
             {
@@ -255,7 +271,7 @@ using namespace OpenGL_2_1;
 
           try
           {
-            if((*m_geometry_descriptor)->positions_vector().size() == 0)
+            if((*m_geometry_descriptor)->get_num_positions() == 0)
                return false;
 
             SceneState &scene_state = Event::Publisher::GetInstance()->get_scene_state();
@@ -299,6 +315,11 @@ using namespace OpenGL_2_1;
                 PixelData color = PixelData(unique_color);
                 RendererAPI<QGL_2_1>()->glColor4f(color.r_float(), color.g_float(), color.b_float(), 1.0f);
             }
+            else if((*m_geometry_descriptor)->isInstanced())
+            {
+                /// Every instance is one pick entity : draw_instances sets the color of each, no per primitive colors
+                m_vao->set_selection_array_mode(false);
+            }
             else if(pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX)
             {
                 m_vao->set_selection_array_mode(true);   
@@ -353,13 +374,94 @@ using namespace OpenGL_2_1;
 
       if(curr_primitive_type == GL_NONE_NULL)
         throw std::runtime_error("Primitive type is not set");
-       
+
+      if((*m_geometry_descriptor)->isInstanced())
+        draw_instances(curr_primitive_type);
+      else
+        draw_prototype(curr_primitive_type);
+    }
+
+    /// @brief No instanced draws in 2.1 : the prototype is drawn once per instance under its transform
+    void OpenGL_2_1_RenderKernel::draw_instances(const GLenum& primitive_type)
+    {
+      std::shared_ptr<const InstanceArray> instances = (*m_geometry_descriptor)->get_instances();
+      const GLenum pick_scheme = (*m_geometry_descriptor)->get_pick_scheme_enum();
+
+      const bool use_pick_colors = is_in_selection_mode && (pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX);
+      const bool use_instance_colors = !is_in_selection_mode && !is_drawing_wireframe && instances->hasColors() && !(*m_geometry_descriptor)->has_color_attrib();
+      const uint32_t pick_id_start = m_geometry_descriptor->get_color_id_reserve_start();
+
+      RendererAPI<QGL_2_1>()->glMatrixMode(GL_MODELVIEW);
+      for(size_t i = 0; i < instances->size(); ++i)
+      {
+        if(use_pick_colors)
+        {
+          PixelData color = PixelData(pick_id_start + static_cast<uint32_t>(i));
+          RendererAPI<QGL_2_1>()->glColor4f(color.r_float(), color.g_float(), color.b_float(), 1.0f);
+        }
+        else if(use_instance_colors)
+        {
+          const uint8_t* color = instances->get_color(i);
+          RendererAPI<QGL_2_1>()->glColor4ub(color[0], color[1], color[2], color[3]);
+        }
+
+        const std::array<float, 16> matrix = instances->get_matrix(i);
+        RendererAPI<QGL_2_1>()->glPushMatrix();
+        RendererAPI<QGL_2_1>()->glMultMatrixf(matrix.data());
+        draw_prototype(primitive_type);
+        RendererAPI<QGL_2_1>()->glPopMatrix();
+      }
+    }
+
+    /// @brief Draw the vertex arrays of the primitive set once
+    void OpenGL_2_1_RenderKernel::draw_prototype(const GLenum& curr_primitive_type)
+    {
+      /// Simplified levels index the client vertex arrays of level 0. Selection always draws level 0
+      const size_t lod_level = select_lod_level();
+      if(lod_level != 0)
+      {
+        const CompactIndexArray& lod_indices = m_vao->get_lod_indices(lod_level);
+        RendererAPI<QGL_2_1>()->glDrawElements(curr_primitive_type, static_cast<GLsizei>(lod_indices.size()), lod_indices.type(), lod_indices.data());
+        return;
+      }
+
       GLenum PickScheme = (*m_geometry_descriptor)->get_pick_scheme_enum();
       
-      if((*m_geometry_descriptor)->indices_vector().size() == 0 || (is_in_selection_mode && (PickScheme == GL_PICK_BY_PRIMITIVE || PickScheme == GL_PICK_BY_VERTEX)))
+      /// Per primitive pick colors need unshared vertices, instanced sets pick by instance and keep their indices
+      const bool use_unique_colors = is_in_selection_mode && !(*m_geometry_descriptor)->isInstanced() && (PickScheme == GL_PICK_BY_PRIMITIVE || PickScheme == GL_PICK_BY_VERTEX);
+
+      /// Per primitive display colors are expanded onto unshared vertices the same way
+      const bool use_expanded_colors = is_using_primitive_colors && !is_in_selection_mode;
+
+      const bool use_draw_arrays = (*m_geometry_descriptor)->indices_vector().size() == 0 || use_unique_colors || use_expanded_colors;
+
+      /// Multi strip sets draw every strip in one call, the unshared vertices keep the strips at the same offsets
+      if(curr_primitive_type != GL_POINTS && m_vao->get_num_strips() != 0)
+      {
+        if(use_draw_arrays)
+          RendererAPI<QGL_2_1>()->glMultiDrawArrays(curr_primitive_type, m_vao->get_strip_firsts(), m_vao->get_strip_counts(), m_vao->get_num_strips());
+        else
+          RendererAPI<QGL_2_1>()->glMultiDrawElements(curr_primitive_type, m_vao->get_strip_counts(), m_vao->get_indices().type(), m_vao->get_strip_index_pointers(), m_vao->get_num_strips());
+      }
+      else if(use_draw_arrays)
       RendererAPI<QGL_2_1>()->glDrawArrays(curr_primitive_type, 0, (*m_geometry_descriptor)->get_num_vertices());        
       else
-      RendererAPI<QGL_2_1>()->glDrawElements(curr_primitive_type,  (*m_geometry_descriptor)->get_num_vertices(), GL_UNSIGNED_INT, (*m_geometry_descriptor)->get_indices_weak_ptr().lock().get()->data());
+      RendererAPI<QGL_2_1>()->glDrawElements(curr_primitive_type,  (*m_geometry_descriptor)->get_num_vertices(), m_vao->get_indices().type(), m_vao->get_indices().data());
+    }
+
+    /// @brief Pick the level of detail from the projected screen size of the primitive set (0 = full resolution)
+    size_t OpenGL_2_1_RenderKernel::select_lod_level()
+    {
+      /// Simplified levels renumber the primitives, per primitive colors follow level 0
+      if(is_in_selection_mode || !(*m_geometry_descriptor)->hasLodChain() || (*m_geometry_descriptor)->hasPrimitiveColors())
+        return 0;
+
+      SceneState& scene_state = Event::Publisher::GetInstance()->get_scene_state();
+      if(!scene_state.enable_lod || scene_state.is_2d)
+        return 0;
+
+      const float screen_size = scene_state.get_projected_screen_size((*m_geometry_descriptor)->get_bounding_box());
+      return (*m_geometry_descriptor)->select_lod_level(screen_size, scene_state.lod_pixel_error);
     }
 
     void OpenGL_2_1_RenderKernel::point_mode_draw()
@@ -367,7 +469,7 @@ using namespace OpenGL_2_1;
       // Round the points to circle
       RendererAPI<QGL_2_1>()->glEnable(GL_POINT_SMOOTH);
       RendererAPI<QGL_2_1>()->glHint(GL_POINT_SMOOTH_HINT, GL_NICEST);
-      RendererAPI<QGL_2_1>()->glDrawArrays(GL_POINTS, 0, (*m_geometry_descriptor)->positions_vector().size()/3);
+      RendererAPI<QGL_2_1>()->glDrawArrays(GL_POINTS, 0, (*m_geometry_descriptor)->get_num_positions());
       RendererAPI<QGL_2_1>()->glDisable(GL_POINT_SMOOTH);
     }
 
@@ -417,6 +519,7 @@ using namespace OpenGL_2_1;
     {
       if ((*m_geometry_descriptor)->get_wireframe_mode_enum() != GL_WIREFRAME_NONE)
       {
+          is_drawing_wireframe = true;
           RendererAPI<QGL_2_1>()->glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
           // RendererAPI<QGL_2_1>()->glEnable(GL_POLYGON_OFFSET_FILL);
           // RendererAPI<QGL_2_1>()->glPolygonOffset(1.0f, 1.0f);
@@ -457,6 +560,8 @@ using namespace OpenGL_2_1;
 
     void OpenGL_2_1_RenderKernel::reset_rasteriser_state()
     {
+      is_drawing_wireframe = false;
+
       if((*m_geometry_descriptor)->get_wireframe_mode_enum() != GL_WIREFRAME_NONE)
       {
         RendererAPI<QGL_2_1>()->glDisable(GL_POLYGON_OFFSET_FILL);
@@ -1,9 +1,12 @@
 
 
+#include <cstring>
+#include <algorithm>
 #include <glm/glm.hpp>
 
 #include "gp_gui_opengl_2_1_vertex_array_object.h"
 #include "gp_gui_geometry_descriptor.h"
+#include "gp_gui_geometry_kernels.h"
 
 #include "gp_gui_pixel_utils.h"
 
@@ -21,8 +24,9 @@ namespace OpenGL_2_1
         NormalData   = (*m_geometry_descriptor)->get_normals_weak_ptr().lock().get();
         ColorData    = (*m_geometry_descriptor)->get_colors_weak_ptr().lock().get();
         IndexData    = (*m_geometry_descriptor)->get_indices_weak_ptr().lock().get();
+        InterleavedData = (*m_geometry_descriptor)->get_interleaved_weak_ptr().lock().get();
         
-        if(PositionData->size() == 0) 
+        if((*m_geometry_descriptor)->get_num_positions() == 0) 
         {
             std::string err = m_geometry_descriptor->get_current_primitive_set_name() + " Position Data is empty\n";
             throw std::runtime_error(err);
@@ -51,13 +55,24 @@ namespace OpenGL_2_1
         uint32_t curr_last_init_id = m_geometry_descriptor->get_color_id_reserve_start();
         GLenum pick_scheme = (*m_geometry_descriptor)->get_pick_scheme_enum();
         
+        /// The strips of a multi strip set are its primitives, every vertex of strip i gets pick color i
+        std::shared_ptr<const StripArray> strips = (*m_geometry_descriptor)->get_strips();
+        const uint32_t strip_version = strips ? strips->version() : 0;
+
         uint32_t curr_entity_count = 0;
         uint32_t vertices_per_primitive = 1; 
+        GLenum pick_primitive_type = GL_POINTS;
 
-        if(pick_scheme == GL_PICK_BY_PRIMITIVE)
+        if(pick_scheme == GL_PICK_BY_PRIMITIVE && strips)
+        {
+          curr_entity_count = static_cast<uint32_t>(strips->size());
+          vertices_per_primitive = 0;
+        }
+        else if(pick_scheme == GL_PICK_BY_PRIMITIVE)
         { 
           curr_entity_count = (*m_geometry_descriptor)->get_num_primitives();
           vertices_per_primitive = (*m_geometry_descriptor)->get_num_vertices_per_primitive();
+          pick_primitive_type = (*m_geometry_descriptor)->get_primitive_type_enum();
         } 
         else if(pick_scheme == GL_PICK_BY_VERTEX)
         {
@@ -70,7 +85,8 @@ namespace OpenGL_2_1
           return;
         }
         
-        if(curr_last_init_id == last_init_id && curr_entity_count == last_pick_entity_count && vertices_per_primitive == last_pick_vertices_per_primitve_count)
+        if(curr_last_init_id == last_init_id && curr_entity_count == last_pick_entity_count && vertices_per_primitive == last_pick_vertices_per_primitve_count &&
+           pick_primitive_type == last_pick_primitive_type && strip_version == last_pick_strip_version)
         {
             return;
         }
@@ -78,79 +94,138 @@ namespace OpenGL_2_1
         last_init_id = curr_last_init_id;
         last_pick_entity_count = curr_entity_count;
         last_pick_vertices_per_primitve_count = vertices_per_primitive;
+        last_pick_primitive_type = pick_primitive_type;
+        last_pick_strip_version = strip_version;
         
         GP_TRACE("Init ID : ", last_init_id);
         GP_TRACE("Entity Count : ", last_pick_entity_count);
-    
-        uint32_t size = curr_entity_count * vertices_per_primitive * 3;
-        
+
+        /// Pick colors go on unshared vertices, indexed sets are drawn from a de-indexed copy
+        const size_t num_vertices = (*m_geometry_descriptor)->get_num_vertices();
         if(has_index_data())
-        {
-        flattened_vertex_array = (*m_geometry_descriptor)->get_flattened_position_array();
-        size = flattened_vertex_array.size();
-        }
+            gather_indexed_positions(flattened_vertex_array);
+        else
+            flattened_vertex_array.clear();
 
-        m_unique_color_array.resize(size);
+        m_unique_color_array.resize(num_vertices * 3);
 
         GP_TRACE("Color Array Size = ", m_unique_color_array.size());
 
         GP_TRACE("Vertices per primitive = ", last_pick_vertices_per_primitve_count);
 
-        for(uint32_t i = 0; i < curr_entity_count ; i++)
+        if(vertices_per_primitive == 0)
+        {
+            for(uint32_t i = 0; i < curr_entity_count; i++)
+                for(uint32_t v = strips->get_first(i); v < strips->get_first(i + 1); v++)
+                    GeometryKernels::write_pick_color(i + last_init_id, &m_unique_color_array[v * 3]);
+        }
+        else
         {
-            uint32_t unique_color_id = i + last_init_id;
-            PixelData color = PixelData(unique_color_id);
-            for(uint32_t j = 0; j < vertices_per_primitive; j++)
+            /// One dispatch on the primitive type, the kernel loop gives each vertex the color of the primitive it provokes
+            dispatch_primitive_type(pick_primitive_type, [&](auto traits)
             {
-                m_unique_color_array[(i * vertices_per_primitive + j) * 3 + 0] = color.r ;
-                m_unique_color_array[(i * vertices_per_primitive + j) * 3 + 1] = color.g ;
-                m_unique_color_array[(i * vertices_per_primitive + j) * 3 + 2] = color.b ;
-            }
+                GeometryKernels::fill_pick_colors<decltype(traits)>(last_init_id, num_vertices, m_unique_color_array.data());
+            });
         }
 
         GP_TRACE("Genrated Color Array\n");
 
     }
 
+    void VertexArrayObject::gather_indexed_positions(std::vector<float>& positions)
+    {
+        calculate_offsets();
+        update_compact_indices();
+
+        const uint8_t* base = InterleavedData ? InterleavedData->data() : reinterpret_cast<const uint8_t*>(PositionData->data());
+        const size_t stride_bytes = InterleavedData ? InterleavedData->stride() : 3 * sizeof(float);
+        gather_indexed_vec3(base, stride_bytes, positions);
+    }
+
+    void VertexArrayObject::gather_indexed_vec3(const uint8_t* base, const size_t& stride_bytes, std::vector<float>& out)
+    {
+        out.resize(m_compact_indices.size() * 3);
+        dispatch_index_type(m_compact_indices.type(), [&](auto index)
+        {
+            using IndexT = decltype(index);
+            GeometryKernels::gather_vec3(base, stride_bytes, static_cast<const IndexT*>(m_compact_indices.data()), m_compact_indices.size(), out.data());
+        });
+    }
+
     void VertexArrayObject::bind()
     {
         calculate_offsets();
-        if(PositionData->size() == 0) 
+        if((*m_geometry_descriptor)->get_num_positions() == 0) 
         {
             std::string err = m_geometry_descriptor->get_current_primitive_set_name() + " Position Data is empty\n";
             throw std::runtime_error(err);
         }
         
+        /// Vertices moved since the last frame become merged dirty ranges, uploaded below with the other edits
         if((*m_geometry_descriptor)->isHavingPositonUpdates())
-        {
-              for(auto& vertex : (*m_geometry_descriptor)->batch_vertex_updates)
-                 perform_micro_vertex_update(vertex.index, vertex.m_position[0], vertex.m_position[1], vertex.m_position[2]);
-                
-              (*m_geometry_descriptor)->batch_vertex_updates.clear();
-        }
+            (*m_geometry_descriptor)->flush_vertex_updates();
+
+        if((*m_geometry_descriptor)->hasDirtyRanges())
+            upload_dirty_ranges();
+
+        update_compact_indices();
+        update_strip_draw_lists();
+
+        const bool use_primitive_colors = is_in_primitive_color_mode && !is_in_selection_mode;
+        if(use_primitive_colors)
+            update_primitive_color_arrays();
 
         RendererAPI<QGL_2_1>()->glEnableClientState(GL_VERTEX_ARRAY);
         
-        if(NormalData->size() > 0)
+        if(has_normal_attrib())
         RendererAPI<QGL_2_1>()->glEnableClientState(GL_NORMAL_ARRAY);
 
-        if(ColorData->size() > 0 || (m_unique_color_array.size() > 0 && is_in_selection_mode))
+        if(use_primitive_colors)
+        {
+         RendererAPI<QGL_2_1>()->glEnableClientState(GL_COLOR_ARRAY);
+         if(!(*m_geometry_descriptor)->get_primitive_traits().is_list)
+           RendererAPI<QGL_2_1>()->glShadeModel(GL_FLAT);
+        }
+        else if(has_color_attrib() || (m_unique_color_array.size() > 0 && is_in_selection_mode))
         {
          RendererAPI<QGL_2_1>()->glEnableClientState(GL_COLOR_ARRAY);
-         RendererAPI<QGL_2_1>()->glShadeModel(GL_SMOOTH);
+         /// Pick colors sit on the provoking vertices, the flat shading of the selection pass stays
+         if(!is_in_selection_mode)
+           RendererAPI<QGL_2_1>()->glShadeModel(GL_SMOOTH);
         } 
+
+        /// Interleaved vertices are handed to the client arrays directly with the layout stride
+        const uint8_t* interleaved_base = InterleavedData ? InterleavedData->data() : nullptr;
+        const GLsizei  interleaved_stride = InterleavedData ? InterleavedData->stride() : 0;
+        const VertexAttribInfo* normal_attrib = InterleavedData ? InterleavedData->layout().find(ATTRIB_NORMAL) : nullptr;
+        const VertexAttribInfo* color_attrib  = InterleavedData ? InterleavedData->layout().find(ATTRIB_COLOR)  : nullptr;
         
         if(flattened_vertex_array.size() && is_in_selection_mode)
         RendererAPI<QGL_2_1>()->glVertexPointer(3, GL_FLOAT, 0, flattened_vertex_array.data());
+        else if(use_primitive_colors && m_expanded_positions.size())
+        RendererAPI<QGL_2_1>()->glVertexPointer(3, GL_FLOAT, 0, m_expanded_positions.data());
+        else if(InterleavedData)
+        RendererAPI<QGL_2_1>()->glVertexPointer(3, GL_FLOAT, interleaved_stride, interleaved_base);
         else
         RendererAPI<QGL_2_1>()->glVertexPointer(3, GL_FLOAT, 0, PositionData->data());
         
-        if(NormalData->size() > 0)
+        if(use_primitive_colors && m_expanded_normals.size())
+           RendererAPI<QGL_2_1>()->glNormalPointer(GL_FLOAT, 0, m_expanded_normals.data());
+        else if(normal_attrib)
+           RendererAPI<QGL_2_1>()->glNormalPointer(GL_FLOAT, interleaved_stride, interleaved_base + normal_attrib->offset);
+        else if(NormalData->size() > 0)
            RendererAPI<QGL_2_1>()->glNormalPointer(GL_FLOAT, 0, NormalData->data());
         
         if(m_unique_color_array.size() > 0 && is_in_selection_mode)
           RendererAPI<QGL_2_1>()->glColorPointer(3, GL_UNSIGNED_BYTE, 0, m_unique_color_array.data());
 
+        else if(use_primitive_colors)
+          RendererAPI<QGL_2_1>()->glColorPointer(PrimitiveColorArray::COLOR_COMPONENTS, GL_UNSIGNED_BYTE, 0, m_expanded_colors.data());
+
+        else if(color_attrib && !is_in_selection_mode)
+        {
+          RendererAPI<QGL_2_1>()->glColorPointer(color_attrib->components, GL_UNSIGNED_BYTE, interleaved_stride, interleaved_base + color_attrib->offset);
+        }
         else if(ColorData->size() > 0 && !is_in_selection_mode)
         {
           RendererAPI<QGL_2_1>()->glColorPointer(3, GL_UNSIGNED_BYTE, 0, ColorData->data()); 
@@ -160,6 +235,7 @@ namespace OpenGL_2_1
     void VertexArrayObject::unbind()
     {
         is_in_selection_mode = false;
+        is_in_primitive_color_mode = false;
         RendererAPI<QGL_2_1>()->glDisableClientState(GL_VERTEX_ARRAY);
         RendererAPI<QGL_2_1>()->glDisableClientState(GL_NORMAL_ARRAY);
         RendererAPI<QGL_2_1>()->glDisableClientState(GL_COLOR_ARRAY);
@@ -171,6 +247,7 @@ namespace OpenGL_2_1
         NormalData   = (*m_geometry_descriptor)->get_normals_weak_ptr().lock().get();
         ColorData    = (*m_geometry_descriptor)->get_colors_weak_ptr().lock().get();
         IndexData    = (*m_geometry_descriptor)->get_indices_weak_ptr().lock().get();  
+        InterleavedData = (*m_geometry_descriptor)->get_interleaved_weak_ptr().lock().get();
     }
 
     void VertexArrayObject::create_vbo()
@@ -188,6 +265,171 @@ namespace OpenGL_2_1
     void VertexArrayObject::perform_micro_vertex_update(const uint32_t& vertex_id, const float& pos_x, const float& pos_y, const float& pos_z)
     {}
 
+    void VertexArrayObject::upload_dirty_ranges()
+    {
+        /// Client arrays are read from the primitive set at draw time, only the flattened
+        /// copy used in selection mode has to follow position and index edits
+        typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+        const bool is_flattened_copy_stale = !(*m_geometry_descriptor)->get_dirty_ranges(PrimitiveSet::POSITION_ARRAY).empty() ||
+                                             !(*m_geometry_descriptor)->get_dirty_ranges(PrimitiveSet::INDEX_ARRAY).empty();
+
+        if(is_flattened_copy_stale || !(*m_geometry_descriptor)->get_dirty_ranges(PrimitiveSet::NORMAL_ARRAY).empty())
+            is_primitive_color_expansion_stale = true;
+
+        /// Edited indices are narrowed again in place, a replaced or resized array is caught by update_compact_indices
+        IndexData = (*m_geometry_descriptor)->get_indices_weak_ptr().lock().get();
+        if(IndexData == m_compact_indices_source && IndexData != nullptr && IndexData->size() == m_compact_indices.size())
+        {
+            for(const DirtyRangeSet::Range& range : (*m_geometry_descriptor)->get_dirty_ranges(PrimitiveSet::INDEX_ARRAY).ranges())
+                m_compact_indices.update(IndexData->data(), range.begin / sizeof(uint32_t), (range.end + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+        }
+
+        if(flattened_vertex_array.size() && is_flattened_copy_stale && has_index_data())
+            gather_indexed_positions(flattened_vertex_array);
+
+        (*m_geometry_descriptor)->clear_dirty_ranges();
+    }
+
+    void VertexArrayObject::update_compact_indices()
+    {
+        if(IndexData == nullptr || IndexData->empty())
+        {
+            m_compact_indices.clear();
+            m_compact_indices_source = nullptr;
+            return;
+        }
+
+        const size_t num_vertices = (*m_geometry_descriptor)->get_num_positions();
+        if(IndexData == m_compact_indices_source && IndexData->size() == m_compact_indices.size() &&
+           select_index_type(num_vertices) == m_compact_indices.type())
+        {
+            /// 32 bit indices are read from the source directly, its storage may have moved
+            if(!m_compact_indices.isCompact())
+                m_compact_indices.update(IndexData->data(), 0, 0);
+            return;
+        }
+
+        m_compact_indices.assign(*IndexData, num_vertices);
+        m_compact_indices_source = IndexData;
+    }
+
+    void VertexArrayObject::update_primitive_color_arrays()
+    {
+        std::shared_ptr<const PrimitiveColorArray> primitive_colors = (*m_geometry_descriptor)->get_primitive_colors();
+        std::shared_ptr<const StripArray> strips = (*m_geometry_descriptor)->get_strips();
+        const size_t num_vertices = (*m_geometry_descriptor)->get_num_vertices();
+        const void* vertex_source = InterleavedData ? static_cast<const void*>(InterleavedData) : static_cast<const void*>(PositionData);
+        const uint32_t strip_version = strips ? strips->version() : 0;
+
+        if(!is_primitive_color_expansion_stale && primitive_colors == m_primitive_colors && primitive_colors->version() == m_primitive_color_version &&
+           vertex_source == m_expanded_vertex_source && IndexData == m_expanded_index_source && strip_version == m_expanded_strip_version &&
+           m_expanded_colors.size() == num_vertices * PrimitiveColorArray::COLOR_COMPONENTS)
+            return;
+
+        /// Indexed vertices are shared between primitives of different colors, they are drawn from unshared copies
+        m_expanded_positions.clear();
+        m_expanded_normals.clear();
+        if(has_index_data())
+        {
+            gather_indexed_positions(m_expanded_positions);
+
+            const VertexAttribInfo* normal_attrib = InterleavedData ? InterleavedData->layout().find(ATTRIB_NORMAL) : nullptr;
+            const uint8_t* normal_base = normal_attrib ? InterleavedData->data() + normal_attrib->offset : reinterpret_cast<const uint8_t*>(NormalData->data());
+            const size_t   normal_stride = normal_attrib ? InterleavedData->stride() : 3 * sizeof(float);
+            if(normal_attrib || NormalData->size() == (*m_geometry_descriptor)->get_num_positions() * 3)
+                gather_indexed_vec3(normal_base, normal_stride, m_expanded_normals);
+        }
+
+        const size_t last_primitive = primitive_colors->size() - 1;
+        m_expanded_colors.resize(num_vertices * PrimitiveColorArray::COLOR_COMPONENTS);
+        if(strips)
+        {
+            /// Every vertex of a strip carries the strip color, the provoking vertex of each segment or triangle included
+            for(size_t strip = 0; strip < strips->size(); ++strip)
+            {
+                const uint8_t* color = primitive_colors->get_color(std::min(strip, last_primitive));
+                for(uint32_t v = strips->get_first(strip); v < strips->get_first(strip + 1); ++v)
+                    std::copy_n(color, PrimitiveColorArray::COLOR_COMPONENTS, &m_expanded_colors[v * PrimitiveColorArray::COLOR_COMPONENTS]);
+            }
+        }
+        else
+        {
+            dispatch_primitive_type((*m_geometry_descriptor)->get_primitive_type_enum(), [&](auto traits)
+            {
+                GeometryKernels::expand_primitive_colors<decltype(traits)>(primitive_colors->colors().data(), primitive_colors->size(), num_vertices, m_expanded_colors.data());
+            });
+        }
+
+        m_primitive_colors = primitive_colors;
+        m_primitive_color_version = primitive_colors->version();
+        m_expanded_vertex_source = vertex_source;
+        m_expanded_index_source = IndexData;
+        m_expanded_strip_version = strip_version;
+        is_primitive_color_expansion_stale = false;
+        GP_TRACE("Expanded ", primitive_colors->size(), " primitive colors onto ", num_vertices, " vertices : ", (*m_geometry_descriptor)->get_instance_name());
+    }
+
+    void VertexArrayObject::update_strip_draw_lists()
+    {
+        std::shared_ptr<const StripArray> strips = (*m_geometry_descriptor)->get_strips();
+        if(strips == nullptr)
+        {
+            m_strips.reset();
+            m_strip_firsts.clear();
+            m_strip_counts.clear();
+            m_strip_index_pointers.clear();
+            return;
+        }
+
+        const bool is_stale = strips != m_strips || strips->version() != m_strip_version;
+        if(is_stale)
+        {
+            m_strips = strips;
+            m_strip_version = strips->version();
+            m_strip_firsts.resize(strips->size());
+            m_strip_counts.resize(strips->size());
+            for(size_t strip = 0; strip < strips->size(); ++strip)
+            {
+                m_strip_firsts[strip] = static_cast<GLint>(strips->get_first(strip));
+                m_strip_counts[strip] = static_cast<GLsizei>(strips->get_count(strip));
+            }
+        }
+
+        /// The index pointers follow the client index array, which moves when it is narrowed again
+        const void* index_base = m_compact_indices.empty() ? nullptr : m_compact_indices.data();
+        if(!is_stale && index_base == m_strip_index_base)
+            return;
+
+        m_strip_index_base = index_base;
+        m_strip_index_pointers.assign(strips->size(), nullptr);
+        if(index_base == nullptr)
+            return;
+
+        for(size_t strip = 0; strip < strips->size(); ++strip)
+            m_strip_index_pointers[strip] = static_cast<const uint8_t*>(index_base) + size_t(m_strip_firsts[strip]) * m_compact_indices.index_size();
+    }
+
+    const CompactIndexArray& VertexArrayObject::get_lod_indices(const size_t& level)
+    {
+        std::shared_ptr<const std::vector<LodLevel>> lod_chain = (*m_geometry_descriptor)->get_lod_chain();
+        if(level == 0 || lod_chain == nullptr || level > lod_chain->size())
+        {
+            m_compact_lod_indices.clear();
+            m_compact_lod_chain.reset();
+            return m_compact_lod_indices;
+        }
+
+        /// A chain is never edited, only replaced, and holding it keeps its address from being reused : the chain and
+        /// level identify the indices, as in the 3.3 VAO
+        if(lod_chain != m_compact_lod_chain || level != m_compact_lod_level)
+        {
+            m_compact_lod_indices.assign((*lod_chain)[level - 1].indices, (*m_geometry_descriptor)->get_num_positions());
+            m_compact_lod_chain = lod_chain;
+            m_compact_lod_level = level;
+        }
+        return m_compact_lod_indices;
+    }
+
     void VertexArrayObject::delete_vbo()
     {}
 
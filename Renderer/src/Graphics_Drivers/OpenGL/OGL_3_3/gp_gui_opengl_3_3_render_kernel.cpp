@@ -24,6 +24,12 @@ namespace GridPro_GFX
 
 using namespace OpenGL_3_3;
 
+    /// @brief Texture unit of the triangle -> primitive ID table in the selection shader
+    static constexpr uint32_t PRIMITIVE_REMAP_TEXTURE_UNIT = 0;
+
+    /// @brief Texture unit of the per primitive colors in the display shaders
+    static constexpr uint32_t PRIMITIVE_COLOR_TEXTURE_UNIT = 1;
+
     OpenGL_3_3_RenderKernel::OpenGL_3_3_RenderKernel() : Abstract_RenderKernel()
     {
       
@@ -76,7 +82,7 @@ using namespace OpenGL_3_3;
           is_in_selection_mode = false;
           try
           {
-            if((*m_geometry_descriptor)->positions_vector().size() == 0) return false;
+            if((*m_geometry_descriptor)->get_num_positions() == 0) return false;
          
             // Bind the texture
             // m_texture->bind(0);
@@ -87,7 +93,8 @@ using namespace OpenGL_3_3;
             if(use_custom_highlight_color)
               (*m_geometry_descriptor)->color.swap((*m_geometry_descriptor)->custom_highlight_color);
 
-            if((*m_geometry_descriptor)->colors_vector().size() == 0)
+            /// Per primitive colors replace the vertex colors, they are drawn by the basic and lighting shaders
+            if(!(*m_geometry_descriptor)->has_color_attrib() || (*m_geometry_descriptor)->hasPrimitiveColors())
               m_shader = get_shader("BasicShader");
             else
             {
@@ -99,7 +106,7 @@ using namespace OpenGL_3_3;
 
             SceneState &scene_state = Event::Publisher::GetInstance()->get_scene_state();
 
-            if (scene_state.enable_lighting == true && (*m_geometry_descriptor)->normals_vector().size() != 0)
+            if (scene_state.enable_lighting == true && (*m_geometry_descriptor)->has_normal_attrib())
             {
               m_shader = get_shader("PhongsLightingShader");
               use_per_vertex_color = false;
@@ -113,6 +120,21 @@ using namespace OpenGL_3_3;
             m_shader->SetMat4fv("projection", scene_state.m_projection);
             m_shader->SetMat4fv("model", scene_state.m_model);
             m_shader->SetMat4fv("view", scene_state.m_view);
+            set_dequantization_uniforms();
+            m_shader->Set1i("use_instancing", (*m_geometry_descriptor)->isInstanced() ? 1 : 0);
+
+            /// Colors are fetched at gl_PrimitiveID, triangulated quads and polygons and multi strip sets map it back
+            /// through the remap table
+            is_using_primitive_colors = false;
+            bool use_primitive_remap = false;
+            if(!use_per_vertex_color)
+            {
+              is_using_primitive_colors = m_vao->bind_primitive_colors(PRIMITIVE_COLOR_TEXTURE_UNIT);
+              use_primitive_remap = is_using_primitive_colors && m_vao->bind_primitive_remap(PRIMITIVE_REMAP_TEXTURE_UNIT);
+              m_shader->Set1i("primitive_colors", PRIMITIVE_COLOR_TEXTURE_UNIT);
+              m_shader->Set1i("primitive_remap", PRIMITIVE_REMAP_TEXTURE_UNIT);
+              m_shader->Set1i("use_primitive_remap", use_primitive_remap ? 1 : 0);
+            }
 
             if (enable_lighting)
             {
@@ -143,7 +165,10 @@ using namespace OpenGL_3_3;
             {
                 glm::vec4 object_color = glm::make_vec4((*m_geometry_descriptor)->color.get_color().data());
                 if(!(use_per_vertex_color))
+                {
                   m_shader->SetVec4fv("object_color", object_color);
+                  set_fill_color_uniforms(true);
+                }
 
                 // Draw Call
                 execute_draw_command();
@@ -151,7 +176,10 @@ using namespace OpenGL_3_3;
                 //// Draw the in wireframe only or fill mode only based on the rasteriser state
                 glm::vec4 wireframe_color = glm::make_vec4((*m_geometry_descriptor)->wireframecolor.get_color().data());
                 if(!(use_per_vertex_color))
+                {
                   m_shader->SetVec4fv("object_color", wireframe_color);
+                  set_fill_color_uniforms(false);
+                }
 
                 set_rasteriser_state();
                 // Draw Call
@@ -164,7 +192,10 @@ using namespace OpenGL_3_3;
             {
                 glm::vec4 wireframe_color = glm::make_vec4((*m_geometry_descriptor)->wireframecolor.get_color().data());
                 if (!(use_per_vertex_color))
+                {
                   m_shader->SetVec4fv("object_color", wireframe_color);
+                  set_fill_color_uniforms(false);
+                }
 
                 set_rasteriser_state();
                 // Draw Call
@@ -176,7 +207,10 @@ using namespace OpenGL_3_3;
             {
                 glm::vec4 object_color = glm::make_vec4((*m_geometry_descriptor)->color.get_color().data());
                 if(!(use_per_vertex_color))
+                {
                    m_shader->SetVec4fv("object_color", object_color);
+                   set_fill_color_uniforms(true);
+                }
 
                 set_rasteriser_state();
                 // Draw Call
@@ -194,6 +228,12 @@ using namespace OpenGL_3_3;
                RendererAPI<QGL_3_3>()->glPointSize(1.0f);
             }
           
+            if(is_using_primitive_colors)
+              m_vao->unbind_primitive_colors(PRIMITIVE_COLOR_TEXTURE_UNIT);
+            if(use_primitive_remap)
+              m_vao->unbind_primitive_remap(PRIMITIVE_REMAP_TEXTURE_UNIT);
+            is_using_primitive_colors = false;
+
             m_vao->unbind();
             m_shader->unbind();
             GP_TRACE("Rendered in Display Mode Sucessfully");
@@ -222,7 +262,7 @@ using namespace OpenGL_3_3;
 
           try
           {
-            if((*m_geometry_descriptor)->positions_vector().size() == 0)
+            if((*m_geometry_descriptor)->get_num_positions() == 0)
                return false;
             
             /// Get the pick information
@@ -250,10 +290,24 @@ using namespace OpenGL_3_3;
             m_shader->SetMat4fv("projection", scene_state.m_projection);
             m_shader->SetMat4fv("model", scene_state.m_model);
             m_shader->SetMat4fv("view", scene_state.m_view);
+            set_dequantization_uniforms();
+
+            const bool is_instanced = (*m_geometry_descriptor)->isInstanced();
+            m_shader->Set1i("use_instancing", is_instanced ? 1 : 0);
             
             if(pick_scheme == GL_PICK_BY_PRIMITIVE || pick_scheme == GL_PICK_BY_VERTEX)
+            {
                 m_shader->Set1i("selection_init_id", m_geometry_descriptor->get_color_id_reserve_start());
 
+                /// Every instance is one pick entity, whatever part of the prototype was hit
+                m_shader->Set1i("pick_by_instance", is_instanced ? 1 : 0);
+
+                /// Triangulated quads and polygons map gl_PrimitiveID back to the primitive the triangle was cut from,
+                /// multi strip sets to the strip holding the segment or triangle
+                const bool use_primitive_remap = pick_scheme == GL_PICK_BY_PRIMITIVE && !is_instanced && m_vao->bind_primitive_remap(PRIMITIVE_REMAP_TEXTURE_UNIT);
+                m_shader->Set1i("primitive_remap", PRIMITIVE_REMAP_TEXTURE_UNIT);
+                m_shader->Set1i("use_primitive_remap", use_primitive_remap ? 1 : 0);
+            }
 
             else if(pick_scheme == GL_PICK_GEOMETRY)
             {
@@ -278,6 +332,9 @@ using namespace OpenGL_3_3;
             if((*m_geometry_descriptor)->get_wireframe_mode_enum() == GL_WIREFRAME_ONLY)
                reset_rasteriser_state();
 
+            if(pick_scheme == GL_PICK_BY_PRIMITIVE)
+               m_vao->unbind_primitive_remap(PRIMITIVE_REMAP_TEXTURE_UNIT);
+
             // Unbind the all the objects
             m_vao->unbind();
             m_shader->unbind();
@@ -315,18 +372,123 @@ using namespace OpenGL_3_3;
       if(curr_primitive_type == GL_NONE_NULL)
         throw std::runtime_error("Primitive type is not set");
 
+      /// An instanced set without instances draws nothing (a plain draw would show the bare prototype)
+      if((*m_geometry_descriptor)->isInstanced() && m_vao->get_num_instances() == 0)
+        return;
+
+      /// Quads and polygons have no core profile primitive : they draw their triangulation, and wireframe passes draw
+      /// the outline of the original primitives so the diagonals do not show
+      if(curr_primitive_type != GL_POINTS && (*m_geometry_descriptor)->requiresTriangulation())
+      {
+        const bool outline = is_drawing_wireframe && !is_in_selection_mode;
+        GLsizei count = 0;
+        GLenum  index_type = GL_UNSIGNED_INT;
+        if(m_vao->bind_triangulation(outline, count, index_type))
+        {
+          draw_elements(outline ? GL_LINES : GL_TRIANGLES, count, index_type, nullptr);
+          m_vao->unbind_triangulation();
+        }
+        return;
+      }
+
+      /// Multi strip sets draw every strip in one call, the strips separated by the restart index of the list's type
+      if(curr_primitive_type != GL_POINTS && (*m_geometry_descriptor)->isMultiStrip())
+      {
+        GLsizei count = 0;
+        GLenum  index_type = GL_UNSIGNED_INT;
+        if(m_vao->bind_strips(count, index_type))
+        {
+          RendererAPI<QGL_3_3>()->glEnable(GL_PRIMITIVE_RESTART);
+          RendererAPI<QGL_3_3>()->glPrimitiveRestartIndex(primitive_restart_index(index_type));
+          draw_elements(curr_primitive_type, count, index_type, nullptr);
+          RendererAPI<QGL_3_3>()->glDisable(GL_PRIMITIVE_RESTART);
+          m_vao->unbind_strips();
+        }
+        return;
+      }
+
+      /// Simplified levels index the same VBO. Selection always draws level 0 since pick IDs follow the primitives
+      GLsizei lod_count = 0;
+      size_t  lod_offset = 0;
+      GLenum  lod_index_type = GL_UNSIGNED_INT;
+      const size_t lod_level = select_lod_level();
+      if(lod_level != 0 && m_vao->bind_lod_level(lod_level, lod_count, lod_offset, lod_index_type))
+      {
+        draw_elements(curr_primitive_type, lod_count, lod_index_type, reinterpret_cast<const void*>(lod_offset));
+        m_vao->unbind_lod_level();
+        return;
+      }
+
       if((*m_geometry_descriptor)->indices_vector().size() == 0 || (is_in_selection_mode && (*m_geometry_descriptor)->get_pick_scheme_enum() == GL_PICK_BY_VERTEX))
-        RendererAPI<QGL_3_3>()->glDrawArrays(curr_primitive_type, 0, (*m_geometry_descriptor)->get_num_vertices());
+        draw_arrays(curr_primitive_type, 0, (*m_geometry_descriptor)->get_num_vertices());
       else
-        RendererAPI<QGL_3_3>()->glDrawElements(curr_primitive_type,  (*m_geometry_descriptor)->get_num_vertices(), GL_UNSIGNED_INT, nullptr);
+        draw_elements(curr_primitive_type,  (*m_geometry_descriptor)->get_num_vertices(), m_vao->get_index_type(), nullptr);
+    }
+
+    /// @brief glDrawElements, once per instance in a single instanced call for prototype instancing sets
+    void OpenGL_3_3_RenderKernel::draw_elements(const GLenum& mode, const GLsizei& count, const GLenum& index_type, const void* offset)
+    {
+      if((*m_geometry_descriptor)->isInstanced())
+        RendererAPI<QGL_3_3>()->glDrawElementsInstanced(mode, count, index_type, offset, m_vao->get_num_instances());
+      else
+        RendererAPI<QGL_3_3>()->glDrawElements(mode, count, index_type, offset);
+    }
+
+    /// @brief glDrawArrays, once per instance in a single instanced call for prototype instancing sets
+    void OpenGL_3_3_RenderKernel::draw_arrays(const GLenum& mode, const GLint& first, const GLsizei& count)
+    {
+      if((*m_geometry_descriptor)->isInstanced())
+        RendererAPI<QGL_3_3>()->glDrawArraysInstanced(mode, first, count, m_vao->get_num_instances());
+      else
+        RendererAPI<QGL_3_3>()->glDrawArrays(mode, first, count);
     }
     
+    /// @brief Pick the level of detail from the projected screen size of the primitive set (0 = full resolution)
+    size_t OpenGL_3_3_RenderKernel::select_lod_level()
+    {
+      /// Simplified levels renumber the triangles, per primitive colors follow level 0
+      if(is_in_selection_mode || !(*m_geometry_descriptor)->hasLodChain() || (*m_geometry_descriptor)->hasPrimitiveColors())
+        return 0;
+
+      SceneState &scene_state = Event::Publisher::GetInstance()->get_scene_state();
+      if(!scene_state.enable_lod || scene_state.is_2d)
+        return 0;
+
+      const float screen_size = scene_state.get_projected_screen_size((*m_geometry_descriptor)->get_bounding_box());
+      return (*m_geometry_descriptor)->select_lod_level(screen_size, scene_state.lod_pixel_error);
+    }
+
     /// @brief Draw the geometry in point mode (For rendering the geometry in point mode)
     void OpenGL_3_3_RenderKernel::point_mode_draw()
     {
-      RendererAPI<QGL_3_3>()->glDrawArrays(GL_POINTS, 0, (*m_geometry_descriptor)->positions_vector().size()/3);
+      RendererAPI<QGL_3_3>()->glDrawArrays(GL_POINTS, 0, (*m_geometry_descriptor)->get_num_positions());
+    }
+
+
+    /// @brief Set the position decode of the bound shader (identity unless the VBO is quantized)
+    void OpenGL_3_3_RenderKernel::set_dequantization_uniforms()
+    {
+      glm::vec3 dequant_scale(1.0f);
+      glm::vec3 dequant_offset(0.0f);
+
+      if(m_vao->is_quantized())
+      {
+        const VertexQuantization& quantization = m_vao->get_vertex_quantization();
+        dequant_scale  = glm::make_vec3(quantization.scale.data());
+        dequant_offset = glm::make_vec3(quantization.offset.data());
+      }
+
+      m_shader->SetVec3fv("dequant_scale", dequant_scale);
+      m_shader->SetVec3fv("dequant_offset", dequant_offset);
     }
 
+    /// @brief Color fill passes with the instance colors, else the primitive colors, and wireframe passes with the uniform color
+    void OpenGL_3_3_RenderKernel::set_fill_color_uniforms(const bool& is_fill_pass)
+    {
+      const bool use_instance_color = is_fill_pass && m_vao->hasInstanceColors();
+      m_shader->Set1i("use_instance_color", use_instance_color ? 1 : 0);
+      m_shader->Set1i("use_primitive_color", is_fill_pass && is_using_primitive_colors && !use_instance_color ? 1 : 0);
+    }
 
     void OpenGL_3_3_RenderKernel::set_depth_test()
     {
@@ -368,6 +530,7 @@ using namespace OpenGL_3_3;
     {
       if((*m_geometry_descriptor)->get_wireframe_mode_enum() != GL_WIREFRAME_NONE)
       {
+          is_drawing_wireframe = true;
           RendererAPI<QGL_3_3>()->glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
           RendererAPI<QGL_3_3>()->glEnable(GL_POLYGON_OFFSET_FILL);
           RendererAPI<QGL_3_3>()->glPolygonOffset(0.1, 0.1);
@@ -393,6 +556,8 @@ using namespace OpenGL_3_3;
 
     void OpenGL_3_3_RenderKernel::reset_rasteriser_state()
     {
+      is_drawing_wireframe = false;
+
       if((*m_geometry_descriptor)->get_wireframe_mode_enum() != GL_WIREFRAME_NONE)
       {
         RendererAPI<QGL_3_3>()->glDisable(GL_POLYGON_OFFSET_FILL);
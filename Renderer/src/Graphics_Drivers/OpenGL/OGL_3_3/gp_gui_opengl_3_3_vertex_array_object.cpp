@@ -1,3 +1,4 @@
+#include <cstring>
 #include <glm/glm.hpp>
 
 #include "gp_gui_opengl_3_3_vertex_array_object.h"
@@ -10,19 +11,52 @@ namespace GridPro_GFX
 {    
 namespace OpenGL_3_3
 {
+    namespace
+    {
+        /// @brief Gap (in bytes) below which two dirty ranges are sent as one glBufferSubData call
+        constexpr size_t DIRTY_RANGE_COALESCE_GAP = 256;
+
+        /// @brief Upload the dirty byte ranges of one attribute living at buffer_offset in the bound buffer
+        void upload_ranges(GLenum target, const DirtyRangeSet& dirty_ranges, const size_t& buffer_offset, const size_t& attrib_size, const void* attrib_data)
+        {
+            if(dirty_ranges.empty() || attrib_size == 0 || attrib_data == nullptr) return;
+
+            DirtyRangeSet ranges = dirty_ranges;
+            ranges.coalesce(DIRTY_RANGE_COALESCE_GAP);
+            ranges.clamp(attrib_size);
+
+            const uint8_t* bytes = static_cast<const uint8_t*>(attrib_data);
+            for(const DirtyRangeSet::Range& range : ranges.ranges())
+                RendererAPI<QGL_3_3>()->glBufferSubData(target, buffer_offset + range.begin, range.size(), bytes + range.begin);
+        }
+
+        /// @brief Allocate the bound buffer and fill it with indices in the narrowest type for num_vertices, returns that type
+        GLenum upload_indices(GLenum target, const std::vector<uint32_t>& indices, const size_t& num_vertices)
+        {
+            CompactIndexArray compact_indices;
+            compact_indices.assign(indices, num_vertices);
+            RendererAPI<QGL_3_3>()->glBufferData(target, compact_indices.size_bytes(), compact_indices.empty() ? nullptr : compact_indices.data(), GL_STATIC_DRAW);
+            return compact_indices.type();
+        }
+    }
+
     VertexArrayObject::VertexArrayObject(GeometryDescriptor* geometry_descriptor) : Abstract_VertexArrayObject(geometry_descriptor)
     {
         PositionData = (*m_geometry_descriptor)->get_position_weak_ptr().lock().get();
         NormalData   = (*m_geometry_descriptor)->get_normals_weak_ptr().lock().get();
         ColorData    = (*m_geometry_descriptor)->get_colors_weak_ptr().lock().get();
         IndexData    = (*m_geometry_descriptor)->get_indices_weak_ptr().lock().get();
+        InterleavedData = (*m_geometry_descriptor)->get_interleaved_weak_ptr().lock().get();
         
-        if(PositionData->size() == 0) 
+        if((*m_geometry_descriptor)->get_num_positions() == 0) 
         {
             std::string err = m_geometry_descriptor->get_current_primitive_set_name() + " Position Data is empty\n";
             throw std::runtime_error(err);
         }
 
+        if((*m_geometry_descriptor)->isVertexCompressionEnabled())
+            quantize_vertex_attributes();
+
         calculate_offsets();
         create_vbo();
 
@@ -39,6 +73,11 @@ namespace OpenGL_3_3
         RendererAPI<QGL_3_3>()->glDeleteVertexArrays(1, &m_vao);
         delete_vbo();
         delete_ibo();
+        delete_lod_ibo();
+        delete_triangulation_buffers();
+        delete_instance_buffer();
+        delete_primitive_color_buffer();
+        delete_strip_buffers();
     }
 
     void VertexArrayObject::set_vertex_attribute(std::vector<float>* position_data = nullptr, std::vector<float>* normal_data = nullptr, std::vector<GLubyte>* color_data = nullptr)
@@ -86,24 +125,25 @@ namespace OpenGL_3_3
 
     void VertexArrayObject::bind()
     {
+        /// Vertices moved since the last frame become merged dirty ranges, uploaded below with the other edits
         if((*m_geometry_descriptor)->isHavingPositonUpdates())
-        {
-              for(auto& vertex : (*m_geometry_descriptor)->batch_vertex_updates)
-                 perform_micro_vertex_update(vertex.index, vertex.m_position[0], vertex.m_position[1], vertex.m_position[2]);
-                
-              (*m_geometry_descriptor)->batch_vertex_updates.clear();
-        }
+            (*m_geometry_descriptor)->flush_vertex_updates();
 
-        if(RendererAPI<QGL_3_3>()->glIsVertexArray(m_vao) != GL_TRUE) 
+        if((*m_geometry_descriptor)->hasDirtyRanges())
+            upload_dirty_ranges();
+
+        if(m_vao == 0 || RendererAPI<QGL_3_3>()->glIsVertexArray(m_vao) != GL_TRUE) 
         { 
             GP_TRACE("VAO is not created : ", (*m_geometry_descriptor)->get_instance_name());
             return;
         }   
-        else
-        {
-            RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
-            GP_TRACE("VAO is bound : ", (*m_geometry_descriptor)->get_instance_name());
-        }
+
+        /// Binds the VAO itself to set the instance pointers, so it runs before the VAO is bound for drawing
+        if((*m_geometry_descriptor)->isInstanced() || m_instances != nullptr)
+            update_instance_buffer();
+
+        RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
+        GP_TRACE("VAO is bound : ", (*m_geometry_descriptor)->get_instance_name());
         
         if(RendererAPI<QGL_3_3>()->glIsBuffer(m_ibo) == GL_TRUE)
         {
@@ -117,12 +157,378 @@ namespace OpenGL_3_3
         RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); 
     }
     
+    bool VertexArrayObject::bind_lod_level(const size_t& level, GLsizei& count, size_t& byte_offset, GLenum& index_type)
+    {
+        std::shared_ptr<const std::vector<LodLevel>> lod_chain = (*m_geometry_descriptor)->get_lod_chain();
+        if(level == 0 || lod_chain == nullptr || level > lod_chain->size())
+            return false;
+
+        if(lod_chain != m_lod_chain)
+        {
+            m_lod_chain = lod_chain;
+            create_lod_ibo();
+        }
+
+        const std::pair<size_t, size_t>& range = m_lod_ranges[level - 1];
+        if(range.second == 0)
+            return false;
+
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_lod_ibo);
+        count = static_cast<GLsizei>(range.second);
+        index_type = m_lod_index_type;
+        byte_offset = range.first * index_type_size(m_lod_index_type);
+        return true;
+    }
+
+    void VertexArrayObject::unbind_lod_level()
+    {
+        if(RendererAPI<QGL_3_3>()->glIsBuffer(m_ibo) == GL_TRUE)
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+        else
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    bool VertexArrayObject::bind_triangulation(const bool& outline, GLsizei& count, GLenum& index_type)
+    {
+        if(!update_triangulation_buffers())
+            return false;
+
+        const size_t num_indices = outline ? m_triangulation->edge_indices.size() : m_triangulation->indices.size();
+        if(num_indices == 0)
+            return false;
+
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, outline ? m_edge_ibo : m_triangle_ibo);
+        count = static_cast<GLsizei>(num_indices);
+        index_type = m_triangulation_index_type;
+        return true;
+    }
+
+    bool VertexArrayObject::bind_strips(GLsizei& count, GLenum& index_type)
+    {
+        if(!update_strip_buffers() || m_strip_list_size == 0)
+            return false;
+
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_strip_ibo);
+        count = m_strip_list_size;
+        index_type = m_strip_index_type;
+        return true;
+    }
+
+    bool VertexArrayObject::bind_primitive_remap(const uint32_t& texture_unit)
+    {
+        uint32_t remap_texture = 0;
+        if(update_triangulation_buffers())
+            remap_texture = m_primitive_remap_texture;
+        else if(update_strip_buffers())
+            remap_texture = m_strip_remap_texture;
+        else
+            return false;
+
+        RendererAPI<QGL_3_3>()->glActiveTexture(GL_TEXTURE0 + texture_unit);
+        RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, remap_texture);
+        RendererAPI<QGL_3_3>()->glActiveTexture(GL_TEXTURE0);
+        return true;
+    }
+
+    void VertexArrayObject::unbind_primitive_remap(const uint32_t& texture_unit)
+    {
+        RendererAPI<QGL_3_3>()->glActiveTexture(GL_TEXTURE0 + texture_unit);
+        RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, 0);
+        RendererAPI<QGL_3_3>()->glActiveTexture(GL_TEXTURE0);
+    }
+
+    bool VertexArrayObject::update_triangulation_buffers()
+    {
+        if(!(*m_geometry_descriptor)->requiresTriangulation())
+            return false;
+
+        std::shared_ptr<const Triangulation> triangulation = (*m_geometry_descriptor)->get_triangulation();
+        if(triangulation == nullptr)
+        {
+            m_geometry_descriptor->triangulate_primitive_set();
+            triangulation = (*m_geometry_descriptor)->get_triangulation();
+        }
+
+        if(triangulation == m_triangulation)
+            return true;
+
+        delete_triangulation_buffers();
+        m_triangulation = triangulation;
+
+        /// Uploaded through GL_ARRAY_BUFFER so the element buffer binding of whatever VAO is bound stays untouched
+        const size_t num_vertices = (*m_geometry_descriptor)->get_num_positions();
+        RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_triangle_ibo);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_triangle_ibo);
+        m_triangulation_index_type = upload_indices(GL_ARRAY_BUFFER, m_triangulation->indices, num_vertices);
+
+        RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_edge_ibo);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_edge_ibo);
+        upload_indices(GL_ARRAY_BUFFER, m_triangulation->edge_indices, num_vertices);
+
+        /// The remap table is sampled as GL_R32UI, it keeps its 32 bit entries
+        const std::vector<uint32_t>& primitive_ids = m_triangulation->primitive_ids;
+        RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_primitive_remap_tbo);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_primitive_remap_tbo);
+        RendererAPI<QGL_3_3>()->glBufferData(GL_ARRAY_BUFFER, primitive_ids.size() * sizeof(uint32_t), primitive_ids.empty() ? nullptr : primitive_ids.data(), GL_STATIC_DRAW);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        RendererAPI<QGL_3_3>()->glGenTextures(1, &m_primitive_remap_texture);
+        RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, m_primitive_remap_texture);
+        RendererAPI<QGL_3_3>()->glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_primitive_remap_tbo);
+        RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+        GP_TRACE("Uploaded triangulation (", m_triangulation->get_num_triangles(), " triangles, ", m_triangulation->edge_indices.size() / 2,
+                 " outline edges) : ", (*m_geometry_descriptor)->get_instance_name());
+        return true;
+    }
+
+    void VertexArrayObject::delete_triangulation_buffers()
+    {
+        for(uint32_t* buffer : { &m_triangle_ibo, &m_edge_ibo, &m_primitive_remap_tbo })
+        {
+            if(*buffer != 0 && RendererAPI<QGL_3_3>()->glIsBuffer(*buffer) == GL_TRUE)
+               RendererAPI<QGL_3_3>()->glDeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+
+        if(m_primitive_remap_texture != 0)
+            RendererAPI<QGL_3_3>()->glDeleteTextures(1, &m_primitive_remap_texture);
+        m_primitive_remap_texture = 0;
+        m_triangulation.reset();
+    }
+
+    bool VertexArrayObject::update_strip_buffers()
+    {
+        std::shared_ptr<const StripArray> strips = (*m_geometry_descriptor)->get_strips();
+        if(strips == nullptr)
+        {
+            if(m_strips != nullptr)
+                delete_strip_buffers();
+            return false;
+        }
+
+        const size_t num_indices   = (*m_geometry_descriptor)->get_num_indices();
+        const size_t num_positions = (*m_geometry_descriptor)->get_num_positions();
+        if(strips == m_strips && strips->version() == m_strip_version && num_indices == m_strip_num_indices && num_positions == m_strip_num_positions)
+            return true;
+
+        delete_strip_buffers();
+        m_strips              = strips;
+        m_strip_version       = strips->version();
+        m_strip_num_indices   = num_indices;
+        m_strip_num_positions = num_positions;
+
+        std::vector<uint32_t> restart_list;
+        std::vector<uint32_t> primitive_ids;
+        strips->build_restart_list((*m_geometry_descriptor)->get_primitive_type_enum(), num_indices ? (*m_geometry_descriptor)->indices_vector().data() : nullptr,
+                                   restart_list, primitive_ids);
+        m_strip_list_size = static_cast<GLsizei>(restart_list.size());
+
+        /// Uploaded through GL_ARRAY_BUFFER so the element buffer binding of whatever VAO is bound stays untouched
+        RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_strip_ibo);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_strip_ibo);
+        m_strip_index_type = upload_indices(GL_ARRAY_BUFFER, restart_list, num_positions);
+
+        RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_strip_remap_tbo);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_strip_remap_tbo);
+        RendererAPI<QGL_3_3>()->glBufferData(GL_ARRAY_BUFFER, primitive_ids.size() * sizeof(uint32_t), primitive_ids.empty() ? nullptr : primitive_ids.data(), GL_STATIC_DRAW);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        RendererAPI<QGL_3_3>()->glGenTextures(1, &m_strip_remap_texture);
+        RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, m_strip_remap_texture);
+        RendererAPI<QGL_3_3>()->glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, m_strip_remap_tbo);
+        RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+        GP_TRACE("Uploaded ", strips->size(), " strips as one restart index list : ", (*m_geometry_descriptor)->get_instance_name());
+        return true;
+    }
+
+    void VertexArrayObject::delete_strip_buffers()
+    {
+        for(uint32_t* buffer : { &m_strip_ibo, &m_strip_remap_tbo })
+        {
+            if(*buffer != 0 && RendererAPI<QGL_3_3>()->glIsBuffer(*buffer) == GL_TRUE)
+               RendererAPI<QGL_3_3>()->glDeleteBuffers(1, buffer);
+            *buffer = 0;
+        }
+
+        if(m_strip_remap_texture != 0)
+            RendererAPI<QGL_3_3>()->glDeleteTextures(1, &m_strip_remap_texture);
+        m_strip_remap_texture = 0;
+        m_strip_list_size = 0;
+        m_strips.reset();
+    }
+
+    void VertexArrayObject::update_instance_buffer()
+    {
+        std::shared_ptr<const InstanceArray> instances = (*m_geometry_descriptor)->get_instances();
+        if(instances == nullptr)
+        {
+            delete_instance_buffer();
+            return;
+        }
+
+        /// The array is copy-on-write : a new pointer or a new version means the instances were edited
+        const bool is_stale = instances != m_instances || instances->version() != m_instance_version;
+        if(!is_stale && m_instance_vao == m_vao)
+            return;
+
+        const size_t transform_bytes = instances->transforms().size() * sizeof(float);
+        const size_t color_bytes     = instances->colors().size();
+
+        if(m_instance_vbo == 0)
+            RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_instance_vbo);
+
+        RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_instance_vbo);
+
+        if(is_stale)
+        {
+            RendererAPI<QGL_3_3>()->glBufferData(GL_ARRAY_BUFFER, transform_bytes + color_bytes, nullptr, GL_DYNAMIC_DRAW);
+            if(transform_bytes)
+                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, 0, transform_bytes, instances->transforms().data());
+            if(color_bytes)
+                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, transform_bytes, color_bytes, instances->colors().data());
+        }
+
+        /// Pointers and divisors are VAO state, they are set again when create_vbo made a new VAO
+        const GLsizei transform_stride = InstanceArray::TRANSFORM_COMPONENTS * sizeof(float);
+        for(uint32_t column = 0; column < 4; ++column)
+        {
+            const uint32_t location = INSTANCE_TRANSFORM_LOCATION + column;
+            RendererAPI<QGL_3_3>()->glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, transform_stride, (void*)(uintptr_t)(column * 3 * sizeof(float)));
+            RendererAPI<QGL_3_3>()->glVertexAttribDivisor(location, 1);
+            RendererAPI<QGL_3_3>()->glEnableVertexAttribArray(location);
+        }
+
+        if(color_bytes)
+        {
+            RendererAPI<QGL_3_3>()->glVertexAttribPointer(INSTANCE_COLOR_LOCATION, 4, GL_UNSIGNED_BYTE, GL_TRUE, InstanceArray::COLOR_COMPONENTS, (void*)(uintptr_t)transform_bytes);
+            RendererAPI<QGL_3_3>()->glVertexAttribDivisor(INSTANCE_COLOR_LOCATION, 1);
+            RendererAPI<QGL_3_3>()->glEnableVertexAttribArray(INSTANCE_COLOR_LOCATION);
+        }
+        else
+            RendererAPI<QGL_3_3>()->glDisableVertexAttribArray(INSTANCE_COLOR_LOCATION);
+
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+        RendererAPI<QGL_3_3>()->glBindVertexArray(0);
+
+        m_instances = instances;
+        m_instance_version = instances->version();
+        m_instance_vao = m_vao;
+        m_num_instances = static_cast<GLsizei>(instances->size());
+        m_has_instance_colors = color_bytes != 0;
+        GP_TRACE("Uploaded ", m_num_instances, " instances : ", (*m_geometry_descriptor)->get_instance_name());
+    }
+
+    void VertexArrayObject::delete_instance_buffer()
+    {
+        if(m_instance_vbo != 0 && RendererAPI<QGL_3_3>()->glIsBuffer(m_instance_vbo) == GL_TRUE)
+            RendererAPI<QGL_3_3>()->glDeleteBuffers(1, &m_instance_vbo);
+
+        m_instance_vbo = 0;
+        m_instance_vao = 0;
+        m_instance_version = 0;
+        m_instances.reset();
+        m_num_instances = 0;
+        m_has_instance_colors = false;
+    }
+
+    bool VertexArrayObject::bind_primitive_colors(const uint32_t& texture_unit)
+    {
+        if(!(*m_geometry_descriptor)->hasPrimitiveColors())
+            return false;
+
+        /// The array is copy-on-write : a new pointer or a new version means the colors were edited
+        std::shared_ptr<const PrimitiveColorArray> primitive_colors = (*m_geometry_descriptor)->get_primitive_colors();
+        if(primitive_colors != m_primitive_colors || primitive_colors->version() != m_primitive_color_version)
+        {
+            if(m_primitive_color_tbo == 0)
+            {
+                RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_primitive_color_tbo);
+                RendererAPI<QGL_3_3>()->glGenTextures(1, &m_primitive_color_texture);
+            }
+
+            const std::vector<uint8_t>& colors = primitive_colors->colors();
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_primitive_color_tbo);
+            RendererAPI<QGL_3_3>()->glBufferData(GL_ARRAY_BUFFER, colors.size(), colors.data(), GL_STATIC_DRAW);
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, m_primitive_color_texture);
+            RendererAPI<QGL_3_3>()->glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA8, m_primitive_color_tbo);
+            RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+            m_primitive_colors = primitive_colors;
+            m_primitive_color_version = primitive_colors->version();
+            GP_TRACE("Uploaded ", primitive_colors->size(), " primitive colors : ", (*m_geometry_descriptor)->get_instance_name());
+        }
+
+        RendererAPI<QGL_3_3>()->glActiveTexture(GL_TEXTURE0 + texture_unit);
+        RendererAPI<QGL_3_3>()->glBindTexture(GL_TEXTURE_BUFFER, m_primitive_color_texture);
+        RendererAPI<QGL_3_3>()->glActiveTexture(GL_TEXTURE0);
+        return true;
+    }
+
+    void VertexArrayObject::delete_primitive_color_buffer()
+    {
+        if(m_primitive_color_tbo != 0 && RendererAPI<QGL_3_3>()->glIsBuffer(m_primitive_color_tbo) == GL_TRUE)
+            RendererAPI<QGL_3_3>()->glDeleteBuffers(1, &m_primitive_color_tbo);
+        if(m_primitive_color_texture != 0)
+            RendererAPI<QGL_3_3>()->glDeleteTextures(1, &m_primitive_color_texture);
+
+        m_primitive_color_tbo = 0;
+        m_primitive_color_texture = 0;
+        m_primitive_color_version = 0;
+        m_primitive_colors.reset();
+    }
+
+    void VertexArrayObject::create_lod_ibo()
+    {
+        delete_lod_ibo();
+        m_lod_ranges.clear();
+
+        size_t total = 0;
+        for(const LodLevel& lod_level : *m_lod_chain)
+        {
+            m_lod_ranges.emplace_back(total, lod_level.indices.size());
+            total += lod_level.indices.size();
+        }
+
+        /// Every level indexes the VBO of level 0, so they all share its index width
+        const size_t num_vertices = (*m_geometry_descriptor)->get_num_positions();
+        m_lod_index_type = select_index_type(num_vertices);
+        const size_t index_size = index_type_size(m_lod_index_type);
+
+        RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_lod_ibo);
+        RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_lod_ibo);
+        RendererAPI<QGL_3_3>()->glBufferData(GL_ELEMENT_ARRAY_BUFFER, total * index_size, nullptr, GL_STATIC_DRAW);
+        CompactIndexArray compact_indices;
+        for(size_t i = 0; i < m_lod_chain->size(); ++i)
+        {
+            const std::vector<uint32_t>& lod_indices = (*m_lod_chain)[i].indices;
+            if(lod_indices.empty()) continue;
+
+            compact_indices.assign(lod_indices, num_vertices);
+            RendererAPI<QGL_3_3>()->glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, m_lod_ranges[i].first * index_size, compact_indices.size_bytes(), compact_indices.data());
+        }
+        GP_TRACE("Uploaded ", m_lod_chain->size(), " levels of detail (", total, " indices) : ", (*m_geometry_descriptor)->get_instance_name());
+    }
+
     void VertexArrayObject::calculate_offsets()
     {
         vSize = 0;
         nSize = 0;
         cSize = 0;
 
+        /// Interleaved vertices are uploaded as one block, the attribute offsets come from the layout
+        if (InterleavedData)
+        {
+            vSize = InterleavedData->size_bytes();
+            vOffset = nOffset = cOffset = 0;
+            GP_TRACE("VBO info : ", "interleaved size = ", vSize, " stride = ", InterleavedData->stride());
+            return;
+        }
+
         if (PositionData)
             vSize = PositionData->size() * sizeof(float);
 
@@ -142,6 +548,9 @@ namespace OpenGL_3_3
     {   
         GLsizei stride = 0;
         calculate_offsets();
+
+        /// Everything is uploaded below, pending partial updates are covered by it
+        (*m_geometry_descriptor)->clear_dirty_ranges();
         /// @brief Allocate the vertex buffer object only if the vertex data size has changed
         /// @note  This is to avoid the reallocation of the VBO for every frame
         if(m_vbo_curr_size != vSize + nSize + cSize)
@@ -149,6 +558,8 @@ namespace OpenGL_3_3
            delete_vao();
            delete_vbo();
            RendererAPI<QGL_3_3>()->glGenVertexArrays(1, &m_vao);
+           /// A new VAO may reuse the name of the deleted one, the instance pointers still have to be set on it
+           m_instance_vao = 0;
            RendererAPI<QGL_3_3>()->glGenBuffers(1, &m_vbo);
            RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
@@ -166,6 +577,18 @@ namespace OpenGL_3_3
     
         uint32_t it = 0;
 
+        if (InterleavedData)
+        {
+            if (vSize != 0)
+                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, 0, vSize, InterleavedData->data());
+
+            set_interleaved_attrib_pointers();
+
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+            unbind();
+            return;
+        }
+
         // Copy data to VBO
         if (vSize != 0)
             RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vOffset, vSize, PositionData->data());
@@ -214,8 +637,9 @@ namespace OpenGL_3_3
 
           bind();
           RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-          RendererAPI<QGL_3_3>()->glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexData->size() * sizeof(uint32_t), IndexData->data(), GL_STATIC_DRAW);
+          m_index_type = upload_indices(GL_ELEMENT_ARRAY_BUFFER, *IndexData, (*m_geometry_descriptor)->get_num_positions());
           m_ibo_curr_size = IndexData->size();
+          m_strip_version = 0;
           RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
           unbind();
       }
@@ -223,22 +647,42 @@ namespace OpenGL_3_3
 
       void VertexArrayObject::update_vertex_attributes(std::vector<float>* position_data, std::vector<float>* normal_data, std::vector<GLubyte>* color_data) 
       {
+            if (m_is_quantized)
+                quantize_vertex_attributes();
+
             RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
             RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
             calculate_offsets();
-            RendererAPI<QGL_3_3>()->glBufferData(GL_ARRAY_BUFFER, vSize + nSize + cSize, nullptr, GL_STATIC_DRAW);
-    
-            if (vSize)
-                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, 0, vSize, PositionData->data());
-    
-            if (nSize)
-                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vSize, nSize, NormalData->data());
-    
-            if (cSize)
-                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vSize + nSize, cSize, ColorData->data());
+
+            /// The storage is only reallocated when the size changed, otherwise the data is overwritten in place
+            if(m_vbo_curr_size != vSize + nSize + cSize)
+            {
+                gridpro_gpu_metrics::gpu_current_vertex_array_size -= get_vbo_size();
+                RendererAPI<QGL_3_3>()->glBufferData(GL_ARRAY_BUFFER, vSize + nSize + cSize, nullptr, GL_STATIC_DRAW);
+                m_vbo_curr_size = vSize + nSize + cSize;
+                gridpro_gpu_metrics::gpu_current_vertex_array_size += get_vbo_size();
+            }
+
+            if (InterleavedData)
+            {
+                if (vSize)
+                    RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, 0, vSize, InterleavedData->data());
+            }
+            else
+            {
+                if (vSize)
+                    RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, 0, vSize, PositionData->data());
+        
+                if (nSize)
+                    RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vSize, nSize, NormalData->data());
+        
+                if (cSize)
+                    RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vSize + nSize, cSize, ColorData->data());
+            }
     
             RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
             RendererAPI<QGL_3_3>()->glBindVertexArray(0);
+            (*m_geometry_descriptor)->clear_dirty_ranges();
       }
 
         void VertexArrayObject::update_indices(std::vector<uint32_t>* IndexData)
@@ -247,18 +691,197 @@ namespace OpenGL_3_3
                 return;
 
             RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-            RendererAPI<QGL_3_3>()->glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexData->size() * sizeof(uint32_t), IndexData->data(), GL_STATIC_DRAW);
+            m_index_type = upload_indices(GL_ELEMENT_ARRAY_BUFFER, *IndexData, (*m_geometry_descriptor)->get_num_positions());
+            m_strip_version = 0;
             RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         }
         
         void VertexArrayObject::perform_micro_vertex_update(const uint32_t& vertex_id, const float& pos_x, const float& pos_y, const float& pos_z)
         {
+            if (m_is_quantized)
+            {
+                /// A vertex leaving the quantization box needs a new box, so the whole VBO is re-encoded
+                if (!m_quantization.contains(pos_x, pos_y, pos_z))
+                {
+                    update_vertex_attributes(nullptr, nullptr, nullptr);
+                    return;
+                }
+
+                const float position[3] = {pos_x, pos_y, pos_z};
+                uint16_t quantized_position[4];
+                m_quantization.encode_position(position, quantized_position);
+                std::memcpy(m_quantized_vertices.data() + vertex_id * m_quantized_vertices.stride(), quantized_position, sizeof(quantized_position));
+
+                RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
+                RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vertex_id * m_quantized_vertices.stride(), sizeof(quantized_position), quantized_position);
+                RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+                unbind();
+                return;
+            }
+
             glm::vec3 new_position(pos_x, pos_y, pos_z);
+            const uint32_t vertex_stride = InterleavedData ? InterleavedData->stride() : sizeof(glm::vec3);
+            RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+            RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vertex_id * vertex_stride, sizeof(glm::vec3), &new_position.x);
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+            unbind();
+        }
+
+        void VertexArrayObject::upload_dirty_ranges()
+        {
+            std::shared_ptr<GeometryDescriptor::PrimitiveSetInstance> primitive_set = m_geometry_descriptor->get_current_primitive_set().lock();
+            if(primitive_set == nullptr || !primitive_set->hasDirtyRanges())
+                return;
+
+            if(m_is_quantized)
+            {
+                upload_dirty_quantized_ranges();
+                return;
+            }
+
+            PositionData = primitive_set->get_position_weak_ptr().lock().get();
+            NormalData   = primitive_set->get_normals_weak_ptr().lock().get();
+            ColorData    = primitive_set->get_colors_weak_ptr().lock().get();
+            IndexData    = primitive_set->get_indices_weak_ptr().lock().get();
+            InterleavedData = primitive_set->get_interleaved_weak_ptr().lock().get();
+            calculate_offsets();
+
+            /// A resized attribute changes the VBO layout, commit_geometry rebuilds the VAO for that
+            if(m_vbo_curr_size != vSize + nSize + cSize)
+            {
+                GP_TRACE("VBO layout changed, dirty ranges left for the next commit : ", primitive_set->get_instance_name());
+                return;
+            }
+
             RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
             RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-            RendererAPI<QGL_3_3>()->glBufferSubData(GL_ARRAY_BUFFER, vertex_id * sizeof(glm::vec3), sizeof(glm::vec3), &new_position.x);
+
+            typedef GeometryDescriptor::PrimitiveSetInstance PrimitiveSet;
+            if (InterleavedData)
+            {
+                upload_ranges(GL_ARRAY_BUFFER, primitive_set->get_dirty_ranges(PrimitiveSet::POSITION_ARRAY), 0, vSize, InterleavedData->data());
+            }
+            else
+            {
+                upload_ranges(GL_ARRAY_BUFFER, primitive_set->get_dirty_ranges(PrimitiveSet::POSITION_ARRAY), vOffset, vSize, PositionData ? PositionData->data() : nullptr);
+                upload_ranges(GL_ARRAY_BUFFER, primitive_set->get_dirty_ranges(PrimitiveSet::NORMAL_ARRAY),   nOffset, nSize, NormalData   ? NormalData->data()   : nullptr);
+                upload_ranges(GL_ARRAY_BUFFER, primitive_set->get_dirty_ranges(PrimitiveSet::COLOR_ARRAY),    cOffset, cSize, ColorData    ? ColorData->data()    : nullptr);
+            }
+
             RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+            upload_dirty_index_ranges();
             unbind();
+
+            primitive_set->clear_dirty_ranges();
+        }
+
+        void VertexArrayObject::upload_dirty_quantized_ranges()
+        {
+            std::shared_ptr<GeometryDescriptor::PrimitiveSetInstance> primitive_set = m_geometry_descriptor->get_current_primitive_set().lock();
+
+            if(primitive_set->get_num_positions() != m_quantized_vertices.size())
+            {
+                GP_TRACE("VBO layout changed, dirty ranges left for the next commit : ", primitive_set->get_instance_name());
+                return;
+            }
+
+            const DirtyRangeSet vertex_ranges = primitive_set->get_dirty_vertex_ranges();
+            std::shared_ptr<InterleavedVertexArray> source_vertices  = primitive_set->get_interleaved_weak_ptr().lock();
+            std::shared_ptr<std::vector<float>>     source_positions = primitive_set->get_position_weak_ptr().lock();
+
+            /// A vertex leaving the quantization box needs a new box, so the whole VBO is re-encoded
+            for(const DirtyRangeSet::Range& range : vertex_ranges.ranges())
+            {
+                for(size_t i = range.begin; i < range.end; i++)
+                {
+                    const float* position = source_vertices ? source_vertices->position(i) : &(*source_positions)[i * 3];
+                    if(!m_quantization.contains(position[0], position[1], position[2]))
+                    {
+                        update_vertex_attributes(nullptr, nullptr, nullptr);
+                        return;
+                    }
+                }
+            }
+
+            const size_t stride = m_quantized_vertices.stride();
+            DirtyRangeSet byte_ranges;
+            for(const DirtyRangeSet::Range& range : vertex_ranges.ranges())
+            {
+                primitive_set->encode_quantized_vertices(m_quantization, m_quantized_vertices, range.begin, range.end);
+                byte_ranges.add(range.begin * stride, range.end * stride);
+            }
+
+            IndexData = primitive_set->get_indices_weak_ptr().lock().get();
+
+            RendererAPI<QGL_3_3>()->glBindVertexArray(m_vao);
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+            upload_ranges(GL_ARRAY_BUFFER, byte_ranges, 0, m_quantized_vertices.size_bytes(), m_quantized_vertices.data());
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ARRAY_BUFFER, 0);
+            upload_dirty_index_ranges();
+            unbind();
+
+            primitive_set->clear_dirty_ranges();
+        }
+
+        void VertexArrayObject::upload_dirty_index_ranges()
+        {
+            const DirtyRangeSet& index_ranges = (*m_geometry_descriptor)->get_dirty_ranges(GeometryDescriptor::PrimitiveSetInstance::INDEX_ARRAY);
+            if(index_ranges.empty() || IndexData == nullptr || m_ibo_curr_size != IndexData->size())
+                return;
+
+            /// The restart list of a multi strip set holds its own copy of the indices
+            m_strip_version = 0;
+
+            /// The VAO is bound by the caller, so this is the element buffer it already references
+            RendererAPI<QGL_3_3>()->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
+            if(m_index_type == GL_UNSIGNED_INT)
+            {
+                upload_ranges(GL_ELEMENT_ARRAY_BUFFER, index_ranges, 0, IndexData->size() * sizeof(uint32_t), IndexData->data());
+                return;
+            }
+
+            /// 16 bit buffer : the ranges are in bytes of the uint32_t source, only the edited indices are narrowed again
+            DirtyRangeSet ranges = index_ranges;
+            ranges.coalesce(DIRTY_RANGE_COALESCE_GAP);
+            ranges.clamp(IndexData->size() * sizeof(uint32_t));
+
+            std::vector<uint16_t> compact_indices;
+            for(const DirtyRangeSet::Range& range : ranges.ranges())
+            {
+                const size_t first = range.begin / sizeof(uint32_t);
+                const size_t end   = (range.end + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+                compact_indices.assign(IndexData->begin() + first, IndexData->begin() + end);
+                RendererAPI<QGL_3_3>()->glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, first * sizeof(uint16_t), compact_indices.size() * sizeof(uint16_t), compact_indices.data());
+            }
+        }
+
+        void VertexArrayObject::set_interleaved_attrib_pointers()
+        {
+            /// Same location assignment as the separate arrays (position, normal, color in that order)
+            const VertexLayoutInfo& layout = InterleavedData->layout();
+            const VertexAttribSemantic location_order[] = { ATTRIB_POSITION, ATTRIB_NORMAL, ATTRIB_COLOR };
+            uint32_t it = 0;
+
+            for (VertexAttribSemantic semantic : location_order)
+            {
+                const VertexAttribInfo* attrib = layout.find(semantic);
+                if (attrib == nullptr) continue;
+
+                RendererAPI<QGL_3_3>()->glVertexAttribPointer(it, attrib->components, attrib->gl_type, attrib->normalized ? GL_TRUE : GL_FALSE,
+                                                              layout.stride, (void*)(uintptr_t)attrib->offset);
+                RendererAPI<QGL_3_3>()->glEnableVertexAttribArray(it);
+                ++it;
+            }
+        }
+
+        void VertexArrayObject::quantize_vertex_attributes()
+        {
+            m_quantized_vertices = (*m_geometry_descriptor)->build_quantized_vertex_array(m_quantization);
+            InterleavedData = &m_quantized_vertices;
+            m_is_quantized  = true;
+            GP_TRACE("Quantized vertex data : ", (*m_geometry_descriptor)->get_instance_name(), " stride = ", m_quantized_vertices.stride());
         }
 
         void VertexArrayObject::delete_vbo()
@@ -283,15 +906,19 @@ namespace OpenGL_3_3
               GP_TRACE("IBO is already deleted");  
         }
 
+        void VertexArrayObject::delete_lod_ibo()
+        {
+            if(m_lod_ibo != 0 && RendererAPI<QGL_3_3>()->glIsBuffer(m_lod_ibo) == GL_TRUE)
+               RendererAPI<QGL_3_3>()->glDeleteBuffers(1, &m_lod_ibo);
+            m_lod_ibo = 0;
+        }
+
         void VertexArrayObject::delete_vao()
         {
-            bind(); 
             if(RendererAPI<QGL_3_3>()->glIsVertexArray(m_vao) == GL_TRUE)
-            {
                RendererAPI<QGL_3_3>()->glDeleteVertexArrays(1, &m_vao);
-               m_vao = 0;
-            }
-            unbind(); 
+            m_vao = 0;
+            m_instance_vao = 0;
         }
 }
 
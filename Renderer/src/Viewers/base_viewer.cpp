@@ -29,6 +29,9 @@
 
 using namespace GridPro_GFX;
 
+/// Hidden and shown at every mouse move, built once
+static const std::string HOVERED_SUB_ENTITY = "HOVERED_SUB_ENTITY";
+
 AbstractViewerWindow::AbstractViewerWindow()
 {
     enable_selection_rendering = true;    
@@ -37,7 +40,6 @@ AbstractViewerWindow::AbstractViewerWindow()
     m_workplane =  WorkPlane(1.0, 0.0, 0.0, 0.0);
     m_workplane.size = 5.0f;
     is_workplane_active = false;
-    previouly_hovered_entity_name = "NULL_ENTITY";
     is_view_changed = true;
     is_cluster_selection_enabled = false;
     DevicePixelRatio = 1.0f;
@@ -100,6 +102,12 @@ void AbstractViewerWindow::switch_driver(const GLenum &driver)
 {
     accquire_render_context();
     m_scene->switch_driver(driver);
+
+    // The scene commits every entity again, hide the hidden ones again
+    for (const EntityId& hidden_entity : m_hidden_entities)
+    {
+        m_scene->uncommit_entity(hidden_entity);
+    }
 }
 
 void AbstractViewerWindow::resize_event(int w, int h)
@@ -127,15 +135,9 @@ void AbstractViewerWindow::render_update()
     create_and_display_workplane();
     create_and_display_mouse_ray();
     
+    // Hidden geometries are uncommitted when hidden (or uploaded), not every frame
     upload_commits();
 
-    m_scene->commit_all();
-
-    for (auto& hidden_geometry : m_hidden_geometries)
-    {
-        m_scene->uncommit_entity(hidden_geometry);
-    }
-
     if (enable_selection_rendering == true)
     {
         m_scene->update((GL_LAYER_PICKABLE));
@@ -400,19 +402,19 @@ bool AbstractViewerWindow::handle_subentity_highlighting()
 
     //*****  Sub Entity Highlighting Mechanism  ***************
 
-    hide_geometry("HOVERED_SUB_ENTITY");  
+    hide_geometry(m_hovered_sub_entity);  
 
-    if (sub.getPickEvent().getEntityKey() != "NULL_ENTITY" && !is_view_changed) // Cant move the world and pick at the same time
+    if (!sub.getPickEvent().getEntityHandle().is_null() && !is_view_changed) // Cant move the world and pick at the same time
     {
-        const std::string selected_entity_key = sub.getPickEvent().getEntityKey();
+        const EntityId selected_entity = sub.getPickEvent().getEntityHandle();
         uint32_t sub_entity_id = sub.getPickEvent().getSubEntityID();
-        auto& hovered_descriptor = get_geometry(selected_entity_key);
+        auto& hovered_descriptor = get_geometry(selected_entity);
         
         if(!(*hovered_descriptor)->isHighlightable()) return need_redraw;
 
         if((*hovered_descriptor)->get_pick_scheme_enum() == GL_PICK_BY_VERTEX)
         {
-        float* vertex = (*hovered_descriptor)->get_vertex_ref(sub_entity_id);
+        const float* vertex = (*hovered_descriptor)->get_vertex_ref(sub_entity_id);
         std::vector<float> pos_array;
         for(int i = 0; i < 3 ; ++i)
         {
@@ -424,8 +426,7 @@ bool AbstractViewerWindow::handle_subentity_highlighting()
         sub_entity_descriptor->move_pos_array(std::move(pos_array));
         sub_entity_descriptor->set_fill_color(255,0,0,255);
         sub_entity_descriptor->set_point_size(20.0f);
-        commit_geometry("HOVERED_SUB_ENTITY", sub_entity_descriptor); 
-        show_geometry("HOVERED_SUB_ENTITY");
+        show_hovered_sub_entity(sub_entity_descriptor);
         need_redraw = true;
         }
     
@@ -433,9 +434,6 @@ bool AbstractViewerWindow::handle_subentity_highlighting()
         {
           if((*hovered_descriptor)->get_primitive_type_enum() == GL_LINES)
           {
-            const std::string selected_entity_key = sub.getPickEvent().getEntityKey();
-            uint32_t sub_entity_id = sub.getPickEvent().getSubEntityID();
-            auto &hovered_descriptor = get_geometry(selected_entity_key);
             std::vector<float> pos_array = (*hovered_descriptor)->get_picked_primitive(sub_entity_id);
             auto sub_entity_descriptor = std::make_shared<GeometryDescriptor>();
             sub_entity_descriptor->set_current_primitive_set("Hovered Entity", (*hovered_descriptor)->get_primitive_type_enum());
@@ -443,26 +441,24 @@ bool AbstractViewerWindow::handle_subentity_highlighting()
             sub_entity_descriptor->set_fill_color(255,0,0,255);
             float curr_lw = (*sub_entity_descriptor)->get_line_width();
             sub_entity_descriptor->set_line_width(curr_lw + 20.0f);
-            commit_geometry("HOVERED_SUB_ENTITY", sub_entity_descriptor); 
-            show_geometry("HOVERED_SUB_ENTITY");
+            show_hovered_sub_entity(sub_entity_descriptor);
             need_redraw = true;
            }
         }
     }    
     else
     {
-        hide_geometry("HOVERED_SUB_ENTITY");
+        hide_geometry(m_hovered_sub_entity);
     }
 
     if (is_holding_a_node)
     {
-        const std::string selected_entity_key = m_currently_holded_node.entity_name;
         uint32_t sub_entity_id = m_currently_holded_node.node_index;
-        auto &hovered_descriptor = get_geometry(selected_entity_key);
+        auto &hovered_descriptor = get_geometry(m_currently_holded_node.entity);
 
         if((*hovered_descriptor)->get_pick_scheme_enum() == GL_PICK_BY_PRIMITIVE || (*hovered_descriptor)->get_pick_scheme_enum() == GL_PICK_BY_VERTEX)
         {
-        float* vertex = (*hovered_descriptor)->get_vertex_ref(sub_entity_id);
+        const float* vertex = (*hovered_descriptor)->get_vertex_ref(sub_entity_id);
         std::vector<float> pos_array;
         for(int i = 0; i < 3 ; ++i)
         {
@@ -474,8 +470,7 @@ bool AbstractViewerWindow::handle_subentity_highlighting()
         sub_entity_descriptor->move_pos_array(std::move(pos_array));
         sub_entity_descriptor->set_fill_color(255,0,0,255);
         sub_entity_descriptor->set_point_size(20.0f);
-        commit_geometry("HOVERED_SUB_ENTITY", sub_entity_descriptor);  
-        show_geometry("HOVERED_SUB_ENTITY");
+        show_hovered_sub_entity(sub_entity_descriptor);
         need_redraw = true;
         }
     }
@@ -483,6 +478,24 @@ bool AbstractViewerWindow::handle_subentity_highlighting()
     return need_redraw;
 }
 
+void AbstractViewerWindow::show_hovered_sub_entity(const std::shared_ptr<GeometryDescriptor>& in_geometry)
+{
+    /// The overlay is looked up by name only until its first commit is uploaded, mouse moves then go by handle
+    if (!m_scene->has_entity(m_hovered_sub_entity))
+    {
+        m_hovered_sub_entity = m_scene->find_entity(HOVERED_SUB_ENTITY);
+    }
+
+    if (m_hovered_sub_entity.is_null())
+    {
+        commit_geometry(HOVERED_SUB_ENTITY, in_geometry);
+        return;
+    }
+
+    commit_geometry(m_hovered_sub_entity, in_geometry);
+    show_geometry(m_hovered_sub_entity);
+}
+
 bool AbstractViewerWindow::handle_geometry_highlighting_and_node_manipulation(const float& x, const float& y, bool& need_redraw)
 {
     bool need_to_return_early = false;
@@ -492,18 +505,16 @@ bool AbstractViewerWindow::handle_geometry_highlighting_and_node_manipulation(co
     // ******* Node Manipulation Mechanism + Geometry Hover Highlighting Mechanism ********
     if(is_holding_a_node) // If a node is being held already
     {
-        auto& curr_entity_descriptor = get_geometry(m_currently_holded_node.entity_name);
+        auto& curr_entity_descriptor = get_geometry(m_currently_holded_node.entity);
         glm::vec3 translation_vector = m_camera->get_world_space_translation_vector(glm::vec2(m_prev_mouse_state.x, m_prev_mouse_state.y), glm::vec2(x, y));
         curr_entity_descriptor->translate_vertex({ translation_vector.x, translation_vector.y, translation_vector.z } , m_currently_holded_node.node_index);
         m_prev_mouse_state.x = x; m_prev_mouse_state.y = y;
-        float* node_pos = (*curr_entity_descriptor)->get_vertex_ref(m_currently_holded_node.node_index);
+        const float* node_pos = (*curr_entity_descriptor)->get_vertex_ref(m_currently_holded_node.node_index);
 
-        if(is_workplane_active && m_workplane.is_valid())
+        if(node_pos != nullptr && is_workplane_active && m_workplane.is_valid())
          {
             Point point_on_plane = m_workplane.project_onto_plane(node_pos[0], node_pos[1], node_pos[2]);
-            node_pos[0] = point_on_plane.x;
-            node_pos[1] = point_on_plane.y;
-            node_pos[2] = point_on_plane.z; 
+            curr_entity_descriptor->update_vertex({ static_cast<float>(point_on_plane.x), static_cast<float>(point_on_plane.y), static_cast<float>(point_on_plane.z) }, m_currently_holded_node.node_index);
         }   
 
         enable_selection_rendering = false;
@@ -513,30 +524,28 @@ bool AbstractViewerWindow::handle_geometry_highlighting_and_node_manipulation(co
         return need_to_return_early;
     }
 
-    if (sub.getPickEvent().getEntityKey() != "NULL_ENTITY")
+    if (!sub.getPickEvent().getEntityHandle().is_null())
     {
-        const std::string selected_entity_key = sub.getPickEvent().getEntityKey();
+        const EntityId selected_entity = sub.getPickEvent().getEntityHandle();
         uint32_t sub_entity_id = sub.getPickEvent().getSubEntityID();
         
-        auto& curr_entity_descriptor = get_geometry(selected_entity_key);
+        auto& curr_entity_descriptor = get_geometry(selected_entity);
 
         // if user tries to hold and move a node on a geometry that has node manipulation enabled
         if((curr_entity_descriptor->isNodeManipulationEnabled() && m_prev_mouse_state.button == MouseButton::Left))
         {
-            m_currently_holded_node.entity_name = selected_entity_key;
+            m_currently_holded_node.entity = selected_entity;
             m_currently_holded_node.node_index  = sub_entity_id;
             glm::vec3 translation_vector = m_camera->get_world_space_translation_vector(glm::vec2(m_prev_mouse_state.x, m_prev_mouse_state.y), glm::vec2(x, y)) * 1.25f;
             curr_entity_descriptor->translate_vertex({ translation_vector.x, translation_vector.y, translation_vector.z }, sub_entity_id);
             m_prev_mouse_state.x = x; m_prev_mouse_state.y = y;
             is_holding_a_node = true;
-            float* node_pos = (*curr_entity_descriptor)->get_vertex_ref(m_currently_holded_node.node_index);
+            const float* node_pos = (*curr_entity_descriptor)->get_vertex_ref(m_currently_holded_node.node_index);
 
-            if(is_workplane_active && m_workplane.is_valid())
+            if(node_pos != nullptr && is_workplane_active && m_workplane.is_valid())
             {
                Point point_on_plane = m_workplane.project_onto_plane(node_pos[0], node_pos[1], node_pos[2]);
-               node_pos[0] = point_on_plane.x;
-               node_pos[1] = point_on_plane.y;
-               node_pos[2] = point_on_plane.z; 
+               curr_entity_descriptor->update_vertex({ static_cast<float>(point_on_plane.x), static_cast<float>(point_on_plane.y), static_cast<float>(point_on_plane.z) }, m_currently_holded_node.node_index);
             }
             
             enable_selection_rendering = false;
@@ -548,32 +557,34 @@ bool AbstractViewerWindow::handle_geometry_highlighting_and_node_manipulation(co
 
         if(!is_view_changed)
         {
-        if (previouly_hovered_entity_name != "NULL_ENTITY")
+        // The previously hovered entity may have been destroyed since
+        if (m_hovered_entity != selected_entity && m_scene->has_entity(m_hovered_entity))
         {
-            auto& previously_hovered_entity_descriptor = get_geometry(previouly_hovered_entity_name);
+            auto& previously_hovered_entity_descriptor = get_geometry(m_hovered_entity);
             previously_hovered_entity_descriptor->set_hover_highlights(false);
         }
 
-        auto& currently_hovered_entity_descriptor = get_geometry(selected_entity_key);
-
-        currently_hovered_entity_descriptor->set_hover_highlights(true);
+        curr_entity_descriptor->set_hover_highlights(true);
 
-        if (previouly_hovered_entity_name != selected_entity_key)
+        if (m_hovered_entity != selected_entity)
         {
             enable_selection_rendering = false;
             update_display();
             need_redraw = true;
-            previouly_hovered_entity_name = selected_entity_key;
+            m_hovered_entity = selected_entity;
         }
         }
     }
     else
     {   
-        if (previouly_hovered_entity_name != "NULL_ENTITY")
+        if (!m_hovered_entity.is_null())
         {
-            auto& currently_hovered_entity_descriptor = get_geometry(previouly_hovered_entity_name);
-            currently_hovered_entity_descriptor->set_hover_highlights(false);
-            previouly_hovered_entity_name = "NULL_ENTITY";
+            if (m_scene->has_entity(m_hovered_entity))
+            {
+                auto& currently_hovered_entity_descriptor = get_geometry(m_hovered_entity);
+                currently_hovered_entity_descriptor->set_hover_highlights(false);
+            }
+            m_hovered_entity = EntityId();
             enable_selection_rendering = false;
             update_display();
             need_redraw = true;
@@ -933,6 +944,19 @@ void AbstractViewerWindow::commit_geometry(const std::string &in_name, const flo
     m_geometry_commit_stack.emplace_back(geometry_commit(in_name, in_layer, geometry_descriptor));
 }
 
+void AbstractViewerWindow::commit_geometry(const EntityId &in_entity, const std::shared_ptr<GeometryDescriptor> &geometry_descriptor)
+{
+    commit_geometry(in_entity, GL_LAYER_1, geometry_descriptor);
+}
+
+void AbstractViewerWindow::commit_geometry(const EntityId &in_entity, const float &in_layer, const std::shared_ptr<GeometryDescriptor> &geometry_descriptor)
+{
+    /// Same selection buffer refresh as the named commit
+    is_view_changed = true;
+    enable_selection_rendering = true;
+    m_geometry_commit_stack.emplace_back(geometry_commit(in_entity, in_layer, geometry_descriptor));
+}
+
 void AbstractViewerWindow::commit_2d_geometry(const std::string &in_name, const float &in_layer, const std::shared_ptr<GeometryDescriptor> &geometry_descriptor)
 {
     /* The Below Line 
@@ -969,7 +993,23 @@ void AbstractViewerWindow::upload_commits()
         for (size_t i = m_geometry_commit_stack.size(); i > 0; --i)
         {
             auto &commit = m_geometry_commit_stack[i - 1];
-            m_scene->commit_geometry(commit.name, commit.layer_id, commit.geometry);
+            EntityId entity_id = commit.entity;
+            if (entity_id.is_null())
+            {
+                entity_id = m_scene->commit_geometry(commit.name, commit.layer_id, commit.geometry);
+                if (!m_hidden_geometries.empty() && m_hidden_geometries.erase(commit.name) != 0)
+                {
+                    m_hidden_entities.insert(entity_id);
+                }
+            }
+            else if (!m_scene->commit_geometry(entity_id, commit.layer_id, commit.geometry))
+            {
+                continue;
+            }
+            if (m_hidden_entities.count(entity_id) != 0)
+            {
+                m_scene->uncommit_entity(entity_id);
+            }
         }
 
         m_geometry_commit_stack.clear();
@@ -980,7 +1020,23 @@ void AbstractViewerWindow::upload_commits()
         for (size_t i = m_2d_geometry_commit_stack.size(); i > 0; --i)
         {
             auto &commit = m_2d_geometry_commit_stack[i - 1];
-            m_scene->commit_geometry(commit.name, commit.layer_id, commit.geometry);
+            EntityId entity_id = commit.entity;
+            if (entity_id.is_null())
+            {
+                entity_id = m_scene->commit_geometry(commit.name, commit.layer_id, commit.geometry);
+                if (!m_hidden_geometries.empty() && m_hidden_geometries.erase(commit.name) != 0)
+                {
+                    m_hidden_entities.insert(entity_id);
+                }
+            }
+            else if (!m_scene->commit_geometry(entity_id, commit.layer_id, commit.geometry))
+            {
+                continue;
+            }
+            if (m_hidden_entities.count(entity_id) != 0)
+            {
+                m_scene->uncommit_entity(entity_id);
+            }
         }
 
         m_2d_geometry_commit_stack.clear();
@@ -992,14 +1048,53 @@ std::shared_ptr<GeometryDescriptor>& AbstractViewerWindow::get_geometry(const st
     return m_scene->get_geometry(in_name);
 }
 
+std::shared_ptr<GeometryDescriptor>& AbstractViewerWindow::get_geometry(const EntityId &in_entity)
+{
+    return m_scene->get_geometry(in_entity);
+}
+
+EntityId AbstractViewerWindow::find_entity(const std::string &in_name) const
+{
+    return m_scene->find_entity(in_name);
+}
+
+/// @note A geometry not uploaded yet is hidden once upload_commits() creates it
 void AbstractViewerWindow::hide_geometry(const std::string &in_name)
 {
-    m_hidden_geometries.insert(in_name);
+    const EntityId entity = m_scene->find_entity(in_name);
+    if (entity.is_null())
+    {
+        m_hidden_geometries.insert(in_name);
+        return;
+    }
+    hide_geometry(entity);
+}
+
+void AbstractViewerWindow::hide_geometry(const EntityId &in_entity)
+{
+    if (m_scene->has_entity(in_entity) && m_hidden_entities.insert(in_entity).second)
+    {
+        m_scene->uncommit_entity(in_entity);
+    }
 }
 
 void AbstractViewerWindow::show_geometry(const std::string &in_name)
 {
-    m_hidden_geometries.erase(in_name);
+    const EntityId entity = m_scene->find_entity(in_name);
+    if (entity.is_null())
+    {
+        m_hidden_geometries.erase(in_name);
+        return;
+    }
+    show_geometry(entity);
+}
+
+void AbstractViewerWindow::show_geometry(const EntityId &in_entity)
+{
+    if (m_hidden_entities.erase(in_entity) != 0)
+    {
+        m_scene->commit_entity(in_entity);
+    }
 }
 
 void AbstractViewerWindow::remove_geometry(const std::string &in_name)
@@ -1012,13 +1107,50 @@ void AbstractViewerWindow::remove_geometry(const std::string &in_name)
     }
     else
     {
+        /// A hidden name stays hidden if it is committed again
+        if (m_hidden_entities.erase(m_scene->find_entity(in_name)) != 0)
+        {
+            m_hidden_geometries.insert(in_name);
+        }
         m_scene->destroy_entity(in_name);
     }
 }
 
+void AbstractViewerWindow::remove_geometry(const EntityId &in_entity)
+{
+    accquire_render_context();
+    if (m_scene->has_entity(in_entity) && m_hidden_entities.erase(in_entity) != 0)
+    {
+        m_hidden_geometries.insert(m_scene->get_entity_key(in_entity));
+    }
+    if (m_scene->destroy_entity(in_entity) == false)
+    {
+        GP_TRACE("Entity not found");
+    }
+}
+
 void AbstractViewerWindow::destroy_entities_in_layer(const float &in_layer_id)
 {
+    std::vector<std::pair<EntityId, std::string>> hidden_entities;
+    for (const EntityId& hidden_entity : m_hidden_entities)
+    {
+        if (m_scene->has_entity(hidden_entity))
+        {
+            hidden_entities.emplace_back(hidden_entity, m_scene->get_entity_key(hidden_entity));
+        }
+    }
+
     m_scene->destroy_entities_in_layer(in_layer_id);
+
+    /// Names of the destroyed hidden entities stay hidden if they are committed again
+    for (const auto& hidden_entity : hidden_entities)
+    {
+        if (!m_scene->has_entity(hidden_entity.first))
+        {
+            m_hidden_entities.erase(hidden_entity.first);
+            m_hidden_geometries.insert(hidden_entity.second);
+        }
+    }
 }
 
 void AbstractViewerWindow::clear_display_layers()
@@ -1194,14 +1326,17 @@ void AbstractViewerWindow::frame_scene(const char* entity_name)
 {
     m_camera->set_zoom_ratio(1.0f);
     
+    std::array<float, 6> bb;
+
+    /// Frame the whole scene when no entity is given
     if(entity_name == nullptr)
-    {
-        return; 
-    }
-    
-    std::shared_ptr<GridPro_GFX::GeometryDescriptor>& entity_descriptor = get_geometry(entity_name);
-    
-    auto bb = (entity_descriptor->get_bounding_box());
+        bb = m_scene->get_scene_bounding_box();
+    else
+        bb = get_geometry(entity_name)->get_total_bounding_box();
+
+    /// Nothing to frame
+    if(bb[0] == bb[3] && bb[1] == bb[4] && bb[2] == bb[5])
+        return;
 
     set_bounding_box({bb[0], bb[1], bb[2], bb[3], bb[4], bb[5]});
     
@@ -15,7 +15,7 @@ PYBIND11_EMBEDDED_MODULE(GridPro_GFX, m)
     // 1. GeometryDescriptor Binding
     py::class_<GridPro_GFX::GeometryDescriptor, std::shared_ptr<GridPro_GFX::GeometryDescriptor>>(m, "GeometryDescriptor")
         .def(py::init<>())
-        .def("set_current_primitive_set", &GridPro_GFX::GeometryDescriptor::set_current_primitive_set)
+        .def("set_current_primitive_set", py::overload_cast<const std::string &, GLenum>(&GridPro_GFX::GeometryDescriptor::set_current_primitive_set))
         // Wrapper for positions (NumPy -> std::vector<float>)
         .def("copy_pos_array", [](GridPro_GFX::GeometryDescriptor &self, py::array_t<float> array)
         {
@@ -52,6 +52,7 @@ struct coord
 };
 
 void load_geometry_file(std::string filename, Viewer *viewer);
+bool load_cached_geometry_file(const std::string& filename, const std::string& cache_path, Viewer *viewer);
 
 int main(int argc, char *argv[])
 {
@@ -96,8 +97,49 @@ int main(int argc, char *argv[])
     return app.exec();
 }
 
+// Quads stay quads (picking and wireframe follow the quads), the 3.3 driver draws their triangulation
+static void commit_mesh(const std::shared_ptr<GridPro_GFX::GeometryDescriptor>& face_descriptor, const bool& is_quad_file, Viewer *viewer)
+{
+    if (is_quad_file)
+    {
+        face_descriptor->set_current_primitive_set("cad_mesh", GL_QUADS);
+        face_descriptor->triangulate_primitive_set();
+    }
+
+    // Commit to GL layer
+    viewer->commit_geometry("MESHFACE", face_descriptor);
+}
+
+// Parsed meshes are cached next to the source in the binary geometry format, reopening maps the cache instead
+bool load_cached_geometry_file(const std::string& filename, const std::string& cache_path, Viewer *viewer)
+{
+    std::error_code error;
+    const auto source_time = std::filesystem::last_write_time(filename, error);
+    if (error) return false;
+    const auto cache_time = std::filesystem::last_write_time(cache_path, error);
+    if (error || cache_time < source_time || !GridPro_GFX::GeometryFile::is_readable(cache_path))
+        return false;
+
+    try
+    {
+        auto face_descriptor = GridPro_GFX::GeometryFile::read(cache_path);
+        std::cout << "Loaded cached geometry " << cache_path << "\n";
+        commit_mesh(face_descriptor, filename.size() >= 5 && filename.substr(filename.size() - 5) == ".quad", viewer);
+        return true;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Ignoring geometry cache : " << e.what() << std::endl;
+        return false;
+    }
+}
+
 void load_geometry_file(std::string filename, Viewer *viewer)
 {
+    const std::string cache_path = filename + GridPro_GFX::GeometryFile::FILE_EXTENSION;
+    if (load_cached_geometry_file(filename, cache_path, viewer))
+        return;
+
     std::vector<coord> points;
     std::vector<uint32_t> faces;
 
@@ -196,10 +238,16 @@ void load_geometry_file(std::string filename, Viewer *viewer)
     auto face_descriptor = std::make_shared<GridPro_GFX::GeometryDescriptor>();
     const std::string face_name = "cad_mesh";
 
-    face_descriptor->set_current_primitive_set(face_name, GL_TRIANGLES);
+    const bool is_quad_file = filename.size() >= 5 && filename.substr(filename.size() - 5) == ".quad";
+
+    face_descriptor->set_current_primitive_set(face_name, is_quad_file ? GL_QUADS : GL_TRIANGLES);
     face_descriptor->move_pos_array(std::move(gl_point));
     face_descriptor->move_index_array(std::move(faces));
 
+    // Mesher output order is cache unfriendly, reorder triangles and vertices before the upload
+    if (filename.size() > 5 && filename.substr(filename.size() - 5) == ".tria")
+        face_descriptor->optimize_vertex_order();
+
     // Visual options (as per your example)
     face_descriptor->set_fill_color(60, 120, 255, 255);
     face_descriptor->set_pick_scheme(GL_PICK_GEOMETRY);
@@ -207,8 +255,16 @@ void load_geometry_file(std::string filename, Viewer *viewer)
     face_descriptor->set_wireframe_color(255, 255, 255, 255);
     face_descriptor->set_line_width(3);
 
-    // Commit to GL layer
-    viewer->commit_geometry("MESHFACE", face_descriptor);
+    try
+    {
+        GridPro_GFX::GeometryFile::write(*face_descriptor, cache_path);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Could not cache geometry : " << e.what() << std::endl;
+    }
+
+    commit_mesh(face_descriptor, is_quad_file, viewer);
 }
 
 
@@ -16,7 +16,26 @@ contains(viewer_variable, qt) {
 # Core
 HEADERS += \
     $$PWD/Renderer/include/Core/gp_gui_geometry_descriptor.h \
+    $$PWD/Renderer/include/Core/gp_gui_vertex_layout.h \
+    $$PWD/Renderer/include/Core/gp_gui_parallel.h \
+    $$PWD/Renderer/include/Core/gp_gui_dirty_ranges.h \
+    $$PWD/Renderer/include/Core/gp_gui_index_buffer.h \
+    $$PWD/Renderer/include/Core/gp_gui_primitive_traits.h \
+    $$PWD/Renderer/include/Core/gp_gui_geometry_kernels.h \
+    $$PWD/Renderer/include/Core/gp_gui_instance_array.h \
+    $$PWD/Renderer/include/Core/gp_gui_primitive_color_array.h \
+    $$PWD/Renderer/include/Core/gp_gui_strip_array.h \
+    $$PWD/Renderer/include/Core/gp_gui_geometry_file.h \
+    $$PWD/Renderer/include/Core/gp_gui_mesh_simplifier.h \
+    $$PWD/Renderer/include/Core/gp_gui_mesh_optimizer.h \
+    $$PWD/Renderer/include/Core/gp_gui_triangulator.h \
+    $$PWD/Renderer/include/Core/gp_gui_interned_table.h \
+    $$PWD/Renderer/include/Core/gp_gui_vertex_transform.h \
+    $$PWD/Renderer/include/Core/gp_gui_tessellator.h \
     $$PWD/Renderer/include/Core/gp_gui_scene.h \
+    $$PWD/Renderer/include/Core/gp_gui_slot_map.h \
+    $$PWD/Renderer/include/Core/gp_gui_pick_id_allocator.h \
+    $$PWD/Renderer/include/Core/gp_gui_draw_buckets.h \
     $$PWD/Renderer/include/Core/gp_gui_entity_handle.h \
     $$PWD/Renderer/include/Core/gp_gui_communications.h \
     $$PWD/Renderer/include/Core/gp_gui_events.h \
@@ -48,6 +67,12 @@ contains(viewer_variable, qt) {
 # Core
 SOURCES += \
     $$PWD/Renderer/src/Core/gp_gui_geometry_descriptor.cpp \
+    $$PWD/Renderer/src/Core/gp_gui_mesh_simplifier.cpp \
+    $$PWD/Renderer/src/Core/gp_gui_mesh_optimizer.cpp \
+    $$PWD/Renderer/src/Core/gp_gui_triangulator.cpp \
+    $$PWD/Renderer/src/Core/gp_gui_vertex_transform.cpp \
+    $$PWD/Renderer/src/Core/gp_gui_geometry_file.cpp \
+    $$PWD/Renderer/src/Core/gp_gui_tessellator.cpp \
     $$PWD/Renderer/src/Core/gp_gui_scene.cpp \
     $$PWD/Renderer/src/Core/gp_gui_entity_handle.cpp \
     $$PWD/Renderer/src/Core/gp_gui_communications.cpp \
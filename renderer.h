@@ -1,3 +1,4 @@
 #pragma once
 #include "Renderer/include/Viewers/viewer.h"
-#include "Renderer/include/Core/gp_gui_geometry_descriptor.h"
\ No newline at end of file
+#include "Renderer/include/Core/gp_gui_geometry_descriptor.h"
+#include "Renderer/include/Core/gp_gui_geometry_file.h"
\ No newline at end of file